@@ -5,7 +5,7 @@ echo ========================================
 echo.
 
 echo Compiling all modules...
-g++ -std=c++98 -Wall -Wextra -O2 src\main.cpp src\rubik_state.cpp src\rubik_rotation.cpp src\rubik_animation.cpp src\rubik_timer.cpp src\rubik_input.cpp src\rubik_render.cpp -Iinclude -I"C:\mingw64\include" -L"C:\mingw64\lib" -lfreeglut -lopengl32 -lglu32 -o build\rubik.exe
+g++ -std=c++98 -Wall -Wextra -O2 src\main.cpp src\rubik_state.cpp src\rubik_rotation.cpp src\rubik_animation.cpp src\rubik_timer.cpp src\rubik_input.cpp src\rubik_render.cpp src\rubik_scheduler.cpp src\rubik_glext.cpp src\rubik_instanced.cpp src\rubik_thread.cpp src\rubik_image.cpp src\rubik_softraster.cpp src\rubik_net.cpp src\rubik_text.cpp src\rubik_perf.cpp src\rubik_wall.cpp src\rubik_picking.cpp src\rubik_video.cpp src\rubik_log.cpp src\rubik_profiler.cpp src\rubik_clock.cpp src\rubik_simulate.cpp src\rubik_record.cpp src\rubik_solvedb.cpp src\rubik_notation.cpp src\rubik_statecodec.cpp src\rubik_cfop.cpp -Iinclude -I"C:\mingw64\include" -L"C:\mingw64\lib" -lfreeglut -lopengl32 -lglu32 -lwinmm -o build\rubik.exe
 
 if %errorlevel% neq 0 (
     echo.
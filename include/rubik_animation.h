@@ -6,16 +6,23 @@
 // Trạng thái animation toàn cục
 extern RotationAnimation g_animation;
 extern MoveQueue g_moveQueue;
-extern int g_lastTimeMs;
+extern ClockNanos g_lastFrameNanos;  // Mốc đồng hồ của lần idle trước, -1 khi cần đặt lại
 extern bool g_keyHeld[256];
 extern int g_scrambleMovesPending;
 
+// Mô phỏng bước cố định
+extern ClockNanos g_simTimeNanos;        // Thời gian mô phỏng, chỉ tăng theo SIMULATION_STEP_NANOS
+extern ClockNanos g_simAccumulatorNanos; // Thời gian thực chưa được mô phỏng
+extern float g_renderAlpha;       // Tỉ lệ nội suy giữa 2 bước mô phỏng (0..1)
+
 // Điều khiển animation
 void startRotation(Face face, bool clockwise, bool isScrambleMove = false);
 void updateAnimation(float deltaTime);
 void cancelAnimationAndQueue();
 bool isPieceInAnimation(int pieceIndex);
 float easeInOutCubic(float t);
+void stepSimulation();
+float getInterpolatedDisplayAngle();
 
 // Quản lý hàng đợi
 bool dequeueQueuedMove(Face& face, bool& clockwise, bool& isScrambleMove);
@@ -0,0 +1,35 @@
+#ifndef RUBIK_CFOP_H
+#define RUBIK_CFOP_H
+
+#include "rubik_types.h"
+
+// Nhận diện các giai đoạn CFOP (cross, từng cặp F2L, OLL, PLL) trên luồng nước đi có
+// mốc thời gian, để tách split time và số nước của từng giai đoạn.
+//
+// Giống isCubeSolved, một mảnh được coi là xong khi mọi sticker của nó cùng màu tâm
+// của mặt chứa sticker đó; mỗi giai đoạn là một tập mảnh (mask 20 bit). Sau mỗi nước
+// chỉ 8 mảnh của mặt vừa xoay được kiểm tra lại, các giai đoạn chỉ còn là phép AND
+// trên mask (OLL thêm 8 sticker của mặt đối diện cross, chỉ khi F2L đã xong).
+//
+// Một giai đoạn được tính xong ở nước đầu tiên mà nó và mọi giai đoạn trước cùng đúng
+// (cặp F2L có sẵn khi cross xong, như XCross, xong cùng nước với cross). Cross trên mặt
+// nào cũng được theo dõi; mặt được chọn là mặt xong F2L sớm nhất.
+
+// Nạp trạng thái (54 ký tự URFDLB, xem rubik_statecodec.h) và bắt đầu đếm từ đây
+void setCfopTrackerState(CfopTracker& tracker, const char facelets[54], ClockNanos startNanos);
+
+// Bắt đầu đếm lại từ trạng thái hiện tại (ngay trước nước giải đầu tiên)
+void restartCfopTracker(CfopTracker& tracker, ClockNanos startNanos);
+
+void trackCfopMove(CfopTracker& tracker, MoveCode move, ClockNanos timeNanos);
+bool isCfopTrackerSolved(const CfopTracker& tracker);
+
+// Split của lần giải đang theo dõi; false nếu cube chưa được giải
+bool getCfopSplits(const CfopTracker& tracker, CfopSplits& splits);
+
+// Chế độ dòng lệnh: --cfop-splits a.rrec [b.rrec ...] [--csv splits.csv]
+// Tách mọi lần giải có tính giờ trong các file phiên, in split trung bình từng giai đoạn
+bool isCfopSplitsRequested(int argc, char** argv);
+int runCfopSplitsCommand(int argc, char** argv);
+
+#endif // RUBIK_CFOP_H
@@ -0,0 +1,36 @@
+#ifndef RUBIK_CLOCK_H
+#define RUBIK_CLOCK_H
+
+#include "rubik_types.h"
+
+// Dịch vụ đồng hồ chung: mốc thời gian là số nguyên 64 bit nano giây kể từ lần
+// đọc đồng hồ đầu tiên của tiến trình (CLOCK_MONOTONIC / QueryPerformanceCounter),
+// không trôi theo giờ hệ thống và không mất độ chính xác khi phiên chạy dài.
+//
+// clockNowNanos(): thời gian của ứng dụng (mô phỏng, timer, log). Có thể thay bằng
+// đồng hồ ảo để chạy không cửa sổ nhanh hơn thời gian thực hoặc lặp lại chính xác.
+// clockRealNanos(): luôn là đồng hồ thật, dùng để đo hiệu năng và chờ frame.
+
+ClockNanos clockNowNanos();
+ClockNanos clockRealNanos();
+
+// Đồng hồ ảo: đứng yên cho tới khi được đẩy tới. Chỉ luồng điều khiển mô phỏng
+// được đặt/đẩy; các luồng khác (log) chỉ đọc
+void setVirtualClock(ClockNanos now);
+void advanceVirtualClock(ClockNanos delta);
+void useRealClock();
+bool isVirtualClockActive();
+
+inline double clockNanosToSeconds(ClockNanos nanos) {
+    return (double)nanos * 1e-9;
+}
+
+inline double clockNanosToMs(ClockNanos nanos) {
+    return (double)nanos * 1e-6;
+}
+
+inline ClockNanos clockSecondsToNanos(double seconds) {
+    return (ClockNanos)(seconds * 1e9 + (seconds >= 0.0 ? 0.5 : -0.5));
+}
+
+#endif // RUBIK_CLOCK_H
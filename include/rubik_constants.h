@@ -23,9 +23,123 @@ const float COLOR_BLACK[] = {0.1f, 0.1f, 0.1f};   // Mặt ẩn
 const float ROTATION_SPEED_DEG_PER_SEC = 360.0f;
 const int MOVE_QUEUE_CAPACITY = 20;
 
+// Tốc độ frame mục tiêu khi có animation/timer đang chạy
+const int TARGET_FRAME_RATE = 60;
+
+// Mô phỏng bước cố định: animation, hàng đợi và timer luôn tiến theo SIMULATION_STEP
+const int SIMULATION_RATE_HZ = 120;
+const float SIMULATION_STEP = 1.0f / (float)SIMULATION_RATE_HZ;
+const long long NANOS_PER_SECOND = 1000000000LL;
+const long long SIMULATION_STEP_NANOS = NANOS_PER_SECOND / SIMULATION_RATE_HZ;
+const int MAX_SIMULATION_STEPS_PER_FRAME = 12;  // Tối đa 100ms mô phỏng mỗi frame
+
 // Hằng số camera
 const float ROTATION_SENSITIVITY = 0.3f;
 const float KEYBOARD_ROTATION_SPEED = 5.0f;
 const float CAMERA_DISTANCE = 8.0f;
+const float CAMERA_FOV_DEG = 45.0f;
+const float CAMERA_NEAR = 0.1f;
+const float CAMERA_FAR = 100.0f;
+const int PICK_DRAG_THRESHOLD_PIXELS = 10;      // Kéo trên sticker quá mức này thì xoay lớp
+const float PICK_DRAG_MIN_ALIGNMENT = 0.5f;    // cos góc tối đa giữa hướng kéo và hướng sticker di chuyển
+
+// File ảnh đánh số (frame_%04d.png, net_%05d.png)
+const int IMAGE_PATH_MAX_NUMBER_WIDTH = 20;    // Độ rộng tối đa của số thứ tự trong tên file
+
+// Renderer phần mềm (headless)
+const int SOFT_TILE_SIZE = 64;                 // Kích thước tile (pixel)
+const float SOFT_DEFAULT_ANGLE_X = 25.0f;      // Góc nhìn mặc định để thấy 3 mặt
+const float SOFT_DEFAULT_ANGLE_Y = -35.0f;
+
+// Overlay chữ (atlas glyph của GLUT_BITMAP_HELVETICA_18)
+const int TEXT_MAX_LABELS = 8;                 // Số dòng chữ tối đa của overlay
+const int TIMER_OVERLAY_LABELS = 4;            // Slot 0..3 cho timer, các slot sau cho HUD hiệu năng
+const int TEXT_LABEL_MAX_CHARS = 64;           // Số ký tự tối đa mỗi dòng
+const int TEXT_ATLAS_CELL = 24;                // Ô chứa một glyph trong atlas (pixel)
+const int TEXT_ATLAS_BASELINE = 6;             // Khoảng cách từ đáy ô tới baseline
+const int TEXT_ATLAS_COLUMNS = 16;             // 16 x 6 ô cho ký tự ASCII 32..127
+const int TEXT_ATLAS_ROWS = 6;
+
+// HUD hiệu năng
+const int PERF_SAMPLE_COUNT = 240;             // Vòng mẫu: 4 giây ở 60 FPS
+const int PERF_HUD_REFRESH_FRAMES = 15;        // Cập nhật chữ HUD mỗi 15 frame
+const int PERF_HISTOGRAM_BUCKETS = 50;         // Histogram frame time: ô 1 ms, ô cuối là >= 49 ms
+const int LATENCY_SAMPLE_COUNT = 512;          // Vòng mẫu độ trễ phím -> màn hình (mỗi mẫu một nước)
+const int LATENCY_HISTOGRAM_BUCKETS = 100;     // Histogram độ trễ: ô 1 ms, ô cuối là >= 99 ms
+
+// Chế độ tường nhiều cube (--wall N)
+const int WALL_DEFAULT_CUBES = 1000;
+const int WALL_MAX_CUBES = 20000;
+const int WALL_PIECES_PER_CUBE = 26;           // Bỏ mảnh lõi (0,0,0), không bao giờ nhìn thấy
+const int WALL_SCRIPT_MOVES = 20;              // Mỗi cube trộn 20 nước rồi giải ngược lại, lặp mãi
+const float WALL_CUBE_SPACING = 4.0f;          // Khoảng cách tâm hai cube cạnh nhau
+const float WALL_CUBE_RADIUS = 2.6f;           // Bán kính cầu bao một cube (kể cả lớp đang xoay)
+const float WALL_MOVE_SECONDS_MIN = 0.25f;     // Thời gian một nước, chọn ngẫu nhiên cho từng cube
+const float WALL_MOVE_SECONDS_MAX = 0.5f;
+const float WALL_MOVE_PAUSE = 0.3f;            // Nghỉ giữa hai nước (tính theo phần của một nước)
+const float WALL_TILT_X_DEG = 25.0f;           // Mỗi cube nghiêng để thấy 3 mặt
+const float WALL_TILT_Y_DEG = -35.0f;
+const float WALL_ZOOM_STEP = 1.25f;            // Phím +/- phóng to/thu nhỏ
+const float WALL_CAMERA_NEAR = 0.5f;
+
+// Level of detail theo kích thước cube trên màn hình (pixel)
+const float LOD_FULL_MIN_PIXELS = 64.0f;       // Từ mức này trở lên: đủ 26 mảnh
+const float LOD_BOX_MAX_PIXELS = 14.0f;        // Dưới mức này: một hộp 6 màu tâm
+const int LOD_ATLAS_WIDTH = 1024;              // Atlas sticker (texel), mỗi cube một ô 18x3
+const int LOD_ATLAS_BLOCK_WIDTH = 18;
+const int LOD_ATLAS_BLOCK_HEIGHT = 3;
+
+// Sơ đồ net 2D (12 x 9 ô)
+const int NET_DEFAULT_CELL_SIZE = 16;          // Kích thước một ô sticker (pixel)
+const int NET_BATCH_CHUNK = 256;               // Số sơ đồ mỗi lô giao cho một luồng
+
+// Xuất video lời giải (--export-video)
+const int VIDEO_QUEUE_DEPTH = 4;               // Số frame tối đa chờ giữa hai giai đoạn
+const int VIDEO_FRAME_POOL = 2 * VIDEO_QUEUE_DEPTH + 3;  // Hai hàng đợi đầy + 1 frame ở mỗi giai đoạn
+const float VIDEO_DEFAULT_HOLD_SECONDS = 0.5f; // Giữ hình trước nước đầu và sau nước cuối
+
+// Nhật ký bất đồng bộ
+const int LOG_RING_CAPACITY = 4096;            // Số bản ghi chờ ghi (lũy thừa của 2)
+const int LOG_BATCH_RECORDS = 512;             // Số bản ghi gom lại trước mỗi lần ghi file
+const int TRACE_PAYLOAD_BYTES = 48;            // Phải khớp TraceRecord::payload
+const int TRACE_MAX_VALUES = TRACE_PAYLOAD_BYTES / 4;
+const unsigned char TRACE_NO_TEXT = 0xFF;
+const unsigned int TRACE_FORMAT_VERSION = 3;   // Tăng khi bố cục TraceRecord/header thay đổi
+
+// Profiler theo vùng (Chrome trace JSON)
+const int PROFILE_EVENTS_PER_THREAD = 1 << 16; // Mỗi luồng 1.5 MB, cấp khi luồng ghi vùng đầu tiên
+const int PROFILE_MAX_THREADS = 64;
+const long long PROFILE_CALIBRATION_NANOS = 20000000; // Đo tần số TSC tối thiểu trong khoảng này (20 ms)
+
+// Mô phỏng không cửa sổ theo đồng hồ ảo (--simulate)
+const float SIMULATE_DEFAULT_TPS = 4.0f;       // Tốc độ nhập nước đi giả lập (nước/giây)
+const int SIMULATE_SETTLE_LIMIT_SECONDS = 600; // settle quá lâu coi như treo
+const int SIMULATE_MAX_SCRAMBLE = MOVE_QUEUE_CAPACITY + 1;  // Một nước chạy + hàng đợi đầy
+
+// Ghi và phát lại phiên (.rrec)
+const unsigned int RECORD_FORMAT_VERSION = 1;
+const int RECORD_CHECKPOINT_MOVES = 64;        // Seek giải mã lại tối đa chừng này nước...
+const int RECORD_CHECKPOINT_EVENTS = 1024;     // ...và chừng này sự kiện (kéo camera sinh nhiều sự kiện)
+const long long RECORD_TIME_UNIT_NANOS = 1000; // Delta thời gian lưu theo micro giây
+const float RECORD_CAMERA_UNIT_DEGREES = 0.01f;
+const double REPLAY_SEEK_STEP_SECONDS = 5.0;   // Phím , / .
+const float REPLAY_MIN_SPEED = 0.125f;
+const float REPLAY_MAX_SPEED = 64.0f;
+
+// Lịch sử lần giải (rubik_solves.db)
+const unsigned int SOLVE_DB_VERSION = 1;
+const int SOLVE_AVERAGE_COUNT = 4;
+const int SOLVE_AVERAGE_SIZES[SOLVE_AVERAGE_COUNT] = {5, 12, 100, 1000};
+const int SOLVE_AVERAGE_TRIM_PERCENT = 5;      // Bỏ ceil(5%) lần tốt nhất và tệ nhất (tối thiểu 1), như csTimer
+const int SOLVE_MAX_AVERAGE_SIZE = 1000;       // Khi mở chỉ cần đọc lại chừng này bản ghi cuối
+
+// Ký hiệu nước đi WCA/SiGN
+const int NOTATION_MAX_MOVES = 1 << 20;        // Mỗi đoạn văn bản, chặn (R)999999999
+const int NOTATION_MAX_NESTING = 32;           // Độ sâu ngoặc ( ) [ ]
+const int NOTATION_MAX_REPORTED_ERRORS = 20;   // --parse-moves in tối đa chừng này lỗi
+
+// Mã hóa trạng thái cube (facelet 54 ký tự / nhị phân 16 byte)
+const unsigned char CUBE_STATE_PACKED_VERSION = 1;
+const int CUBE_STATE_MAX_REPORTED_ERRORS = 20; // --state-convert in tối đa chừng này lỗi
 
 #endif // RUBIK_CONSTANTS_H
@@ -0,0 +1,59 @@
+#ifndef RUBIK_GLEXT_H
+#define RUBIK_GLEXT_H
+
+#include <GL/glut.h>
+#include <GL/glext.h>
+
+// Con trỏ hàm OpenGL mở rộng, được nạp lúc chạy qua glutGetProcAddress
+// (opengl32 trên Windows chỉ export OpenGL 1.1)
+
+// Vertex buffer object (OpenGL 1.5)
+extern PFNGLGENBUFFERSPROC pglGenBuffers;
+extern PFNGLDELETEBUFFERSPROC pglDeleteBuffers;
+extern PFNGLBINDBUFFERPROC pglBindBuffer;
+extern PFNGLBUFFERDATAPROC pglBufferData;
+extern PFNGLBUFFERSUBDATAPROC pglBufferSubData;
+
+// Shader GLSL (OpenGL 2.0)
+extern PFNGLCREATESHADERPROC pglCreateShader;
+extern PFNGLDELETESHADERPROC pglDeleteShader;
+extern PFNGLSHADERSOURCEPROC pglShaderSource;
+extern PFNGLCOMPILESHADERPROC pglCompileShader;
+extern PFNGLGETSHADERIVPROC pglGetShaderiv;
+extern PFNGLGETSHADERINFOLOGPROC pglGetShaderInfoLog;
+extern PFNGLCREATEPROGRAMPROC pglCreateProgram;
+extern PFNGLDELETEPROGRAMPROC pglDeleteProgram;
+extern PFNGLATTACHSHADERPROC pglAttachShader;
+extern PFNGLBINDATTRIBLOCATIONPROC pglBindAttribLocation;
+extern PFNGLLINKPROGRAMPROC pglLinkProgram;
+extern PFNGLGETPROGRAMIVPROC pglGetProgramiv;
+extern PFNGLGETPROGRAMINFOLOGPROC pglGetProgramInfoLog;
+extern PFNGLUSEPROGRAMPROC pglUseProgram;
+extern PFNGLGETUNIFORMLOCATIONPROC pglGetUniformLocation;
+extern PFNGLUNIFORM1FPROC pglUniform1f;
+extern PFNGLUNIFORM2FPROC pglUniform2f;
+extern PFNGLUNIFORM3FPROC pglUniform3f;
+extern PFNGLUNIFORM4FPROC pglUniform4f;
+extern PFNGLENABLEVERTEXATTRIBARRAYPROC pglEnableVertexAttribArray;
+extern PFNGLDISABLEVERTEXATTRIBARRAYPROC pglDisableVertexAttribArray;
+extern PFNGLVERTEXATTRIBPOINTERPROC pglVertexAttribPointer;
+
+// Instancing (OpenGL 3.3 hoặc ARB_instanced_arrays)
+extern PFNGLVERTEXATTRIBDIVISORPROC pglVertexAttribDivisor;
+extern PFNGLDRAWARRAYSINSTANCEDPROC pglDrawArraysInstanced;
+
+// Khả năng của context hiện tại (hợp lệ sau khi gọi loadGLExtensions)
+extern bool g_glBuffersSupported;
+extern bool g_glShadersSupported;
+extern bool g_glInstancingSupported;
+
+// Nạp các hàm mở rộng (gọi sau khi đã tạo cửa sổ/context)
+void loadGLExtensions();
+
+// Biên dịch và link một chương trình shader
+// attribNames[i] được gán vào location i trước khi link
+// Trả về 0 nếu lỗi (chi tiết được ghi vào log)
+GLuint createShaderProgram(const char* vertexSource, const char* fragmentSource,
+                           const char* const* attribNames, int attribCount);
+
+#endif // RUBIK_GLEXT_H
@@ -0,0 +1,24 @@
+#ifndef RUBIK_IMAGE_H
+#define RUBIK_IMAGE_H
+
+#include "rubik_types.h"
+#include <cstdio>
+
+// Ghi ảnh RGB 8-bit (các hàng từ trên xuống, không có padding)
+
+// PPM nhị phân (P6)
+bool writeImagePPM(const char* path, int width, int height, const unsigned char* rgb);
+bool writeImagePPMToStream(FILE* file, int width, int height, const unsigned char* rgb);
+
+// PNG không nén (deflate "stored"), không cần zlib
+bool writeImagePNG(const char* path, int width, int height, const unsigned char* rgb);
+
+// Chọn định dạng theo phần mở rộng (.png, còn lại là PPM)
+bool writeImageFile(const char* path, int width, int height, const unsigned char* rgb);
+
+// Tách đường dẫn có một chỗ số %d / %Nd / %0Nd; numbered = false nếu không có '%'.
+// false nếu có '%' khác hoặc độ rộng vượt IMAGE_PATH_MAX_NUMBER_WIDTH
+bool parseImagePathPattern(const char* path, bool& numbered, ImagePathPattern& pattern);
+void formatImagePath(const ImagePathPattern& pattern, int index, char* path, size_t size);
+
+#endif // RUBIK_IMAGE_H
@@ -0,0 +1,36 @@
+#ifndef RUBIK_INSTANCED_H
+#define RUBIK_INSTANCED_H
+
+#include "rubik_types.h"
+
+// Renderer retained-mode: hình học một mảnh được upload một lần vào VBO,
+// transform và màu từng mảnh được gửi dưới dạng dữ liệu instance,
+// cả khối được vẽ bằng một draw call. Dữ liệu instance chỉ đổi khi nước đi hoàn
+// tất; lớp đang xoay được chọn và xoay trong vertex shader theo uniform
+// (mặt phẳng chọn lớp, trục, cos/sin của góc).
+
+// Khởi tạo (sau loadGLExtensions). Trả về false nếu GL không hỗ trợ,
+// khi đó renderer immediate mode được dùng thay thế.
+bool initInstancedRenderer();
+bool isInstancedRendererReady();
+
+// Vẽ toàn bộ g_visualCube
+void drawRubikCubeInstanced();
+
+// Vẽ một dãy instance bất kỳ bằng một draw call (chế độ nhiều cube)
+void drawPieceInstances(const PieceInstance* instances, int count);
+
+// LOD trung bình: mỗi cube là một hộp, màu sticker lấy từ atlas (mỗi cube một ô
+// 18x3 texel: 6 mặt x 3x3 sticker). false nếu shader không dựng được.
+bool isCubeLodRendererReady();
+void drawCubeLodInstances(const CubeLodInstance* instances, int count,
+                          unsigned int atlasTexture, int atlasWidth, int atlasHeight);
+
+// Ô (u, v) trong lưới 3x3 của mặt face ứng với mảnh ở toạ độ lưới grid,
+// cùng hướng u/v với toạ độ texture của hộp LOD
+void getStickerCell(int face, const int grid[3], int& u, int& v);
+
+// Đóng gói màu float của một mảnh thành RGBA 8-bit
+void packPieceColors(const CubePiece& piece, unsigned char colors[6][4]);
+
+#endif // RUBIK_INSTANCED_H
@@ -0,0 +1,160 @@
+#ifndef RUBIK_LOG_H
+#define RUBIK_LOG_H
+
+#include "rubik_types.h"
+#include "rubik_constants.h"
+#include <cstring>
+
+// Nhật ký bất đồng bộ dạng trace nhị phân (rubik_debug.trace). Mỗi sự kiện là
+// một bản ghi 64 byte: mã sự kiện, mốc thời gian và các giá trị thô; format chữ
+// nằm trong bảng rubik_log_events.h và chỉ được áp dụng khi giải mã offline
+// (rubik --decode-log rubik_debug.trace). Luồng gọi chép bản ghi vào một ô của
+// vòng đệm không khoá (nhiều luồng ghi, một luồng đọc) rồi trả về; luồng ghi nền
+// ghi nguyên các bản ghi xuống file theo lô. Vòng đệm đầy thì bản ghi bị bỏ và được đếm.
+//
+// Cách gọi: RUBIK_LOG(EVT_ANIM_START) << face << clockwise << queueCount;
+// Sự kiện có mức lớn hơn RUBIK_LOG_COMPILE_LEVEL bị loại lúc biên dịch (không còn
+// nhánh, không tính tham số). Mức và nhóm còn lại lọc lúc chạy bằng biến môi trường
+// RUBIK_LOG_LEVEL (error|warn|info|debug|trace) và RUBIK_LOG_CATEGORIES (danh sách
+// general,move,input,render,timer,io hoặc all), hoặc setLogLevel/setLogCategories.
+
+// Mặc định giữ mọi mức; bản release (-DNDEBUG) không còn lời gọi log nào.
+// Chọn mức khác: -DRUBIK_LOG_COMPILE_LEVEL=2 (chỉ error, warn, info)
+#ifndef RUBIK_LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define RUBIK_LOG_COMPILE_LEVEL -1
+#else
+#define RUBIK_LOG_COMPILE_LEVEL 4
+#endif
+#endif
+
+enum LogEventId {
+#define LOG_EVENT(name, level, category, format) name,
+#include "rubik_log_events.h"
+#undef LOG_EVENT
+    LOG_EVENT_COUNT
+};
+
+// Mức và nhóm của từng sự kiện dưới dạng hằng biên dịch (<tên>_LEVEL, <tên>_CATEGORY)
+enum LogEventTraits {
+#define LOG_EVENT(name, level, category, format) name##_LEVEL = level, name##_CATEGORY = category,
+#include "rubik_log_events.h"
+#undef LOG_EVENT
+    LOG_EVENT_TRAITS_END
+};
+
+// Mở file, đọc cấu hình từ môi trường và khởi động luồng ghi (bản release: không làm gì)
+void initLogFile();
+// Ghi nốt các bản ghi còn trong vòng đệm rồi đóng file
+void closeLogFile();
+
+void setLogLevel(LogLevel level);
+LogLevel getLogLevel();
+void setLogCategories(unsigned int mask);
+unsigned int getLogCategories();
+
+// Số bản ghi bị bỏ vì vòng đệm đầy
+int getLogDroppedCount();
+
+// Chế độ dòng lệnh: --decode-log rubik_debug.trace [output.txt] (mặc định stdout)
+bool isLogDecodeRequested(int argc, char** argv);
+int runLogDecodeCommand(int argc, char** argv);
+
+// Kiểm tra nhanh trước khi dựng bản ghi (đọc hai biến, không khoá)
+extern volatile int g_logLevelLimit;      // -1 khi log chưa mở
+extern volatile int g_logCategoryMask;
+
+inline bool isLogEnabled(LogLevel level, unsigned int category) {
+    return (int)level <= g_logLevelLimit && (category & (unsigned int)g_logCategoryMask) != 0;
+}
+
+#define LOG_EVENT_ENABLED(event) \
+    ((int)event##_LEVEL <= RUBIK_LOG_COMPILE_LEVEL && isLogEnabled((LogLevel)event##_LEVEL, event##_CATEGORY))
+
+// Dạng if/else để RUBIK_LOG(...) << ...; an toàn trong if không ngoặc.
+// Ép kiểu để RUBIK_LOG(EVT_X); không tham số không bị hiểu là khai báo biến EVT_X
+#define RUBIK_LOG(event) \
+    if (!LOG_EVENT_ENABLED(event)) {} else LogEmitter(static_cast<LogEventId>(event))
+
+// Đưa bản ghi đã dựng vào vòng đệm (gọi từ ~LogEmitter)
+void submitTraceRecord(TraceRecord& record);
+
+// Dựng một bản ghi trên stack; bản ghi được gửi khi biểu thức kết thúc.
+// Giá trị vượt quá TRACE_MAX_VALUES ô bị bỏ, chuỗi bị cắt cho vừa payload
+struct LogEmitter {
+    TraceRecord record;
+    const char* text;
+
+    explicit LogEmitter(LogEventId eventId) : text(0) {
+        record.eventId = (unsigned short)eventId;
+        record.realMask = 0;
+        record.valueCount = 0;
+        record.textLength = TRACE_NO_TEXT;
+        record.wideMask = 0;
+        memset(record.payload, 0, sizeof(record.payload));
+    }
+
+    ~LogEmitter() {
+        if (text != 0) {
+            // Chuỗi đặt ngay sau các ô số (chuỗi còn sống tới hết biểu thức)
+            int offset = record.valueCount * 4;
+            int room = TRACE_PAYLOAD_BYTES - offset;
+            int length = (int)strlen(text);
+            if (length > room) {
+                // Cắt ở ranh giới ký tự UTF-8
+                length = room;
+                while (length > 0 && ((unsigned char)text[length] & 0xC0) == 0x80) {
+                    length--;
+                }
+            }
+            memcpy(record.payload + offset, text, length);
+            record.textLength = (unsigned char)length;
+        }
+        submitTraceRecord(record);
+    }
+
+    LogEmitter& operator<<(int value) {
+        if (record.valueCount < TRACE_MAX_VALUES) {
+            memcpy(record.payload + record.valueCount * 4, &value, 4);
+            record.valueCount++;
+        }
+        return *this;
+    }
+
+    LogEmitter& operator<<(unsigned int value) {
+        return *this << (int)value;
+    }
+
+    LogEmitter& operator<<(bool value) {
+        return *this << (value ? 1 : 0);
+    }
+
+    LogEmitter& operator<<(float value) {
+        if (record.valueCount < TRACE_MAX_VALUES) {
+            memcpy(record.payload + record.valueCount * 4, &value, 4);
+            record.realMask |= (unsigned short)(1 << record.valueCount);
+            record.valueCount++;
+        }
+        return *this;
+    }
+
+    // double giữ nguyên 8 byte (mốc giây kể từ lúc chạy cần độ chính xác dưới ms sau
+    // nhiều giờ); chỉ còn một ô thì lưu dạng float
+    LogEmitter& operator<<(double value) {
+        if (record.valueCount + 2 > TRACE_MAX_VALUES) {
+            return *this << (float)value;
+        }
+        memcpy(record.payload + record.valueCount * 4, &value, 8);
+        record.realMask |= (unsigned short)(1 << record.valueCount);
+        record.wideMask |= (unsigned short)(1 << record.valueCount);
+        record.valueCount += 2;
+        return *this;
+    }
+
+    LogEmitter& operator<<(const char* value) {
+        text = value != 0 ? value : "(null)";
+        return *this;
+    }
+};
+
+#endif // RUBIK_LOG_H
@@ -0,0 +1,89 @@
+// Bảng sự kiện log, dùng chung cho chương trình (ghi bản ghi nhị phân) và
+// bộ giải mã --decode-log (dựng lại dòng chữ). Không có include guard: file
+// được include nhiều lần với các định nghĩa LOG_EVENT khác nhau.
+//
+// LOG_EVENT(tên, mức, nhóm, format)
+// Format như printf với %d %u %x %c %f %e %g %s (tối đa một %s mỗi sự kiện), cộng thêm
+// %F: tên mặt (FRONT..DOWN) từ số nguyên, %R: chiều xoay CW/CCW từ giá trị bool.
+// Chỉ thêm sự kiện mới vào cuối để file trace cũ vẫn giải mã được.
+
+// Chung
+LOG_EVENT(EVT_APP_READY, LOG_INFO, LOG_CAT_GENERAL, "Ứng dụng khởi tạo thành công")
+LOG_EVENT(EVT_CUBE_INIT, LOG_INFO, LOG_CAT_GENERAL, "Giai đoạn 2: Đã khởi tạo %d mảnh Rubik")
+LOG_EVENT(EVT_SCHEDULER_INIT, LOG_INFO, LOG_CAT_GENERAL, "SCHEDULER: target=%d fps")
+LOG_EVENT(EVT_IDENTITY_TEST_BEGIN, LOG_INFO, LOG_CAT_GENERAL, "=== KIỂM TRA TÍNH ĐỒNG NHẤT XOAỸ ===")
+LOG_EVENT(EVT_IDENTITY_TEST_FACE, LOG_INFO, LOG_CAT_GENERAL, "Kiểm tra %F: thực hiện 4 lượt xoay CW...")
+LOG_EVENT(EVT_IDENTITY_TEST_PASS, LOG_INFO, LOG_CAT_GENERAL, "  -> %F THÀNH CÔNG (%d/%d khớp)")
+LOG_EVENT(EVT_IDENTITY_TEST_FAIL, LOG_ERROR, LOG_CAT_GENERAL, "  -> %F THẤT BẠI (%d/%d khớp)")
+LOG_EVENT(EVT_IDENTITY_TEST_END, LOG_INFO, LOG_CAT_GENERAL, "=== KẾT THÚC KIỂM TRA TÍNH ĐỒNG NHẤT XOAỸ ===")
+LOG_EVENT(EVT_LOG_DROPPED, LOG_WARN, LOG_CAT_GENERAL, "LOG: %d bản ghi bị bỏ vì vòng đệm đầy")
+
+// Nước đi và animation
+LOG_EVENT(EVT_ANIM_START, LOG_DEBUG, LOG_CAT_MOVE, "ANIM START %F %R | queue=%d")
+LOG_EVENT(EVT_ANIM_QUEUED, LOG_DEBUG, LOG_CAT_MOVE, "ANIM QUEUED %F %R | queue=%d")
+LOG_EVENT(EVT_ANIM_END, LOG_DEBUG, LOG_CAT_MOVE, "ANIM END %F %R | queue=%d sim=%.4f s")
+LOG_EVENT(EVT_QUEUE_FULL, LOG_WARN, LOG_CAT_MOVE, "QUEUE FULL: drop %F %R")
+LOG_EVENT(EVT_ROTATE_COLORS, LOG_DEBUG, LOG_CAT_MOVE, "ROTATE %F %R: colors swapped, positions preserved")
+LOG_EVENT(EVT_ROTATE_PIECES, LOG_DEBUG, LOG_CAT_MOVE, "ROTATE %F %R: pieces [%d,%d,%d,%d,%d,%d,%d,%d,%d]")
+LOG_EVENT(EVT_CUBE_RESET, LOG_INFO, LOG_CAT_MOVE, "RESET: Cube về trạng thái đã giải")
+LOG_EVENT(EVT_SCRAMBLE_QUEUED, LOG_INFO, LOG_CAT_MOVE, "TRỘN: %d bước ngẫu nhiên đã xếp hàng")
+
+// Chuột, bàn phím
+LOG_EVENT(EVT_REL_FACE, LOG_DEBUG, LOG_CAT_INPUT, "REL FACE %d -> %F (front=%F up=%F right=%F) angles(X=%.1f,Y=%.1f)")
+LOG_EVENT(EVT_FACE_CHANGE, LOG_DEBUG, LOG_CAT_INPUT, "FACE CHANGE: %F | verticalAxis=[%.1f,%.1f,%.1f] horizontalAxis=[%.1f,%.1f,%.1f]")
+LOG_EVENT(EVT_MOUSE_BUTTON, LOG_DEBUG, LOG_CAT_INPUT, "MOUSE EVENT: button=%d state=%d x=%d y=%d")
+LOG_EVENT(EVT_STICKER_DRAG_START, LOG_DEBUG, LOG_CAT_INPUT, "*** STICKER DRAG START *** face=%F grid=[%d,%d,%d]")
+LOG_EVENT(EVT_DRAG_START, LOG_DEBUG, LOG_CAT_INPUT, "*** DRAG START ***")
+LOG_EVENT(EVT_DRAG_END, LOG_DEBUG, LOG_CAT_INPUT, "*** DRAG END ***")
+LOG_EVENT(EVT_STICKER_DRAG_IGNORED, LOG_DEBUG, LOG_CAT_INPUT, "STICKER DRAG: lớp giữa hoặc hướng kéo không rõ, bỏ qua (dx=%d dy=%d)")
+LOG_EVENT(EVT_STICKER_DRAG_TURN, LOG_INFO, LOG_CAT_INPUT, "STICKER DRAG: dx=%d dy=%d → %F %R")
+LOG_EVENT(EVT_MOUSE_MOTION, LOG_TRACE, LOG_CAT_INPUT, "MOUSE: x=%d y=%d | dx=%d dy=%d | yawDelta=%.1f pitchDelta=%.1f")
+LOG_EVENT(EVT_CAMERA_ANGLES, LOG_TRACE, LOG_CAT_INPUT, "  → Updated angles: X=%.1f Y=%.1f")
+LOG_EVENT(EVT_PERF_HUD_TOGGLE, LOG_INFO, LOG_CAT_INPUT, "KEYBOARD: F3 pressed | perf HUD %s")
+LOG_EVENT(EVT_KEY_PRESSED, LOG_INFO, LOG_CAT_INPUT, "KEYBOARD: %s pressed | angleX=%.1f angleY=%.1f")
+
+// OpenGL và vẽ
+LOG_EVENT(EVT_GL_VERSION, LOG_INFO, LOG_CAT_RENDER, "GL: %s")
+LOG_EVENT(EVT_GL_RENDERER, LOG_INFO, LOG_CAT_RENDER, "GL RENDERER: %s")
+LOG_EVENT(EVT_GL_EXTENSIONS, LOG_INFO, LOG_CAT_RENDER, "GL EXT: buffers=%d shaders=%d instancing=%d")
+LOG_EVENT(EVT_GL_SHADER_ERROR, LOG_ERROR, LOG_CAT_RENDER, "GL SHADER COMPILE ERROR (%s):")
+LOG_EVENT(EVT_GL_LINK_ERROR, LOG_ERROR, LOG_CAT_RENDER, "GL PROGRAM LINK ERROR:")
+LOG_EVENT(EVT_GL_INFO_LOG, LOG_ERROR, LOG_CAT_RENDER, "  %s")
+LOG_EVENT(EVT_INSTANCED_READY, LOG_INFO, LOG_CAT_RENDER, "RENDER: instanced VBO renderer ready")
+LOG_EVENT(EVT_DISPLAY_FRAME, LOG_TRACE, LOG_CAT_RENDER, "DISPLAY: frame=%d")
+LOG_EVENT(EVT_TEXT_ATLAS, LOG_INFO, LOG_CAT_RENDER, "TEXT: atlas %dx%d %s")
+LOG_EVENT(EVT_SOFT_RENDER_INIT, LOG_INFO, LOG_CAT_RENDER, "SOFT RENDER: %dx%d, %d tile, %d luồng")
+LOG_EVENT(EVT_WALL_INIT, LOG_INFO, LOG_CAT_RENDER, "WALL: %d cubes (%d x %d), %d instances")
+
+// Đồng hồ speedcubing
+LOG_EVENT(EVT_TIMER_START, LOG_INFO, LOG_CAT_TIMER, "TIMER ĐÃ BẮT ĐẦU")
+LOG_EVENT(EVT_TIMER_SOLVED, LOG_INFO, LOG_CAT_TIMER, "ĐÃ GIẢI XONG CUBE! Thời gian: %.3f giây | Số nước: %d | TPS: %.2f")
+
+// Lệnh dòng lệnh, ghi file
+LOG_EVENT(EVT_PERF_DUMP_FAILED, LOG_ERROR, LOG_CAT_IO, "LỖI: Không mở được file %s để ghi histogram")
+LOG_EVENT(EVT_PERF_DUMP, LOG_INFO, LOG_CAT_IO, "Đã ghi histogram hiệu năng (%d frame) vào %s")
+LOG_EVENT(EVT_SOFT_RENDER_STATS, LOG_INFO, LOG_CAT_IO, "SOFT RENDER: %d frame, %d luồng, %.3f ms/frame, %.1f fps, tổng %.2fs")
+LOG_EVENT(EVT_NET_BATCH, LOG_INFO, LOG_CAT_IO, "NET BATCH: %d sơ đồ, %d luồng, %.3fs, %.0f sơ đồ/giây, %d không hợp lệ, %d lỗi ghi")
+LOG_EVENT(EVT_VIDEO_EXPORT, LOG_INFO, LOG_CAT_IO, "VIDEO: %s, %d frame, %.2fs, x%.1f thời gian thực")
+LOG_EVENT(EVT_VIDEO_STAGES, LOG_INFO, LOG_CAT_IO, "VIDEO: ms/frame vẽ %.3f đổi màu %.3f ghi %.3f")
+LOG_EVENT(EVT_PROFILE_WRITE_FAILED, LOG_ERROR, LOG_CAT_IO, "LỖI: Không mở được file %s để ghi profile")
+LOG_EVENT(EVT_PROFILE_WRITTEN, LOG_INFO, LOG_CAT_IO, "PROFILE: %d vùng, %d luồng, %d bị bỏ, %d luồng không được ghi -> %s")
+LOG_EVENT(EVT_SIMULATE_DONE, LOG_INFO, LOG_CAT_IO, "SIMULATE: %d phiên, %.1f giây mô phỏng trong %.2fs, %d nước, %d lần giải, %d lỗi")
+LOG_EVENT(EVT_SIMULATE_FAILURE, LOG_ERROR, LOG_CAT_GENERAL, "SIMULATE: phiên %d dòng %d: %s")
+LOG_EVENT(EVT_RECORD_STARTED, LOG_INFO, LOG_CAT_IO, "RECORD: ghi phiên vào %s")
+LOG_EVENT(EVT_RECORD_FINISHED, LOG_INFO, LOG_CAT_IO, "RECORD: %d sự kiện, %d nước, %d checkpoint, %d byte -> %s")
+LOG_EVENT(EVT_RECORD_WRITE_FAILED, LOG_ERROR, LOG_CAT_IO, "LỖI: Không ghi được file phiên %s")
+LOG_EVENT(EVT_REPLAY_LOADED, LOG_INFO, LOG_CAT_IO, "REPLAY: %.1f giây, %d sự kiện, %d nước, %d checkpoint: %s")
+LOG_EVENT(EVT_REPLAY_INDEX_REBUILT, LOG_WARN, LOG_CAT_IO, "REPLAY: phiên chưa được đóng, dựng lại %d checkpoint từ %d sự kiện: %s")
+LOG_EVENT(EVT_REPLAY_OPEN_FAILED, LOG_ERROR, LOG_CAT_IO, "LỖI: Không đọc được file phiên %s")
+LOG_EVENT(EVT_REPLAY_SEEK, LOG_DEBUG, LOG_CAT_MOVE, "REPLAY SEEK %.3f s: checkpoint %d + %d sự kiện, %.1f us")
+LOG_EVENT(EVT_SOLVE_DB_OPENED, LOG_INFO, LOG_CAT_IO, "SOLVES: %d lần giải, gộp thêm %d bản ghi, nạp trong %.3f ms: %s")
+LOG_EVENT(EVT_SOLVE_DB_FAILED, LOG_ERROR, LOG_CAT_IO, "LỖI: Không đọc/ghi được file lịch sử giải %s")
+LOG_EVENT(EVT_SOLVE_STATS, LOG_INFO, LOG_CAT_TIMER, "SOLVE #%d: %.3f | best %.3f | mean %.3f | ao5 %.3f | ao12 %.3f | ao100 %.3f")
+LOG_EVENT(EVT_PARSE_MOVES, LOG_INFO, LOG_CAT_IO, "PARSE MOVES: %d dòng, %d nước, %d dòng lỗi, %.0f MB/s: %s")
+LOG_EVENT(EVT_STATE_IMPORTED, LOG_INFO, LOG_CAT_GENERAL, "STATE: nạp trạng thái %s")
+LOG_EVENT(EVT_STATE_IMPORT_FAILED, LOG_WARN, LOG_CAT_GENERAL, "STATE: trạng thái không hợp lệ (%s)")
+LOG_EVENT(EVT_STATE_EXPORTED, LOG_INFO, LOG_CAT_GENERAL, "STATE: %s")
+LOG_EVENT(EVT_STATE_CONVERT, LOG_INFO, LOG_CAT_IO, "STATE CONVERT: %d trạng thái, %d lỗi, %.1f triệu/giây: %s")
+LOG_EVENT(EVT_CFOP_SPLITS, LOG_INFO, LOG_CAT_IO, "CFOP: %d lần giải từ %d file, %d lần bỏ dở, %.1f triệu nước/giây")
+LOG_EVENT(EVT_LATENCY_DUMP, LOG_INFO, LOG_CAT_IO, "LATENCY: %d mẫu, phím -> swap p50 %.1f p95 %.1f p99 %.1f ms: %s")
@@ -0,0 +1,36 @@
+#ifndef RUBIK_NET_H
+#define RUBIK_NET_H
+
+#include "rubik_types.h"
+
+// Sơ đồ net 2D (cube trải phẳng) cho tờ trộn, preview và thumbnail:
+//
+//         U
+//     L   F   R   B
+//         D
+//
+// 54 sticker theo thứ tự mặt U, R, F, D, L, B (giống chuỗi facelet chuẩn),
+// mỗi mặt 9 ô theo hàng từ trên xuống khi nhìn trên net.
+
+// Màu 54 sticker (RGB 8-bit) lấy trực tiếp từ màu các mảnh của cube
+void extractNetStickers(const RubikCube& cube, unsigned char stickers[54][3]);
+
+// Màu 54 sticker từ chuỗi facelet 54 ký tự URFDLB, false nếu chuỗi không hợp lệ
+bool faceletsToNetStickers(const char* facelets, unsigned char stickers[54][3]);
+
+// Kích thước ảnh net với một ô cellSize pixel
+int getNetImageWidth(int cellSize);
+int getNetImageHeight(int cellSize);
+
+// Ghi sơ đồ nối tiếp vào buffer (không tạo đối tượng trung gian)
+// SVG: dựng khuôn một lần cho mỗi kích thước ô, mỗi sơ đồ chỉ chép khuôn và điền 54 màu
+void buildNetSVGTemplate(NetSVGTemplate& svgTemplate, int cellSize);
+void appendNetSVG(std::string& out, const NetSVGTemplate& svgTemplate, const unsigned char stickers[54][3]);
+void rasterNetRGB(unsigned char* rgb, const unsigned char stickers[54][3], int cellSize);
+
+// Chế độ dòng lệnh: --net-batch input.txt output [--format svg|ppm] [--cell N] [--threads N]
+// Mỗi dòng input là một chuỗi nước đi hoặc một chuỗi facelet 54 ký tự
+bool isNetBatchRequested(int argc, char** argv);
+int runNetBatchCommand(int argc, char** argv);
+
+#endif // RUBIK_NET_H
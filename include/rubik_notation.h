@@ -0,0 +1,50 @@
+#ifndef RUBIK_NOTATION_H
+#define RUBIK_NOTATION_H
+
+#include "rubik_types.h"
+#include <string>
+#include <vector>
+
+// Bộ đọc ký hiệu nước đi WCA/SiGN, đọc thẳng trên bộ nhớ (không sao chép, không
+// cần '\0' ở cuối) nên dùng được trên file map vào bộ nhớ hàng triệu dòng:
+//   R U' F2 R2' R3      mặt, hậu tố số lần và ' (cả ’ khi chép từ web)
+//   Rw r M E S          wide (Rw hoặc chữ thường) và slice
+//   x y z               xoay cả khối
+//   (R U R' U')3 (R U)' nhóm lặp / đảo
+//   [R, U] [R: U]       commutator R U R' U', conjugate R U R'
+//   // ... hoặc # ...   chú thích tới hết dòng
+//
+// Engine chỉ xoay 6 mặt ngoài với tâm cố định, nên slice/wide/xoay khối được quy
+// về mặt ngoài cộng một hướng nhìn ảo: M = L' R rồi đổi nhãn các mặt theo x'.
+// Trạng thái nhận được trùng trạng thái thật sau khi xoay cả khối về hướng chuẩn.
+
+inline int moveCodeFace(MoveCode code) {
+    return code / 3;
+}
+
+// Số quarter turn xuôi chiều: 1, 2 hoặc 3 (= một lần ngược chiều)
+inline int moveCodeTurns(MoveCode code) {
+    return code % 3 + 1;
+}
+
+inline MoveCode makeMoveCode(int face, int quarterTurns) {
+    return (MoveCode)(face * 3 + quarterTurns - 1);
+}
+
+inline MoveCode invertMoveCode(MoveCode code) {
+    return makeMoveCode(moveCodeFace(code), 4 - moveCodeTurns(code));
+}
+
+// Đọc [begin, end) thành mã nước đi (moves bị ghi đè, dung lượng được giữ lại để
+// dùng lại giữa các dòng). Sai cú pháp: trả về false và vị trí lỗi
+bool parseNotation(const char* begin, const char* end, std::vector<MoveCode>& moves, NotationError& error);
+
+// Ghi lại theo ký hiệu của engine ("R U2 F'"), nối vào out
+void formatMoveCodes(const MoveCode* moves, int count, std::string& out);
+
+// Chế độ dòng lệnh: --parse-moves file [--out engine.txt]
+// Mỗi dòng là một chuỗi (scramble hoặc lời giải); in thống kê, tốc độ và vị trí lỗi
+bool isParseMovesRequested(int argc, char** argv);
+int runParseMovesCommand(int argc, char** argv);
+
+#endif // RUBIK_NOTATION_H
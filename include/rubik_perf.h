@@ -0,0 +1,48 @@
+#ifndef RUBIK_PERF_H
+#define RUBIK_PERF_H
+
+#include "rubik_types.h"
+
+// Thu thập số liệu mỗi frame vào vòng mẫu cố định PERF_SAMPLE_COUNT phần tử:
+// thời gian frame, phần update/render/swap, số draw call, số đỉnh và độ sâu hàng đợi.
+// HUD (F3) được vẽ cùng overlay timer, F4 ghi histogram ra file, F7 ghi độ trễ phím.
+
+extern bool g_perfHudVisible;
+
+void togglePerfHud();
+
+// Đo phần mô phỏng (bao quanh các bước stepSimulation trong idle)
+void perfBeginUpdate();
+void perfEndUpdate();
+
+// Đo một frame: đầu display(), trước swap, sau swap
+void perfBeginFrame();
+void perfBeginSwap();
+void perfEndFrame();
+
+// Ghi nhận một lệnh vẽ và số đỉnh gửi lên GL
+void perfCountDraw(int vertices);
+
+// Thống kê trên vòng mẫu hiện tại
+void computePerfStats(PerfStats& stats);
+
+// Ghi histogram frame time và toàn bộ mẫu ra file văn bản
+bool dumpPerfHistogram(const char* path);
+
+// Độ trễ phím -> màn hình: mỗi phím xoay mặt được theo dõi qua startRotation, lúc
+// animation bắt đầu, frame đầu tiên có chuyển động và lúc swap của frame đó.
+// keyboard() bao quanh phần xử lý phím bằng perfKeyArrived/perfKeyHandled; các mốc
+// còn lại được gọi từ rubik_animation và perfBeginFrame/perfEndFrame.
+void perfKeyArrived();
+void perfKeyHandled();
+void perfMoveAccepted(bool isScrambleMove);
+void perfAnimationStarted();
+void perfAnimationFinished();
+void perfMovesCancelled();
+
+void computeLatencyStats(LatencyStats& stats);
+
+// Ghi percentile từng mốc, histogram phím -> swap và toàn bộ mẫu ra file CSV
+bool dumpLatencyHistogram(const char* path);
+
+#endif // RUBIK_PERF_H
@@ -0,0 +1,23 @@
+#ifndef RUBIK_PICKING_H
+#define RUBIK_PICKING_H
+
+#include "rubik_types.h"
+
+// Chọn sticker dưới con trỏ bằng phép giao tia - khối tính trên CPU, dùng cùng
+// ma trận camera với display(). Không dùng selection mode hay đọc lại màu từ
+// framebuffer nên không phải chờ GPU; chi phí không phụ thuộc số mảnh.
+// Mảnh được chọn theo vị trí nghỉ trên lưới (bỏ qua lớp đang xoay dở).
+
+// Tia từ camera qua pixel (x, y) của cửa sổ (toạ độ chuột, gốc trên-trái)
+void computePickRay(int x, int y, float origin[3], float direction[3]);
+
+// Giao tia với bề mặt khối, false nếu tia không chạm khối
+bool pickSticker(const float origin[3], const float direction[3], StickerHit& hit);
+bool pickStickerAt(int x, int y, StickerHit& hit);
+
+// Từ sticker đã chọn và hướng kéo trên màn hình (pixel) suy ra lớp cần xoay.
+// false nếu lớp đó là lớp giữa (chưa có nước đi cho lớp giữa) hoặc hướng kéo
+// không đủ gần hướng di chuyển của sticker khi xoay lớp nào
+bool computeDragTurn(const StickerHit& hit, int dx, int dy, Face& face, bool& clockwise);
+
+#endif // RUBIK_PICKING_H
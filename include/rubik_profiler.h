@@ -0,0 +1,97 @@
+#ifndef RUBIK_PROFILER_H
+#define RUBIK_PROFILER_H
+
+#include "rubik_types.h"
+#include "rubik_constants.h"
+#include "rubik_thread.h"
+#include "rubik_clock.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Profiler theo vùng: PROFILE_ZONE("tên") đo từ chỗ khai báo tới hết khối { }.
+// Mỗi luồng ghi vào bộ đệm riêng (không khoá, không cấp phát sau lần đầu), thời
+// điểm lấy bằng bộ đếm TSC của CPU (x86) hoặc clockRealNanos(). Kết quả xuất ra
+// Chrome trace JSON, mở bằng ui.perfetto.dev hoặc chrome://tracing.
+//
+// Bật/tắt khi chạy: F5 (mỗi lần tắt ghi một file rubik_profile_N.json), hoặc biến
+// môi trường RUBIK_PROFILE=out.json để ghi từ lúc khởi động tới khi thoát (dùng
+// được cho các chế độ không cửa sổ). Khi tắt, mỗi vùng chỉ tốn một phép đọc cờ.
+
+// Gọi một lần ở đầu main (sau initLogFile)
+void initProfiler();
+
+// Bắt đầu phiên đo mới (xoá dữ liệu cũ) / dừng phiên đo
+void startProfileCapture();
+void stopProfileCapture();
+bool isProfileCaptureActive();
+
+// Ghi các vùng của phiên gần nhất ra file Chrome trace JSON
+bool writeProfileTrace(const char* path);
+
+// F5: bắt đầu, hoặc dừng và ghi rubik_profile_N.json
+void toggleProfileCapture();
+
+// Tên luồng hiển thị trong Perfetto (gọi từ chính luồng đó)
+void setProfilerThreadName(const char* name);
+
+// Nội bộ: cờ bật và bộ đệm của luồng hiện tại (cấp khi luồng ghi vùng đầu tiên;
+// trỏ vào g_profileNoBuffer nếu luồng bị từ chối vì đã đủ PROFILE_MAX_THREADS)
+extern volatile int g_profilerEnabled;
+extern RUBIK_THREAD_LOCAL ProfileThreadBuffer* t_profileBuffer;
+extern ProfileThreadBuffer g_profileNoBuffer;
+ProfileThreadBuffer* registerProfileThread();
+
+inline ProfileTicks readProfileTicks() {
+#if defined(_MSC_VER)
+    return __rdtsc();
+#elif defined(__i386__) || defined(__x86_64__)
+    return __builtin_ia32_rdtsc();
+#else
+    return (ProfileTicks)clockRealNanos();
+#endif
+}
+
+struct ProfileZone {
+    ProfileThreadBuffer* buffer;   // NULL khi profiler tắt lúc vào vùng hoặc luồng không có bộ đệm
+    const char* name;
+    ProfileTicks start;
+
+    explicit ProfileZone(const char* zoneName) : buffer(0), name(zoneName), start(0) {
+        if (g_profilerEnabled) {
+            buffer = t_profileBuffer != 0 ? t_profileBuffer : registerProfileThread();
+            if (buffer == &g_profileNoBuffer) {
+                buffer = 0;
+                return;
+            }
+            start = readProfileTicks();
+        }
+    }
+
+    ~ProfileZone() {
+        if (buffer == 0) {
+            return;
+        }
+        ProfileTicks end = readProfileTicks();
+        int index = buffer->count;
+        if (index >= PROFILE_EVENTS_PER_THREAD) {
+            buffer->dropped++;
+            return;
+        }
+        ProfileEvent& event = buffer->events[index];
+        event.name = name;
+        event.start = start;
+        event.end = end;
+        buffer->count = index + 1;
+    }
+
+private:
+    ProfileZone(const ProfileZone&);
+    ProfileZone& operator=(const ProfileZone&);
+};
+
+// Một vùng mỗi khối; name phải là chuỗi hằng (chỉ con trỏ được lưu)
+#define PROFILE_ZONE(name) ProfileZone profileZone(name)
+
+#endif // RUBIK_PROFILER_H
@@ -0,0 +1,76 @@
+#ifndef RUBIK_RECORD_H
+#define RUBIK_RECORD_H
+
+#include "rubik_types.h"
+
+// Ghi phiên: mọi nước đi được chấp nhận (startRotation), trộn, reset và thay đổi
+// camera được ghi thành luồng sự kiện gọn (1 byte tag + delta thời gian varint theo
+// micro giây + dữ liệu varint), trung bình 2-4 byte mỗi nước. Cứ RECORD_CHECKPOINT_MOVES
+// nước (hoặc RECORD_CHECKPOINT_EVENTS sự kiện) lại chụp một checkpoint trạng thái; bảng
+// checkpoint kích thước cố định ở cuối file là chỉ mục để seek bằng tìm kiếm nhị phân
+// rồi giải mã tiếp tối đa một khoảng checkpoint, thay vì mô phỏng lại từ đầu.
+//
+// File được đọc bằng cách map vào bộ nhớ (mmap / MapViewOfFile), không cần giải nén
+// hay cấp phát. Phiên bị ngắt giữa chừng (chưa có bảng checkpoint) vẫn phát lại được:
+// bảng được dựng lại một lần khi mở.
+
+// ==================== Ghi ====================
+
+// Bắt đầu ghi vào path (trạng thái hiện tại là checkpoint đầu); tự đóng khi thoát
+bool startRecording(const char* path);
+void finishRecording();
+bool isRecording();
+
+// Cửa sổ: ghi mọi phiên vào rubik_session_<ngày>_<giờ>.rrec, hoặc theo biến môi
+// trường RUBIK_RECORD=path (RUBIK_RECORD=off để tắt)
+void initSessionRecording();
+
+// Gọi ngay TRƯỚC khi trạng thái thay đổi (checkpoint là trạng thái trước sự kiện)
+void recordMoveAccepted(Face face, bool clockwise, bool isScrambleMove);
+void recordScrambleBegin(int numMoves);
+void recordReset();
+
+// Gọi sau khi góc camera / mặt trước thay đổi (chỉ ghi khi giá trị lượng tử đổi)
+void recordCameraChanged();
+
+// ==================== Phát lại ====================
+
+// Dòng lệnh: --replay file.rrec [--speed X]; false nếu không yêu cầu
+bool parseReplayOptions(int argc, char** argv, const char*& path, float& speed);
+
+// Mở file và đưa ứng dụng về đầu phiên. Đồng hồ chung được thay bằng đồng hồ ảo
+// chạy theo thời gian của phiên (timer hiển thị đúng thời gian đã ghi)
+bool startReplay(const char* path, float speed);
+bool isReplayActive();
+bool isReplayPlaying();   // Đang chạy (không tạm dừng): scheduler cần cập nhật liên tục
+
+// Gọi ở đầu idle(): đẩy thời gian phiên theo đồng hồ thật * tốc độ và nạp các sự kiện tới hạn
+void updateReplay();
+
+// Nhảy tới thời điểm bất kỳ: O(log n) tìm checkpoint + tối đa một khoảng checkpoint
+void seekReplay(double seconds);
+void toggleReplayPause();
+void scaleReplaySpeed(float factor);
+
+// Cho overlay
+double getReplayPositionSeconds();
+double getReplayDurationSeconds();
+float getReplaySpeed();
+bool isReplayPaused();
+
+// ==================== Đọc tuần tự ====================
+
+// Duyệt luồng sự kiện từ đầu cho công cụ phân tích hàng loạt, không đụng tới trạng thái
+// ứng dụng. Phiên chưa được đóng vẫn đọc được tới sự kiện hoàn chỉnh cuối cùng
+bool openRecordStream(const char* path, RecordStream& stream);
+bool readRecordStream(RecordStream& stream, RecordEvent& event);
+void closeRecordStream(RecordStream& stream);
+
+// Trạng thái lúc bắt đầu ghi (chỉ ghi đè 54 sticker, cube truyền vào nên là cube đã giải)
+void getRecordStreamInitialCube(const RecordStream& stream, RubikCube& cube);
+
+// Chế độ dòng lệnh: --record-info file.rrec [--at S] [--seeks N]
+bool isRecordInfoRequested(int argc, char** argv);
+int runRecordInfoCommand(int argc, char** argv);
+
+#endif // RUBIK_RECORD_H
@@ -14,6 +14,17 @@ void drawRubikCube();
 void display();
 void reshape(int w, int h);
 
+// Transform của mảnh (dùng chung cho mọi đường vẽ)
+float getFaceRotation(Face face, bool clockwise, float displayAngle, float axis[3]);
+float getAnimationRotation(float axis[3]);
+void computePieceTransform(const RubikCube& cube, int pieceIndex, float transform[12]);
+int computeStaticLayerKey();
+
+// Ma trận camera dùng chung cho GL và renderer phần mềm
+void computeViewMatrix(float view[16]);
+void computeViewMatrixAtDistance(float view[16], float distance);
+void computeProjectionMatrix(float projection[16], float aspect);
+
 // Hỗ trợ xoay
 void rotateAroundAxis(const float axis[3], float angle);
 float clampAngle(float angle, float minAngle, float maxAngle);
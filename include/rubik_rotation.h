@@ -3,14 +3,17 @@
 
 #include "rubik_types.h"
 
-// Hàm xoay chính
+// Hàm xoay chính (trạng thái logic)
 void rotateFace(int face, bool clockwise);
 
 // Xoay vị trí
-void rotatePositions(int face, bool clockwise);
+void rotatePositions(RubikCube& cube, int face, bool clockwise);
+
+// Áp dụng chuỗi nước đi ("R U R' U2", đủ ký hiệu WCA/SiGN) lên một cube, trả về -1 nếu không hợp lệ
+int applyMoveString(RubikCube& cube, const char* moves);
 
 // Xoay hướng mảnh
-void rotatePieceOrientation(int pieceIndex, int axis, bool clockwise);
+void rotatePieceOrientation(RubikCube& cube, int pieceIndex, int axis, bool clockwise);
 
 // Xoay tọa độ
 void rotateCoordinates(int axis, int axisSign, bool clockwise,
@@ -25,6 +28,18 @@ void rotateVectorAroundAxis(const float axis[3], float angleDegrees,
 void axisAngleToMatrix(float m[3][3], const float axis[3], float angleDegrees);
 void matrixMultiply(float result[3][3], const float a[3][3], const float b[3][3]);
 
+// Ma trận 4x4 theo quy ước OpenGL (column-major, giống glLoadMatrixf)
+void makeIdentityMatrix4(float m[16]);
+void makeTranslationMatrix4(float m[16], float x, float y, float z);
+void makeRotationMatrix4(float m[16], const float axis[3], float angleDegrees);
+void makePerspectiveMatrix4(float m[16], float fovYDegrees, float aspect, float zNear, float zFar);
+void multiplyMatrix4(float result[16], const float a[16], const float b[16]);
+void transformPoint4(const float m[16], const float p[3], float out[4]);
+
+// Frustum culling (mặt phẳng lấy từ projection * view)
+void extractFrustumPlanes(const float clip[16], float planes[6][4]);
+bool isSphereInFrustum(const float planes[6][4], const float center[3], float radius);
+
 // Tiện ích cho mặt
 Face getOppositeFace(Face face);
 Face getAbsoluteFace(int relativeFace);
@@ -0,0 +1,36 @@
+#ifndef RUBIK_SCHEDULER_H
+#define RUBIK_SCHEDULER_H
+
+// Bộ lập lịch frame: chỉ vẽ lại khi trạng thái thay đổi (dirty) hoặc đang có
+// animation/timer chạy, giữ nhịp ở tốc độ frame mục tiêu bằng glutTimerFunc (không
+// ngủ trong vòng lặp sự kiện nên phím/chuột không phải chờ) và ngừng đặt timer khi
+// không còn việc để làm.
+
+// Khởi tạo (gọi sau khi đã tạo cửa sổ GLUT)
+void initFrameScheduler(int targetFps);
+
+// Chế độ không cửa sổ (render phần mềm): requestRedisplay/wakeScheduler không gọi GLUT,
+// người gọi tự gọi stepSimulation()
+void setSchedulerHeadless(bool headless);
+
+// Đánh dấu cần vẽ lại (gộp nhiều yêu cầu trong cùng một frame thành một)
+void requestRedisplay();
+
+// Được gọi từ display() sau khi vẽ xong một frame
+void onFrameRendered();
+
+// Bật lại nhịp frame khi có animation/timer cần cập nhật liên tục
+void wakeScheduler();
+
+// true nếu scheduler đã ngủ (ngừng nhịp frame) kể từ frame trước: khoảng cách giữa hai frame
+// khi đó là thời gian nghỉ chứ không phải frame chậm. Đọc xong thì xóa cờ
+bool consumeSchedulerResume();
+
+// Kiểm tra còn việc cần cập nhật mỗi frame hay không
+bool hasContinuousWork();
+
+// Gọi ở đầu mỗi frame: đặt timer cho mốc frame kế tiếp rồi trả về ngay, hoặc dừng
+// nhịp nếu không còn việc. Trả về false nếu scheduler vừa được tạm dừng
+bool scheduleNextFrame();
+
+#endif // RUBIK_SCHEDULER_H
@@ -0,0 +1,25 @@
+#ifndef RUBIK_SIMULATE_H
+#define RUBIK_SIMULATE_H
+
+// Chạy toàn bộ logic ứng dụng (startRotation, hàng đợi, updateAnimation,
+// updateTimer, trộn) không cần cửa sổ, theo đồng hồ ảo: thời gian mô phỏng
+// được đẩy nhanh hết mức CPU cho phép và input được lấy từ kịch bản. Dùng để
+// chạy hàng giờ phiên giải trong vài giây (soak test, đo hồi quy hiệu năng).
+//
+// Kịch bản: mỗi dòng (hoặc mỗi đoạn cách nhau bởi ';') là một lệnh, '#' là chú thích
+//   scramble N      trộn N nước ngẫu nhiên (như phím S)
+//   move R U R' U2  nhập nước đi như bàn phím, cách nhau 1/tps giây
+//   solve           nhập chuỗi ngược của mọi nước từ lần cube được giải gần nhất
+//   wait S          để thời gian trôi S giây
+//   settle          chạy tới khi hết animation và hàng đợi
+//   reset           như phím Space
+//   expect solved|unsolved|stopped|ready   kiểm tra trạng thái, sai thì tính là lỗi
+// Sau mỗi settle, trạng thái hiển thị phải trùng trạng thái logic.
+
+// Chế độ dòng lệnh: --simulate [--script "..."] [--script-file f] [--sessions N]
+//                   [--hours H] [--tps X] [--seed N] [--record out.rrec]
+//                   [--solve-db solves.db]
+bool isSimulationRequested(int argc, char** argv);
+int runSimulationCommand(int argc, char** argv);
+
+#endif // RUBIK_SIMULATE_H
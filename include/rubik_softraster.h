@@ -0,0 +1,27 @@
+#ifndef RUBIK_SOFTRASTER_H
+#define RUBIK_SOFTRASTER_H
+
+#include "rubik_types.h"
+
+// Renderer phần mềm cho máy không có GPU (render farm, CI)
+// Vẽ cùng cảnh với display()/drawRubikCube(): cùng ma trận camera, cùng transform
+// của mảnh, depth test GL_LESS. Tam giác được phân vào các tile SOFT_TILE_SIZE và
+// các tile được raster song song trên nhiều luồng.
+// Không vẽ overlay chữ và không có MSAA.
+
+// Khởi tạo framebuffer và thread pool (threadCount <= 0: theo số lõi CPU)
+bool initSoftRenderer(int width, int height, int threadCount);
+void shutdownSoftRenderer();
+int getSoftRendererThreadCount();
+
+// Vẽ g_visualCube với camera hiện tại vào framebuffer
+void renderSceneSoftware();
+const SoftFramebuffer& getSoftFramebuffer();
+
+// Chế độ dòng lệnh: --soft-render out.(ppm|png) [--frames N] [--size WxH]
+//                   [--threads N] [--angles X,Y] [--scramble N] [--seed N]
+// Chạy không cần cửa sổ/GL, trả về mã thoát của chương trình
+bool isSoftRenderRequested(int argc, char** argv);
+int runSoftRenderCommand(int argc, char** argv);
+
+#endif // RUBIK_SOFTRASTER_H
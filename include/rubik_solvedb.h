@@ -0,0 +1,33 @@
+#ifndef RUBIK_SOLVEDB_H
+#define RUBIK_SOLVEDB_H
+
+#include "rubik_types.h"
+
+// Lịch sử lần giải: mỗi lần giải xong được nối vào file thành một SolveRecord
+// 16 byte. Best, mean và ao5/ao12/ao100/ao1000 (trung bình cắt bỏ) được cập nhật
+// dần: mỗi cửa sổ chia N lần giải cuối thành 3 multiset (phần bỏ dưới, phần giữa,
+// phần bỏ trên) cùng tổng phần giữa, nên mỗi lần giải mới là O(log N).
+//
+// Header giữ thống kê đã gộp nên khi mở không phải tính lại từ đầu: chỉ đọc lại
+// SOLVE_MAX_AVERAGE_SIZE bản ghi cuối để dựng cửa sổ, cộng các bản ghi nằm sau
+// header (khi chương trình bị ngắt giữa lúc ghi bản ghi và ghi header).
+
+// Mở (hoặc tạo) file; thống kê hiện tại lấy từ file này
+bool openSolveDatabase(const char* path);
+void closeSolveDatabase();
+bool isSolveDatabaseOpen();
+
+// Cửa sổ: dùng rubik_solves.db, hoặc theo biến môi trường RUBIK_SOLVES=path
+// (RUBIK_SOLVES=off để tắt); tự đóng khi thoát
+void initSolveDatabase();
+
+// Gọi khi timer dừng; không làm gì nếu chưa mở file
+void addSolveRecord(double seconds, int moveCount);
+
+void getSolveStats(SolveStats& stats);
+
+// Chế độ dòng lệnh: --solve-stats file.db [--verify]
+bool isSolveStatsRequested(int argc, char** argv);
+int runSolveStatsCommand(int argc, char** argv);
+
+#endif // RUBIK_SOLVEDB_H
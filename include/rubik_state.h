@@ -6,15 +6,18 @@
 #include <ctime>
 
 // Instance toàn cục Rubik's Cube
+// g_rubikCube: trạng thái logic, cập nhật ngay khi nước đi được chấp nhận
+// g_visualCube: trạng thái hiển thị, đuổi theo trạng thái logic qua animation
 extern RubikCube g_rubikCube;
-
-// Debug
-extern FILE* g_logFile;
-extern clock_t g_logStartClock;
+extern RubikCube g_visualCube;
+extern int g_visualCubeVersion;  // Tăng mỗi khi g_visualCube thay đổi (dùng để vô hiệu cache khi vẽ)
 
 // Khởi tạo và quản lý trạng thái cube
 void initRubikCube();
 void resetCube();
+void syncVisualCube();
+void markVisualCubeChanged();
+void beginScramble(int numMoves);
 void shuffleCube(int numMoves);
 bool isCubeSolved();
 
@@ -23,11 +26,6 @@ int positionToIndex(int i, int j, int k);
 void getFaceIndices(int face, int indices[9]);
 int encodePositionKey(int x, int y, int z);
 
-// Hàm logging
-void initLogFile();
-void closeLogFile();
-double getLogTimestampMs();
-
 // Hàm kiểm tra
 void testRotationIdentity();
 
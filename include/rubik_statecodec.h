@@ -0,0 +1,63 @@
+#ifndef RUBIK_STATECODEC_H
+#define RUBIK_STATECODEC_H
+
+#include "rubik_types.h"
+
+// Mã hóa trạng thái cube để trao đổi giữa các công cụ (thay cho mảng CubePiece 2 KB):
+//
+// - Facelet: 54 ký tự URFDLB, thứ tự mặt U, R, F, D, L, B, mỗi mặt 9 ô theo hàng như
+//   trên sơ đồ net (rubik_net.h). Ví dụ trạng thái đã giải: "UUUUUUUUURRRRRRRRRFFF...".
+// - Nhị phân 16 byte (little-endian), mọi trạng thái hợp lệ có đúng một mã:
+//     0-1  hạng hoán vị góc (0..8!-1)     2-3  hướng 7 góc đầu, cơ số 3
+//     4-7  hạng hoán vị cạnh (0..12!-1)   8-9  hướng 11 cạnh đầu, mỗi bit một cạnh
+//     10   CUBE_STATE_PACKED_VERSION      11-15 dự trữ, luôn 0
+//   Hướng của góc/cạnh cuối suy ra từ tổng nên mã nhị phân luôn đúng twist/flip.
+//
+// Kiểm tra khả năng giải (mọi mảnh có mặt đúng một lần, tổng hướng góc chia hết cho 3,
+// tổng hướng cạnh chẵn, hoán vị góc và cạnh cùng tính chẵn lẻ) chạy trong một lượt
+// tra bảng, gộp lỗi bằng phép OR thay vì rẽ nhánh theo từng mảnh.
+
+// Mảnh và mặt (enum Face) chứa sticker thứ facelet (0..53)
+void getFaceletLocation(int facelet, int& pieceIndex, int& face);
+
+// Sticker của mảnh thứ piece: 0..7 là góc URF..DRB, 8..19 là cạnh UR..BR (thứ tự của
+// CubieState); trả về số sticker (3 hoặc 2)
+int getPieceFacelets(int piece, int facelets[3]);
+
+// Đọc/ghi 54 sticker của một cube (màu không nhận ra được ghi là '?')
+void captureCubeFacelets(const RubikCube& cube, char facelets[54]);
+void applyCubeFacelets(RubikCube& cube, const char facelets[54]);
+
+// Chuyển đổi kèm kiểm tra; facelets không cần '\0' ở cuối
+CubeStateError faceletsToCubies(const char* facelets, CubieState& state);
+void cubiesToFacelets(const CubieState& state, char facelets[54]);
+CubeStateError validateCubieState(const CubieState& state);
+void packCubieState(const CubieState& state, PackedCubeState& packed);
+CubeStateError unpackCubieState(const PackedCubeState& packed, CubieState& state);
+
+// Dạng văn bản của mã nhị phân: 32 chữ số hex
+void packedStateToHex(const PackedCubeState& packed, char hex[32]);
+bool hexToPackedState(const char* hex, PackedCubeState& packed);
+
+const char* getCubeStateErrorMessage(CubeStateError error);
+
+// Trạng thái hiện tại của một cube dưới cả hai dạng (chuỗi kết thúc bằng '\0')
+CubeStateError exportCubeState(const RubikCube& cube, char facelets[55], char hex[33]);
+
+// Nạp vào g_rubikCube từ 54 ký tự facelet hoặc 32 chữ số hex: hủy animation và hàng đợi,
+// timer về trạng thái chờ. Trạng thái không hợp lệ thì cube giữ nguyên
+CubeStateError importCubeState(const char* text, int length);
+
+// F6: in trạng thái hiện tại ra console và nhật ký
+void printCurrentCubeState();
+
+// Tham số --state FACELETS|HEX khi mở cửa sổ: nạp trạng thái trước khi bắt đầu ghi phiên
+const char* parseStateOption(int argc, char** argv);
+
+// Chế độ dòng lệnh: --state-convert input [output] [--to bin|text]
+// --to bin (mặc định): mỗi dòng input là facelet hoặc hex, output là bản ghi 16 byte
+// --to text: input là các bản ghi 16 byte, output là dòng facelet. Không có output: chỉ kiểm tra
+bool isStateConvertRequested(int argc, char** argv);
+int runStateConvertCommand(int argc, char** argv);
+
+#endif // RUBIK_STATECODEC_H
@@ -0,0 +1,24 @@
+#ifndef RUBIK_TEXT_H
+#define RUBIK_TEXT_H
+
+#include "rubik_types.h"
+
+// Vẽ chữ bằng atlas glyph: các glyph của GLUT_BITMAP_HELVETICA_18 được vẽ một lần
+// vào texture, mỗi dòng chữ là một dãy quad được cache và chỉ tính/upload lại
+// khi nội dung thay đổi. Một frame vẽ overlay chỉ còn vài lệnh glDrawArrays.
+
+// Dựng atlas nếu chưa có (gọi đầu display(), trước glClear, vì dùng back buffer làm nháp)
+void prepareTextAtlas();
+bool isTextAtlasReady();
+
+// Cập nhật phép chiếu 2D của overlay (gọi từ reshape)
+void setTextViewport(int width, int height);
+
+// Đặt nội dung một dòng chữ; không làm gì nếu chữ, vị trí và màu không đổi
+void setTextLabel(int slot, float x, float y, const float color[3], const char* text);
+void hideTextLabel(int slot);
+
+// Vẽ tất cả dòng chữ đang hiển thị (tắt depth test trong lúc vẽ)
+void drawTextLabels();
+
+#endif // RUBIK_TEXT_H
@@ -0,0 +1,89 @@
+#ifndef RUBIK_THREAD_H
+#define RUBIK_THREAD_H
+
+#include "rubik_types.h"
+
+// Lớp bọc đa luồng tối thiểu (C++98 không có std::thread)
+// Windows: Win32 API, các hệ khác: pthreads
+
+#ifdef _WIN32
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600  // CONDITION_VARIABLE cần Windows Vista trở lên
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// Biến riêng từng luồng (chỉ kiểu POD, khởi tạo hằng)
+#ifdef _MSC_VER
+#define RUBIK_THREAD_LOCAL __declspec(thread)
+#else
+#define RUBIK_THREAD_LOCAL __thread
+#endif
+
+typedef void (*ThreadFunction)(void* arg);
+
+struct RubikThread {
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    ThreadFunction function;
+    void* arg;
+};
+
+struct RubikMutex {
+#ifdef _WIN32
+    CRITICAL_SECTION section;
+#else
+    pthread_mutex_t mutex;
+#endif
+};
+
+struct RubikCondition {
+#ifdef _WIN32
+    CONDITION_VARIABLE condition;
+#else
+    pthread_cond_t condition;
+#endif
+};
+
+// Luồng
+bool startThread(RubikThread& thread, ThreadFunction function, void* arg);
+void joinThread(RubikThread& thread);
+int getHardwareThreadCount();
+
+// Mutex
+void initMutex(RubikMutex& mutex);
+void destroyMutex(RubikMutex& mutex);
+void lockMutex(RubikMutex& mutex);
+void unlockMutex(RubikMutex& mutex);
+
+// Biến điều kiện (luôn dùng cùng một mutex đã lock)
+void initCondition(RubikCondition& condition);
+void destroyCondition(RubikCondition& condition);
+void waitCondition(RubikCondition& condition, RubikMutex& mutex);
+void signalCondition(RubikCondition& condition);
+void broadcastCondition(RubikCondition& condition);
+
+// Ngủ ít nhất milliseconds mili giây
+void sleepMilliseconds(int milliseconds);
+
+// Phép toán nguyên tử, trả về giá trị sau khi cộng
+int atomicAdd(volatile int* value, int delta);
+
+// So sánh và đổi: ghi desired nếu *value == expected, trả về true nếu đã ghi
+bool atomicCompareExchange(volatile int* value, int expected, int desired);
+
+// Đọc/ghi kèm rào bộ nhớ đầy đủ: mọi ghi trước atomicStore được nhìn thấy bởi
+// luồng đọc được giá trị đó qua atomicLoad
+int atomicLoad(volatile int* value);
+void atomicStore(volatile int* value, int newValue);
+
+// File map vào bộ nhớ chỉ để đọc (mmap / MapViewOfFile)
+bool mapReadOnlyFile(const char* path, MappedFile& file);
+void unmapFile(MappedFile& file);
+
+#endif // RUBIK_THREAD_H
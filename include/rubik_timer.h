@@ -10,12 +10,11 @@ extern SpeedTimer g_timer;
 void resetTimerState();
 void armTimerForSolve();
 void updateTimer();
-void onMoveStarted();
+void onMoveAccepted(bool isScrambleMove);
 void handleScrambleMoveCompletion(bool wasScrambleMove);
 
 // Hiển thị timer
 void displayTimerOverlay();
-void renderBitmapString(float x, float y, void* font, const char* string);
-void formatTimerText(float seconds, char* buffer, int bufferSize);
+void formatTimerText(double seconds, char* buffer, int bufferSize);
 
 #endif // RUBIK_TIMER_H
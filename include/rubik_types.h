@@ -1,6 +1,8 @@
 #ifndef RUBIK_TYPES_H
 #define RUBIK_TYPES_H
 
+#include <string>
+
 // Enum hướng mặt
 enum Face {
     FRONT = 0,  // Đỏ
@@ -25,6 +27,83 @@ struct RubikCube {
     float gapSize;         // Khoảng cách giữa các mảnh
 };
 
+// Dữ liệu per-instance của một mảnh khi vẽ bằng instancing
+struct PieceInstance {
+    float transform[12];          // Ma trận affine 3x4 (theo hàng): xoay animation + dịch chuyển
+    unsigned char colors[6][4];   // Màu 6 mặt dạng RGBA 8-bit (cùng thứ tự với CubePiece::colors)
+};
+
+// Dữ liệu per-instance của một cube ở LOD trung bình (một hộp dán texture sticker)
+struct CubeLodInstance {
+    float transform[12];          // Ma trận affine 3x4 (theo hàng) của cả khối
+    float atlasOrigin[2];         // Góc ô 18x3 texel của cube trong atlas sticker
+};
+
+// Framebuffer của renderer phần mềm (hàng từ trên xuống)
+struct SoftFramebuffer {
+    int width;
+    int height;
+    unsigned char* color;  // RGB 8-bit, width * height * 3
+    float* depth;          // Độ sâu [0, 1] như depth buffer của GL
+};
+
+// Một dòng chữ của overlay: bố cục glyph chỉ được tính lại khi chữ/vị trí đổi
+struct TextLabel {
+    bool visible;
+    bool dirty;                   // Bố cục vừa đổi, cần upload lại lên GPU
+    char text[65];                // TEXT_LABEL_MAX_CHARS + 1
+    float x, y;                   // Vị trí baseline (pixel, gốc dưới trái)
+    float color[3];
+    int glyphCount;
+    float vertices[64 * 16];      // Mỗi glyph 4 đỉnh (x, y, u, v)
+    unsigned int buffer;          // VBO của dòng chữ (0 nếu dùng vertex array phía client)
+};
+
+// Số liệu của một frame trong vòng mẫu của HUD hiệu năng
+struct FrameSample {
+    float frameMs;     // Khoảng cách giữa hai frame liên tiếp
+    float updateMs;    // CPU: các bước mô phỏng trong idle()
+    float renderMs;    // CPU: display() cho tới trước khi swap
+    float swapMs;      // Chờ glutSwapBuffers (GPU/driver/vsync)
+    int drawCalls;
+    int vertices;
+    int queueDepth;    // Số nước đi đang chờ trong hàng đợi
+};
+
+// Thống kê trên toàn bộ vòng mẫu
+struct PerfStats {
+    int sampleCount;
+    float lastFrameMs;
+    float p50FrameMs;
+    float p95FrameMs;
+    float p99FrameMs;
+    float maxFrameMs;
+    float avgUpdateMs;
+    float avgRenderMs;
+    float avgSwapMs;
+    int drawCalls;     // Của frame gần nhất
+    int vertices;
+    int queueDepth;
+    int maxQueueDepth;
+};
+
+// Đường dẫn ảnh đánh số (frame_%04d.png): phần trước số, độ rộng số (%d, %5d, %05d), phần
+// sau số. Tên file được ghép từ ba phần này, đường dẫn của người dùng không bao giờ là chuỗi
+// định dạng
+struct ImagePathPattern {
+    std::string prefix;
+    std::string suffix;
+    int width;
+    bool zeroPad;
+};
+
+// Khuôn SVG của sơ đồ net: hình học cố định theo kích thước ô, chỉ màu thay đổi
+struct NetSVGTemplate {
+    int cellSize;
+    std::string text;              // Toàn bộ <svg>...</svg>, màu sticker để trống "000000"
+    size_t colorOffsets[54];       // Vị trí 6 ký tự hex màu của từng sticker trong text
+};
+
 // Trạng thái animation
 struct RotationAnimation {
     bool isActive;
@@ -35,6 +114,7 @@ struct RotationAnimation {
     float targetAngle;
     float speed;
     float displayAngle;
+    float prevDisplayAngle;   // Góc hiển thị ở bước mô phỏng trước (dùng để nội suy khi vẽ)
     int affectedIndices[9];
 };
 
@@ -47,6 +127,33 @@ struct MoveQueue {
     int head;
 };
 
+// Mốc thời gian của dịch vụ đồng hồ (nano giây, xem rubik_clock.h)
+typedef long long ClockNanos;
+
+// Các mốc của một lần bấm phím xoay mặt, tính từ lúc phím tới keyboard()
+enum LatencyStage {
+    LATENCY_ACCEPT = 0,      // startRotation chấp nhận nước đi
+    LATENCY_ANIM_START,      // Animation của nước đi bắt đầu (chậm hơn nếu phải xếp hàng)
+    LATENCY_FIRST_FRAME,     // Bắt đầu vẽ frame đầu tiên có mặt đang xoay
+    LATENCY_SWAP,            // glutSwapBuffers của frame đó trả về
+    LATENCY_STAGE_COUNT
+};
+
+struct LatencySample {
+    ClockNanos arrivalNanos;                // Đồng hồ thực
+    float stageMs[LATENCY_STAGE_COUNT];
+    int queueDepth;                         // Số nước đứng trước trong hàng đợi lúc chấp nhận
+};
+
+struct LatencyStats {
+    int sampleCount;
+    int droppedCount;                       // Nước bị hủy/kết thúc trước khi kịp hiện lên màn hình
+    float p50Ms[LATENCY_STAGE_COUNT];
+    float p95Ms[LATENCY_STAGE_COUNT];
+    float p99Ms[LATENCY_STAGE_COUNT];
+    float maxMs[LATENCY_STAGE_COUNT];
+};
+
 // Trạng thái timer
 enum TimerState {
     TIMER_IDLE = 0,
@@ -57,12 +164,11 @@ enum TimerState {
 
 struct SpeedTimer {
     TimerState state;
-    float startTime;
-    float endTime;
+    ClockNanos startNanos;   // clockNowNanos() lúc nước giải đầu tiên được chấp nhận
+    double endTime;          // Thời gian giải (giây), khi đã dừng
     int moveCount;
-    float currentTime;
+    double currentTime;      // Thời gian đã trôi (giây), khi đang chạy
     float tps;
-    float lastSampleTime;
 };
 
 // Ánh xạ mặt theo góc nhìn cho xoay động
@@ -75,4 +181,251 @@ struct ViewFaceMapping {
     Face down;
 };
 
+// Kết quả chọn sticker bằng tia chuột
+struct StickerHit {
+    Face face;          // Mặt ngoài chứa sticker
+    int grid[3];        // Toạ độ lưới (-1..1) của mảnh mang sticker
+    float point[3];     // Điểm chạm trên bề mặt khối (toạ độ thế giới)
+    float distance;     // Khoảng cách dọc tia từ camera
+};
+
+// Mức log (số nhỏ hơn = quan trọng hơn)
+enum LogLevel {
+    LOG_ERROR = 0,
+    LOG_WARN,
+    LOG_INFO,
+    LOG_DEBUG,
+    LOG_TRACE       // Mỗi frame / mỗi sự kiện chuột: mặc định tắt
+};
+
+// Nhóm log (bitmask, lọc được khi chạy)
+enum LogCategory {
+    LOG_CAT_GENERAL = 1 << 0,   // Khởi tạo, trạng thái cube, kiểm tra
+    LOG_CAT_MOVE = 1 << 1,      // Nước đi, hàng đợi, animation
+    LOG_CAT_INPUT = 1 << 2,     // Chuột, bàn phím
+    LOG_CAT_RENDER = 1 << 3,    // OpenGL, shader, vẽ frame
+    LOG_CAT_TIMER = 1 << 4,     // Đồng hồ speedcubing
+    LOG_CAT_IO = 1 << 5,        // Lệnh dòng lệnh, ghi file
+    LOG_CAT_ALL = 0xFF
+};
+
+// Bản ghi trace nhị phân kích thước cố định (64 byte), ghi thẳng xuống file và
+// được dựng lại thành chữ bởi --decode-log. Giá trị số nằm trong các ô 4 byte ở
+// đầu payload (int, float, hoặc double chiếm hai ô theo realMask/wideMask), chuỗi
+// (nếu có) nằm ngay sau
+struct TraceRecord {
+    unsigned short eventId;
+    unsigned short realMask;     // Bit i = 1: ô i là số thực
+    unsigned char valueCount;    // Số ô số đã dùng
+    unsigned char textLength;    // Độ dài chuỗi, TRACE_NO_TEXT nếu sự kiện không có chuỗi
+    unsigned short wideMask;     // Bit i = 1: số thực ở ô i là double, chiếm ô i và i + 1
+    ClockNanos timeNanos;        // clockNowNanos() lúc ghi (đồng hồ thật hoặc ảo)
+    unsigned char payload[48];
+};
+
+// Profiler theo vùng: một vùng (zone) đã kết thúc, thời điểm tính bằng tick của readProfileTicks()
+typedef unsigned long long ProfileTicks;
+
+struct ProfileEvent {
+    const char* name;            // Chuỗi hằng, chỉ lưu con trỏ
+    ProfileTicks start;
+    ProfileTicks end;
+};
+
+// Bộ đệm riêng của một luồng: chỉ luồng sở hữu ghi, bộ xuất chỉ đọc [0, count)
+struct ProfileThreadBuffer {
+    ProfileEvent* events;        // PROFILE_EVENTS_PER_THREAD phần tử
+    volatile int count;
+    volatile int dropped;        // Vùng bị bỏ vì bộ đệm đầy
+    int threadId;
+    char threadName[32];
+};
+
+// File ghi phiên (.rrec, xem rubik_record.h). Bố cục cố định, little-endian, đọc
+// thẳng từ vùng nhớ map: [header][checkpoint đầu][luồng sự kiện][bảng checkpoint]
+struct RecordFileHeader {
+    char magic[4];               // "RBRC"
+    unsigned int version;
+    unsigned int checkpointBytes;    // sizeof(RecordCheckpoint), kiểm tra khi đọc
+    unsigned int checkpointMoves;    // Checkpoint sau mỗi N nước...
+    unsigned int checkpointEvents;   // ...hoặc mỗi N sự kiện
+    unsigned int eventCount;
+    unsigned int moveCount;
+    unsigned int checkpointCount;
+    long long streamOffset;      // Vị trí luồng sự kiện trong file
+    long long streamBytes;
+    long long indexOffset;       // Vị trí bảng checkpoint, 0 nếu phiên chưa được đóng
+    ClockNanos durationNanos;    // Mốc của sự kiện cuối
+    long long startUnixTime;     // time(NULL) lúc bắt đầu ghi
+    long long reserved;
+};
+
+// Ảnh chụp trạng thái ngay trước sự kiện tại streamOffset: phát lại từ đây không
+// cần mô phỏng lại từ đầu. Trạng thái được "làm xong" (animation coi như đã chạy hết)
+struct RecordCheckpoint {
+    ClockNanos timeNanos;        // Mốc của sự kiện trước đó (gốc của delta kế tiếp)
+    long long streamOffset;      // Tính từ đầu luồng sự kiện
+    ClockNanos timerStartNanos;  // Tính từ lúc bắt đầu ghi
+    double timerEndTime;
+    int moveIndex;               // Số nước đã ghi trước checkpoint
+    int eventIndex;
+    int timerMoveCount;
+    int scramblePending;         // Nước trộn đã báo trước nhưng chưa được chấp nhận
+    int cameraX;                 // Góc camera đã lượng tử (RECORD_CAMERA_UNIT_DEGREES)
+    int cameraY;
+    unsigned char timerState;
+    unsigned char frontFace;
+    unsigned char facelets[54];  // Màu (chỉ số mặt) 9 sticker của từng mặt, theo getFaceIndices
+};
+
+// Loại sự kiện trong luồng của file phiên: 3 bit cao của byte tag. Sau tag luôn là delta
+// thời gian (varint, RECORD_TIME_UNIT_NANOS) so với sự kiện trước, rồi tới dữ liệu riêng của loại
+enum RecordEventType {
+    RECORD_MOVE = 0,      // bit 0-2: mặt, bit 3: ngược chiều, bit 4: nước trộn
+    RECORD_CAMERA = 1,    // bit 0-2: mặt trước; dữ liệu: delta góc X, Y (zigzag varint)
+    RECORD_SCRAMBLE = 2,  // dữ liệu: số nước trộn sắp tới (varint)
+    RECORD_RESET = 3
+};
+
+// Một sự kiện đã giải mã (giá trị camera là tuyệt đối)
+struct RecordEvent {
+    int type;
+    ClockNanos timeNanos;
+    int face;
+    bool clockwise;
+    bool isScrambleMove;
+    int count;
+    int cameraX;
+    int cameraY;
+};
+
+// Vị trí trong luồng sự kiện cùng các giá trị mà delta kế tiếp dựa vào
+struct RecordCursor {
+    long long offset;
+    ClockNanos timeNanos;
+    int cameraX;
+    int cameraY;
+    int moveIndex;
+    int eventIndex;
+};
+
+// File được map vào bộ nhớ chỉ để đọc
+struct MappedFile {
+    const unsigned char* data;
+    long long size;
+    void* fileHandle;            // Win32: HANDLE của file và của mapping
+    void* mappingHandle;
+};
+
+// Đọc tuần tự một file phiên (xem openRecordStream), không đụng tới trạng thái ứng dụng
+struct RecordStream {
+    MappedFile file;
+    const unsigned char* events;
+    long long eventBytes;
+    const RecordCheckpoint* initial;  // Checkpoint đầu: trạng thái lúc bắt đầu ghi
+    RecordCursor cursor;
+};
+
+// File lịch sử lần giải: [header][SolveRecord...]. Bản ghi chỉ được nối thêm; header
+// giữ thống kê đã gộp tới bản ghi thứ solveCount và được ghi đè sau mỗi lần giải
+struct SolveDbHeader {
+    char magic[4];               // "RBSD"
+    unsigned int version;
+    unsigned int recordBytes;    // sizeof(SolveRecord), kiểm tra khi đọc
+    unsigned int averageCount;   // SOLVE_AVERAGE_COUNT lúc ghi
+    long long solveCount;
+    long long totalMillis;
+    unsigned int bestMillis;
+    unsigned int reserved;
+    double bestAverageMillis[4]; // Tốt nhất của ao5/ao12/ao100/ao1000, 0 nếu chưa đủ lần giải
+};
+
+struct SolveRecord {
+    long long finishedUnixTime;
+    unsigned int timeMillis;
+    unsigned short moveCount;
+    unsigned short flags;        // Dự phòng (+2/DNF)
+};
+
+// Mã nước đi của engine: mặt * 3 + (số quarter turn xuôi chiều - 1), 0..17
+// (F F2 F' B B2 B' ...). Mọi ký hiệu (slice, wide, xoay cả khối) được quy về 18 mã này
+typedef unsigned char MoveCode;
+
+// Vị trí lỗi khi đọc ký hiệu nước đi; line/column tính từ 1 (column theo byte)
+struct NotationError {
+    long long offset;            // Tính từ đầu đoạn văn bản
+    int line;
+    int column;
+    const char* message;
+};
+
+// Thống kê hiện tại (giây); < 0 nếu chưa đủ lần giải
+struct SolveStats {
+    long long solveCount;
+    double lastSeconds;
+    double bestSeconds;
+    double meanSeconds;
+    double currentAverage[4];    // Theo SOLVE_AVERAGE_SIZES
+    double bestAverage[4];
+};
+
+// Trạng thái dạng cubie (quy ước Kociemba): vị trí góc URF UFL ULB UBR DFR DLF DBL DRB,
+// vị trí cạnh UR UF UL UB DR DF DL DB FR FL BL BR; perm[i] = mảnh đang nằm ở vị trí i
+struct CubieState {
+    unsigned char cornerPerm[8];
+    unsigned char cornerTwist[8];  // 0..2: sticker U/D của mảnh nằm ở sticker thứ mấy của vị trí
+    unsigned char edgePerm[12];
+    unsigned char edgeFlip[12];    // 0..1
+};
+
+// Dạng nhị phân 16 byte để trao đổi trạng thái (bố cục trong rubik_statecodec.h)
+struct PackedCubeState {
+    unsigned char bytes[16];
+};
+
+enum CubeStateError {
+    CUBE_STATE_OK = 0,
+    CUBE_STATE_BAD_LENGTH,
+    CUBE_STATE_BAD_LETTER,
+    CUBE_STATE_BAD_CENTER,
+    CUBE_STATE_BAD_PIECE,        // Tổ hợp màu không tồn tại hoặc hai vị trí cùng một mảnh
+    CUBE_STATE_TWIST,            // Tổng hướng góc không chia hết cho 3
+    CUBE_STATE_FLIP,             // Tổng hướng cạnh lẻ
+    CUBE_STATE_PARITY,           // Hoán vị góc và cạnh khác tính chẵn lẻ
+    CUBE_STATE_BAD_PACKED        // Giá trị ngoài miền, sai phiên bản hoặc byte dự trữ khác 0
+};
+
+// Các mốc của một lần giải CFOP: cross, cặp F2L thứ 1..4, OLL, PLL
+enum CfopStage {
+    CFOP_CROSS = 0,
+    CFOP_PAIR_1,
+    CFOP_PAIR_2,
+    CFOP_PAIR_3,
+    CFOP_PAIR_4,
+    CFOP_OLL,
+    CFOP_PLL,
+    CFOP_STAGE_COUNT
+};
+
+// Bộ dò giai đoạn CFOP theo luồng nước đi (rubik_cfop.h); theo dõi song song cả 6 mặt
+// cross, mặt nào được dùng chỉ quyết định khi lấy kết quả
+struct CfopTracker {
+    unsigned char facelets[54];  // Chỉ số mặt URFDLB của màu từng sticker (rubik_statecodec.h)
+    unsigned int solvedMask;     // Bit p: mảnh p (thứ tự CubieState) đúng chỗ và đúng hướng
+    ClockNanos startNanos;
+    int moveCount;
+    int nextStage[6];            // Theo mặt cross, thứ tự URFDLB
+    int stageMoves[6][CFOP_STAGE_COUNT];
+    ClockNanos stageNanos[6][CFOP_STAGE_COUNT];
+};
+
+// Mốc hoàn thành từng giai đoạn của một lần giải, tính từ nước đầu tiên (nước đầu ở mốc 0)
+struct CfopSplits {
+    int crossFace;               // enum Face
+    int moveCount;
+    ClockNanos totalNanos;
+    int stageMoves[CFOP_STAGE_COUNT];         // Số nước đã làm khi giai đoạn xong (lũy kế)
+    ClockNanos stageNanos[CFOP_STAGE_COUNT];  // Thời điểm của nước làm xong giai đoạn
+};
+
 #endif // RUBIK_TYPES_H
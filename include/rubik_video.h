@@ -0,0 +1,16 @@
+#ifndef RUBIK_VIDEO_H
+#define RUBIK_VIDEO_H
+
+// Xuất video lời giải không cần cửa sổ: chuỗi nước đi được phát lại bằng mô
+// phỏng bước cố định (stepSimulation/updateAnimation) và vẽ bằng renderer phần
+// mềm (cùng cảnh với display()). Ba giai đoạn chạy trên ba luồng, nối bằng
+// hàng đợi có giới hạn: vẽ frame -> đổi RGB sang YUV 4:2:0 -> ghi file.
+// Khi luồng ghi chậm, hàng đợi đầy chặn giai đoạn trước thay vì ăn hết bộ nhớ.
+
+// Chế độ dòng lệnh: --export-video out.(y4m|yuv) [--moves "R U R'"] [--moves-file f]
+//                   [--setup "..."] [--scramble N] [--seed N] [--size WxH] [--fps N]
+//                   [--threads N] [--angles X,Y] [--hold S]
+bool isVideoExportRequested(int argc, char** argv);
+int runVideoExportCommand(int argc, char** argv);
+
+#endif // RUBIK_VIDEO_H
@@ -0,0 +1,35 @@
+#ifndef RUBIK_WALL_H
+#define RUBIK_WALL_H
+
+#include "rubik_types.h"
+
+// Chế độ tường nhiều cube (trưng bày): hàng trăm tới hàng nghìn cube độc lập,
+// mỗi cube tự phát lại lời giải của mình. Trạng thái được giữ trong các mảng
+// liền nhau (màu sticker nằm sẵn trong dữ liệu instance), animation của mọi cube
+// được cập nhật trong một vòng lặp, các cube ngoài frustum bị loại trước khi vẽ
+// và phần còn lại vẽ bằng instancing. Mức chi tiết chọn theo kích thước cube trên
+// màn hình: đủ 26 mảnh khi ở gần, một hộp dán atlas sticker ở xa, một hộp 6 màu
+// khi cube chỉ còn vài pixel.
+
+// Dòng lệnh: --wall [N] (mặc định WALL_DEFAULT_CUBES), trả về 0 nếu không yêu cầu
+int parseCubeWallCount(int argc, char** argv);
+
+// Khởi tạo N cube với kịch bản ngẫu nhiên từ seed (sau initRubikCube: dùng cube đã giải làm mẫu)
+void initCubeWall(int cubeCount, unsigned int seed);
+bool isCubeWallActive();
+
+// Tiến animation của mọi cube một bước mô phỏng (gọi từ stepSimulation)
+void updateCubeWall(float stepSeconds);
+
+// Thiết lập camera riêng của tường, chọn LOD và vẽ các cube nhìn thấy
+void drawCubeWall();
+
+// Phóng to (factor < 1) hoặc thu nhỏ (factor > 1) khoảng cách camera
+void zoomCubeWall(float factor);
+
+// Số liệu cho overlay
+int getCubeWallCount();
+int getCubeWallVisibleCount();
+void getCubeWallLodCounts(int counts[3]);  // Đủ mảnh / hộp dán atlas / hộp 6 màu
+
+#endif // RUBIK_WALL_H
@@ -9,15 +9,22 @@
  * - Điều khiển xoay mặt (phím F/U/R/L/D/B)
  * - Tính năng timer và speedsolving
  * - Chức năng trộn tự động
+ * - Render phần mềm đa luồng không cần GPU (--soft-render)
+ * - Xuất hàng loạt sơ đồ net 2D dạng SVG/PPM (--net-batch)
+ * - Tường nhiều cube cho trưng bày (--wall N)
+ * - Giải mã nhật ký trace nhị phân (--decode-log)
+ * - Nhập/xuất trạng thái cube dạng facelet hoặc nhị phân 16 byte (--state, --state-convert, F6)
+ * - Split CFOP (cross, F2L, OLL, PLL) của các lần giải trong file phiên (--cfop-splits)
+ * - Đo độ trễ phím -> màn hình qua từng mốc, histogram CSV (F7)
  * 
  * Biên dịch (Windows/MinGW - PowerShell):
- * g++ -std=c++98 -Wall -Wextra -O2 src\main.cpp src\rubik_state.cpp src\rubik_rotation.cpp src\rubik_animation.cpp src\rubik_timer.cpp src\rubik_input.cpp src\rubik_render.cpp -Iinclude -I"C:\mingw64\include" -L"C:\mingw64\lib" -lfreeglut -lopengl32 -lglu32 -o build\rubik.exe
+ * g++ -std=c++98 -Wall -Wextra -O2 src\main.cpp src\rubik_state.cpp src\rubik_rotation.cpp src\rubik_animation.cpp src\rubik_timer.cpp src\rubik_input.cpp src\rubik_render.cpp src\rubik_scheduler.cpp src\rubik_glext.cpp src\rubik_instanced.cpp src\rubik_thread.cpp src\rubik_image.cpp src\rubik_softraster.cpp src\rubik_net.cpp src\rubik_text.cpp src\rubik_perf.cpp src\rubik_wall.cpp src\rubik_picking.cpp src\rubik_video.cpp src\rubik_log.cpp src\rubik_profiler.cpp src\rubik_clock.cpp src\rubik_simulate.cpp src\rubik_record.cpp src\rubik_solvedb.cpp src\rubik_notation.cpp src\rubik_statecodec.cpp src\rubik_cfop.cpp -Iinclude -I"C:\mingw64\include" -L"C:\mingw64\lib" -lfreeglut -lopengl32 -lglu32 -lwinmm -o build\rubik.exe
  * 
  * Hoặc dùng build.bat:
  * build.bat
  * 
  * Biên dịch (Linux):
- * g++ -std=c++98 -Wall -Wextra -O2 src/main.cpp src/rubik_state.cpp src/rubik_rotation.cpp src/rubik_animation.cpp src/rubik_timer.cpp src/rubik_input.cpp src/rubik_render.cpp -Iinclude -lglut -lGLU -lGL -lm -o build/rubik
+ * g++ -std=c++98 -Wall -Wextra -O2 src/main.cpp src/rubik_state.cpp src/rubik_rotation.cpp src/rubik_animation.cpp src/rubik_timer.cpp src/rubik_input.cpp src/rubik_render.cpp src/rubik_scheduler.cpp src/rubik_glext.cpp src/rubik_instanced.cpp src/rubik_thread.cpp src/rubik_image.cpp src/rubik_softraster.cpp src/rubik_net.cpp src/rubik_text.cpp src/rubik_perf.cpp src/rubik_wall.cpp src/rubik_picking.cpp src/rubik_video.cpp src/rubik_log.cpp src/rubik_profiler.cpp src/rubik_clock.cpp src/rubik_simulate.cpp src/rubik_record.cpp src/rubik_solvedb.cpp src/rubik_notation.cpp src/rubik_statecodec.cpp src/rubik_cfop.cpp -Iinclude -lglut -lGLU -lGL -lpthread -lm -o build/rubik
  * 
  * Điều khiển:
  * - Kéo chuột: Xoay góc nhìn camera
@@ -30,6 +37,7 @@
 
 #include <GL/glut.h>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <iostream>
 
@@ -42,14 +50,98 @@
 #include "rubik_timer.h"
 #include "rubik_input.h"
 #include "rubik_render.h"
+#include "rubik_scheduler.h"
+#include "rubik_softraster.h"
+#include "rubik_net.h"
+#include "rubik_wall.h"
+#include "rubik_video.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
+#include "rubik_clock.h"
+#include "rubik_simulate.h"
+#include "rubik_record.h"
+#include "rubik_solvedb.h"
+#include "rubik_notation.h"
+#include "rubik_statecodec.h"
+#include "rubik_cfop.h"
 
 /**
  * Hàm chính (entry point) của chương trình.
  * Nơi khởi tạo cửa sổ, thiết lập OpenGL và bắt đầu vòng lặp sự kiện.
  */
 int main(int argc, char** argv) {
+    // Giải mã file trace (--decode-log): chạy trước initLogFile để không ghi đè file đang đọc
+    if (isLogDecodeRequested(argc, argv)) {
+        return runLogDecodeCommand(argc, argv);
+    }
+    
     // 1. Khởi tạo hệ thống ghi nhật ký (logging) để debug lỗi
     initLogFile(); // Mở file log và ghi thời gian bắt đầu
+    initProfiler(); // F5 hoặc RUBIK_PROFILE=out.json để ghi Chrome trace
+    
+    // Chế độ render phần mềm (--soft-render): không tạo cửa sổ, không cần GPU
+    // Phải xử lý trước glutInit vì máy không có màn hình sẽ không mở được display
+    if (isSoftRenderRequested(argc, argv)) {
+        int exitCode = runSoftRenderCommand(argc, argv);
+        closeLogFile();
+        return exitCode;
+    }
+    
+    // Chế độ batch sơ đồ net 2D (--net-batch): SVG/PPM cho tờ trộn và thumbnail
+    if (isNetBatchRequested(argc, argv)) {
+        int exitCode = runNetBatchCommand(argc, argv);
+        closeLogFile();
+        return exitCode;
+    }
+    
+    // Chế độ xuất video lời giải (--export-video): Y4M/YUV thô, không cần cửa sổ
+    if (isVideoExportRequested(argc, argv)) {
+        int exitCode = runVideoExportCommand(argc, argv);
+        closeLogFile();
+        return exitCode;
+    }
+    
+    // Thông tin và đo seek của file phiên đã ghi (--record-info)
+    if (isRecordInfoRequested(argc, argv)) {
+        int exitCode = runRecordInfoCommand(argc, argv);
+        closeLogFile();
+        return exitCode;
+    }
+    
+    // Kiểm tra/chuyển đổi file ký hiệu nước đi hàng loạt (--parse-moves)
+    if (isParseMovesRequested(argc, argv)) {
+        int exitCode = runParseMovesCommand(argc, argv);
+        closeLogFile();
+        return exitCode;
+    }
+    
+    // Kiểm tra/chuyển đổi trạng thái cube hàng loạt giữa facelet và nhị phân 16 byte (--state-convert)
+    if (isStateConvertRequested(argc, argv)) {
+        int exitCode = runStateConvertCommand(argc, argv);
+        closeLogFile();
+        return exitCode;
+    }
+    
+    // Split CFOP của các lần giải trong file phiên (--cfop-splits)
+    if (isCfopSplitsRequested(argc, argv)) {
+        int exitCode = runCfopSplitsCommand(argc, argv);
+        closeLogFile();
+        return exitCode;
+    }
+    
+    // Thống kê lịch sử giải (--solve-stats)
+    if (isSolveStatsRequested(argc, argv)) {
+        int exitCode = runSolveStatsCommand(argc, argv);
+        closeLogFile();
+        return exitCode;
+    }
+    
+    // Mô phỏng không cửa sổ theo đồng hồ ảo (--simulate): chạy kịch bản nhanh hết mức CPU
+    if (isSimulationRequested(argc, argv)) {
+        int exitCode = runSimulationCommand(argc, argv);
+        closeLogFile();
+        return exitCode;
+    }
     
     // 2. Khởi tạo thư viện GLUT (OpenGL Utility Toolkit)
     // GLUT giúp quản lý cửa sổ và sự kiện đầu vào một cách dễ dàng
@@ -95,6 +187,37 @@ int main(int argc, char** argv) {
     // Dùng thời gian hiện tại làm seed để mỗi lần chạy có chuỗi trộn (shuffle) khác nhau
     srand((unsigned int)time(NULL));
     
+    // Chế độ tường nhiều cube (--wall N): mỗi cube tự phát lại lời giải của mình
+    int wallCubes = parseCubeWallCount(argc, argv);
+    if (wallCubes > 0) {
+        initCubeWall(wallCubes, (unsigned int)rand());
+    }
+    
+    // Phát lại phiên đã ghi (--replay file.rrec [--speed X]); ngoài ra mọi phiên đều được ghi
+    const char* replayPath = NULL;
+    float replaySpeed = 1.0f;
+    if (parseReplayOptions(argc, argv, replayPath, replaySpeed)) {
+        if (!startReplay(replayPath, replaySpeed)) {
+            std::cerr << "Không mở được file phiên: " << replayPath << std::endl;
+            closeLogFile();
+            return 1;
+        }
+    } else if (wallCubes == 0) {
+        // Trạng thái ban đầu tùy chọn (--state FACELETS|HEX): nạp trước để checkpoint đầu của phiên ghi giữ nó
+        const char* stateText = parseStateOption(argc, argv);
+        if (stateText != NULL) {
+            CubeStateError stateError = importCubeState(stateText, (int)strlen(stateText));
+            if (stateError != CUBE_STATE_OK) {
+                std::cerr << "Trạng thái không hợp lệ (" << getCubeStateErrorMessage(stateError) << "): "
+                          << stateText << std::endl;
+                closeLogFile();
+                return 1;
+            }
+        }
+        initSessionRecording();
+        initSolveDatabase();
+    }
+    
     // 10. Đăng ký các hàm Callback cho GLUT
     // Callback là các hàm sẽ được GLUT gọi tự động khi có sự kiện tương ứng
     
@@ -105,21 +228,24 @@ int main(int argc, char** argv) {
     glutKeyboardFunc(keyboard);     // Gọi khi nhấn phím ký tự thường (trong rubik_input.cpp)
     glutKeyboardUpFunc(keyboardUp); // Gọi khi nhả phím (trong rubik_input.cpp)
     glutSpecialFunc(keyboardSpecial); // Gọi khi nhấn phím đặc biệt (mũi tên, F1-F12...)
-    glutIdleFunc(idle);             // Gọi liên tục khi chương trình rảnh (dùng cho animation)
+    
+    // Idle callback (animation) chỉ được đăng ký khi cần, do bộ lập lịch frame quản lý
+    // Khi không có gì thay đổi, chương trình ngủ hoàn toàn thay vì chiếm 100% một lõi CPU
+    initFrameScheduler(TARGET_FRAME_RATE);
+    if (isCubeWallActive() || isReplayActive()) {
+        wakeScheduler();
+    }
     
     // Ngăn chặn việc lặp lại phím khi giữ (chỉ nhận sự kiện nhấn xuống một lần)
     // Giúp việc xoay Rubik không bị quá nhanh hoặc mất kiểm soát
     glutIgnoreKeyRepeat(1);
     
-    // Lấy thời gian hiện tại của hệ thống (tính bằng mili giây)
+    // Lấy mốc thời gian hiện tại từ đồng hồ chung (nano giây)
     // Dùng để tính delta time cho animation mượt mà
-    g_lastTimeMs = glutGet(GLUT_ELAPSED_TIME);
+    g_lastFrameNanos = clockNowNanos();
     
     // Ghi log xác nhận khởi tạo thành công
-    if (g_logFile != NULL) {
-        fprintf(g_logFile, "Ứng dụng khởi tạo thành công\n\n");
-        fflush(g_logFile); // Đẩy dữ liệu từ bộ đệm xuống file ngay lập tức
-    }
+    RUBIK_LOG(EVT_APP_READY);
     
     // In hướng dẫn sử dụng ra màn hình Console
     std::cout << "=== Mô phỏng Rubik's Cube ===" << std::endl;
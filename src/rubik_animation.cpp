@@ -3,7 +3,13 @@
 #include "rubik_rotation.h"
 #include "rubik_timer.h"
 #include "rubik_constants.h"
-#include <GL/glut.h>
+#include "rubik_scheduler.h"
+#include "rubik_perf.h"
+#include "rubik_wall.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
+#include "rubik_clock.h"
+#include "rubik_record.h"
 #include <cstdio>
 
 // Trạng thái animation hiện tại
@@ -15,6 +21,7 @@
 // targetAngle: Góc mục tiêu (thường là 90 độ)
 // speed: Tốc độ xoay (độ/giây)
 // displayAngle: Góc hiển thị sau khi áp dụng easing
+// prevDisplayAngle: Góc hiển thị ở bước mô phỏng trước
 // affectedIndices: Chỉ số của 9 mảnh đang xoay
 RotationAnimation g_animation = {
     false,
@@ -25,14 +32,15 @@ RotationAnimation g_animation = {
     90.0f,
     ROTATION_SPEED_DEG_PER_SEC,
     0.0f,
+    0.0f,
     {-1, -1, -1, -1, -1, -1, -1, -1, -1}
 };
 
 // Hàng đợi các nước đi chờ thực hiện
 MoveQueue g_moveQueue = {{0}, {false}, {false}, 0, 0};
 
-// Thời gian frame trước (đơn vị: milliseconds)
-int g_lastTimeMs = 0;
+// Mốc đồng hồ của lần idle trước (nano giây), -1 khi cần đặt lại
+ClockNanos g_lastFrameNanos = -1;
 
 // Trạng thái phím đang được giữ
 bool g_keyHeld[256] = {false};
@@ -40,6 +48,11 @@ bool g_keyHeld[256] = {false};
 // Số nước trộn còn lại đang chờ
 int g_scrambleMovesPending = 0;
 
+// Thời gian mô phỏng và phần dư chưa mô phỏng của frame
+ClockNanos g_simTimeNanos = 0;
+ClockNanos g_simAccumulatorNanos = 0;
+float g_renderAlpha = 0.0f;
+
 // Hàm easing cubic - Tạo hiệu ứng chuyển động mượt mà
 // Đầu vào: t trong khoảng [0, 1] (0 = bắt đầu, 1 = kết thúc)
 // Đầu ra: Giá trị đã được easing trong [0, 1]
@@ -90,6 +103,7 @@ void cancelAnimationAndQueue() {
     g_animation.isScrambleMove = false;
     g_animation.currentAngle = 0.0f;
     g_animation.displayAngle = 0.0f;
+    g_animation.prevDisplayAngle = 0.0f;
     
     // Xóa danh sách 9 mảnh bị ảnh hưởng
     for (int i = 0; i < 9; i++) {
@@ -97,6 +111,7 @@ void cancelAnimationAndQueue() {
     }
     
     // Xóa hàng đợi chờ
+    perfMovesCancelled();
     g_moveQueue.count = 0;
     g_moveQueue.head = 0;
     for (int i = 0; i < MOVE_QUEUE_CAPACITY; i++) {
@@ -137,8 +152,31 @@ bool dequeueQueuedMove(Face& face, bool& clockwise, bool& isScrambleMove) {
     return true;
 }
 
-// Bắt đầu một animation xoay mặt
-// Nếu đang có animation khác chạy, sẽ thêm vào hàng đợi
+// Bắt đầu animation cho một nước đi đã được chấp nhận
+// Trạng thái logic (g_rubikCube) đã được cập nhật từ trước, animation chỉ đưa
+// trạng thái hiển thị (g_visualCube) đuổi theo
+static void beginVisualRotation(Face face, bool clockwise, bool isScrambleMove) {
+    g_animation.isActive = true;
+    g_animation.face = face;
+    g_animation.clockwise = clockwise;
+    g_animation.isScrambleMove = isScrambleMove;
+    g_animation.currentAngle = 0.0f;      // Bắt đầu từ 0 độ
+    g_animation.displayAngle = 0.0f;
+    g_animation.prevDisplayAngle = 0.0f;
+    g_animation.targetAngle = 90.0f;      // Mục tiêu 90 độ
+    g_animation.speed = ROTATION_SPEED_DEG_PER_SEC;
+    
+    // Lấy danh sách 9 mảnh thuộc mặt này
+    getFaceIndices(face, g_animation.affectedIndices);
+    RUBIK_LOG(EVT_ANIM_START) << face << clockwise << g_moveQueue.count;
+    perfAnimationStarted();
+    wakeScheduler();
+    requestRedisplay();
+}
+
+// Chấp nhận một nước đi xoay mặt
+// Trạng thái logic được cập nhật ngay (timer, kiểm tra solved không phải chờ animation),
+// còn animation được bắt đầu ngay hoặc thêm vào hàng đợi nếu đang có animation khác chạy
 // Tham số:
 //   face: Mặt cần xoay (FRONT, BACK, LEFT, RIGHT, UP, DOWN)
 //   clockwise: true = xuôi chiều kim đồng hồ, false = ngược chiều
@@ -149,71 +187,42 @@ void startRotation(Face face, bool clockwise, bool isScrambleMove) {
         return;
     }
     
-    // Nếu đang có animation chạy, thêm vào hàng đợi
-    if (g_animation.isActive) {
-        // Hàng đợi đầy, bỏ qua nước đi này
-        if (g_moveQueue.count >= MOVE_QUEUE_CAPACITY) {
-            if (g_logFile != NULL) {
-                const char* faceNames[] = {"FRONT", "BACK", "LEFT", "RIGHT", "UP", "DOWN"};
-                double tsMs = getLogTimestampMs();
-                fprintf(g_logFile, "[%010.3f ms] QUEUE FULL: drop %s %s\n",
-                        tsMs,
-                        faceNames[face],
-                        clockwise ? "CW" : "CCW");
-                fflush(g_logFile);
-            }
-        } else {
-            // Thêm vào cuối hàng đợi
-            int idx = (g_moveQueue.head + g_moveQueue.count) % MOVE_QUEUE_CAPACITY;
-            g_moveQueue.moves[idx] = static_cast<int>(face);
-            g_moveQueue.dirs[idx] = clockwise;
-            g_moveQueue.scrambleFlags[idx] = isScrambleMove;
-            g_moveQueue.count++;
-            if (g_logFile != NULL) {
-                const char* faceNames[] = {"FRONT", "BACK", "LEFT", "RIGHT", "UP", "DOWN"};
-                double tsMs = getLogTimestampMs();
-                fprintf(g_logFile, "[%010.3f ms] ANIM QUEUED %s %s | queue=%d\n",
-                        tsMs,
-                        faceNames[face],
-                        clockwise ? "CW" : "CCW",
-                        g_moveQueue.count);
-                fflush(g_logFile);
-            }
-        }
+    // Hàng đợi đầy, bỏ qua nước đi này (cả trạng thái logic lẫn hiển thị)
+    if (g_animation.isActive && g_moveQueue.count >= MOVE_QUEUE_CAPACITY) {
+        RUBIK_LOG(EVT_QUEUE_FULL) << face << clockwise;
         return;
     }
     
-    // Bắt đầu animation mới
-    onMoveStarted();  // Thông báo cho timer (nếu đang chạy)
+    // Ghi phiên trước khi trạng thái đổi (checkpoint là trạng thái trước nước đi)
+    recordMoveAccepted(face, clockwise, isScrambleMove);
     
-    g_animation.isActive = true;
-    g_animation.face = face;
-    g_animation.clockwise = clockwise;
-    g_animation.isScrambleMove = isScrambleMove;
-    g_animation.currentAngle = 0.0f;      // Bắt đầu từ 0 độ
-    g_animation.displayAngle = 0.0f;
-    g_animation.targetAngle = 90.0f;      // Mục tiêu 90 độ
-    g_animation.speed = ROTATION_SPEED_DEG_PER_SEC;
+    perfMoveAccepted(isScrambleMove);  // Mốc độ trễ phím (nước trộn không đo)
     
-    // Lấy danh sách 9 mảnh thuộc mặt này
-    getFaceIndices(face, g_animation.affectedIndices);
-    if (g_logFile != NULL) {
-        const char* faceNames[] = {"FRONT", "BACK", "LEFT", "RIGHT", "UP", "DOWN"};
-        double tsMs = getLogTimestampMs();
-        fprintf(g_logFile, "[%010.3f ms] ANIM START %s %s | queue=%d\n",
-                tsMs,
-                faceNames[face],
-                clockwise ? "CW" : "CCW",
-                g_moveQueue.count);
-        fflush(g_logFile);
+    // Cập nhật trạng thái logic ngay khi nước đi được chấp nhận
+    rotateFace(face, clockwise);
+    onMoveAccepted(isScrambleMove);  // Thông báo cho timer (bắt đầu/đếm/dừng)
+    
+    // Nếu đang có animation chạy, thêm vào hàng đợi
+    if (g_animation.isActive) {
+        // Thêm vào cuối hàng đợi
+        int idx = (g_moveQueue.head + g_moveQueue.count) % MOVE_QUEUE_CAPACITY;
+        g_moveQueue.moves[idx] = static_cast<int>(face);
+        g_moveQueue.dirs[idx] = clockwise;
+        g_moveQueue.scrambleFlags[idx] = isScrambleMove;
+        g_moveQueue.count++;
+        RUBIK_LOG(EVT_ANIM_QUEUED) << face << clockwise << g_moveQueue.count;
+        return;
     }
-    glutPostRedisplay();
+    
+    // Bắt đầu animation mới
+    beginVisualRotation(face, clockwise, isScrambleMove);
 }
 
-// Cập nhật animation mỗi frame
+// Cập nhật animation mỗi bước mô phỏng
 // Tham số:
-//   deltaTime: Thời gian trôi qua kể từ frame trước (đơn vị: giây)
+//   deltaTime: Thời gian trôi qua kể từ bước trước (đơn vị: giây)
 void updateAnimation(float deltaTime) {
+    PROFILE_ZONE("updateAnimation");
     // Không có animation nào đang chạy
     if (!g_animation.isActive) {
         return;
@@ -245,29 +254,24 @@ void updateAnimation(float deltaTime) {
         bool finishedDir = g_animation.clockwise;
         bool finishedWasScramble = g_animation.isScrambleMove;
         
-        // Thực hiện xoay logic (cập nhật màu sắc của các mảnh)
-        rotateFace(finishedFace, finishedDir);
+        // Trạng thái hiển thị bắt kịp nước đi (trạng thái logic đã xoay từ lúc chấp nhận)
+        rotatePositions(g_visualCube, finishedFace, finishedDir);
+        markVisualCubeChanged();
         
         // Reset trạng thái animation
         g_animation.isActive = false;
         g_animation.isScrambleMove = false;
         g_animation.currentAngle = 0.0f;
         g_animation.displayAngle = 0.0f;
+        g_animation.prevDisplayAngle = 0.0f;
         
         // Xóa danh sách mảnh bị ảnh hưởng
         for (int i = 0; i < 9; i++) {
             g_animation.affectedIndices[i] = -1;
         }
-        if (g_logFile != NULL) {
-            const char* faceNames[] = {"FRONT", "BACK", "LEFT", "RIGHT", "UP", "DOWN"};
-            double tsMs = getLogTimestampMs();
-            fprintf(g_logFile, "[%010.3f ms] ANIM END %s %s | queue=%d\n",
-                    tsMs,
-                    faceNames[finishedFace],
-                    finishedDir ? "CW" : "CCW",
-                    g_moveQueue.count);
-            fflush(g_logFile);
-        }
+        RUBIK_LOG(EVT_ANIM_END) << finishedFace << finishedDir << g_moveQueue.count
+                                << clockNanosToSeconds(g_simTimeNanos);
+        perfAnimationFinished();
         // Xử lý hoàn thành nước trộn (nếu có)
         handleScrambleMoveCompletion(finishedWasScramble);
         
@@ -277,39 +281,84 @@ void updateAnimation(float deltaTime) {
         bool nextIsScramble = false;
         if (dequeueQueuedMove(nextFace, nextDir, nextIsScramble)) {
             // Bắt đầu animation tiếp theo
-            startRotation(nextFace, nextDir, nextIsScramble);
+            beginVisualRotation(nextFace, nextDir, nextIsScramble);
         }
     }
     
     // Yêu cầu vẽ lại màn hình
-    glutPostRedisplay();
+    requestRedisplay();
+}
+
+// Tiến mô phỏng đúng một bước cố định
+// Animation, hàng đợi và timer chỉ thay đổi ở đây nên kết quả không phụ thuộc tốc độ frame
+void stepSimulation() {
+    PROFILE_ZONE("stepSimulation");
+    g_animation.prevDisplayAngle = g_animation.displayAngle;
+    g_simTimeNanos += SIMULATION_STEP_NANOS;
+    updateAnimation(SIMULATION_STEP);
+    updateTimer();
+    if (isCubeWallActive()) {
+        updateCubeWall(SIMULATION_STEP);
+    }
 }
 
-// Hàm callback idle - được gọi liên tục khi chương trình rảnh
-// Dùng để cập nhật animation và timer
+// Góc hiển thị nội suy giữa bước mô phỏng trước và bước hiện tại
+float getInterpolatedDisplayAngle() {
+    if (!g_animation.isActive) {
+        return 0.0f;
+    }
+    return g_animation.prevDisplayAngle +
+           (g_animation.displayAngle - g_animation.prevDisplayAngle) * g_renderAlpha;
+}
+
+// Cập nhật mỗi frame - được timer của scheduler gọi khi có animation/timer đang chạy
+// Đổi thời gian thực thành các bước mô phỏng cố định, phần dư dùng để nội suy khi vẽ
 void idle() {
-    // Lấy thời gian hiện tại (milliseconds kể từ khi chương trình bắt đầu)
-    int currentTime = glutGet(GLUT_ELAPSED_TIME);
+    // Đặt mốc frame kế tiếp (không chờ); scheduler tự dừng nhịp khi không còn việc
+    if (!scheduleNextFrame()) {
+        return;
+    }
     
-    // Khởi tạo lần đầu
-    if (g_lastTimeMs == 0) {
-        g_lastTimeMs = currentTime;
+    // Phát lại phiên: đẩy đồng hồ ảo và nạp các sự kiện tới hạn trước khi mô phỏng
+    if (isReplayActive()) {
+        updateReplay();
     }
     
-    // Tính thời gian giữa 2 frame (chuyển sang giây)
-    float deltaTime = (float)(currentTime - g_lastTimeMs) / 1000.0f;
+    // Lấy thời gian hiện tại từ đồng hồ chung (nano giây, đơn điệu)
+    ClockNanos currentTime = clockNowNanos();
     
-    // Giới hạn deltaTime để tránh nhảy frame quá lớn
-    if (deltaTime > 0.1f) {
-        deltaTime = 0.1f;  // Tối đa 100ms
-    } else if (deltaTime < 0.0f) {
-        deltaTime = 0.0f;
+    // Khởi tạo lần đầu (hoặc sau khi scheduler vừa thức dậy)
+    if (g_lastFrameNanos < 0) {
+        g_lastFrameNanos = currentTime;
+        g_simAccumulatorNanos = 0;
+    }
+    
+    // Thời gian giữa 2 frame
+    ClockNanos deltaTime = currentTime - g_lastFrameNanos;
+    if (deltaTime < 0) {
+        deltaTime = 0;
     }
     
     // Lưu thời gian hiện tại cho frame tiếp theo
-    g_lastTimeMs = currentTime;
+    g_lastFrameNanos = currentTime;
     
-    // Cập nhật animation và timer
-    updateAnimation(deltaTime);
-    updateTimer();
+    // Chạy các bước mô phỏng cố định tương ứng với thời gian thực đã trôi qua
+    // (cộng dồn bằng số nguyên nên không mất độ chính xác dù chạy bao lâu)
+    g_simAccumulatorNanos += deltaTime;
+    perfBeginUpdate();
+    int steps = 0;
+    while (g_simAccumulatorNanos >= SIMULATION_STEP_NANOS && steps < MAX_SIMULATION_STEPS_PER_FRAME) {
+        stepSimulation();
+        g_simAccumulatorNanos -= SIMULATION_STEP_NANOS;
+        steps++;
+    }
+    perfEndUpdate();
+    
+    // Bị trễ quá nhiều: bỏ phần dư thay vì đuổi theo mãi (tránh vòng xoáy chậm dần)
+    if (g_simAccumulatorNanos >= SIMULATION_STEP_NANOS) {
+        g_simAccumulatorNanos = 0;
+    }
+    
+    g_renderAlpha = (float)g_simAccumulatorNanos / (float)SIMULATION_STEP_NANOS;
+    requestRedisplay();
 }
@@ -0,0 +1,507 @@
+#include "rubik_cfop.h"
+#include "rubik_statecodec.h"
+#include "rubik_notation.h"
+#include "rubik_record.h"
+#include "rubik_rotation.h"
+#include "rubik_state.h"
+#include "rubik_clock.h"
+#include "rubik_log.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const int CFOP_PIECES = 20;               // 8 góc + 12 cạnh
+static const unsigned int ALL_PIECES_MASK = (1u << 20) - 1;
+static const int MOVE_CODE_COUNT = 18;
+static const int MOVED_FACELETS = 20;            // Mỗi nước mặt ngoài đổi chỗ đúng 20 sticker
+static const int NOT_REACHED = 0x7FFFFFFF;
+
+// Mặt của engine theo thứ tự URFDLB của facelet
+static const int FACELET_FACES[6] = {UP, RIGHT, FRONT, DOWN, LEFT, BACK};
+static const char* const STAGE_NAMES[CFOP_STAGE_COUNT] = {
+    "Cross", "F2L 1", "F2L 2", "F2L 3", "F2L 4", "OLL", "PLL"
+};
+
+// Sau nước move: sticker dest[i] nhận màu của sticker source[i] (trước nước đi)
+static unsigned char s_moveDest[MOVE_CODE_COUNT][MOVED_FACELETS];
+static unsigned char s_moveSource[MOVE_CODE_COUNT][MOVED_FACELETS];
+static unsigned char s_movePieces[MOVE_CODE_COUNT][8];  // 8 mảnh bị nước đi đụng tới
+static unsigned int s_moveMask[MOVE_CODE_COUNT];
+
+// Sticker của từng mảnh; cạnh lặp lại sticker đầu để mọi mảnh cùng 3 phép so sánh
+static unsigned char s_pieceFacelets[CFOP_PIECES][3];
+static unsigned char s_faceletHome[54];                 // Màu đã giải = mặt chứa sticker
+
+// Mask giai đoạn theo mặt cross (thứ tự URFDLB)
+static unsigned int s_crossMask[6];
+static unsigned int s_pairMask[6][4];
+static unsigned int s_f2lMask[6];
+static bool s_tablesReady = false;
+
+static int faceletFace(int facelet) {
+    return facelet / 9;
+}
+
+// Mask các mảnh có sticker trên đúng những mặt trong faceMask (bit = mặt URFDLB)
+static unsigned int piecesOnFaces(unsigned int faceMask) {
+    unsigned int mask = 0;
+    for (int p = 0; p < CFOP_PIECES; p++) {
+        unsigned int faces = 0;
+        for (int k = 0; k < 3; k++) {
+            faces |= 1u << faceletFace(s_pieceFacelets[p][k]);
+        }
+        if (faces == faceMask) {
+            mask |= 1u << p;
+        }
+    }
+    return mask;
+}
+
+// Dựng bảng hoán vị sticker bằng chính rotatePositions (như tường nhiều cube): mỗi sticker
+// được đánh số bằng giá trị màu, sau nước đi đọc lại số để biết sticker đến từ đâu
+static void buildCfopTables() {
+    if (s_tablesReady) {
+        return;
+    }
+    for (int p = 0; p < CFOP_PIECES; p++) {
+        int facelets[3];
+        int count = getPieceFacelets(p, facelets);
+        for (int k = 0; k < 3; k++) {
+            s_pieceFacelets[p][k] = (unsigned char)facelets[k < count ? k : 0];
+        }
+    }
+    for (int s = 0; s < 54; s++) {
+        s_faceletHome[s] = (unsigned char)faceletFace(s);
+    }
+
+    RubikCube labeled;
+    memset(&labeled, 0, sizeof(labeled));
+    for (int k = -1; k <= 1; k++) {
+        for (int j = -1; j <= 1; j++) {
+            for (int i = -1; i <= 1; i++) {
+                CubePiece& piece = labeled.pieces[positionToIndex(i, j, k)];
+                piece.position[0] = i;
+                piece.position[1] = j;
+                piece.position[2] = k;
+            }
+        }
+    }
+    unsigned int savedCategories = getLogCategories();  // rotatePositions ghi log mỗi lần gọi
+    setLogCategories(savedCategories & ~(unsigned int)LOG_CAT_MOVE);
+    for (int move = 0; move < MOVE_CODE_COUNT; move++) {
+        RubikCube cube = labeled;
+        for (int s = 0; s < 54; s++) {
+            int pieceIndex, face;
+            getFaceletLocation(s, pieceIndex, face);
+            cube.pieces[pieceIndex].colors[face][0] = (float)s;
+        }
+        int turns = moveCodeTurns((MoveCode)move);
+        for (int t = 0; t < turns; t++) {
+            rotatePositions(cube, moveCodeFace((MoveCode)move), true);
+        }
+        int moved = 0;
+        unsigned int pieces = 0;
+        for (int s = 0; s < 54 && moved < MOVED_FACELETS; s++) {
+            int pieceIndex, face;
+            getFaceletLocation(s, pieceIndex, face);
+            int source = (int)cube.pieces[pieceIndex].colors[face][0];
+            if (source != s) {
+                s_moveDest[move][moved] = (unsigned char)s;
+                s_moveSource[move][moved] = (unsigned char)source;
+                moved++;
+            }
+        }
+        for (int p = 0; p < CFOP_PIECES; p++) {
+            for (int m = 0; m < MOVED_FACELETS; m++) {
+                const unsigned char* facelets = s_pieceFacelets[p];
+                if (facelets[0] == s_moveDest[move][m] || facelets[1] == s_moveDest[move][m] ||
+                    facelets[2] == s_moveDest[move][m]) {
+                    pieces |= 1u << p;
+                }
+            }
+        }
+        s_moveMask[move] = pieces;
+        int count = 0;
+        for (int p = 0; p < CFOP_PIECES; p++) {
+            if (pieces & (1u << p)) {
+                s_movePieces[move][count++] = (unsigned char)p;
+            }
+        }
+    }
+    setLogCategories(savedCategories);
+
+    // Mặt đối diện của mặt thứ x (URFDLB) là (x + 3) % 6
+    for (int x = 0; x < 6; x++) {
+        unsigned int sideFaces = 0x3Fu & ~(1u << x) & ~(1u << (x + 3) % 6);
+        s_crossMask[x] = 0;
+        s_f2lMask[x] = 0;
+        int pair = 0;
+        for (int a = 0; a < 6; a++) {
+            if (!(sideFaces & (1u << a))) {
+                continue;
+            }
+            s_crossMask[x] |= piecesOnFaces(1u << x | 1u << a);
+            for (int b = a + 1; b < 6; b++) {
+                unsigned int corner = piecesOnFaces(1u << x | 1u << a | 1u << b);
+                if ((sideFaces & (1u << b)) && corner != 0) {
+                    s_pairMask[x][pair++] = corner | piecesOnFaces(1u << a | 1u << b);
+                }
+            }
+        }
+        s_f2lMask[x] = s_crossMask[x];
+        for (int k = 0; k < 4; k++) {
+            s_f2lMask[x] |= s_pairMask[x][k];
+        }
+    }
+    s_tablesReady = true;
+}
+
+static unsigned int isPieceSolved(const unsigned char* facelets, int piece) {
+    const unsigned char* at = s_pieceFacelets[piece];
+    return (unsigned int)(facelets[at[0]] == s_faceletHome[at[0]]) &
+           (unsigned int)(facelets[at[1]] == s_faceletHome[at[1]]) &
+           (unsigned int)(facelets[at[2]] == s_faceletHome[at[2]]);
+}
+
+static bool isLastLayerOriented(const unsigned char* facelets, int crossFace) {
+    int lastFace = (crossFace + 3) % 6;
+    const unsigned char* sticker = facelets + lastFace * 9;
+    unsigned int wrong = 0;
+    for (int i = 0; i < 9; i++) {
+        wrong |= (unsigned int)(sticker[i] != lastFace);
+    }
+    return wrong == 0;
+}
+
+static void completeStage(CfopTracker& tracker, int crossFace, int& stage, ClockNanos timeNanos) {
+    tracker.stageMoves[crossFace][stage] = tracker.moveCount;
+    tracker.stageNanos[crossFace][stage] = timeNanos;
+    stage++;
+}
+
+// Tiến các giai đoạn của một mặt cross theo mask hiện tại (có thể xong nhiều giai đoạn
+// trong cùng một nước)
+static void advanceCfopStages(CfopTracker& tracker, int crossFace, ClockNanos timeNanos) {
+    const unsigned int solved = tracker.solvedMask;
+    const unsigned int cross = s_crossMask[crossFace];
+    int stage = tracker.nextStage[crossFace];
+    if (stage == CFOP_STAGE_COUNT || (solved & cross) != cross) {
+        return;
+    }
+    if (stage == CFOP_CROSS) {
+        completeStage(tracker, crossFace, stage, timeNanos);
+    }
+    if (stage <= CFOP_PAIR_4) {
+        int pairs = 0;
+        for (int k = 0; k < 4; k++) {
+            pairs += (int)((solved & s_pairMask[crossFace][k]) == s_pairMask[crossFace][k]);
+        }
+        while (stage < CFOP_PAIR_1 + pairs) {
+            completeStage(tracker, crossFace, stage, timeNanos);
+        }
+    }
+    if (stage == CFOP_OLL && (solved & s_f2lMask[crossFace]) == s_f2lMask[crossFace] &&
+        isLastLayerOriented(tracker.facelets, crossFace)) {
+        completeStage(tracker, crossFace, stage, timeNanos);
+    }
+    if (stage == CFOP_PLL && solved == ALL_PIECES_MASK) {
+        completeStage(tracker, crossFace, stage, timeNanos);
+    }
+    tracker.nextStage[crossFace] = stage;
+}
+
+void setCfopTrackerState(CfopTracker& tracker, const char facelets[54], ClockNanos startNanos) {
+    static const char LETTERS[] = "URFDLB";
+    buildCfopTables();
+    for (int s = 0; s < 54; s++) {
+        const char* letter = strchr(LETTERS, facelets[s]);
+        tracker.facelets[s] = (unsigned char)(letter != NULL && *letter != '\0' ? letter - LETTERS : 6);
+    }
+    restartCfopTracker(tracker, startNanos);
+}
+
+void restartCfopTracker(CfopTracker& tracker, ClockNanos startNanos) {
+    buildCfopTables();
+    tracker.solvedMask = 0;
+    for (int p = 0; p < CFOP_PIECES; p++) {
+        tracker.solvedMask |= isPieceSolved(tracker.facelets, p) << p;
+    }
+    tracker.startNanos = startNanos;
+    tracker.moveCount = 0;
+    for (int x = 0; x < 6; x++) {
+        tracker.nextStage[x] = CFOP_CROSS;
+        for (int stage = 0; stage < CFOP_STAGE_COUNT; stage++) {
+            tracker.stageMoves[x][stage] = NOT_REACHED;
+            tracker.stageNanos[x][stage] = 0;
+        }
+        advanceCfopStages(tracker, x, startNanos);
+    }
+}
+
+void trackCfopMove(CfopTracker& tracker, MoveCode move, ClockNanos timeNanos) {
+    const unsigned char* dest = s_moveDest[move];
+    const unsigned char* source = s_moveSource[move];
+    unsigned char moved[MOVED_FACELETS];
+    for (int i = 0; i < MOVED_FACELETS; i++) {
+        moved[i] = tracker.facelets[source[i]];
+    }
+    for (int i = 0; i < MOVED_FACELETS; i++) {
+        tracker.facelets[dest[i]] = moved[i];
+    }
+
+    // Chỉ 8 mảnh của mặt vừa xoay có thể đổi trạng thái
+    unsigned int solved = tracker.solvedMask & ~s_moveMask[move];
+    for (int k = 0; k < 8; k++) {
+        solved |= isPieceSolved(tracker.facelets, s_movePieces[move][k]) << s_movePieces[move][k];
+    }
+    tracker.solvedMask = solved;
+    tracker.moveCount++;
+    for (int x = 0; x < 6; x++) {
+        advanceCfopStages(tracker, x, timeNanos);
+    }
+}
+
+bool isCfopTrackerSolved(const CfopTracker& tracker) {
+    return tracker.solvedMask == ALL_PIECES_MASK;
+}
+
+// Mặt cross có F2L xong sớm hơn thì tốt hơn, hòa thì so cross; D được xét trước
+static bool isBetterCrossFace(const CfopTracker& tracker, int candidate, int best) {
+    const int* a = tracker.stageMoves[candidate];
+    const int* b = tracker.stageMoves[best];
+    if (a[CFOP_PAIR_4] != b[CFOP_PAIR_4]) {
+        return a[CFOP_PAIR_4] < b[CFOP_PAIR_4];
+    }
+    return a[CFOP_CROSS] < b[CFOP_CROSS];
+}
+
+bool getCfopSplits(const CfopTracker& tracker, CfopSplits& splits) {
+    if (!isCfopTrackerSolved(tracker)) {
+        return false;
+    }
+    static const int CANDIDATE_ORDER[6] = {3, 0, 2, 5, 1, 4};  // D U F B R L
+    int best = CANDIDATE_ORDER[0];
+    for (int i = 1; i < 6; i++) {
+        if (isBetterCrossFace(tracker, CANDIDATE_ORDER[i], best)) {
+            best = CANDIDATE_ORDER[i];
+        }
+    }
+    splits.crossFace = FACELET_FACES[best];
+    splits.moveCount = tracker.moveCount;
+    splits.totalNanos = tracker.stageNanos[best][CFOP_PLL] - tracker.startNanos;
+    for (int stage = 0; stage < CFOP_STAGE_COUNT; stage++) {
+        splits.stageMoves[stage] = tracker.stageMoves[best][stage];
+        splits.stageNanos[stage] = tracker.stageNanos[best][stage] - tracker.startNanos;
+    }
+    return true;
+}
+
+// ==================== Chế độ dòng lệnh ====================
+
+bool isCfopSplitsRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cfop-splits") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printCfopSplitsUsage() {
+    fprintf(stderr,
+            "Cách dùng: rubik --cfop-splits a.rrec [b.rrec ...] [--csv splits.csv]\n"
+            "  Tách mọi lần giải có tính giờ (sau lệnh trộn) trong các file phiên, nhận diện cross,\n"
+            "  4 cặp F2L, OLL, PLL và in split trung bình; --csv ghi split từng lần giải.\n");
+}
+
+// Mọi lần giải trong một file phiên, theo cùng quy tắc với timer: timer sẵn sàng khi nước
+// trộn cuối chạy xong animation (handleScrambleMoveCompletion), lần giải bắt đầu ở nước không
+// phải nước trộn đầu tiên được chấp nhận sau đó và kết thúc khi cube được giải; trộn lại hoặc
+// reset giữa chừng thì lần giải bị bỏ dở. File chỉ ghi mốc chấp nhận nên mốc xong animation
+// được dựng lại: các nước chạy lần lượt, mỗi nước 90 độ với ROTATION_SPEED_DEG_PER_SEC. Trong
+// app animation xong ở khung hình đầu tiên sau mốc này (chậm hơn tối đa một khung hình)
+static bool collectRecordSolves(const char* path, const char solvedFacelets[54], const RubikCube& solvedCube,
+                                std::vector<CfopSplits>& solves, long long& abandoned, long long& moves) {
+    RecordStream stream;
+    if (!openRecordStream(path, stream)) {
+        return false;
+    }
+    RubikCube initial = solvedCube;
+    getRecordStreamInitialCube(stream, initial);
+    char facelets[54];
+    captureCubeFacelets(initial, facelets);
+
+    CfopTracker tracker;
+    setCfopTrackerState(tracker, facelets, 0);
+    const ClockNanos animationNanos = (ClockNanos)(90.0 / ROTATION_SPEED_DEG_PER_SEC * 1e9);
+    int scramblePending = stream.initial->scramblePending;
+    bool armed = stream.initial->timerState == TIMER_READY;
+    bool armPending = false;               // Nước trộn cuối đã chấp nhận, chờ animation xong
+    ClockNanos armNanos = 0;
+    ClockNanos animationEnd = stream.initial->timeNanos;  // Checkpoint: animation đã chạy hết
+    bool solving = false;
+    RecordEvent event;
+    while (readRecordStream(stream, event)) {
+        if (event.type == RECORD_SCRAMBLE || event.type == RECORD_RESET) {
+            abandoned += solving ? 1 : 0;
+            solving = false;
+            armed = false;
+            armPending = false;
+            scramblePending = event.type == RECORD_SCRAMBLE ? event.count : 0;
+            if (event.type == RECORD_RESET) {
+                setCfopTrackerState(tracker, solvedFacelets, event.timeNanos);
+                animationEnd = event.timeNanos;  // resetCube huỷ animation và hàng đợi
+            }
+            continue;
+        }
+        if (event.type != RECORD_MOVE) {
+            continue;
+        }
+        if (armPending && event.timeNanos >= armNanos) {
+            armPending = false;
+            armed = true;
+        }
+        animationEnd = (event.timeNanos > animationEnd ? event.timeNanos : animationEnd) + animationNanos;
+        if (!event.isScrambleMove && armed) {
+            restartCfopTracker(tracker, event.timeNanos);
+            armed = false;
+            solving = true;
+        }
+        trackCfopMove(tracker, makeMoveCode(event.face, event.clockwise ? 1 : 3), event.timeNanos);
+        moves++;
+        if (event.isScrambleMove) {
+            if (scramblePending > 0 && --scramblePending == 0) {
+                armPending = true;
+                armNanos = animationEnd;
+            }
+        } else if (solving && isCfopTrackerSolved(tracker)) {
+            CfopSplits splits;
+            getCfopSplits(tracker, splits);
+            solves.push_back(splits);
+            solving = false;
+        }
+    }
+    abandoned += solving ? 1 : 0;
+    closeRecordStream(stream);
+    return true;
+}
+
+int runCfopSplitsCommand(int argc, char** argv) {
+    std::vector<const char*> paths;
+    std::vector<int> fileOfSolve;
+    const char* csvPath = NULL;
+    bool collecting = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cfop-splits") == 0) {
+            collecting = true;
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+            collecting = false;
+        } else if (collecting && argv[i][0] != '-') {
+            paths.push_back(argv[i]);
+        } else {
+            fprintf(stderr, "Tham số không hợp lệ: %s\n", argv[i]);
+            printCfopSplitsUsage();
+            return 1;
+        }
+    }
+    if (paths.empty()) {
+        printCfopSplitsUsage();
+        return 1;
+    }
+
+    initRubikCube();
+    RubikCube solvedCube = g_rubikCube;
+    char solvedFacelets[54];
+    captureCubeFacelets(solvedCube, solvedFacelets);
+
+    std::vector<CfopSplits> solves;
+    long long abandoned = 0;
+    long long moves = 0;
+    int failedFiles = 0;
+    ClockNanos started = clockRealNanos();
+    for (size_t f = 0; f < paths.size(); f++) {
+        if (!collectRecordSolves(paths[f], solvedFacelets, solvedCube, solves, abandoned, moves)) {
+            failedFiles++;
+        }
+        fileOfSolve.resize(solves.size(), (int)f);
+    }
+    double seconds = clockNanosToSeconds(clockRealNanos() - started);
+    if (failedFiles == (int)paths.size()) {
+        return 1;
+    }
+
+    // Split của từng giai đoạn = mốc của nó trừ mốc giai đoạn trước
+    double splitSeconds[CFOP_STAGE_COUNT] = {0.0};
+    double splitMoves[CFOP_STAGE_COUNT] = {0.0};
+    int skips[CFOP_STAGE_COUNT] = {0};
+    int crossFaces[6] = {0};
+    double totalSeconds = 0.0;
+    double totalMoves = 0.0;
+    for (size_t i = 0; i < solves.size(); i++) {
+        const CfopSplits& splits = solves[i];
+        for (int stage = 0; stage < CFOP_STAGE_COUNT; stage++) {
+            int previousMoves = stage > 0 ? splits.stageMoves[stage - 1] : 0;
+            ClockNanos previousNanos = stage > 0 ? splits.stageNanos[stage - 1] : 0;
+            splitSeconds[stage] += clockNanosToSeconds(splits.stageNanos[stage] - previousNanos);
+            splitMoves[stage] += splits.stageMoves[stage] - previousMoves;
+            skips[stage] += stage > 0 && splits.stageMoves[stage] == previousMoves ? 1 : 0;
+        }
+        crossFaces[splits.crossFace]++;
+        totalSeconds += clockNanosToSeconds(splits.totalNanos);
+        totalMoves += splits.moveCount;
+    }
+
+    int count = (int)solves.size();
+    double divisor = count > 0 ? (double)count : 1.0;
+    printf("CFOP: %d lần giải từ %d file, %lld lần bỏ dở, %lld nước, %.3fs\n",
+           count, (int)paths.size() - failedFiles, abandoned, moves, seconds);
+    printf("             TB giây   TB nước  bỏ qua\n");  // Căn tay: printf đếm byte, không đếm ký tự UTF-8
+    for (int stage = 0; stage < CFOP_STAGE_COUNT; stage++) {
+        printf("  %-8s %9.3f %9.2f %7d\n", STAGE_NAMES[stage], splitSeconds[stage] / divisor,
+               splitMoves[stage] / divisor, skips[stage]);
+    }
+    printf("  Tổng     %9.3f %9.2f\n", totalSeconds / divisor, totalMoves / divisor);
+    static const char FACE_LETTERS[6] = {'F', 'B', 'L', 'R', 'U', 'D'};
+    printf("  Mặt cross:");
+    for (int face = 0; face < 6; face++) {
+        if (crossFaces[face] > 0) {
+            printf(" %c=%d", FACE_LETTERS[face], crossFaces[face]);
+        }
+    }
+    printf("\n");
+
+    bool writeFailed = false;
+    if (csvPath != NULL) {
+        FILE* csv = fopen(csvPath, "w");
+        if (csv == NULL) {
+            writeFailed = true;
+        } else {
+            fprintf(csv, "file,solve,cross_face,total_seconds,total_moves");
+            for (int stage = 0; stage < CFOP_STAGE_COUNT; stage++) {
+                fprintf(csv, ",%s_seconds,%s_moves", STAGE_NAMES[stage], STAGE_NAMES[stage]);
+            }
+            fprintf(csv, "\n");
+            for (size_t i = 0; i < solves.size(); i++) {
+                const CfopSplits& splits = solves[i];
+                fprintf(csv, "%s,%d,%c,%.3f,%d", paths[fileOfSolve[i]], (int)i + 1,
+                        FACE_LETTERS[splits.crossFace], clockNanosToSeconds(splits.totalNanos), splits.moveCount);
+                for (int stage = 0; stage < CFOP_STAGE_COUNT; stage++) {
+                    int previousMoves = stage > 0 ? splits.stageMoves[stage - 1] : 0;
+                    ClockNanos previousNanos = stage > 0 ? splits.stageNanos[stage - 1] : 0;
+                    fprintf(csv, ",%.3f,%d", clockNanosToSeconds(splits.stageNanos[stage] - previousNanos),
+                            splits.stageMoves[stage] - previousMoves);
+                }
+                fprintf(csv, "\n");
+            }
+            writeFailed = ferror(csv) != 0;
+            writeFailed = fclose(csv) != 0 || writeFailed;
+        }
+        if (writeFailed) {
+            fprintf(stderr, "Lỗi khi ghi file: %s\n", csvPath);
+        }
+    }
+    double millionsPerSecond = seconds > 0.0 ? (double)moves / seconds / 1e6 : 0.0;
+    RUBIK_LOG(EVT_CFOP_SPLITS) << count << (int)paths.size() - failedFiles << (int)abandoned << millionsPerSecond;
+    return writeFailed || failedFiles > 0 ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+#include "rubik_clock.h"
+#include "rubik_constants.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// Số nano giây của bộ đếm hệ điều hành (gốc tuỳ ý)
+static ClockNanos readMonotonicNanos() {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = {{0, 0}};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    // Tách phần nguyên giây để counter * 1e9 không tràn int64
+    ClockNanos seconds = counter.QuadPart / frequency.QuadPart;
+    ClockNanos remainder = counter.QuadPart % frequency.QuadPart;
+    return seconds * NANOS_PER_SECOND + remainder * NANOS_PER_SECOND / frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ClockNanos)ts.tv_sec * NANOS_PER_SECOND + (ClockNanos)ts.tv_nsec;
+#endif
+}
+
+// Gốc thời gian đặt lúc khởi động tiến trình (trước main, chưa có luồng phụ)
+static const ClockNanos s_origin = readMonotonicNanos();
+static volatile ClockNanos s_virtualNow = 0;
+static volatile bool s_virtualActive = false;
+
+ClockNanos clockRealNanos() {
+    return readMonotonicNanos() - s_origin;
+}
+
+ClockNanos clockNowNanos() {
+    if (s_virtualActive) {
+        return s_virtualNow;
+    }
+    return clockRealNanos();
+}
+
+void setVirtualClock(ClockNanos now) {
+    s_virtualNow = now;
+    s_virtualActive = true;
+}
+
+void advanceVirtualClock(ClockNanos delta) {
+    s_virtualNow = s_virtualNow + delta;
+}
+
+void useRealClock() {
+    s_virtualActive = false;
+}
+
+bool isVirtualClockActive() {
+    return s_virtualActive;
+}
@@ -0,0 +1,196 @@
+#include "rubik_glext.h"
+#include "rubik_state.h"
+#include "rubik_log.h"
+#include <GL/freeglut_ext.h>
+#include <cstdio>
+#include <cstring>
+
+PFNGLGENBUFFERSPROC pglGenBuffers = NULL;
+PFNGLDELETEBUFFERSPROC pglDeleteBuffers = NULL;
+PFNGLBINDBUFFERPROC pglBindBuffer = NULL;
+PFNGLBUFFERDATAPROC pglBufferData = NULL;
+PFNGLBUFFERSUBDATAPROC pglBufferSubData = NULL;
+
+PFNGLCREATESHADERPROC pglCreateShader = NULL;
+PFNGLDELETESHADERPROC pglDeleteShader = NULL;
+PFNGLSHADERSOURCEPROC pglShaderSource = NULL;
+PFNGLCOMPILESHADERPROC pglCompileShader = NULL;
+PFNGLGETSHADERIVPROC pglGetShaderiv = NULL;
+PFNGLGETSHADERINFOLOGPROC pglGetShaderInfoLog = NULL;
+PFNGLCREATEPROGRAMPROC pglCreateProgram = NULL;
+PFNGLDELETEPROGRAMPROC pglDeleteProgram = NULL;
+PFNGLATTACHSHADERPROC pglAttachShader = NULL;
+PFNGLBINDATTRIBLOCATIONPROC pglBindAttribLocation = NULL;
+PFNGLLINKPROGRAMPROC pglLinkProgram = NULL;
+PFNGLGETPROGRAMIVPROC pglGetProgramiv = NULL;
+PFNGLGETPROGRAMINFOLOGPROC pglGetProgramInfoLog = NULL;
+PFNGLUSEPROGRAMPROC pglUseProgram = NULL;
+PFNGLGETUNIFORMLOCATIONPROC pglGetUniformLocation = NULL;
+PFNGLUNIFORM1FPROC pglUniform1f = NULL;
+PFNGLUNIFORM2FPROC pglUniform2f = NULL;
+PFNGLUNIFORM3FPROC pglUniform3f = NULL;
+PFNGLUNIFORM4FPROC pglUniform4f = NULL;
+PFNGLENABLEVERTEXATTRIBARRAYPROC pglEnableVertexAttribArray = NULL;
+PFNGLDISABLEVERTEXATTRIBARRAYPROC pglDisableVertexAttribArray = NULL;
+PFNGLVERTEXATTRIBPOINTERPROC pglVertexAttribPointer = NULL;
+
+PFNGLVERTEXATTRIBDIVISORPROC pglVertexAttribDivisor = NULL;
+PFNGLDRAWARRAYSINSTANCEDPROC pglDrawArraysInstanced = NULL;
+
+bool g_glBuffersSupported = false;
+bool g_glShadersSupported = false;
+bool g_glInstancingSupported = false;
+
+// Tìm hàm theo tên chuẩn, nếu không có thì thử tên có hậu tố ARB
+static void* loadProc(const char* name, const char* arbName) {
+    void* proc = (void*)glutGetProcAddress(name);
+    if (proc == NULL && arbName != NULL) {
+        proc = (void*)glutGetProcAddress(arbName);
+    }
+    return proc;
+}
+
+#define LOAD_GL_PROC(type, var, name, arbName) \
+    var = (type)loadProc(name, arbName)
+
+void loadGLExtensions() {
+    LOAD_GL_PROC(PFNGLGENBUFFERSPROC, pglGenBuffers, "glGenBuffers", "glGenBuffersARB");
+    LOAD_GL_PROC(PFNGLDELETEBUFFERSPROC, pglDeleteBuffers, "glDeleteBuffers", "glDeleteBuffersARB");
+    LOAD_GL_PROC(PFNGLBINDBUFFERPROC, pglBindBuffer, "glBindBuffer", "glBindBufferARB");
+    LOAD_GL_PROC(PFNGLBUFFERDATAPROC, pglBufferData, "glBufferData", "glBufferDataARB");
+    LOAD_GL_PROC(PFNGLBUFFERSUBDATAPROC, pglBufferSubData, "glBufferSubData", "glBufferSubDataARB");
+
+    LOAD_GL_PROC(PFNGLCREATESHADERPROC, pglCreateShader, "glCreateShader", NULL);
+    LOAD_GL_PROC(PFNGLDELETESHADERPROC, pglDeleteShader, "glDeleteShader", NULL);
+    LOAD_GL_PROC(PFNGLSHADERSOURCEPROC, pglShaderSource, "glShaderSource", NULL);
+    LOAD_GL_PROC(PFNGLCOMPILESHADERPROC, pglCompileShader, "glCompileShader", NULL);
+    LOAD_GL_PROC(PFNGLGETSHADERIVPROC, pglGetShaderiv, "glGetShaderiv", NULL);
+    LOAD_GL_PROC(PFNGLGETSHADERINFOLOGPROC, pglGetShaderInfoLog, "glGetShaderInfoLog", NULL);
+    LOAD_GL_PROC(PFNGLCREATEPROGRAMPROC, pglCreateProgram, "glCreateProgram", NULL);
+    LOAD_GL_PROC(PFNGLDELETEPROGRAMPROC, pglDeleteProgram, "glDeleteProgram", NULL);
+    LOAD_GL_PROC(PFNGLATTACHSHADERPROC, pglAttachShader, "glAttachShader", NULL);
+    LOAD_GL_PROC(PFNGLBINDATTRIBLOCATIONPROC, pglBindAttribLocation, "glBindAttribLocation", NULL);
+    LOAD_GL_PROC(PFNGLLINKPROGRAMPROC, pglLinkProgram, "glLinkProgram", NULL);
+    LOAD_GL_PROC(PFNGLGETPROGRAMIVPROC, pglGetProgramiv, "glGetProgramiv", NULL);
+    LOAD_GL_PROC(PFNGLGETPROGRAMINFOLOGPROC, pglGetProgramInfoLog, "glGetProgramInfoLog", NULL);
+    LOAD_GL_PROC(PFNGLUSEPROGRAMPROC, pglUseProgram, "glUseProgram", NULL);
+    LOAD_GL_PROC(PFNGLGETUNIFORMLOCATIONPROC, pglGetUniformLocation, "glGetUniformLocation", NULL);
+    LOAD_GL_PROC(PFNGLUNIFORM1FPROC, pglUniform1f, "glUniform1f", NULL);
+    LOAD_GL_PROC(PFNGLUNIFORM2FPROC, pglUniform2f, "glUniform2f", NULL);
+    LOAD_GL_PROC(PFNGLUNIFORM3FPROC, pglUniform3f, "glUniform3f", NULL);
+    LOAD_GL_PROC(PFNGLUNIFORM4FPROC, pglUniform4f, "glUniform4f", NULL);
+    LOAD_GL_PROC(PFNGLENABLEVERTEXATTRIBARRAYPROC, pglEnableVertexAttribArray,
+                 "glEnableVertexAttribArray", NULL);
+    LOAD_GL_PROC(PFNGLDISABLEVERTEXATTRIBARRAYPROC, pglDisableVertexAttribArray,
+                 "glDisableVertexAttribArray", NULL);
+    LOAD_GL_PROC(PFNGLVERTEXATTRIBPOINTERPROC, pglVertexAttribPointer, "glVertexAttribPointer", NULL);
+
+    LOAD_GL_PROC(PFNGLVERTEXATTRIBDIVISORPROC, pglVertexAttribDivisor,
+                 "glVertexAttribDivisor", "glVertexAttribDivisorARB");
+    LOAD_GL_PROC(PFNGLDRAWARRAYSINSTANCEDPROC, pglDrawArraysInstanced,
+                 "glDrawArraysInstanced", "glDrawArraysInstancedARB");
+
+    g_glBuffersSupported = pglGenBuffers != NULL && pglDeleteBuffers != NULL &&
+                           pglBindBuffer != NULL && pglBufferData != NULL &&
+                           pglBufferSubData != NULL;
+    g_glShadersSupported = pglCreateShader != NULL && pglDeleteShader != NULL &&
+                           pglShaderSource != NULL && pglCompileShader != NULL &&
+                           pglGetShaderiv != NULL && pglGetShaderInfoLog != NULL &&
+                           pglCreateProgram != NULL && pglDeleteProgram != NULL &&
+                           pglAttachShader != NULL && pglBindAttribLocation != NULL &&
+                           pglLinkProgram != NULL && pglGetProgramiv != NULL &&
+                           pglGetProgramInfoLog != NULL && pglUseProgram != NULL &&
+                           pglGetUniformLocation != NULL && pglUniform1f != NULL &&
+                           pglUniform2f != NULL && pglUniform3f != NULL &&
+                           pglUniform4f != NULL &&
+                           pglEnableVertexAttribArray != NULL &&
+                           pglDisableVertexAttribArray != NULL &&
+                           pglVertexAttribPointer != NULL;
+    g_glInstancingSupported = g_glBuffersSupported && g_glShadersSupported &&
+                              pglVertexAttribDivisor != NULL && pglDrawArraysInstanced != NULL;
+
+    RUBIK_LOG(EVT_GL_VERSION) << (const char*)glGetString(GL_VERSION);
+    RUBIK_LOG(EVT_GL_RENDERER) << (const char*)glGetString(GL_RENDERER);
+    RUBIK_LOG(EVT_GL_EXTENSIONS) << g_glBuffersSupported << g_glShadersSupported << g_glInstancingSupported;
+}
+
+// Ghi log lỗi biên dịch/liên kết từng dòng (mỗi bản ghi trace chỉ chứa được một đoạn chuỗi ngắn)
+static void logShaderInfoLog(char* infoLog) {
+    char* line = infoLog;
+    while (*line != '\0') {
+        char* end = strchr(line, '\n');
+        if (end != NULL) {
+            *end = '\0';
+        }
+        if (*line != '\0') {
+            RUBIK_LOG(EVT_GL_INFO_LOG) << line;
+        }
+        if (end == NULL) {
+            break;
+        }
+        line = end + 1;
+    }
+}
+
+// Biên dịch một shader, trả về 0 nếu lỗi
+static GLuint compileShader(GLenum type, const char* source) {
+    GLuint shader = pglCreateShader(type);
+    pglShaderSource(shader, 1, &source, NULL);
+    pglCompileShader(shader);
+
+    GLint status = GL_FALSE;
+    pglGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        if (LOG_EVENT_ENABLED(EVT_GL_SHADER_ERROR)) {
+            char infoLog[1024];
+            pglGetShaderInfoLog(shader, sizeof(infoLog), NULL, infoLog);
+            RUBIK_LOG(EVT_GL_SHADER_ERROR) << (type == GL_VERTEX_SHADER ? "vertex" : "fragment");
+            logShaderInfoLog(infoLog);
+        }
+        pglDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+GLuint createShaderProgram(const char* vertexSource, const char* fragmentSource,
+                           const char* const* attribNames, int attribCount) {
+    if (!g_glShadersSupported) {
+        return 0;
+    }
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+    if (vertexShader == 0) {
+        return 0;
+    }
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+    if (fragmentShader == 0) {
+        pglDeleteShader(vertexShader);
+        return 0;
+    }
+
+    GLuint program = pglCreateProgram();
+    pglAttachShader(program, vertexShader);
+    pglAttachShader(program, fragmentShader);
+    for (int i = 0; i < attribCount; i++) {
+        pglBindAttribLocation(program, (GLuint)i, attribNames[i]);
+    }
+    pglLinkProgram(program);
+
+    // Shader đã được gắn vào program, có thể đánh dấu xóa
+    pglDeleteShader(vertexShader);
+    pglDeleteShader(fragmentShader);
+
+    GLint status = GL_FALSE;
+    pglGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        if (LOG_EVENT_ENABLED(EVT_GL_LINK_ERROR)) {
+            char infoLog[1024];
+            pglGetProgramInfoLog(program, sizeof(infoLog), NULL, infoLog);
+            RUBIK_LOG(EVT_GL_LINK_ERROR);
+            logShaderInfoLog(infoLog);
+        }
+        pglDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
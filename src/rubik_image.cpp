@@ -0,0 +1,193 @@
+#include "rubik_image.h"
+#include "rubik_constants.h"
+#include <cstring>
+#include <vector>
+
+bool writeImagePPMToStream(FILE* file, int width, int height, const unsigned char* rgb) {
+    if (file == NULL || width <= 0 || height <= 0) {
+        return false;
+    }
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    size_t size = (size_t)width * (size_t)height * 3;
+    return fwrite(rgb, 1, size, file) == size;
+}
+
+bool writeImagePPM(const char* path, int width, int height, const unsigned char* rgb) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    bool ok = writeImagePPMToStream(file, width, height, rgb);
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+// Bảng CRC-32 (đa thức 0xEDB88320) cho các chunk PNG
+static unsigned long crcTable[256];
+static bool crcTableReady = false;
+
+static void buildCrcTable() {
+    for (unsigned long n = 0; n < 256; n++) {
+        unsigned long c = n;
+        for (int k = 0; k < 8; k++) {
+            c = (c & 1) ? (0xEDB88320UL ^ (c >> 1)) : (c >> 1);
+        }
+        crcTable[n] = c;
+    }
+    crcTableReady = true;
+}
+
+static unsigned long updateCrc(unsigned long crc, const unsigned char* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+static void appendUint32BE(std::vector<unsigned char>& out, unsigned long value) {
+    out.push_back((unsigned char)((value >> 24) & 0xFF));
+    out.push_back((unsigned char)((value >> 16) & 0xFF));
+    out.push_back((unsigned char)((value >> 8) & 0xFF));
+    out.push_back((unsigned char)(value & 0xFF));
+}
+
+// Ghi một chunk PNG: độ dài, kiểu, dữ liệu, CRC(kiểu + dữ liệu)
+static bool writePngChunk(FILE* file, const char* type, const std::vector<unsigned char>& data) {
+    std::vector<unsigned char> header;
+    appendUint32BE(header, (unsigned long)data.size());
+    header.insert(header.end(), type, type + 4);
+
+    unsigned long crc = 0xFFFFFFFFUL;
+    crc = updateCrc(crc, (const unsigned char*)type, 4);
+    if (!data.empty()) {
+        crc = updateCrc(crc, &data[0], data.size());
+    }
+    std::vector<unsigned char> trailer;
+    appendUint32BE(trailer, crc ^ 0xFFFFFFFFUL);
+
+    if (fwrite(&header[0], 1, header.size(), file) != header.size()) {
+        return false;
+    }
+    if (!data.empty() && fwrite(&data[0], 1, data.size(), file) != data.size()) {
+        return false;
+    }
+    return fwrite(&trailer[0], 1, trailer.size(), file) == trailer.size();
+}
+
+bool writeImagePNG(const char* path, int width, int height, const unsigned char* rgb) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    if (!crcTableReady) {
+        buildCrcTable();
+    }
+
+    // Dữ liệu ảnh thô: mỗi hàng bắt đầu bằng byte filter 0 (None)
+    const size_t rowBytes = (size_t)width * 3;
+    std::vector<unsigned char> raw;
+    raw.reserve((rowBytes + 1) * (size_t)height);
+    for (int y = 0; y < height; y++) {
+        raw.push_back(0);
+        const unsigned char* row = rgb + (size_t)y * rowBytes;
+        raw.insert(raw.end(), row, row + rowBytes);
+    }
+
+    // Luồng zlib với các block deflate "stored" (tối đa 65535 byte mỗi block)
+    std::vector<unsigned char> zlib;
+    zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    zlib.push_back(0x78);
+    zlib.push_back(0x01);
+    size_t offset = 0;
+    do {
+        size_t blockSize = raw.size() - offset;
+        if (blockSize > 65535) {
+            blockSize = 65535;
+        }
+        bool last = offset + blockSize >= raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back((unsigned char)(blockSize & 0xFF));
+        zlib.push_back((unsigned char)((blockSize >> 8) & 0xFF));
+        zlib.push_back((unsigned char)(~blockSize & 0xFF));
+        zlib.push_back((unsigned char)((~blockSize >> 8) & 0xFF));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+        offset += blockSize;
+    } while (offset < raw.size());
+
+    // Adler-32 của dữ liệu thô
+    unsigned long a = 1;
+    unsigned long b = 0;
+    for (size_t i = 0; i < raw.size(); i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendUint32BE(zlib, (b << 16) | a);
+
+    std::vector<unsigned char> ihdr;
+    appendUint32BE(ihdr, (unsigned long)width);
+    appendUint32BE(ihdr, (unsigned long)height);
+    ihdr.push_back(8);   // 8 bit mỗi kênh
+    ihdr.push_back(2);   // RGB
+    ihdr.push_back(0);   // Nén deflate
+    ihdr.push_back(0);   // Filter chuẩn
+    ihdr.push_back(0);   // Không interlace
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    static const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    bool ok = fwrite(signature, 1, sizeof(signature), file) == sizeof(signature);
+    ok = ok && writePngChunk(file, "IHDR", ihdr);
+    ok = ok && writePngChunk(file, "IDAT", zlib);
+    ok = ok && writePngChunk(file, "IEND", std::vector<unsigned char>());
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+bool writeImageFile(const char* path, int width, int height, const unsigned char* rgb) {
+    size_t length = strlen(path);
+    if (length >= 4) {
+        const char* ext = path + length - 4;
+        if ((ext[0] == '.') &&
+            (ext[1] == 'p' || ext[1] == 'P') &&
+            (ext[2] == 'n' || ext[2] == 'N') &&
+            (ext[3] == 'g' || ext[3] == 'G')) {
+            return writeImagePNG(path, width, height, rgb);
+        }
+    }
+    return writeImagePPM(path, width, height, rgb);
+}
+
+// Chỉ chấp nhận đúng một chỗ số; mọi '%' khác bị từ chối thay vì chuyển cho printf
+bool parseImagePathPattern(const char* path, bool& numbered, ImagePathPattern& pattern) {
+    const char* percent = strchr(path, '%');
+    numbered = percent != NULL;
+    if (!numbered) {
+        return true;
+    }
+    const char* p = percent + 1;
+    pattern.zeroPad = *p == '0';
+    if (pattern.zeroPad) {
+        p++;
+    }
+    pattern.width = 0;
+    while (*p >= '0' && *p <= '9' && pattern.width <= IMAGE_PATH_MAX_NUMBER_WIDTH) {
+        pattern.width = pattern.width * 10 + (*p++ - '0');
+    }
+    if (*p != 'd' || pattern.width > IMAGE_PATH_MAX_NUMBER_WIDTH || strchr(p + 1, '%') != NULL) {
+        return false;
+    }
+    pattern.prefix.assign(path, percent - path);
+    pattern.suffix = p + 1;
+    return true;
+}
+
+void formatImagePath(const ImagePathPattern& pattern, int index, char* path, size_t size) {
+    char number[32];
+    snprintf(number, sizeof(number), pattern.zeroPad ? "%0*d" : "%*d", pattern.width, index);
+    snprintf(path, size, "%s%s%s", pattern.prefix.c_str(), number, pattern.suffix.c_str());
+}
@@ -3,6 +3,14 @@
 #include "rubik_rotation.h"
 #include "rubik_animation.h"
 #include "rubik_constants.h"
+#include "rubik_scheduler.h"
+#include "rubik_perf.h"
+#include "rubik_wall.h"
+#include "rubik_picking.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
+#include "rubik_record.h"
+#include "rubik_statecodec.h"
 #include <GL/glut.h>
 #include <cstdio>
 #include <cctype>
@@ -17,6 +25,12 @@ bool isDragging = false;
 int lastMouseX = 0;  // Vị trí chuột cuối cùng
 int lastMouseY = 0;
 
+// Kéo trên sticker: xoay lớp thay vì xoay camera
+static bool s_stickerDrag = false;
+static StickerHit s_dragHit;
+static int s_dragStartX = 0;
+static int s_dragStartY = 0;
+
 // Mặt hiện tại đang hướng về phía người dùng
 Face currentFrontFace = FRONT;
 
@@ -63,14 +77,9 @@ void updateRotationAxes() {
             break;
     }
     
-    if (g_logFile != NULL) {
-        const char* faceNames[] = {"FRONT", "BACK", "LEFT", "RIGHT", "UP", "DOWN"};
-        fprintf(g_logFile, "FACE CHANGE: %s | verticalAxis=[%.1f,%.1f,%.1f] horizontalAxis=[%.1f,%.1f,%.1f]\n",
-                faceNames[currentFrontFace],
-                verticalAxis[0], verticalAxis[1], verticalAxis[2],
-                horizontalAxis[0], horizontalAxis[1], horizontalAxis[2]);
-        fflush(g_logFile);
-    }
+    RUBIK_LOG(EVT_FACE_CHANGE) << currentFrontFace
+                               << verticalAxis[0] << verticalAxis[1] << verticalAxis[2]
+                               << horizontalAxis[0] << horizontalAxis[1] << horizontalAxis[2];
 }
 
 void resetRotationAngles() {
@@ -89,6 +98,7 @@ void applyCurrentViewRotation(float& x, float& y, float& z) {
 // Xác định mặt nào của cube đang hướng về các hướng front/back/left/right/up/down
 // từ góc nhìn của camera hiện tại
 void computeViewFaceMapping(ViewFaceMapping& mapping) {
+    PROFILE_ZONE("computeViewFaceMapping");
     // Vector pháp tuyến của 6 mặt cube trong không gian thế giới
     const float normals[6][3] = {
         {0.0f, 0.0f, 1.0f},   // FRONT
@@ -203,36 +213,58 @@ bool performRelativeFaceTurn(int relativeFace, bool clockwise) {
 }
 
 // Callback xử lý sự kiện chuột
-// Xử lý click và drag để xoay camera
+// Nhấn trên sticker rồi kéo để xoay lớp, nhấn ngoài khối rồi kéo để xoay camera
 void mouse(int button, int state, int x, int y) {
-    if (g_logFile != NULL) {
-        fprintf(g_logFile, "MOUSE EVENT: button=%d state=%d x=%d y=%d\n", button, state, x, y);
-        fflush(g_logFile);
-    }
+    RUBIK_LOG(EVT_MOUSE_BUTTON) << button << state << x << y;
     
     if (button == GLUT_LEFT_BUTTON) {
-        if (state == GLUT_DOWN) {
-            if (g_logFile != NULL) {
-                fprintf(g_logFile, "*** DRAG START ***\n");
-                fflush(g_logFile);
-            }
+        if (state == GLUT_DOWN && !isCubeWallActive() && !isReplayActive() && pickStickerAt(x, y, s_dragHit)) {
+            RUBIK_LOG(EVT_STICKER_DRAG_START) << s_dragHit.face
+                                              << s_dragHit.grid[0] << s_dragHit.grid[1] << s_dragHit.grid[2];
+            s_stickerDrag = true;
+            s_dragStartX = x;
+            s_dragStartY = y;
+        } else if (state == GLUT_DOWN) {
+            RUBIK_LOG(EVT_DRAG_START);
             isDragging = true;
             lastMouseX = x;
             lastMouseY = y;
         } else if (state == GLUT_UP) {
-            if (g_logFile != NULL) {
-                fprintf(g_logFile, "*** DRAG END ***\n");
-                fflush(g_logFile);
-            }
+            RUBIK_LOG(EVT_DRAG_END);
             isDragging = false;
+            s_stickerDrag = false;
         }
     }
-    glutPostRedisplay();
+    requestRedisplay();
+}
+
+// Kéo trên sticker đủ xa thì xoay lớp theo hướng kéo (mỗi lần kéo một nước)
+static void updateStickerDrag(int x, int y) {
+    int dx = x - s_dragStartX;
+    int dy = y - s_dragStartY;
+    if (dx * dx + dy * dy < PICK_DRAG_THRESHOLD_PIXELS * PICK_DRAG_THRESHOLD_PIXELS) {
+        return;
+    }
+    s_stickerDrag = false;
+    
+    Face face;
+    bool clockwise;
+    if (!computeDragTurn(s_dragHit, dx, dy, face, clockwise)) {
+        RUBIK_LOG(EVT_STICKER_DRAG_IGNORED) << dx << dy;
+        return;
+    }
+    RUBIK_LOG(EVT_STICKER_DRAG_TURN) << dx << dy << face << clockwise;
+    startRotation(face, clockwise);
 }
 
 // Callback xử lý chuyển động chuột khi đang kéo
 // Cập nhật góc xoay camera dựa trên độ dịch chuyển chuột
 void motion(int x, int y) {
+    if (s_stickerDrag) {
+        updateStickerDrag(x, y);
+        return;
+    }
+    
     // Chỉ xử lý khi đang kéo chuột
     if (!isDragging) {
         return;
@@ -245,28 +277,49 @@ void motion(int x, int y) {
     float yawDelta = (float)dx * ROTATION_SENSITIVITY;
     float pitchDelta = (float)(y - lastMouseY) * ROTATION_SENSITIVITY;
     
-    if (g_logFile != NULL) {
-        fprintf(g_logFile, "MOUSE: x=%d y=%d | dx=%d dy=%d | yawDelta=%.1f pitchDelta=%.1f\n", 
-                x, y, dx, dy, yawDelta, pitchDelta);
-        fflush(g_logFile);
-    }
+    RUBIK_LOG(EVT_MOUSE_MOTION) << x << y << dx << dy << yawDelta << pitchDelta;
     
     cameraAngleY += yawDelta;
     cameraAngleX += pitchDelta;
     
-    if (g_logFile != NULL) {
-        fprintf(g_logFile, "  → Updated angles: X=%.1f Y=%.1f\n", cameraAngleX, cameraAngleY);
-        fflush(g_logFile);
-    }
+    RUBIK_LOG(EVT_CAMERA_ANGLES) << cameraAngleX << cameraAngleY;
+    recordCameraChanged();
     
     lastMouseX = x;
     lastMouseY = y;
-    glutPostRedisplay();
+    requestRedisplay();
 }
 
-// Callback xử lý phím bấm
-// Điều khiển xoay các mặt cube và các chức năng khác
-void keyboard(unsigned char key, int /* x */, int /* y */) {
+// Xử lý phím bấm: điều khiển xoay các mặt cube và các chức năng khác
+static void handleKeyPress(unsigned char key) {
+    // Chế độ tường nhiều cube: các cube tự chạy, chỉ có phím phóng to/thu nhỏ
+    if (isCubeWallActive()) {
+        if (key == '+' || key == '=') {
+            zoomCubeWall(1.0f / WALL_ZOOM_STEP);
+        } else if (key == '-' || key == '_') {
+            zoomCubeWall(WALL_ZOOM_STEP);
+        }
+        return;
+    }
+    
+    // Phát lại phiên: chỉ có phím điều khiển phát lại (nước đi đến từ bản ghi)
+    if (isReplayActive()) {
+        if (key == ' ') {
+            toggleReplayPause();
+        } else if (key == ',' || key == '<') {
+            seekReplay(getReplayPositionSeconds() - REPLAY_SEEK_STEP_SECONDS);
+        } else if (key == '.' || key == '>') {
+            seekReplay(getReplayPositionSeconds() + REPLAY_SEEK_STEP_SECONDS);
+        } else if (key == '[') {
+            scaleReplaySpeed(0.5f);
+        } else if (key == ']') {
+            scaleReplaySpeed(2.0f);
+        } else if (key >= '0' && key <= '9') {
+            seekReplay(getReplayDurationSeconds() * (double)(key - '0') / 10.0);
+        }
+        return;
+    }
+    
     // Kiểm tra phím Shift có được giữ không
     int modifiers = glutGetModifiers();
     bool shiftDown = (modifiers & GLUT_ACTIVE_SHIFT) != 0;
@@ -306,12 +359,12 @@ void keyboard(unsigned char key, int /* x */, int /* y */) {
     switch (keyUpper) {
         case ' ':  // Phím Space: Reset cube về trạng thái đã giải
             resetCube();
-            glutPostRedisplay();
+            requestRedisplay();
             return;
             
         case 'S':  // Phím S: Trộn cube (20 bước ngẫu nhiên)
             shuffleCube(20);
-            glutPostRedisplay();
+            requestRedisplay();
             return;
             
         case 'F':  // Phím F: Xoay mặt Front (Shift+F = ngược chiều)
@@ -409,10 +462,19 @@ void keyboard(unsigned char key, int /* x */, int /* y */) {
     if (faceChanged) {
         currentFrontFace = newFace;
         updateRotationAxes();
-        glutPostRedisplay();
+        recordCameraChanged();
+        requestRedisplay();
     }
 }
 
+// Callback xử lý phím bấm; mốc thời gian lúc phím tới được gắn vào nước đi mà phím
+// này tạo ra (nếu có) để đo độ trễ tới lúc nước đi hiện lên màn hình
+void keyboard(unsigned char key, int /* x */, int /* y */) {
+    perfKeyArrived();
+    handleKeyPress(key);
+    perfKeyHandled();
+}
+
 void keyboardUp(unsigned char key, int /* x */, int /* y */) {
     int keyUpper = toupper((unsigned char)key);
     if (keyUpper < 0 || keyUpper >= 256) {
@@ -425,12 +487,50 @@ void keyboardUp(unsigned char key, int /* x */, int /* y */) {
 }
 
 // Callback xử lý phím đặc biệt (mũi tên, F1-F12, etc.)
-// Dùng phím mũi tên để xoay camera
+// Dùng phím mũi tên để xoay camera, F3 bật/tắt HUD hiệu năng, F4 ghi histogram,
+// F5 bắt đầu/dừng ghi profile, F7 ghi độ trễ phím -> màn hình
 void keyboardSpecial(int key, int /* x */, int /* y */) {
     const float ROTATION_STEP = KEYBOARD_ROTATION_SPEED;
     const char* keyName = "";
     
     switch (key) {
+        case GLUT_KEY_F3:
+            togglePerfHud();
+            RUBIK_LOG(EVT_PERF_HUD_TOGGLE) << (g_perfHudVisible ? "ON" : "OFF");
+            return;
+            
+        case GLUT_KEY_F5:
+            toggleProfileCapture();
+            return;
+            
+        case GLUT_KEY_F6:  // In trạng thái hiện tại (facelet + hex) để dán vào --state hoặc công cụ khác
+            printCurrentCubeState();
+            return;
+            
+        case GLUT_KEY_F4: {
+            // Mỗi lần ghi một file mới để so sánh trước/sau khi thay đổi
+            static int dumpIndex = 0;
+            char path[64];
+            sprintf(path, "rubik_perf_%d.txt", ++dumpIndex);
+            dumpPerfHistogram(path);
+            return;
+        }
+            
+        case GLUT_KEY_F7: {
+            static int latencyIndex = 0;
+            char path[64];
+            sprintf(path, "rubik_latency_%d.csv", ++latencyIndex);
+            if (dumpLatencyHistogram(path)) {
+                LatencyStats stats;
+                computeLatencyStats(stats);
+                printf("Độ trễ phím -> màn hình (%d nước): p50 %.1f p95 %.1f p99 %.1f max %.1f ms -> %s\n",
+                       stats.sampleCount, stats.p50Ms[LATENCY_SWAP], stats.p95Ms[LATENCY_SWAP],
+                       stats.p99Ms[LATENCY_SWAP], stats.maxMs[LATENCY_SWAP], path);
+            }
+            return;
+        }
+            
+
         case GLUT_KEY_UP:     // Mũi tên lên: xoay camera lên
             cameraAngleX -= ROTATION_STEP;
             keyName = "UP";
@@ -455,10 +555,8 @@ void keyboardSpecial(int key, int /* x */, int /* y */) {
             return;
     }
     
-    if (g_logFile != NULL) {
-        fprintf(g_logFile, "KEYBOARD: %s pressed | angleX=%.1f angleY=%.1f\n", keyName, cameraAngleX, cameraAngleY);
-        fflush(g_logFile);
-    }
+    RUBIK_LOG(EVT_KEY_PRESSED) << keyName << cameraAngleX << cameraAngleY;
+    recordCameraChanged();
     
-    glutPostRedisplay();
+    requestRedisplay();
 }
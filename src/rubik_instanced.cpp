@@ -0,0 +1,512 @@
+#include "rubik_instanced.h"
+#include "rubik_glext.h"
+#include "rubik_render.h"
+#include "rubik_state.h"
+#include "rubik_animation.h"
+#include "rubik_constants.h"
+#include "rubik_perf.h"
+#include "rubik_log.h"
+#include <cstdio>
+#include <cstddef>
+#include <cmath>
+
+// Location cố định của các attribute (gán bằng glBindAttribLocation)
+enum InstancedAttrib {
+    ATTRIB_POSITION = 0,   // Per-vertex: vị trí đỉnh
+    ATTRIB_FACE = 1,       // Per-vertex: chỉ số mặt (0-5) để chọn màu
+    ATTRIB_ROW0 = 2,       // Per-instance: 3 hàng của ma trận affine
+    ATTRIB_ROW1 = 3,
+    ATTRIB_ROW2 = 4,
+    ATTRIB_COLOR0 = 5,     // Per-instance: màu 6 mặt (5..10)
+    ATTRIB_COUNT = 11
+};
+
+static const char* const ATTRIB_NAMES[ATTRIB_COUNT] = {
+    "a_position", "a_face",
+    "a_row0", "a_row1", "a_row2",
+    "a_color0", "a_color1", "a_color2", "a_color3", "a_color4", "a_color5"
+};
+
+// Ma trận camera/projection lấy từ fixed-function (gl_ModelViewProjectionMatrix)
+// nên display() vẫn thiết lập camera như cũ.
+// Lớp đang xoay được chọn và xoay ngay trong shader: instance nào có tâm (cột
+// tịnh tiến của ma trận nghỉ) nằm phía ngoài mặt phẳng u_turnLayer thì được xoay
+// quanh u_turnAxis một góc có cos/sin là u_turnCosSin (công thức Rodrigues).
+// Khi không có animation, ngưỡng u_turnLayer.w đủ lớn để không instance nào bị chọn.
+static const char* VERTEX_SHADER_SOURCE =
+    "#version 120\n"
+    "uniform vec4 u_turnLayer;\n"
+    "uniform vec3 u_turnAxis;\n"
+    "uniform vec2 u_turnCosSin;\n"
+    "attribute vec3 a_position;\n"
+    "attribute float a_face;\n"
+    "attribute vec4 a_row0;\n"
+    "attribute vec4 a_row1;\n"
+    "attribute vec4 a_row2;\n"
+    "attribute vec4 a_color0;\n"
+    "attribute vec4 a_color1;\n"
+    "attribute vec4 a_color2;\n"
+    "attribute vec4 a_color3;\n"
+    "attribute vec4 a_color4;\n"
+    "attribute vec4 a_color5;\n"
+    "varying vec3 v_color;\n"
+    "void main() {\n"
+    "    vec4 local = vec4(a_position, 1.0);\n"
+    "    vec3 world = vec3(dot(a_row0, local), dot(a_row1, local), dot(a_row2, local));\n"
+    "    vec3 center = vec3(a_row0.w, a_row1.w, a_row2.w);\n"
+    "    if (dot(center, u_turnLayer.xyz) > u_turnLayer.w) {\n"
+    "        float c = u_turnCosSin.x;\n"
+    "        world = world * c + cross(u_turnAxis, world) * u_turnCosSin.y\n"
+    "              + u_turnAxis * dot(u_turnAxis, world) * (1.0 - c);\n"
+    "    }\n"
+    "    vec4 color = a_color0;\n"
+    "    if (a_face > 4.5) color = a_color5;\n"
+    "    else if (a_face > 3.5) color = a_color4;\n"
+    "    else if (a_face > 2.5) color = a_color3;\n"
+    "    else if (a_face > 1.5) color = a_color2;\n"
+    "    else if (a_face > 0.5) color = a_color1;\n"
+    "    v_color = color.rgb;\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * vec4(world, 1.0);\n"
+    "}\n";
+
+static const char* FRAGMENT_SHADER_SOURCE =
+    "#version 120\n"
+    "varying vec3 v_color;\n"
+    "void main() {\n"
+    "    gl_FragColor = vec4(v_color, 1.0);\n"
+    "}\n";
+
+// Chương trình LOD trung bình: cả cube là một hộp, mỗi mặt lấy 3x3 màu sticker
+// từ ô của cube trong atlas; khe giữa các sticker được vẽ bằng fragment shader
+enum LodAttrib {
+    LOD_ATTRIB_POSITION = 0,
+    LOD_ATTRIB_FACE = 1,
+    LOD_ATTRIB_UV = 2,          // Per-vertex: toạ độ trên mặt (0..1)
+    LOD_ATTRIB_ROW0 = 3,        // Per-instance: ma trận affine của cả cube
+    LOD_ATTRIB_ROW1 = 4,
+    LOD_ATTRIB_ROW2 = 5,
+    LOD_ATTRIB_ATLAS = 6,       // Per-instance: góc ô của cube trong atlas (texel)
+    LOD_ATTRIB_COUNT = 7
+};
+
+static const char* const LOD_ATTRIB_NAMES[LOD_ATTRIB_COUNT] = {
+    "a_position", "a_face", "a_uv", "a_row0", "a_row1", "a_row2", "a_atlas"
+};
+
+static const char* LOD_VERTEX_SHADER_SOURCE =
+    "#version 120\n"
+    "attribute vec3 a_position;\n"
+    "attribute float a_face;\n"
+    "attribute vec2 a_uv;\n"
+    "attribute vec4 a_row0;\n"
+    "attribute vec4 a_row1;\n"
+    "attribute vec4 a_row2;\n"
+    "attribute vec2 a_atlas;\n"
+    "varying vec2 v_cell;\n"
+    "varying vec2 v_base;\n"
+    "void main() {\n"
+    "    vec4 local = vec4(a_position, 1.0);\n"
+    "    vec4 world = vec4(dot(a_row0, local), dot(a_row1, local), dot(a_row2, local), 1.0);\n"
+    "    v_cell = a_uv * 3.0;\n"
+    "    v_base = a_atlas + vec2(a_face * 3.0, 0.0);\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * world;\n"
+    "}\n";
+
+static const char* LOD_FRAGMENT_SHADER_SOURCE =
+    "#version 120\n"
+    "uniform sampler2D u_atlas;\n"
+    "uniform vec2 u_atlasScale;\n"
+    "uniform float u_gap;\n"
+    "varying vec2 v_cell;\n"
+    "varying vec2 v_base;\n"
+    "void main() {\n"
+    "    vec2 cell = min(floor(v_cell), vec2(2.0));\n"
+    "    vec2 inCell = v_cell - cell;\n"
+    "    vec3 color = texture2D(u_atlas, (v_base + cell + 0.5) * u_atlasScale).rgb;\n"
+    "    float edge = min(min(inCell.x, 1.0 - inCell.x), min(inCell.y, 1.0 - inCell.y));\n"
+    "    if (edge < u_gap) color = vec3(0.1);\n"
+    "    gl_FragColor = vec4(color, 1.0);\n"
+    "}\n";
+
+// Đỉnh của hình học một mảnh (6 mặt x 2 tam giác)
+struct PieceVertex {
+    float position[3];
+    float face;
+};
+
+static const int PIECE_VERTEX_COUNT = 36;
+
+// Đỉnh của hộp LOD (thêm toạ độ trên mặt để tra sticker)
+struct LodVertex {
+    float position[3];
+    float face;
+    float uv[2];
+};
+
+// 4 góc của mỗi mặt theo thứ tự của drawCubePiece (đơn vị: +-1)
+// Cạnh góc 0 -> góc 1 là trục u, góc 0 -> góc 3 là trục v của mặt
+static const float FACE_CORNERS[6][4][3] = {
+    {{-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1}},        // Trước (Z+)
+    {{1, -1, -1}, {-1, -1, -1}, {-1, 1, -1}, {1, 1, -1}},    // Sau (Z-)
+    {{-1, -1, -1}, {-1, -1, 1}, {-1, 1, 1}, {-1, 1, -1}},    // Trái (X-)
+    {{1, -1, 1}, {1, -1, -1}, {1, 1, -1}, {1, 1, 1}},        // Phải (X+)
+    {{-1, 1, 1}, {1, 1, 1}, {1, 1, -1}, {-1, 1, -1}},        // Trên (Y+)
+    {{-1, -1, -1}, {1, -1, -1}, {1, -1, 1}, {-1, -1, 1}}     // Dưới (Y-)
+};
+
+// Mỗi quad tách thành 2 tam giác (0,1,2) và (0,2,3)
+static const int QUAD_TO_TRIANGLES[6] = {0, 1, 2, 0, 2, 3};
+
+// Pháp tuyến ngoài của 6 mặt (cùng thứ tự enum Face): chọn lớp đang xoay trong shader
+static const float FACE_NORMALS[6][3] = {
+    {0, 0, 1}, {0, 0, -1}, {-1, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, -1, 0}
+};
+
+static GLuint s_program = 0;
+static GLint s_turnLayerLocation = -1;
+static GLint s_turnAxisLocation = -1;
+static GLint s_turnCosSinLocation = -1;
+static GLuint s_vertexBuffer = 0;
+static GLuint s_instanceBuffer = 0;
+static GLuint s_streamBuffer = 0;      // Buffer instance của drawPieceInstances (ghi lại mỗi frame)
+static int s_streamCapacity = 0;
+static bool s_ready = false;
+
+static GLuint s_lodProgram = 0;
+static GLuint s_lodVertexBuffer = 0;
+static GLuint s_lodStreamBuffer = 0;
+static int s_lodStreamCapacity = 0;
+static GLint s_lodAtlasScaleLocation = -1;
+static GLint s_lodGapLocation = -1;
+static bool s_lodReady = false;
+
+// Cache dữ liệu instance: transform ở vị trí nghỉ của mọi mảnh, chỉ upload lại
+// khi trạng thái hiển thị đổi (một nước đi vừa hoàn tất). Trong lúc animation
+// buffer không đổi, mỗi frame chỉ cập nhật vài uniform của lớp đang xoay
+static PieceInstance s_instances[27];
+static int s_instanceCount = 0;
+static int s_cacheVersion = -1;
+
+// Tạo 36 đỉnh của một mảnh, cùng thứ tự mặt và đỉnh với drawCubePiece()
+static void buildPieceGeometry(PieceVertex vertices[36], float halfSize) {
+    int v = 0;
+    for (int face = 0; face < 6; face++) {
+        for (int t = 0; t < 6; t++) {
+            const float* corner = FACE_CORNERS[face][QUAD_TO_TRIANGLES[t]];
+            vertices[v].position[0] = corner[0] * halfSize;
+            vertices[v].position[1] = corner[1] * halfSize;
+            vertices[v].position[2] = corner[2] * halfSize;
+            vertices[v].face = (float)face;
+            v++;
+        }
+    }
+}
+
+// Hộp LOD: 36 đỉnh như một mảnh nhưng mang thêm toạ độ (u, v) của góc trên mặt
+static void buildLodGeometry(LodVertex vertices[36], float halfSize) {
+    static const float cornerUV[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    int v = 0;
+    for (int face = 0; face < 6; face++) {
+        for (int t = 0; t < 6; t++) {
+            int corner = QUAD_TO_TRIANGLES[t];
+            for (int c = 0; c < 3; c++) {
+                vertices[v].position[c] = FACE_CORNERS[face][corner][c] * halfSize;
+            }
+            vertices[v].face = (float)face;
+            vertices[v].uv[0] = cornerUV[corner][0];
+            vertices[v].uv[1] = cornerUV[corner][1];
+            v++;
+        }
+    }
+}
+
+// Chương trình và hình học của LOD hộp dán texture (không bắt buộc: nếu lỗi,
+// các cube ở mức này được vẽ đầy đủ)
+static void initCubeLodRenderer() {
+    s_lodProgram = createShaderProgram(LOD_VERTEX_SHADER_SOURCE, LOD_FRAGMENT_SHADER_SOURCE,
+                                       LOD_ATTRIB_NAMES, LOD_ATTRIB_COUNT);
+    if (s_lodProgram == 0) {
+        return;
+    }
+    s_lodAtlasScaleLocation = pglGetUniformLocation(s_lodProgram, "u_atlasScale");
+    s_lodGapLocation = pglGetUniformLocation(s_lodProgram, "u_gap");
+
+    const float spacing = PIECE_SIZE + GAP_SIZE;
+    LodVertex vertices[PIECE_VERTEX_COUNT];
+    buildLodGeometry(vertices, spacing * 1.5f - GAP_SIZE * 0.5f);
+    pglGenBuffers(1, &s_lodVertexBuffer);
+    pglBindBuffer(GL_ARRAY_BUFFER, s_lodVertexBuffer);
+    pglBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    pglBindBuffer(GL_ARRAY_BUFFER, 0);
+    s_lodReady = true;
+}
+
+bool initInstancedRenderer() {
+    s_ready = false;
+    if (!g_glInstancingSupported) {
+        return false;
+    }
+
+    s_program = createShaderProgram(VERTEX_SHADER_SOURCE, FRAGMENT_SHADER_SOURCE,
+                                    ATTRIB_NAMES, ATTRIB_COUNT);
+    if (s_program == 0) {
+        return false;
+    }
+    s_turnLayerLocation = pglGetUniformLocation(s_program, "u_turnLayer");
+    s_turnAxisLocation = pglGetUniformLocation(s_program, "u_turnAxis");
+    s_turnCosSinLocation = pglGetUniformLocation(s_program, "u_turnCosSin");
+
+    // Hình học một mảnh: upload một lần, không bao giờ thay đổi
+    PieceVertex vertices[PIECE_VERTEX_COUNT];
+    buildPieceGeometry(vertices, PIECE_SIZE * 0.5f);
+    pglGenBuffers(1, &s_vertexBuffer);
+    pglBindBuffer(GL_ARRAY_BUFFER, s_vertexBuffer);
+    pglBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    // Buffer instance: 27 mảnh ở vị trí nghỉ, chỉ đổi khi nước đi hoàn tất
+    pglGenBuffers(1, &s_instanceBuffer);
+    pglBindBuffer(GL_ARRAY_BUFFER, s_instanceBuffer);
+    pglBufferData(GL_ARRAY_BUFFER, sizeof(PieceInstance) * 27, NULL, GL_DYNAMIC_DRAW);
+    pglBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    initCubeLodRenderer();
+
+    s_cacheVersion = -1;
+    s_ready = true;
+    RUBIK_LOG(EVT_INSTANCED_READY);
+    return true;
+}
+
+bool isInstancedRendererReady() {
+    return s_ready;
+}
+
+bool isCubeLodRendererReady() {
+    return s_ready && s_lodReady;
+}
+
+void getStickerCell(int face, const int grid[3], int& u, int& v) {
+    const float* c0 = FACE_CORNERS[face][0];
+    const float* c1 = FACE_CORNERS[face][1];
+    const float* c3 = FACE_CORNERS[face][3];
+    float du = 0.0f;
+    float dv = 0.0f;
+    for (int c = 0; c < 3; c++) {
+        du += (float)grid[c] * (c1[c] - c0[c]) * 0.5f;
+        dv += (float)grid[c] * (c3[c] - c0[c]) * 0.5f;
+    }
+    u = (int)du + 1;
+    v = (int)dv + 1;
+}
+
+void packPieceColors(const CubePiece& piece, unsigned char colors[6][4]) {
+    for (int face = 0; face < 6; face++) {
+        for (int c = 0; c < 3; c++) {
+            float value = piece.colors[face][c];
+            if (value < 0.0f) {
+                value = 0.0f;
+            } else if (value > 1.0f) {
+                value = 1.0f;
+            }
+            colors[face][c] = (unsigned char)(value * 255.0f + 0.5f);
+        }
+        colors[face][3] = 255;
+    }
+}
+
+// Gắn các attribute per-vertex và per-instance vào buffer tương ứng
+static void bindInstancedAttributes(GLuint instanceBuffer) {
+    pglBindBuffer(GL_ARRAY_BUFFER, s_vertexBuffer);
+    pglEnableVertexAttribArray(ATTRIB_POSITION);
+    pglVertexAttribPointer(ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(PieceVertex),
+                           (const void*)offsetof(PieceVertex, position));
+    pglEnableVertexAttribArray(ATTRIB_FACE);
+    pglVertexAttribPointer(ATTRIB_FACE, 1, GL_FLOAT, GL_FALSE, sizeof(PieceVertex),
+                           (const void*)offsetof(PieceVertex, face));
+
+    pglBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    for (int row = 0; row < 3; row++) {
+        GLuint location = (GLuint)(ATTRIB_ROW0 + row);
+        pglEnableVertexAttribArray(location);
+        pglVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(PieceInstance),
+                               (const void*)(offsetof(PieceInstance, transform) + row * 4 * sizeof(float)));
+        pglVertexAttribDivisor(location, 1);
+    }
+    for (int face = 0; face < 6; face++) {
+        GLuint location = (GLuint)(ATTRIB_COLOR0 + face);
+        pglEnableVertexAttribArray(location);
+        pglVertexAttribPointer(location, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PieceInstance),
+                               (const void*)(offsetof(PieceInstance, colors) + face * 4));
+        pglVertexAttribDivisor(location, 1);
+    }
+}
+
+static void unbindInstancedAttributes() {
+    for (int location = 0; location < ATTRIB_COUNT; location++) {
+        if (location >= ATTRIB_ROW0) {
+            pglVertexAttribDivisor((GLuint)location, 0);
+        }
+        pglDisableVertexAttribArray((GLuint)location);
+    }
+    pglBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Đặt uniform của lớp đang xoay: chỉ các instance có tâm phía ngoài mặt phẳng
+// (pháp tuyến của mặt, ngưỡng nửa khoảng cách giữa hai mảnh) bị xoay.
+// Không có lớp nào (layerFace < 0) thì ngưỡng vô cùng lớn, shader không xoay gì
+static void setTurnUniforms(int layerFace, const float axis[3], float angleDegrees) {
+    if (layerFace < 0) {
+        pglUniform4f(s_turnLayerLocation, 0.0f, 0.0f, 0.0f, 1.0e30f);
+        pglUniform3f(s_turnAxisLocation, 0.0f, 0.0f, 1.0f);
+        pglUniform2f(s_turnCosSinLocation, 1.0f, 0.0f);
+        return;
+    }
+    const float* normal = FACE_NORMALS[layerFace];
+    const float spacing = g_visualCube.pieceSize + g_visualCube.gapSize;
+    float radians = angleDegrees * (float)(3.14159265358979323846 / 180.0);
+    pglUniform4f(s_turnLayerLocation, normal[0], normal[1], normal[2], spacing * 0.5f);
+    pglUniform3f(s_turnAxisLocation, axis[0], axis[1], axis[2]);
+    pglUniform2f(s_turnCosSinLocation, cosf(radians), sinf(radians));
+}
+
+// Dựng lại toàn bộ cache instance ở vị trí nghỉ và upload (khi nước đi hoàn tất)
+static void rebuildInstanceCache() {
+    const float spacing = g_visualCube.pieceSize + g_visualCube.gapSize;
+    s_instanceCount = 0;
+    for (int i = 0; i < 27; i++) {
+        const CubePiece& piece = g_visualCube.pieces[i];
+        if (!piece.isVisible) {
+            continue;
+        }
+        PieceInstance& instance = s_instances[s_instanceCount];
+        for (int row = 0; row < 3; row++) {
+            for (int col = 0; col < 3; col++) {
+                instance.transform[row * 4 + col] = row == col ? 1.0f : 0.0f;
+            }
+            instance.transform[row * 4 + 3] = (float)piece.position[row] * spacing;
+        }
+        packPieceColors(piece, instance.colors);
+        s_instanceCount++;
+    }
+    if (s_instanceCount > 0) {
+        pglBindBuffer(GL_ARRAY_BUFFER, s_instanceBuffer);
+        pglBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(PieceInstance) * s_instanceCount, s_instances);
+    }
+    s_cacheVersion = g_visualCubeVersion;
+}
+
+void drawRubikCubeInstanced() {
+    if (!s_ready) {
+        return;
+    }
+
+    if (s_cacheVersion != g_visualCubeVersion) {
+        rebuildInstanceCache();
+    }
+    if (s_instanceCount == 0) {
+        return;
+    }
+
+    pglUseProgram(s_program);
+    if (g_animation.isActive) {
+        float axis[3];
+        float angle = getAnimationRotation(axis);
+        setTurnUniforms((int)g_animation.face, axis, angle);
+    } else {
+        setTurnUniforms(-1, NULL, 0.0f);
+    }
+    bindInstancedAttributes(s_instanceBuffer);
+    pglDrawArraysInstanced(GL_TRIANGLES, 0, PIECE_VERTEX_COUNT, s_instanceCount);
+    perfCountDraw(PIECE_VERTEX_COUNT * s_instanceCount);
+    unbindInstancedAttributes();
+    pglUseProgram(0);
+}
+
+void drawPieceInstances(const PieceInstance* instances, int count) {
+    if (!s_ready || count <= 0) {
+        return;
+    }
+
+    // Cấp lại vùng nhớ (orphan) trước khi ghi để driver không phải chờ frame trước vẽ xong
+    if (s_streamBuffer == 0) {
+        pglGenBuffers(1, &s_streamBuffer);
+    }
+    pglBindBuffer(GL_ARRAY_BUFFER, s_streamBuffer);
+    if (count > s_streamCapacity) {
+        s_streamCapacity = count;
+    }
+    pglBufferData(GL_ARRAY_BUFFER, sizeof(PieceInstance) * s_streamCapacity, NULL, GL_STREAM_DRAW);
+    pglBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(PieceInstance) * count, instances);
+
+    // Transform của từng cube đã gồm cả lớp đang xoay (mỗi cube một góc riêng)
+    pglUseProgram(s_program);
+    setTurnUniforms(-1, NULL, 0.0f);
+    bindInstancedAttributes(s_streamBuffer);
+    pglDrawArraysInstanced(GL_TRIANGLES, 0, PIECE_VERTEX_COUNT, count);
+    perfCountDraw(PIECE_VERTEX_COUNT * count);
+    unbindInstancedAttributes();
+    pglUseProgram(0);
+}
+
+void drawCubeLodInstances(const CubeLodInstance* instances, int count,
+                          unsigned int atlasTexture, int atlasWidth, int atlasHeight) {
+    if (!s_ready || !s_lodReady || count <= 0) {
+        return;
+    }
+
+    if (s_lodStreamBuffer == 0) {
+        pglGenBuffers(1, &s_lodStreamBuffer);
+    }
+    pglBindBuffer(GL_ARRAY_BUFFER, s_lodStreamBuffer);
+    if (count > s_lodStreamCapacity) {
+        s_lodStreamCapacity = count;
+    }
+    pglBufferData(GL_ARRAY_BUFFER, sizeof(CubeLodInstance) * s_lodStreamCapacity, NULL, GL_STREAM_DRAW);
+    pglBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(CubeLodInstance) * count, instances);
+
+    pglUseProgram(s_lodProgram);
+    pglUniform2f(s_lodAtlasScaleLocation, 1.0f / (float)atlasWidth, 1.0f / (float)atlasHeight);
+    // Nửa khe giữa hai sticker, tính theo bề rộng một ô sticker trên mặt hộp
+    const float cellWidth = (3.0f * (PIECE_SIZE + GAP_SIZE) - GAP_SIZE) / 3.0f;
+    pglUniform1f(s_lodGapLocation, GAP_SIZE * 0.5f / cellWidth);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+
+    pglBindBuffer(GL_ARRAY_BUFFER, s_lodVertexBuffer);
+    pglEnableVertexAttribArray(LOD_ATTRIB_POSITION);
+    pglVertexAttribPointer(LOD_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(LodVertex),
+                           (const void*)offsetof(LodVertex, position));
+    pglEnableVertexAttribArray(LOD_ATTRIB_FACE);
+    pglVertexAttribPointer(LOD_ATTRIB_FACE, 1, GL_FLOAT, GL_FALSE, sizeof(LodVertex),
+                           (const void*)offsetof(LodVertex, face));
+    pglEnableVertexAttribArray(LOD_ATTRIB_UV);
+    pglVertexAttribPointer(LOD_ATTRIB_UV, 2, GL_FLOAT, GL_FALSE, sizeof(LodVertex),
+                           (const void*)offsetof(LodVertex, uv));
+
+    pglBindBuffer(GL_ARRAY_BUFFER, s_lodStreamBuffer);
+    for (int row = 0; row < 3; row++) {
+        GLuint location = (GLuint)(LOD_ATTRIB_ROW0 + row);
+        pglEnableVertexAttribArray(location);
+        pglVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(CubeLodInstance),
+                               (const void*)(offsetof(CubeLodInstance, transform) + row * 4 * sizeof(float)));
+        pglVertexAttribDivisor(location, 1);
+    }
+    pglEnableVertexAttribArray(LOD_ATTRIB_ATLAS);
+    pglVertexAttribPointer(LOD_ATTRIB_ATLAS, 2, GL_FLOAT, GL_FALSE, sizeof(CubeLodInstance),
+                           (const void*)offsetof(CubeLodInstance, atlasOrigin));
+    pglVertexAttribDivisor(LOD_ATTRIB_ATLAS, 1);
+
+    pglDrawArraysInstanced(GL_TRIANGLES, 0, PIECE_VERTEX_COUNT, count);
+    perfCountDraw(PIECE_VERTEX_COUNT * count);
+
+    for (int location = 0; location < LOD_ATTRIB_COUNT; location++) {
+        if (location >= LOD_ATTRIB_ROW0) {
+            pglVertexAttribDivisor((GLuint)location, 0);
+        }
+        pglDisableVertexAttribArray((GLuint)location);
+    }
+    pglBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+    pglUseProgram(0);
+}
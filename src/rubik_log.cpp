@@ -0,0 +1,520 @@
+#include "rubik_log.h"
+#include "rubik_constants.h"
+#include "rubik_clock.h"
+#include "rubik_thread.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#if defined(_MSC_VER) && !defined(snprintf)
+#define snprintf _snprintf
+#endif
+
+volatile int g_logLevelLimit = -1;
+volatile int g_logCategoryMask = LOG_CAT_ALL;
+
+// Một ô của vòng đệm. sequence cho biết ô đang ở vòng nào: bằng vị trí ghi khi
+// ô trống, bằng vị trí + 1 khi bản ghi đã sẵn sàng cho luồng đọc
+struct LogSlot {
+    volatile int sequence;
+    TraceRecord record;
+};
+
+// Đầu file trace (64 byte), để bộ giải mã nhận ra file và bảng sự kiện đã dùng
+struct TraceFileHeader {
+    char magic[8];                 // "RBKTRACE"
+    unsigned int version;          // TRACE_FORMAT_VERSION
+    unsigned int recordSize;       // sizeof(TraceRecord)
+    unsigned int eventCount;       // LOG_EVENT_COUNT
+    unsigned int eventTableHash;   // FNV-1a của mọi format trong bảng sự kiện
+    char startTime[40];
+};
+
+static const char TRACE_MAGIC[8] = {'R', 'B', 'K', 'T', 'R', 'A', 'C', 'E'};
+
+static const char* const EVENT_FORMATS[] = {
+#define LOG_EVENT(name, level, category, format) format,
+#include "rubik_log_events.h"
+#undef LOG_EVENT
+};
+
+static const int LOG_RING_MASK = LOG_RING_CAPACITY - 1;
+
+static LogSlot s_ring[LOG_RING_CAPACITY];
+static volatile int s_enqueuePos = 0;
+static int s_dequeuePos = 0;             // Chỉ luồng ghi đọc/ghi
+static volatile int s_droppedCount = 0;
+static int s_reportedDrops = 0;
+
+static FILE* s_logFile = NULL;
+static RubikThread s_writerThread;
+static volatile int s_writerRunning = 0;
+static bool s_writerStarted = false;
+
+// Luồng ghi ngủ trên biến điều kiện khi vòng đệm rỗng (không thức theo chu kỳ).
+// s_writerWaiting = 1 trong lúc nó chờ; luồng gọi đầu tiên đưa bản ghi vào lúc đó
+// đổi cờ về 0 và đánh thức nó, các luồng gọi khác chỉ tốn một phép đọc cờ
+static RubikMutex s_writerMutex;
+static RubikCondition s_writerCondition;
+static volatile int s_writerWaiting = 0;
+
+static TraceRecord s_batch[LOG_BATCH_RECORDS];
+static int s_batchCount = 0;
+
+static unsigned int computeEventTableHash() {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < LOG_EVENT_COUNT; i++) {
+        for (const char* p = EVENT_FORMATS[i]; ; p++) {
+            hash = (hash ^ (unsigned char)*p) * 16777619u;
+            if (*p == '\0') {
+                break;
+            }
+        }
+    }
+    return hash;
+}
+
+// ----------------------------------------------------------------------------
+// Luồng gọi
+// ----------------------------------------------------------------------------
+
+void submitTraceRecord(TraceRecord& record) {
+    // Giành một ô (Vyukov bounded queue): ô trống có sequence == vị trí
+    int pos = atomicLoad(&s_enqueuePos);
+    LogSlot* slot;
+    for (;;) {
+        slot = &s_ring[pos & LOG_RING_MASK];
+        int diff = (int)((unsigned int)atomicLoad(&slot->sequence) - (unsigned int)pos);
+        if (diff == 0) {
+            if (atomicCompareExchange(&s_enqueuePos, pos, pos + 1)) {
+                break;
+            }
+            pos = atomicLoad(&s_enqueuePos);
+        } else if (diff < 0) {
+            // Vòng đệm đầy: bỏ bản ghi thay vì chờ luồng ghi
+            atomicAdd(&s_droppedCount, 1);
+            return;
+        } else {
+            pos = atomicLoad(&s_enqueuePos);
+        }
+    }
+
+    record.timeNanos = clockNowNanos();
+    slot->record = record;
+    atomicStore(&slot->sequence, pos + 1);
+
+    if (atomicLoad(&s_writerWaiting) != 0 && atomicCompareExchange(&s_writerWaiting, 1, 0)) {
+        lockMutex(s_writerMutex);
+        signalCondition(s_writerCondition);
+        unlockMutex(s_writerMutex);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Luồng ghi
+// ----------------------------------------------------------------------------
+
+static void flushBatch() {
+    if (s_batchCount > 0 && s_logFile != NULL) {
+        fwrite(s_batch, sizeof(TraceRecord), s_batchCount, s_logFile);
+        fflush(s_logFile);
+    }
+    s_batchCount = 0;
+}
+
+static void appendBatch(const TraceRecord& record) {
+    if (s_batchCount == LOG_BATCH_RECORDS) {
+        flushBatch();
+    }
+    s_batch[s_batchCount++] = record;
+}
+
+// Lấy mọi bản ghi đã sẵn sàng, trả về số bản ghi đã xử lý
+static int drainRing() {
+    int processed = 0;
+    for (;;) {
+        LogSlot& slot = s_ring[s_dequeuePos & LOG_RING_MASK];
+        if (atomicLoad(&slot.sequence) != s_dequeuePos + 1) {
+            break;
+        }
+        appendBatch(slot.record);
+        // Trả ô cho vòng kế tiếp của luồng gọi
+        atomicStore(&slot.sequence, s_dequeuePos + LOG_RING_CAPACITY);
+        s_dequeuePos++;
+        processed++;
+    }
+
+    // Báo số bản ghi bị bỏ bằng một bản ghi đưa thẳng vào lô (không qua vòng đệm)
+    int dropped = atomicLoad(&s_droppedCount);
+    if (dropped != s_reportedDrops) {
+        TraceRecord record;
+        memset(&record, 0, sizeof(record));
+        record.eventId = EVT_LOG_DROPPED;
+        record.valueCount = 1;
+        record.textLength = TRACE_NO_TEXT;
+        record.timeNanos = clockNowNanos();
+        int count = dropped - s_reportedDrops;
+        memcpy(record.payload, &count, 4);
+        appendBatch(record);
+        s_reportedDrops = dropped;
+    }
+    return processed;
+}
+
+static bool isRingEmpty() {
+    return atomicLoad(&s_ring[s_dequeuePos & LOG_RING_MASK].sequence) != s_dequeuePos + 1;
+}
+
+static void logWriterThread(void*) {
+    while (atomicLoad(&s_writerRunning)) {
+        drainRing();
+        flushBatch();
+        // Đặt cờ trước khi xem lại vòng đệm: bản ghi đến sau lần xem này chắc chắn
+        // thấy cờ và đánh thức luồng ghi
+        lockMutex(s_writerMutex);
+        atomicStore(&s_writerWaiting, 1);
+        while (atomicLoad(&s_writerWaiting) != 0 && atomicLoad(&s_writerRunning) && isRingEmpty()) {
+            waitCondition(s_writerCondition, s_writerMutex);
+        }
+        atomicStore(&s_writerWaiting, 0);
+        unlockMutex(s_writerMutex);
+    }
+    // Dừng: ghi nốt những gì luồng gọi đã kịp đưa vào
+    drainRing();
+    flushBatch();
+}
+
+// ----------------------------------------------------------------------------
+// Cấu hình
+// ----------------------------------------------------------------------------
+
+static const char* const LEVEL_NAMES[] = {"error", "warn", "info", "debug", "trace"};
+
+static const char* const CATEGORY_NAMES[] = {"general", "move", "input", "render", "timer", "io"};
+
+static bool nameEquals(const char* begin, int length, const char* name) {
+    return (int)strlen(name) == length && strncmp(begin, name, length) == 0;
+}
+
+static void loadLogConfig() {
+    const char* level = getenv("RUBIK_LOG_LEVEL");
+    if (level != NULL && level[0] != '\0') {
+        for (int i = 0; i < 5; i++) {
+            if (strcmp(level, LEVEL_NAMES[i]) == 0) {
+                g_logLevelLimit = i;
+            }
+        }
+    }
+
+    const char* categories = getenv("RUBIK_LOG_CATEGORIES");
+    if (categories != NULL && categories[0] != '\0') {
+        int mask = 0;
+        const char* p = categories;
+        while (*p != '\0') {
+            const char* end = p;
+            while (*end != '\0' && *end != ',') {
+                end++;
+            }
+            int length = (int)(end - p);
+            if (nameEquals(p, length, "all")) {
+                mask |= LOG_CAT_ALL;
+            }
+            for (int i = 0; i < 6; i++) {
+                if (nameEquals(p, length, CATEGORY_NAMES[i])) {
+                    mask |= 1 << i;
+                }
+            }
+            p = *end == ',' ? end + 1 : end;
+        }
+        g_logCategoryMask = mask;
+    }
+}
+
+void setLogLevel(LogLevel level) {
+    if (s_logFile != NULL) {
+        g_logLevelLimit = (int)level;
+    }
+}
+
+LogLevel getLogLevel() {
+    return g_logLevelLimit < 0 ? LOG_ERROR : (LogLevel)g_logLevelLimit;
+}
+
+void setLogCategories(unsigned int mask) {
+    g_logCategoryMask = (int)mask;
+}
+
+unsigned int getLogCategories() {
+    return (unsigned int)g_logCategoryMask;
+}
+
+int getLogDroppedCount() {
+    return atomicLoad(&s_droppedCount);
+}
+
+// ----------------------------------------------------------------------------
+// Mở / đóng
+// ----------------------------------------------------------------------------
+
+void initLogFile() {
+#if RUBIK_LOG_COMPILE_LEVEL < 0
+    // Bản release không còn lời gọi log nào: không tạo file trace, không khởi động
+    // luồng ghi và không đăng ký hook thoát (closeLogFile thấy s_logFile == NULL)
+    return;
+#endif
+    s_logFile = fopen("rubik_debug.trace", "wb");
+    if (s_logFile == NULL) {
+        return;
+    }
+
+    TraceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_FORMAT_VERSION;
+    header.recordSize = sizeof(TraceRecord);
+    header.eventCount = LOG_EVENT_COUNT;
+    header.eventTableHash = computeEventTableHash();
+    time_t rawTime;
+    time(&rawTime);
+    strftime(header.startTime, sizeof(header.startTime), "%Y-%m-%d %H:%M:%S", localtime(&rawTime));
+    fwrite(&header, sizeof(header), 1, s_logFile);
+    fflush(s_logFile);
+
+    for (int i = 0; i < LOG_RING_CAPACITY; i++) {
+        s_ring[i].sequence = i;
+    }
+    s_enqueuePos = 0;
+    s_dequeuePos = 0;
+    s_droppedCount = 0;
+    s_reportedDrops = 0;
+
+    g_logLevelLimit = LOG_DEBUG;
+    loadLogConfig();
+
+    static bool writerSyncInitialized = false;
+    if (!writerSyncInitialized) {
+        initMutex(s_writerMutex);
+        initCondition(s_writerCondition);
+        writerSyncInitialized = true;
+    }
+    s_writerWaiting = 0;
+    s_writerRunning = 1;
+    s_writerStarted = startThread(s_writerThread, logWriterThread, NULL);
+    if (!s_writerStarted) {
+        // Không có luồng ghi thì không ai đọc vòng đệm: tắt log
+        fprintf(stderr, "LỖI: không tạo được luồng ghi log\n");
+        g_logLevelLimit = -1;
+        return;
+    }
+    // Đóng cửa sổ GLUT kết thúc chương trình bằng exit(): vẫn ghi nốt vòng đệm
+    static bool exitHookRegistered = false;
+    if (!exitHookRegistered) {
+        atexit(closeLogFile);
+        exitHookRegistered = true;
+    }
+}
+
+void closeLogFile() {
+    if (s_logFile == NULL) {
+        return;
+    }
+    g_logLevelLimit = -1;
+    if (s_writerStarted) {
+        atomicStore(&s_writerRunning, 0);
+        lockMutex(s_writerMutex);
+        signalCondition(s_writerCondition);
+        unlockMutex(s_writerMutex);
+        joinThread(s_writerThread);
+        s_writerStarted = false;
+    }
+    fclose(s_logFile);
+    s_logFile = NULL;
+}
+
+// ----------------------------------------------------------------------------
+// Giải mã (--decode-log)
+// ----------------------------------------------------------------------------
+
+static const char* const FACE_NAMES[] = {"FRONT", "BACK", "LEFT", "RIGHT", "UP", "DOWN"};
+
+static bool isIntegerConversion(char c) {
+    return c == 'd' || c == 'i' || c == 'u' || c == 'x' || c == 'X' || c == 'o' || c == 'c';
+}
+
+static bool isRealConversion(char c) {
+    return c == 'f' || c == 'e' || c == 'E' || c == 'g' || c == 'G';
+}
+
+// Dựng lại một dòng: đi qua format, mỗi đặc tả lấy ô số kế tiếp (ép sang kiểu
+// đặc tả cần) hoặc chuỗi của bản ghi, rồi định dạng riêng bằng snprintf
+static int formatTraceRecord(const TraceRecord& record, char* out, int size) {
+    int length = snprintf(out, size, "[%010.3f ms] ", clockNanosToMs(record.timeNanos));
+    if (record.eventId >= LOG_EVENT_COUNT) {
+        length += snprintf(out + length, size - length, "EVENT #%d (không có trong bảng sự kiện)", record.eventId);
+        out[length++] = '\n';
+        out[length] = '\0';
+        return length;
+    }
+
+    char text[TRACE_PAYLOAD_BYTES + 1];
+    text[0] = '\0';
+    int textOffset = record.valueCount * 4;
+    if (record.textLength != TRACE_NO_TEXT && textOffset + record.textLength <= TRACE_PAYLOAD_BYTES) {
+        memcpy(text, record.payload + textOffset, record.textLength);
+        text[record.textLength] = '\0';
+    }
+
+    int valueIndex = 0;
+    const char* p = EVENT_FORMATS[record.eventId];
+    while (*p != '\0' && length < size - 2) {
+        if (*p != '%') {
+            out[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Gom cờ/độ rộng/độ chính xác của đặc tả
+        char spec[32];
+        int specLength = 0;
+        spec[specLength++] = *p++;
+        while (*p != '\0' && strchr("-+ #0123456789.", *p) != NULL && specLength < 24) {
+            spec[specLength++] = *p++;
+        }
+        char conversion = *p;
+        if (conversion == '\0') {
+            break;
+        }
+        p++;
+        spec[specLength++] = conversion == 'F' || conversion == 'R' ? 's' : conversion;
+        spec[specLength] = '\0';
+
+        int room = size - length;
+        int written = 0;
+        if (conversion == 's') {
+            written = snprintf(out + length, room, spec, text);
+        } else if (valueIndex >= record.valueCount) {
+            written = snprintf(out + length, room, "?");
+        } else {
+            int index = valueIndex++;
+            int integerValue;
+            double realValue;
+            if ((record.wideMask & (1 << index)) != 0 && index + 1 < record.valueCount) {
+                memcpy(&realValue, record.payload + index * 4, 8);
+                integerValue = (int)realValue;
+                valueIndex++;
+            } else if ((record.realMask & (1 << index)) != 0) {
+                float narrowValue;
+                memcpy(&narrowValue, record.payload + index * 4, 4);
+                realValue = narrowValue;
+                integerValue = (int)narrowValue;
+            } else {
+                memcpy(&integerValue, record.payload + index * 4, 4);
+                realValue = (double)integerValue;
+            }
+
+            if (conversion == 'F') {
+                bool valid = integerValue >= 0 && integerValue < 6;
+                written = snprintf(out + length, room, spec, valid ? FACE_NAMES[integerValue] : "?");
+            } else if (conversion == 'R') {
+                written = snprintf(out + length, room, spec, integerValue != 0 ? "CW" : "CCW");
+            } else if (isIntegerConversion(conversion)) {
+                written = snprintf(out + length, room, spec, integerValue);
+            } else if (isRealConversion(conversion)) {
+                written = snprintf(out + length, room, spec, realValue);
+            }
+        }
+        if (written < 0) {
+            written = 0;
+        }
+        length += written < room ? written : room - 1;
+    }
+    if (length > size - 2) {
+        length = size - 2;
+    }
+    out[length++] = '\n';
+    out[length] = '\0';
+    return length;
+}
+
+bool isLogDecodeRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--decode-log") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int runLogDecodeCommand(int argc, char** argv) {
+    const char* inputPath = NULL;
+    const char* outputPath = NULL;
+    bool valid = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--decode-log") == 0 && i + 1 < argc && inputPath == NULL) {
+            inputPath = argv[++i];
+        } else if (inputPath != NULL && outputPath == NULL && argv[i][0] != '-') {
+            outputPath = argv[i];
+        } else {
+            valid = false;
+        }
+    }
+    if (!valid || inputPath == NULL) {
+        fprintf(stderr, "Cách dùng: rubik --decode-log rubik_debug.trace [output.txt]\n");
+        return 1;
+    }
+
+    FILE* input = fopen(inputPath, "rb");
+    if (input == NULL) {
+        fprintf(stderr, "Không mở được file trace: %s\n", inputPath);
+        return 1;
+    }
+    TraceFileHeader header;
+    if (fread(&header, sizeof(header), 1, input) != 1 ||
+        memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != TRACE_FORMAT_VERSION || header.recordSize != sizeof(TraceRecord)) {
+        fprintf(stderr, "%s không phải file trace của phiên bản này\n", inputPath);
+        fclose(input);
+        return 1;
+    }
+    if (header.eventCount != (unsigned int)LOG_EVENT_COUNT || header.eventTableHash != computeEventTableHash()) {
+        // Vẫn giải mã: sự kiện chỉ được thêm vào cuối bảng nên các mã cũ thường còn đúng
+        fprintf(stderr, "Cảnh báo: file trace được ghi với bảng sự kiện khác (%u sự kiện), nội dung có thể sai\n",
+                header.eventCount);
+    }
+
+    FILE* output = stdout;
+    if (outputPath != NULL) {
+        output = fopen(outputPath, "w");
+        if (output == NULL) {
+            fprintf(stderr, "Không mở được output: %s\n", outputPath);
+            fclose(input);
+            return 1;
+        }
+    }
+
+    header.startTime[sizeof(header.startTime) - 1] = '\0';
+    fprintf(output, "=== Nhật ký Debug Rubik's Cube ===\n");
+    fprintf(output, "Bắt đầu: %s\n", header.startTime);
+    fprintf(output, "==============================\n\n");
+
+    char line[512];
+    int recordCount = 0;
+    TraceRecord record;
+    while (fread(&record, sizeof(record), 1, input) == 1) {
+        int length = formatTraceRecord(record, line, (int)sizeof(line));
+        fwrite(line, 1, length, output);
+        recordCount++;
+    }
+    fprintf(output, "\n=== Kết thúc nhật ký (%d bản ghi) ===\n", recordCount);
+
+    fclose(input);
+    if (output != stdout) {
+        fclose(output);
+    }
+    return 0;
+}
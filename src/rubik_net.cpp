@@ -0,0 +1,517 @@
+#include "rubik_net.h"
+#include "rubik_state.h"
+#include "rubik_statecodec.h"
+#include "rubik_rotation.h"
+#include "rubik_constants.h"
+#include "rubik_clock.h"
+#include "rubik_thread.h"
+#include "rubik_image.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(snprintf)
+#define snprintf _snprintf
+#endif
+
+// Vị trí (theo ô) của từng mặt trên net, theo thứ tự U, R, F, D, L, B
+// (sticker nào nằm ở ô nào do rubik_statecodec quyết định, chung với chuỗi facelet)
+static const int NET_FACE_COL[6] = {3, 6, 3, 3, 0, 9};
+static const int NET_FACE_ROW[6] = {0, 3, 3, 6, 3, 3};
+static const char NET_FACE_LETTERS[] = "URFDLB";
+
+static const int NET_COLUMNS = 12;
+static const int NET_ROWS = 9;
+
+static const unsigned char NET_BACKGROUND[3] = {255, 255, 255};  // Nền trắng để in tờ trộn
+static const unsigned char NET_PLATE[3] = {26, 26, 26};          // Viền giữa các sticker
+static const unsigned char NET_INVALID[3] = {128, 128, 128};     // Dòng input không hợp lệ
+
+static unsigned char colorToByte(float value) {
+    if (value < 0.0f) {
+        value = 0.0f;
+    } else if (value > 1.0f) {
+        value = 1.0f;
+    }
+    return (unsigned char)(value * 255.0f + 0.5f);
+}
+
+void extractNetStickers(const RubikCube& cube, unsigned char stickers[54][3]) {
+    for (int s = 0; s < 54; s++) {
+        int pieceIndex, face;
+        getFaceletLocation(s, pieceIndex, face);
+        const float* color = cube.pieces[pieceIndex].colors[face];
+        stickers[s][0] = colorToByte(color[0]);
+        stickers[s][1] = colorToByte(color[1]);
+        stickers[s][2] = colorToByte(color[2]);
+    }
+}
+
+bool faceletsToNetStickers(const char* facelets, unsigned char stickers[54][3]) {
+    // Màu tâm của từng mặt theo thứ tự URFDLB (cùng bảng màu với initRubikCube)
+    const float* centerColors[6] = {COLOR_WHITE, COLOR_BLUE, COLOR_RED, COLOR_YELLOW, COLOR_GREEN, COLOR_ORANGE};
+    for (int s = 0; s < 54; s++) {
+        const char* letter = facelets[s] != '\0' ? strchr(NET_FACE_LETTERS, facelets[s]) : NULL;
+        if (letter == NULL) {
+            return false;
+        }
+        const float* color = centerColors[letter - NET_FACE_LETTERS];
+        stickers[s][0] = colorToByte(color[0]);
+        stickers[s][1] = colorToByte(color[1]);
+        stickers[s][2] = colorToByte(color[2]);
+    }
+    return facelets[54] == '\0';
+}
+
+int getNetImageWidth(int cellSize) {
+    return NET_COLUMNS * cellSize;
+}
+
+int getNetImageHeight(int cellSize) {
+    return NET_ROWS * cellSize;
+}
+
+// Viền giữa các sticker: 1/16 kích thước ô, tối thiểu 1 pixel
+static int netStickerInset(int cellSize) {
+    int inset = cellSize / 16;
+    return inset < 1 ? 1 : inset;
+}
+
+void buildNetSVGTemplate(NetSVGTemplate& svgTemplate, int cellSize) {
+    const int width = getNetImageWidth(cellSize);
+    const int height = getNetImageHeight(cellSize);
+    const int inset = netStickerInset(cellSize);
+    const int stickerSize = cellSize - 2 * inset;
+    std::string& out = svgTemplate.text;
+    char buffer[160];
+
+    svgTemplate.cellSize = cellSize;
+    out.clear();
+    snprintf(buffer, sizeof(buffer),
+             "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"%d\" height=\"%d\" viewBox=\"0 0 %d %d\">",
+             width, height, width, height);
+    out += buffer;
+    for (int n = 0; n < 6; n++) {
+        // Nền mỗi mặt là màu viền, sticker vẽ đè lên
+        snprintf(buffer, sizeof(buffer), "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"#%02x%02x%02x\"/>",
+                 NET_FACE_COL[n] * cellSize, NET_FACE_ROW[n] * cellSize, 3 * cellSize, 3 * cellSize,
+                 NET_PLATE[0], NET_PLATE[1], NET_PLATE[2]);
+        out += buffer;
+        for (int cell = 0; cell < 9; cell++) {
+            snprintf(buffer, sizeof(buffer), "<rect x=\"%d\" y=\"%d\" width=\"%d\" height=\"%d\" fill=\"#",
+                     (NET_FACE_COL[n] + cell % 3) * cellSize + inset,
+                     (NET_FACE_ROW[n] + cell / 3) * cellSize + inset,
+                     stickerSize, stickerSize);
+            out += buffer;
+            svgTemplate.colorOffsets[n * 9 + cell] = out.size();
+            out += "000000\"/>";
+        }
+    }
+    out += "</svg>\n";
+}
+
+void appendNetSVG(std::string& out, const NetSVGTemplate& svgTemplate, const unsigned char stickers[54][3]) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    size_t base = out.size();
+    out += svgTemplate.text;
+    for (int s = 0; s < 54; s++) {
+        char* hex = &out[base + svgTemplate.colorOffsets[s]];
+        for (int c = 0; c < 3; c++) {
+            hex[c * 2] = HEX_DIGITS[stickers[s][c] >> 4];
+            hex[c * 2 + 1] = HEX_DIGITS[stickers[s][c] & 0x0F];
+        }
+    }
+}
+
+static void fillRect(unsigned char* rgb, int imageWidth, int x, int y, int w, int h, const unsigned char color[3]) {
+    for (int row = y; row < y + h; row++) {
+        unsigned char* p = rgb + ((size_t)row * imageWidth + x) * 3;
+        for (int col = 0; col < w; col++) {
+            p[0] = color[0];
+            p[1] = color[1];
+            p[2] = color[2];
+            p += 3;
+        }
+    }
+}
+
+void rasterNetRGB(unsigned char* rgb, const unsigned char stickers[54][3], int cellSize) {
+    const int width = getNetImageWidth(cellSize);
+    const int height = getNetImageHeight(cellSize);
+    const int inset = netStickerInset(cellSize);
+    const int stickerSize = cellSize - 2 * inset;
+
+    fillRect(rgb, width, 0, 0, width, height, NET_BACKGROUND);
+    for (int n = 0; n < 6; n++) {
+        fillRect(rgb, width, NET_FACE_COL[n] * cellSize, NET_FACE_ROW[n] * cellSize,
+                 3 * cellSize, 3 * cellSize, NET_PLATE);
+        for (int cell = 0; cell < 9; cell++) {
+            fillRect(rgb, width,
+                     (NET_FACE_COL[n] + cell % 3) * cellSize + inset,
+                     (NET_FACE_ROW[n] + cell / 3) * cellSize + inset,
+                     stickerSize, stickerSize, stickers[n * 9 + cell]);
+        }
+    }
+}
+
+// ==================== Chế độ batch ====================
+
+// Một lô đang xử lý: dòng input của lô và kết quả chờ ghi. Lô thứ c dùng ô c % window
+struct NetBatchSlot {
+    std::vector<std::string> lines;
+    std::string output;
+    bool done;
+};
+
+// Trạng thái chung của một lần chạy batch
+// Luồng nhận lô kế tiếp tự đọc NET_BATCH_CHUNK dòng của lô đó từ input (dưới mutex nên
+// các lô được đọc đúng thứ tự); luồng chính ghi kết quả theo đúng thứ tự. Số lô đã đọc
+// nhưng chưa ghi bị giới hạn bởi window nên bộ nhớ không tăng theo input.
+struct NetBatchJob {
+    FILE* input;
+    ImagePathPattern outputPattern;
+    bool perFile;            // Đường dẫn có %d: mỗi dòng một file, do luồng worker ghi
+    bool svg;
+    int cellSize;
+    NetSVGTemplate svgTemplate;
+    RubikCube solved;
+
+    RubikMutex mutex;
+    RubikCondition condition;
+    bool inputEnded;
+    int chunkCount;          // Chỉ biết khi input đã hết
+    int nextChunk;
+    int writtenChunks;
+    int window;
+    std::vector<NetBatchSlot> slots;
+    int lineCount;
+    int invalidLines;
+    int failedWrites;
+};
+
+// Màu sticker của một dòng input: chuỗi facelet 54 ký tự hoặc chuỗi nước đi
+static bool lineToStickers(const NetBatchJob& job, const std::string& line, unsigned char stickers[54][3]) {
+    if (line.size() == 54 && line.find_first_not_of(NET_FACE_LETTERS) == std::string::npos) {
+        return faceletsToNetStickers(line.c_str(), stickers);
+    }
+    RubikCube cube = job.solved;
+    if (applyMoveString(cube, line.c_str()) < 0) {
+        for (int s = 0; s < 54; s++) {
+            stickers[s][0] = NET_INVALID[0];
+            stickers[s][1] = NET_INVALID[1];
+            stickers[s][2] = NET_INVALID[2];
+        }
+        return false;
+    }
+    extractNetStickers(cube, stickers);
+    return true;
+}
+
+static void renderNetChunk(const NetBatchJob& job, int chunk, const std::vector<std::string>& lines,
+                           std::string& out, std::vector<unsigned char>& rgb, int& invalidLines, int& failedWrites) {
+    const int width = getNetImageWidth(job.cellSize);
+    const int height = getNetImageHeight(job.cellSize);
+
+    unsigned char stickers[54][3];
+    char header[64];
+    for (size_t i = 0; i < lines.size(); i++) {
+        int index = chunk * NET_BATCH_CHUNK + (int)i;
+        if (!lineToStickers(job, lines[i], stickers)) {
+            invalidLines++;
+        }
+
+        if (job.svg) {
+            appendNetSVG(out, job.svgTemplate, stickers);
+        } else {
+            rasterNetRGB(&rgb[0], stickers, job.cellSize);
+            if (!job.perFile) {
+                snprintf(header, sizeof(header), "P6\n%d %d\n255\n", width, height);
+                out += header;
+                out.append((const char*)&rgb[0], rgb.size());
+            }
+        }
+
+        if (job.perFile) {
+            char path[1024];
+            formatImagePath(job.outputPattern, index, path, sizeof(path));
+            bool ok;
+            if (job.svg) {
+                FILE* file = fopen(path, "wb");
+                ok = file != NULL && fwrite(out.data(), 1, out.size(), file) == out.size();
+                if (file != NULL && fclose(file) != 0) {
+                    ok = false;
+                }
+                out.clear();
+            } else {
+                ok = writeImageFile(path, width, height, &rgb[0]);
+            }
+            if (!ok) {
+                failedWrites++;
+            }
+        }
+    }
+}
+
+// Một dòng input, bỏ '\n'/'\r' ở cuối; false khi input đã hết
+static bool readInputLine(FILE* file, std::string& line) {
+    line.clear();
+    char buffer[4096];
+    while (fgets(buffer, sizeof(buffer), file) != NULL) {
+        line += buffer;
+        if (line[line.size() - 1] == '\n') {
+            break;
+        }
+    }
+    if (line.empty()) {
+        return false;
+    }
+    while (!line.empty() && (line[line.size() - 1] == '\n' || line[line.size() - 1] == '\r')) {
+        line.erase(line.size() - 1);
+    }
+    return true;
+}
+
+// Gọi khi đang giữ mutex: nhận lô kế tiếp, đọc dòng của nó, render (nhả mutex trong lúc
+// render) rồi lưu kết quả. false nếu input đã hết hoặc window đã đầy
+static bool processNextChunk(NetBatchJob& job, std::vector<unsigned char>& rgb) {
+    if (job.inputEnded || job.nextChunk >= job.writtenChunks + job.window) {
+        return false;
+    }
+    int chunk = job.nextChunk;
+    NetBatchSlot& slot = job.slots[chunk % job.window];
+    slot.lines.resize(NET_BATCH_CHUNK);
+    int count = 0;
+    while (count < NET_BATCH_CHUNK && readInputLine(job.input, slot.lines[count])) {
+        count++;
+    }
+    slot.lines.resize(count);
+    job.lineCount += count;
+    if (count < NET_BATCH_CHUNK) {
+        job.inputEnded = true;
+        job.chunkCount = count > 0 ? chunk + 1 : chunk;
+        broadcastCondition(job.condition);
+        if (count == 0) {
+            return false;
+        }
+    }
+    job.nextChunk++;
+    unlockMutex(job.mutex);
+
+    std::string out;
+    int invalidLines = 0;
+    int failedWrites = 0;
+    {
+        PROFILE_ZONE("renderNetChunk");
+        renderNetChunk(job, chunk, slot.lines, out, rgb, invalidLines, failedWrites);
+    }
+
+    lockMutex(job.mutex);
+    slot.output.swap(out);
+    slot.done = true;
+    job.invalidLines += invalidLines;
+    job.failedWrites += failedWrites;
+    broadcastCondition(job.condition);
+    return true;
+}
+
+static void netBatchWorker(void* arg) {
+    NetBatchJob& job = *(NetBatchJob*)arg;
+    setProfilerThreadName("net batch worker");
+    std::vector<unsigned char> rgb((size_t)getNetImageWidth(job.cellSize) * getNetImageHeight(job.cellSize) * 3);
+
+    lockMutex(job.mutex);
+    for (;;) {
+        if (processNextChunk(job, rgb)) {
+            continue;
+        }
+        if (job.inputEnded) {
+            break;
+        }
+        waitCondition(job.condition, job.mutex);
+    }
+    unlockMutex(job.mutex);
+}
+
+static bool hasSuffix(const char* text, const char* suffix) {
+    size_t textLength = strlen(text);
+    size_t suffixLength = strlen(suffix);
+    return textLength >= suffixLength && strcmp(text + textLength - suffixLength, suffix) == 0;
+}
+
+bool isNetBatchRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--net-batch") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printNetBatchUsage() {
+    fprintf(stderr,
+            "Cách dùng: rubik --net-batch input.txt output [--format svg|ppm] [--cell N] [--threads N]\n"
+            "  Mỗi dòng input: chuỗi nước đi (vd. R U R' U2) hoặc 54 ký tự facelet URFDLB.\n"
+            "  input/output là - để dùng stdin/stdout.\n"
+            "  Output chứa %%d (vd. net_%%05d.svg): mỗi dòng một file (SVG hoặc ảnh .png/.ppm).\n"
+            "  Nếu không: một luồng PPM nối tiếp các ảnh P6 (SVG luôn cần %%d, mỗi file một <svg>).\n");
+}
+
+int runNetBatchCommand(int argc, char** argv) {
+    const char* inputPath = NULL;
+    const char* outputPath = NULL;
+    const char* format = NULL;
+    int cellSize = NET_DEFAULT_CELL_SIZE;
+    int threads = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--net-batch") == 0 && i + 2 < argc) {
+            inputPath = argv[++i];
+            outputPath = argv[++i];
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            format = argv[++i];
+        } else if (strcmp(argv[i], "--cell") == 0 && i + 1 < argc) {
+            cellSize = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Tham số không hợp lệ: %s\n", argv[i]);
+            printNetBatchUsage();
+            return 1;
+        }
+    }
+    if (inputPath == NULL || outputPath == NULL || cellSize <= 0 || cellSize > 1024) {
+        printNetBatchUsage();
+        return 1;
+    }
+    if (threads <= 0) {
+        threads = getHardwareThreadCount();
+    }
+
+    NetBatchJob job;
+    if (!parseImagePathPattern(outputPath, job.perFile, job.outputPattern)) {
+        fprintf(stderr, "Đường dẫn output phải có đúng một %%d (vd. net_%%05d.png) và không có %% nào khác: %s\n",
+                outputPath);
+        return 1;
+    }
+    job.svg = format != NULL ? strcmp(format, "svg") == 0 : hasSuffix(outputPath, ".svg");
+    if (job.svg && !job.perFile) {
+        // Nhiều <svg> gốc nối nhau trong một file không còn là tài liệu SVG/XML hợp lệ
+        fprintf(stderr, "SVG cần đường dẫn output có %%d (mỗi sơ đồ một file): %s\n", outputPath);
+        return 1;
+    }
+    job.cellSize = cellSize;
+    if (job.svg) {
+        buildNetSVGTemplate(job.svgTemplate, cellSize);
+    }
+
+    // Trạng thái đã giải làm gốc cho mọi chuỗi nước đi
+    initRubikCube();
+    job.solved = g_rubikCube;
+
+    job.input = strcmp(inputPath, "-") == 0 ? stdin : fopen(inputPath, "r");
+    if (job.input == NULL) {
+        fprintf(stderr, "Không đọc được input: %s\n", inputPath);
+        return 1;
+    }
+    FILE* output = NULL;
+    if (!job.perFile) {
+        output = strcmp(outputPath, "-") == 0 ? stdout : fopen(outputPath, "wb");
+        if (output == NULL) {
+            fprintf(stderr, "Không mở được output: %s\n", outputPath);
+            if (job.input != stdin) {
+                fclose(job.input);
+            }
+            return 1;
+        }
+    }
+
+    // rotatePositions ghi log mỗi nước đi: tắt nhóm MOVE trong lúc batch để không làm tràn vòng đệm log
+    unsigned int savedCategories = getLogCategories();
+    setLogCategories(savedCategories & ~(unsigned int)LOG_CAT_MOVE);
+
+    initMutex(job.mutex);
+    initCondition(job.condition);
+    job.inputEnded = false;
+    job.chunkCount = 0;
+    job.nextChunk = 0;
+    job.writtenChunks = 0;
+    job.window = threads * 4;
+    job.slots.resize(job.window);
+    for (int i = 0; i < job.window; i++) {
+        job.slots[i].done = false;
+    }
+    job.lineCount = 0;
+    job.invalidLines = 0;
+    job.failedWrites = 0;
+
+    ClockNanos startTime = clockRealNanos();
+    std::vector<RubikThread> workers(threads);
+    int started = 0;
+    for (int t = 0; t < threads; t++) {
+        if (!startThread(workers[t], netBatchWorker, &job)) {
+            break;
+        }
+        started++;
+    }
+    // Không tạo được luồng: luồng chính tự render xen kẽ với ghi
+    std::vector<unsigned char> mainRgb;
+    if (started == 0) {
+        mainRgb.resize((size_t)getNetImageWidth(cellSize) * getNetImageHeight(cellSize) * 3);
+    }
+
+    // Ghi các lô theo thứ tự ngay khi lô đó xong
+    for (int chunk = 0;; chunk++) {
+        std::string out;
+        lockMutex(job.mutex);
+        NetBatchSlot& slot = job.slots[chunk % job.window];
+        while (!slot.done && !(job.inputEnded && chunk >= job.chunkCount)) {
+            if (started == 0 && processNextChunk(job, mainRgb)) {
+                continue;
+            }
+            waitCondition(job.condition, job.mutex);
+        }
+        if (!slot.done) {
+            unlockMutex(job.mutex);
+            break;
+        }
+        out.swap(slot.output);
+        slot.done = false;
+        job.writtenChunks++;
+        broadcastCondition(job.condition);
+        unlockMutex(job.mutex);
+
+        if (output != NULL && !out.empty() && fwrite(out.data(), 1, out.size(), output) != out.size()) {
+            job.failedWrites++;
+        }
+    }
+    for (int t = 0; t < started; t++) {
+        joinThread(workers[t]);
+    }
+    if (job.input != stdin) {
+        fclose(job.input);
+    }
+    if (output != NULL && output != stdout && fclose(output) != 0) {
+        job.failedWrites++;
+    } else if (output == stdout) {
+        fflush(stdout);
+    }
+    double seconds = clockNanosToSeconds(clockRealNanos() - startTime);
+
+    destroyCondition(job.condition);
+    destroyMutex(job.mutex);
+    setLogCategories(savedCategories);
+
+    double rate = seconds > 0.0 ? (double)job.lineCount / seconds : 0.0;
+    fprintf(stderr, "NET BATCH: %d sơ đồ %s, %d luồng, %.3fs (%.0f sơ đồ/giây), %d dòng không hợp lệ\n",
+            job.lineCount, job.svg ? "SVG" : "ảnh", threads, seconds, rate, job.invalidLines);
+    RUBIK_LOG(EVT_NET_BATCH) << job.lineCount << threads << seconds << rate
+                             << job.invalidLines << job.failedWrites;
+    if (job.failedWrites > 0) {
+        fprintf(stderr, "Lỗi ghi output (%d lần)\n", job.failedWrites);
+        return 1;
+    }
+    return 0;
+}
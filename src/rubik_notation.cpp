@@ -0,0 +1,592 @@
+#include "rubik_notation.h"
+#include "rubik_constants.h"
+#include "rubik_thread.h"
+#include "rubik_clock.h"
+#include "rubik_log.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+// Loại ký hiệu ở bước đọc: 6 mặt (thứ tự enum Face), 6 wide, 3 slice, 3 xoay khối.
+// Token = loại * 4 + số quarter turn xuôi chiều (1..3), đảo token = 4 - số lần
+enum NotationKind {
+    KIND_SPACE = -2,     // Chỉ trong bảng chữ cái: bỏ qua không cần vào switch
+    KIND_WIDE = 6,
+    KIND_SLICE_M = 12,
+    KIND_SLICE_E = 13,
+    KIND_SLICE_S = 14,
+    KIND_ROTATE_X = 15,
+    KIND_ROTATE_Y = 16,
+    KIND_ROTATE_Z = 17,
+    KIND_COUNT = 18
+};
+
+enum RotationAxis {
+    AXIS_NONE = -1,
+    AXIS_X = 0,      // Như R
+    AXIS_Y = 1,      // Như U
+    AXIS_Z = 2       // Như F
+};
+
+// Cách quy một ký hiệu về mặt ngoài: xoay faceA (và faceB) theo hệ số rồi đổi hướng
+// nhìn quanh trục. Hệ số 3 = ngược chiều. Các lớp song song giao hoán nên thứ tự tự do
+struct LoweringRule {
+    int faceA;
+    int turnsA;
+    int faceB;
+    int turnsB;
+    int axis;
+    int axisTurns;
+};
+
+static const LoweringRule LOWERING_RULES[KIND_COUNT] = {
+    {FRONT, 1, -1, 0, AXIS_NONE, 0},
+    {BACK, 1, -1, 0, AXIS_NONE, 0},
+    {LEFT, 1, -1, 0, AXIS_NONE, 0},
+    {RIGHT, 1, -1, 0, AXIS_NONE, 0},
+    {UP, 1, -1, 0, AXIS_NONE, 0},
+    {DOWN, 1, -1, 0, AXIS_NONE, 0},
+    {BACK, 1, -1, 0, AXIS_Z, 1},     // Fw = B z
+    {FRONT, 1, -1, 0, AXIS_Z, 3},    // Bw = F z'
+    {RIGHT, 1, -1, 0, AXIS_X, 3},    // Lw = R x'
+    {LEFT, 1, -1, 0, AXIS_X, 1},     // Rw = L x
+    {DOWN, 1, -1, 0, AXIS_Y, 1},     // Uw = D y
+    {UP, 1, -1, 0, AXIS_Y, 3},       // Dw = U y'
+    {LEFT, 3, RIGHT, 1, AXIS_X, 3},  // M = L' R x'
+    {UP, 1, DOWN, 3, AXIS_Y, 3},     // E = U D' y'
+    {FRONT, 3, BACK, 1, AXIS_Z, 1},  // S = F' B z
+    {-1, 0, -1, 0, AXIS_X, 1},
+    {-1, 0, -1, 0, AXIS_Y, 1},
+    {-1, 0, -1, 0, AXIS_Z, 1}
+};
+
+// Một quarter turn của cả khối: mặt ở vị trí i sau khi xoay là mặt ở vị trí source[i] trước đó
+static const int ROTATION_SOURCE[3][6] = {
+    {DOWN, UP, LEFT, RIGHT, FRONT, BACK},    // x: F lên U
+    {RIGHT, LEFT, FRONT, BACK, UP, DOWN},    // y: F sang L
+    {FRONT, BACK, DOWN, UP, LEFT, RIGHT}     // z: U sang R
+};
+
+static const int ORIENTATION_COUNT = 24;
+
+// Hướng nhìn: mặt tuyệt đối đang nằm ở vị trí F/B/L/R/U/D của ký hiệu
+static unsigned char s_orientationFace[ORIENTATION_COUNT][6];
+static unsigned char s_orientationNext[ORIENTATION_COUNT][3];
+static signed char s_letterKind[256];
+
+// Ký tự ngay sau chữ cái của nước đi: đường nhanh giải mã ' và 2 bằng một lần tra bảng
+enum SuffixInfo {
+    SUFFIX_NONE = 1,        // Bit 0-1: số quarter turn nếu nước đi kết thúc ở đây
+    SUFFIX_TURNS = 3,
+    SUFFIX_ADVANCE = 4,     // Ký tự thuộc hậu tố (' hoặc 2), bỏ qua
+    SUFFIX_PART = 8,        // Có thể là một phần hậu tố
+    SUFFIX_SLOW = 16        // Cần đọc đầy đủ: w, số khác 2, ’
+};
+static unsigned char s_suffixInfo[256];
+
+static int findOrientation(const unsigned char faces[6], int count) {
+    for (int i = 0; i < count; i++) {
+        if (memcmp(s_orientationFace[i], faces, 6) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Dựng bảng khi nạp chương trình (trước main), nên đọc song song từ nhiều luồng an toàn
+static bool buildNotationTables() {
+    memset(s_letterKind, -1, sizeof(s_letterKind));
+    const char upper[6] = {'F', 'B', 'L', 'R', 'U', 'D'};
+    const char lower[6] = {'f', 'b', 'l', 'r', 'u', 'd'};
+    for (int face = 0; face < 6; face++) {
+        s_letterKind[(unsigned char)upper[face]] = (signed char)face;
+        s_letterKind[(unsigned char)lower[face]] = (signed char)(KIND_WIDE + face);
+    }
+    s_letterKind[(unsigned char)'M'] = KIND_SLICE_M;
+    s_letterKind[(unsigned char)'E'] = KIND_SLICE_E;
+    s_letterKind[(unsigned char)'S'] = KIND_SLICE_S;
+    s_letterKind[(unsigned char)'x'] = KIND_ROTATE_X;
+    s_letterKind[(unsigned char)'y'] = KIND_ROTATE_Y;
+    s_letterKind[(unsigned char)'z'] = KIND_ROTATE_Z;
+    s_letterKind[(unsigned char)' '] = KIND_SPACE;
+    s_letterKind[(unsigned char)'\t'] = KIND_SPACE;
+
+    memset(s_suffixInfo, SUFFIX_NONE, sizeof(s_suffixInfo));
+    for (char digit = '0'; digit <= '9'; digit++) {
+        s_suffixInfo[(unsigned char)digit] = SUFFIX_PART | SUFFIX_SLOW;
+    }
+    s_suffixInfo[(unsigned char)'2'] = 2 | SUFFIX_ADVANCE | SUFFIX_PART;
+    s_suffixInfo[(unsigned char)'\''] = 3 | SUFFIX_ADVANCE | SUFFIX_PART;
+    s_suffixInfo[(unsigned char)'w'] = SUFFIX_PART | SUFFIX_SLOW;
+    s_suffixInfo[0xE2] = SUFFIX_PART | SUFFIX_SLOW;
+
+    // Loang từ hướng chuẩn qua x, y, z: đủ 24 hướng
+    for (int i = 0; i < 6; i++) {
+        s_orientationFace[0][i] = (unsigned char)i;
+    }
+    int count = 1;
+    for (int current = 0; current < count; current++) {
+        for (int axis = 0; axis < 3; axis++) {
+            unsigned char rotated[6];
+            for (int i = 0; i < 6; i++) {
+                rotated[i] = s_orientationFace[current][ROTATION_SOURCE[axis][i]];
+            }
+            int next = findOrientation(rotated, count);
+            if (next < 0 && count < ORIENTATION_COUNT) {
+                memcpy(s_orientationFace[count], rotated, 6);
+                next = count++;
+            }
+            s_orientationNext[current][axis] = (unsigned char)next;
+        }
+    }
+    return count == ORIENTATION_COUNT;
+}
+
+static const bool s_notationTablesReady = buildNotationTables();
+
+// ==================== Đọc ====================
+
+// Ngoặc đang mở: nhóm là các token từ start; separator là vị trí ',' hoặc ':' trong [ ]
+struct GroupFrame {
+    char open;
+    char separatorChar;
+    int start;
+    int separator;
+    const char* position;
+};
+
+static bool isPrime(const char* p, const char* end, int& length) {
+    if (*p == '\'') {
+        length = 1;
+        return true;
+    }
+    // ’ (U+2019) trong UTF-8
+    if ((unsigned char)p[0] == 0xE2 && end - p >= 3 && (unsigned char)p[1] == 0x80 && (unsigned char)p[2] == 0x99) {
+        length = 3;
+        return true;
+    }
+    return false;
+}
+
+// Hậu tố "n", "'", "n'" hoặc "'n"; count mặc định 1. false nếu số quá lớn
+static bool readSuffix(const char*& p, const char* end, int& count, bool& prime) {
+    count = 1;
+    prime = false;
+    int primeLength = 0;
+    if (p < end && isPrime(p, end, primeLength)) {
+        prime = true;
+        p += primeLength;
+    }
+    if (p < end && *p >= '0' && *p <= '9') {
+        count = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            count = count * 10 + (*p - '0');
+            if (count > NOTATION_MAX_MOVES) {
+                return false;
+            }
+            p++;
+        }
+    }
+    if (!prime && p < end && isPrime(p, end, primeLength)) {
+        prime = true;
+        p += primeLength;
+    }
+    return true;
+}
+
+static void invertTokens(MoveCode* first, MoveCode* last) {
+    std::reverse(first, last);
+    for (MoveCode* token = first; token != last; token++) {
+        *token = (MoveCode)((*token & ~3) | (4 - (*token & 3)));
+    }
+}
+
+// Nối bản sao của tokens[first, last) (insert từ chính vector là không hợp lệ)
+static void appendCopy(std::vector<MoveCode>& tokens, int first, int last) {
+    size_t at = tokens.size();
+    tokens.resize(at + (last - first));
+    std::copy(tokens.begin() + first, tokens.begin() + last, tokens.begin() + at);
+}
+
+static void appendInverted(std::vector<MoveCode>& tokens, int first, int last) {
+    size_t at = tokens.size();
+    appendCopy(tokens, first, last);
+    if (last > first) {
+        invertTokens(&tokens[0] + at, &tokens[0] + tokens.size());
+    }
+}
+
+// Áp dụng hậu tố của nhóm lên tokens[start, end): đảo nếu có ', lặp count lần
+static bool applyGroupSuffix(std::vector<MoveCode>& tokens, int start, int count, bool prime) {
+    int end = (int)tokens.size();
+    if ((long long)(end - start) * count + start > NOTATION_MAX_MOVES) {
+        return false;
+    }
+    if (prime && end > start) {
+        invertTokens(&tokens[0] + start, &tokens[0] + end);
+    }
+    if (count == 0) {
+        tokens.resize(start);
+        return true;
+    }
+    tokens.reserve(start + (size_t)(end - start) * count);
+    for (int i = 1; i < count; i++) {
+        appendCopy(tokens, start, end);
+    }
+    return true;
+}
+
+static bool failNotation(const char* begin, const char* at, const char* message, NotationError& error) {
+    error.offset = at - begin;
+    error.line = 1;
+    const char* lineStart = begin;
+    for (const char* c = begin; c < at; c++) {
+        if (*c == '\n') {
+            error.line++;
+            lineStart = c + 1;
+        }
+    }
+    error.column = (int)(at - lineStart) + 1;
+    error.message = message;
+    return false;
+}
+
+// Bước 1: văn bản -> token ký hiệu (nhóm đã được khai triển). Mỗi token chiếm ít
+// nhất một byte nên tokens luôn được giữ đủ chỗ cho count + số byte còn lại, và
+// đường nhanh (mặt + hậu tố ' hoặc 2) ghi thẳng không cần kiểm tra dung lượng
+static bool readNotationTokens(const char* begin, const char* end, std::vector<MoveCode>& tokens,
+                               int& count, NotationError& error) {
+    GroupFrame stack[NOTATION_MAX_NESTING];
+    int depth = 0;
+    count = 0;
+    tokens.resize(end - begin);
+    MoveCode* out = &tokens[0];
+    const char* p = begin;
+    while (p < end) {
+        const char c = *p;
+        int kind = s_letterKind[(unsigned char)c];
+        if (kind == KIND_SPACE) {
+            p++;
+            continue;
+        }
+        if (kind >= 0) {
+            const char* start = p++;
+            int turns = -1;
+            unsigned int info = p < end ? s_suffixInfo[(unsigned char)*p] : (unsigned int)SUFFIX_NONE;
+            if ((info & SUFFIX_SLOW) == 0) {
+                const char* next = p + ((info & SUFFIX_ADVANCE) != 0 ? 1 : 0);
+                if (next == end || (s_suffixInfo[(unsigned char)*next] & SUFFIX_PART) == 0) {
+                    turns = info & SUFFIX_TURNS;
+                    p = next;
+                }
+            }
+            if (turns < 0) {
+                // Đường chậm: Rw, R3, R'2, R’
+                if (kind < KIND_WIDE && p < end && *p == 'w') {
+                    kind += KIND_WIDE;
+                    p++;
+                }
+                int repeat;
+                bool prime;
+                if (!readSuffix(p, end, repeat, prime)) {
+                    return failNotation(begin, start, "số lần xoay quá lớn", error);
+                }
+                turns = repeat % 4;
+                if (prime) {
+                    turns = (4 - turns) % 4;
+                }
+            }
+            if (turns != 0) {
+                out[count++] = (MoveCode)(kind * 4 + turns);
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '\r':
+            case '\n':
+                p++;
+                break;
+            case '/':
+                if (end - p < 2 || p[1] != '/') {
+                    return failNotation(begin, p, "ký tự không phải nước đi", error);
+                }
+                // fall through
+            case '#': {
+                const char* newline = (const char*)memchr(p, '\n', end - p);
+                p = newline != NULL ? newline : end;
+                break;
+            }
+            case '(':
+            case '[':
+                if (depth == NOTATION_MAX_NESTING) {
+                    return failNotation(begin, p, "ngoặc lồng quá sâu", error);
+                }
+                stack[depth].open = c;
+                stack[depth].separatorChar = 0;
+                stack[depth].start = count;
+                stack[depth].separator = -1;
+                stack[depth].position = p;
+                depth++;
+                p++;
+                break;
+            case ',':
+            case ':':
+                if (depth == 0 || stack[depth - 1].open != '[' || stack[depth - 1].separatorChar != 0) {
+                    return failNotation(begin, p, "',' / ':' chỉ dùng một lần trong [ ]", error);
+                }
+                stack[depth - 1].separatorChar = c;
+                stack[depth - 1].separator = count;
+                p++;
+                break;
+            case ')':
+            case ']': {
+                const char* closing = p++;
+                char open = c == ')' ? '(' : '[';
+                if (depth == 0) {
+                    return failNotation(begin, closing, c == ')' ? "thừa ')'" : "thừa ']'", error);
+                }
+                if (stack[depth - 1].open != open) {
+                    return failNotation(begin, stack[depth - 1].position,
+                                        stack[depth - 1].open == '(' ? "thiếu ')'" : "thiếu ']'", error);
+                }
+                const GroupFrame& frame = stack[--depth];
+                tokens.resize(count);
+                if (open == '[') {
+                    if (frame.separatorChar == 0) {
+                        return failNotation(begin, closing, "[ ] cần ',' (commutator) hoặc ':' (conjugate)", error);
+                    }
+                    // [A, B] = A B A' B'; [A: B] = A B A'
+                    if ((long long)count * 2 > NOTATION_MAX_MOVES) {
+                        return failNotation(begin, closing, "quá nhiều nước đi", error);
+                    }
+                    appendInverted(tokens, frame.start, frame.separator);
+                    if (frame.separatorChar == ',') {
+                        appendInverted(tokens, frame.separator, count);
+                    }
+                }
+                int repeat;
+                bool prime;
+                if (!readSuffix(p, end, repeat, prime) || !applyGroupSuffix(tokens, frame.start, repeat, prime)) {
+                    return failNotation(begin, closing, "quá nhiều nước đi", error);
+                }
+                count = (int)tokens.size();
+                tokens.resize(count + (end - p));
+                out = tokens.empty() ? NULL : &tokens[0];
+                break;
+            }
+            default:
+                return failNotation(begin, p, "ký tự không phải nước đi", error);
+        }
+    }
+    if (depth > 0) {
+        return failNotation(begin, stack[depth - 1].position,
+                            stack[depth - 1].open == '(' ? "thiếu ')'" : "thiếu ']'", error);
+    }
+    return true;
+}
+
+// Bước 2: token -> mã mặt ngoài theo hướng nhìn hiện tại. Đoạn đầu chỉ gồm mặt
+// ngoài (thường là cả chuỗi trộn) được đổi tại chỗ; phần còn lại mỗi token sinh tối
+// đa 2 mã, ghi vào cùng vector ngay sau token rồi dời về
+static void lowerNotationTokens(std::vector<MoveCode>& moves, int tokenCount) {
+    MoveCode* tokens = &moves[0];
+    int first = 0;
+    while (first < tokenCount && (tokens[first] >> 2) < KIND_WIDE) {
+        tokens[first] = makeMoveCode(tokens[first] >> 2, tokens[first] & 3);
+        first++;
+    }
+    if (first == tokenCount) {
+        moves.resize(tokenCount);
+        return;
+    }
+
+    moves.resize((size_t)tokenCount * 3);
+    tokens = &moves[0];
+    MoveCode* out = &moves[0] + tokenCount;
+    MoveCode* write = out;
+    int orientation = 0;
+    for (int i = first; i < tokenCount; i++) {
+        int kind = tokens[i] >> 2;
+        int turns = tokens[i] & 3;
+        const LoweringRule& rule = LOWERING_RULES[kind];
+        const unsigned char* faces = s_orientationFace[orientation];
+        if (rule.faceA >= 0) {
+            *write++ = makeMoveCode(faces[rule.faceA], turns * rule.turnsA % 4);
+        }
+        if (rule.faceB >= 0) {
+            *write++ = makeMoveCode(faces[rule.faceB], turns * rule.turnsB % 4);
+        }
+        if (rule.axis != AXIS_NONE) {
+            for (int t = turns * rule.axisTurns % 4; t > 0; t--) {
+                orientation = s_orientationNext[orientation][rule.axis];
+            }
+        }
+    }
+    int count = (int)(write - out);
+    memmove(&moves[0] + first, out, (size_t)count);
+    moves.resize(first + count);
+}
+
+bool parseNotation(const char* begin, const char* end, std::vector<MoveCode>& moves, NotationError& error) {
+    moves.clear();
+    if (!s_notationTablesReady) {
+        return failNotation(begin, begin, "bảng hướng nhìn không hợp lệ", error);
+    }
+    if (begin >= end) {
+        return true;
+    }
+    int count = 0;
+    if (!readNotationTokens(begin, end, moves, count, error)) {
+        moves.clear();
+        return false;
+    }
+    if (count > 0) {
+        lowerNotationTokens(moves, count);
+    } else {
+        moves.clear();
+    }
+    return true;
+}
+
+void formatMoveCodes(const MoveCode* moves, int count, std::string& out) {
+    static const char FACE_LETTERS[6] = {'F', 'B', 'L', 'R', 'U', 'D'};
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            out += ' ';
+        }
+        out += FACE_LETTERS[moveCodeFace(moves[i])];
+        int turns = moveCodeTurns(moves[i]);
+        if (turns == 2) {
+            out += '2';
+        } else if (turns == 3) {
+            out += '\'';
+        }
+    }
+}
+
+// ==================== Chế độ dòng lệnh ====================
+
+bool isParseMovesRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--parse-moves") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printParseMovesUsage() {
+    fprintf(stderr,
+            "Cách dùng: rubik --parse-moves moves.txt [--out engine.txt]\n"
+            "  Mỗi dòng là một chuỗi nước đi WCA/SiGN. In số dòng, số nước, tốc độ và vị trí\n"
+            "  lỗi; --out ghi lại từng dòng bằng 18 nước mặt ngoài của engine (dòng lỗi để trống).\n");
+}
+
+// In "file:dòng:cột: lỗi" kèm dòng nguồn (cắt bớt) và dấu ^ dưới vị trí lỗi
+static void printNotationError(const char* path, long long line, const char* lineStart, const char* lineEnd,
+                               const NotationError& error) {
+    const int SHOWN = 72;
+    long long column = error.column;
+    const char* shownStart = lineStart;
+    if (column > SHOWN / 2) {
+        shownStart = lineStart + (column - SHOWN / 2);
+    }
+    int shownLength = (int)std::min<long long>(SHOWN, lineEnd - shownStart);
+    while (shownLength > 0 && (shownStart[shownLength - 1] == '\r' || shownStart[shownLength - 1] == '\n')) {
+        shownLength--;
+    }
+    fprintf(stderr, "%s:%lld:%d: %s\n    %.*s\n    %*s^\n", path, line + error.line - 1, error.column,
+            error.message, shownLength, shownStart, (int)(lineStart + error.offset - shownStart), "");
+}
+
+int runParseMovesCommand(int argc, char** argv) {
+    const char* path = NULL;
+    const char* outPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--parse-moves") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            fprintf(stderr, "Tham số không hợp lệ: %s\n", argv[i]);
+            printParseMovesUsage();
+            return 1;
+        }
+    }
+    if (path == NULL) {
+        printParseMovesUsage();
+        return 1;
+    }
+
+    MappedFile file;
+    if (!mapReadOnlyFile(path, file)) {
+        fprintf(stderr, "Không đọc được file: %s\n", path);
+        return 1;
+    }
+    FILE* out = NULL;
+    if (outPath != NULL && (out = fopen(outPath, "wb")) == NULL) {
+        fprintf(stderr, "Không ghi được file: %s\n", outPath);
+        unmapFile(file);
+        return 1;
+    }
+
+    std::vector<MoveCode> moves;
+    std::string outBuffer;
+    long long lines = 0;
+    long long totalMoves = 0;
+    long long invalidLines = 0;
+    ClockNanos started = clockRealNanos();
+    const char* data = (const char*)file.data;
+    const char* fileEnd = data + file.size;
+    for (const char* lineStart = data; lineStart < fileEnd; ) {
+        const char* newline = (const char*)memchr(lineStart, '\n', fileEnd - lineStart);
+        const char* lineEnd = newline != NULL ? newline : fileEnd;
+        lines++;
+        NotationError error;
+        if (parseNotation(lineStart, lineEnd, moves, error)) {
+            totalMoves += (long long)moves.size();
+            if (out != NULL && !moves.empty()) {
+                formatMoveCodes(&moves[0], (int)moves.size(), outBuffer);
+            }
+        } else {
+            if (invalidLines < NOTATION_MAX_REPORTED_ERRORS) {
+                printNotationError(path, lines, lineStart, lineEnd, error);
+            }
+            invalidLines++;
+        }
+        if (out != NULL) {
+            outBuffer += '\n';
+            if (outBuffer.size() >= (1 << 20)) {
+                fwrite(outBuffer.data(), 1, outBuffer.size(), out);
+                outBuffer.clear();
+            }
+        }
+        lineStart = lineEnd + 1;
+    }
+    double seconds = clockNanosToSeconds(clockRealNanos() - started);
+
+    bool writeFailed = false;
+    if (out != NULL) {
+        fwrite(outBuffer.data(), 1, outBuffer.size(), out);
+        writeFailed = ferror(out) != 0;
+        writeFailed = fclose(out) != 0 || writeFailed;
+    }
+    double megabytes = (double)file.size / (1024.0 * 1024.0);
+    double megabytesPerSecond = seconds > 0.0 ? megabytes / seconds : 0.0;
+    if (invalidLines > NOTATION_MAX_REPORTED_ERRORS) {
+        fprintf(stderr, "... và %lld dòng lỗi khác\n", invalidLines - NOTATION_MAX_REPORTED_ERRORS);
+    }
+    printf("PARSE: %s, %.1f MB, %lld dòng, %lld nước (mặt ngoài), %lld dòng lỗi\n",
+           path, megabytes, lines, totalMoves, invalidLines);
+    printf("  %.3fs, %.0f MB/s, %.1f triệu dòng/giây\n", seconds, megabytesPerSecond,
+           seconds > 0.0 ? (double)lines / seconds / 1e6 : 0.0);
+    if (writeFailed) {
+        fprintf(stderr, "Lỗi khi ghi file: %s\n", outPath);
+    }
+    RUBIK_LOG(EVT_PARSE_MOVES) << (int)lines << (int)std::min<long long>(totalMoves, 0x7FFFFFFF)
+                               << (int)invalidLines << megabytesPerSecond << path;
+    unmapFile(file);
+    return writeFailed ? 1 : (invalidLines > 0 ? 2 : 0);
+}
@@ -0,0 +1,387 @@
+#include "rubik_perf.h"
+#include "rubik_constants.h"
+#include "rubik_scheduler.h"
+#include "rubik_clock.h"
+#include "rubik_animation.h"
+#include "rubik_state.h"
+#include "rubik_log.h"
+#include <algorithm>
+#include <cstdio>
+
+bool g_perfHudVisible = false;
+
+// Vòng mẫu cố định: không cấp phát trong lúc chạy, mẫu mới đè lên mẫu cũ nhất
+static FrameSample s_samples[PERF_SAMPLE_COUNT];
+static int s_sampleHead = 0;       // Vị trí sẽ ghi mẫu kế tiếp
+static int s_sampleCount = 0;
+
+// Số liệu của frame đang đo
+static ClockNanos s_frameStart = 0;
+static ClockNanos s_lastFrameStart = -1;
+static ClockNanos s_swapStart = 0;
+static ClockNanos s_updateStart = 0;
+static float s_pendingUpdateMs = 0.0f;  // Cộng dồn các lần idle() trước frame này
+static int s_drawCalls = 0;
+static int s_vertices = 0;
+
+// Độ trễ phím: mỗi nước đã chấp nhận có một probe, cùng thứ tự với nước đang chạy
+// và hàng đợi (phần tử đầu là nước đang có animation)
+struct LatencyProbe {
+    ClockNanos arrivalNanos;   // -1: không đến từ phím (trộn, kéo chuột, phát lại) hoặc đã đo xong
+    ClockNanos stageNanos[LATENCY_STAGE_COUNT];
+    int queueDepth;
+};
+static const int LATENCY_PROBE_CAPACITY = MOVE_QUEUE_CAPACITY + 1;
+static LatencyProbe s_probes[LATENCY_PROBE_CAPACITY];
+static int s_probeHead = 0;
+static int s_probeCount = 0;
+static ClockNanos s_keyArrival = -1;   // Chỉ khác -1 trong lúc keyboard() đang xử lý phím
+
+static LatencySample s_latencySamples[LATENCY_SAMPLE_COUNT];
+static int s_latencyHead = 0;
+static int s_latencyCount = 0;
+static int s_latencyDropped = 0;
+
+void togglePerfHud() {
+    g_perfHudVisible = !g_perfHudVisible;
+    requestRedisplay();
+}
+
+void perfBeginUpdate() {
+    s_updateStart = clockRealNanos();
+}
+
+void perfEndUpdate() {
+    s_pendingUpdateMs += (float)clockNanosToMs(clockRealNanos() - s_updateStart);
+}
+
+void perfBeginFrame() {
+    s_frameStart = clockRealNanos();
+    s_drawCalls = 0;
+    s_vertices = 0;
+
+    // Frame đầu tiên mà mặt đang xoay đã lệch khỏi 0 độ là frame đầu tiên có chuyển động
+    if (s_probeCount > 0 && g_animation.isActive) {
+        LatencyProbe& probe = s_probes[s_probeHead];
+        if (probe.arrivalNanos >= 0 && probe.stageNanos[LATENCY_FIRST_FRAME] < 0 &&
+            getInterpolatedDisplayAngle() > 0.0f) {
+            probe.stageNanos[LATENCY_FIRST_FRAME] = s_frameStart;
+        }
+    }
+}
+
+void perfBeginSwap() {
+    s_swapStart = clockRealNanos();
+}
+
+void perfEndFrame() {
+    ClockNanos now = clockRealNanos();
+    FrameSample& sample = s_samples[s_sampleHead];
+    sample.updateMs = s_pendingUpdateMs;
+    sample.renderMs = (float)clockNanosToMs(s_swapStart - s_frameStart);
+    sample.swapMs = (float)clockNanosToMs(now - s_swapStart);
+    sample.drawCalls = s_drawCalls;
+    sample.vertices = s_vertices;
+    sample.queueDepth = g_moveQueue.count;
+
+    // Scheduler ngủ khi không có việc; khoảng nghỉ đó không phải frame chậm nên thay
+    // bằng thời gian làm việc thực của frame. Chỉ khi scheduler báo đã ngủ: frame chậm
+    // do swap bị chặn hay khựng dài vẫn được tính đủ
+    if (consumeSchedulerResume() || s_lastFrameStart < 0) {
+        sample.frameMs = sample.updateMs + (float)clockNanosToMs(now - s_frameStart);
+    } else {
+        sample.frameMs = (float)clockNanosToMs(s_frameStart - s_lastFrameStart);
+    }
+
+    s_lastFrameStart = s_frameStart;
+    s_pendingUpdateMs = 0.0f;
+    s_sampleHead = (s_sampleHead + 1) % PERF_SAMPLE_COUNT;
+    if (s_sampleCount < PERF_SAMPLE_COUNT) {
+        s_sampleCount++;
+    }
+
+    if (s_probeCount > 0) {
+        LatencyProbe& probe = s_probes[s_probeHead];
+        if (probe.arrivalNanos >= 0 && probe.stageNanos[LATENCY_FIRST_FRAME] >= 0) {
+            probe.stageNanos[LATENCY_SWAP] = now;
+            LatencySample& latency = s_latencySamples[s_latencyHead];
+            latency.arrivalNanos = probe.arrivalNanos;
+            for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+                latency.stageMs[stage] = (float)clockNanosToMs(probe.stageNanos[stage] - probe.arrivalNanos);
+            }
+            latency.queueDepth = probe.queueDepth;
+            probe.arrivalNanos = -1;
+            s_latencyHead = (s_latencyHead + 1) % LATENCY_SAMPLE_COUNT;
+            if (s_latencyCount < LATENCY_SAMPLE_COUNT) {
+                s_latencyCount++;
+            }
+        }
+    }
+}
+
+void perfKeyArrived() {
+    s_keyArrival = clockRealNanos();
+}
+
+void perfKeyHandled() {
+    s_keyArrival = -1;
+}
+
+// Gọi trong startRotation sau khi nước đi được chấp nhận, trước khi nó vào hàng đợi
+void perfMoveAccepted(bool isScrambleMove) {
+    if (s_probeCount >= LATENCY_PROBE_CAPACITY) {
+        return;
+    }
+    LatencyProbe& probe = s_probes[(s_probeHead + s_probeCount) % LATENCY_PROBE_CAPACITY];
+    s_probeCount++;
+    probe.arrivalNanos = isScrambleMove ? -1 : s_keyArrival;
+    s_keyArrival = -1;  // Một phím chỉ cho một nước (S trộn nhiều nước nhưng không đo)
+    if (probe.arrivalNanos < 0) {
+        return;
+    }
+    probe.stageNanos[LATENCY_ACCEPT] = clockRealNanos();
+    for (int stage = LATENCY_ANIM_START; stage < LATENCY_STAGE_COUNT; stage++) {
+        probe.stageNanos[stage] = -1;
+    }
+    probe.queueDepth = g_animation.isActive ? g_moveQueue.count + 1 : 0;
+}
+
+void perfAnimationStarted() {
+    if (s_probeCount > 0 && s_probes[s_probeHead].arrivalNanos >= 0) {
+        s_probes[s_probeHead].stageNanos[LATENCY_ANIM_START] = clockRealNanos();
+    }
+}
+
+void perfAnimationFinished() {
+    if (s_probeCount == 0) {
+        return;
+    }
+    if (s_probes[s_probeHead].arrivalNanos >= 0) {
+        s_latencyDropped++;  // Kết thúc mà chưa có frame nào vẽ chuyển động
+    }
+    s_probeHead = (s_probeHead + 1) % LATENCY_PROBE_CAPACITY;
+    s_probeCount--;
+}
+
+void perfMovesCancelled() {
+    for (int i = 0; i < s_probeCount; i++) {
+        if (s_probes[(s_probeHead + i) % LATENCY_PROBE_CAPACITY].arrivalNanos >= 0) {
+            s_latencyDropped++;
+        }
+    }
+    s_probeHead = 0;
+    s_probeCount = 0;
+}
+
+void perfCountDraw(int vertices) {
+    s_drawCalls++;
+    s_vertices += vertices;
+}
+
+// Percentile theo nearest-rank trên mảng đã sắp xếp
+static float percentile(const float* sorted, int count, float p) {
+    int rank = (int)(p * count + 0.999f);
+    if (rank < 1) {
+        rank = 1;
+    }
+    if (rank > count) {
+        rank = count;
+    }
+    return sorted[rank - 1];
+}
+
+void computePerfStats(PerfStats& stats) {
+    stats.sampleCount = s_sampleCount;
+    stats.lastFrameMs = 0.0f;
+    stats.p50FrameMs = 0.0f;
+    stats.p95FrameMs = 0.0f;
+    stats.p99FrameMs = 0.0f;
+    stats.maxFrameMs = 0.0f;
+    stats.avgUpdateMs = 0.0f;
+    stats.avgRenderMs = 0.0f;
+    stats.avgSwapMs = 0.0f;
+    stats.drawCalls = 0;
+    stats.vertices = 0;
+    stats.queueDepth = 0;
+    stats.maxQueueDepth = 0;
+    if (s_sampleCount == 0) {
+        return;
+    }
+
+    float sorted[PERF_SAMPLE_COUNT];
+    for (int i = 0; i < s_sampleCount; i++) {
+        const FrameSample& sample = s_samples[i];
+        sorted[i] = sample.frameMs;
+        stats.avgUpdateMs += sample.updateMs;
+        stats.avgRenderMs += sample.renderMs;
+        stats.avgSwapMs += sample.swapMs;
+        if (sample.queueDepth > stats.maxQueueDepth) {
+            stats.maxQueueDepth = sample.queueDepth;
+        }
+    }
+    std::sort(sorted, sorted + s_sampleCount);
+    stats.p50FrameMs = percentile(sorted, s_sampleCount, 0.50f);
+    stats.p95FrameMs = percentile(sorted, s_sampleCount, 0.95f);
+    stats.p99FrameMs = percentile(sorted, s_sampleCount, 0.99f);
+    stats.maxFrameMs = sorted[s_sampleCount - 1];
+    stats.avgUpdateMs /= s_sampleCount;
+    stats.avgRenderMs /= s_sampleCount;
+    stats.avgSwapMs /= s_sampleCount;
+
+    const FrameSample& last = s_samples[(s_sampleHead + PERF_SAMPLE_COUNT - 1) % PERF_SAMPLE_COUNT];
+    stats.lastFrameMs = last.frameMs;
+    stats.drawCalls = last.drawCalls;
+    stats.vertices = last.vertices;
+    stats.queueDepth = last.queueDepth;
+}
+
+bool dumpPerfHistogram(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        RUBIK_LOG(EVT_PERF_DUMP_FAILED) << path;
+        return false;
+    }
+
+    PerfStats stats;
+    computePerfStats(stats);
+    fprintf(file, "# Rubik perf: %d frame gần nhất\n", stats.sampleCount);
+    fprintf(file, "# frame ms: p50 %.3f p95 %.3f p99 %.3f max %.3f\n",
+            stats.p50FrameMs, stats.p95FrameMs, stats.p99FrameMs, stats.maxFrameMs);
+    fprintf(file, "# trung bình ms: update %.3f render %.3f swap %.3f\n",
+            stats.avgUpdateMs, stats.avgRenderMs, stats.avgSwapMs);
+    fprintf(file, "# hàng đợi tối đa: %d\n\n", stats.maxQueueDepth);
+
+    int buckets[PERF_HISTOGRAM_BUCKETS];
+    for (int b = 0; b < PERF_HISTOGRAM_BUCKETS; b++) {
+        buckets[b] = 0;
+    }
+    int maxBucket = 0;
+    for (int i = 0; i < s_sampleCount; i++) {
+        int b = (int)s_samples[i].frameMs;
+        if (b >= PERF_HISTOGRAM_BUCKETS) {
+            b = PERF_HISTOGRAM_BUCKETS - 1;
+        }
+        if (b < 0) {
+            b = 0;
+        }
+        buckets[b]++;
+        if (buckets[b] > maxBucket) {
+            maxBucket = buckets[b];
+        }
+    }
+    fprintf(file, "# histogram frame time (ô 1 ms)\n");
+    for (int b = 0; b < PERF_HISTOGRAM_BUCKETS; b++) {
+        if (buckets[b] == 0) {
+            continue;
+        }
+        int bar = maxBucket > 0 ? (buckets[b] * 50 + maxBucket - 1) / maxBucket : 0;
+        if (b == PERF_HISTOGRAM_BUCKETS - 1) {
+            fprintf(file, ">=%2d ms %5d ", b, buckets[b]);
+        } else {
+            fprintf(file, "%4d ms %5d ", b, buckets[b]);
+        }
+        for (int k = 0; k < bar; k++) {
+            fputc('#', file);
+        }
+        fputc('\n', file);
+    }
+
+    // Mẫu thô theo thứ tự thời gian, cũ nhất trước
+    fprintf(file, "\nframe_ms,update_ms,render_ms,swap_ms,draw_calls,vertices,queue_depth\n");
+    int start = (s_sampleHead - s_sampleCount + PERF_SAMPLE_COUNT) % PERF_SAMPLE_COUNT;
+    for (int i = 0; i < s_sampleCount; i++) {
+        const FrameSample& sample = s_samples[(start + i) % PERF_SAMPLE_COUNT];
+        fprintf(file, "%.3f,%.3f,%.3f,%.3f,%d,%d,%d\n",
+                sample.frameMs, sample.updateMs, sample.renderMs, sample.swapMs,
+                sample.drawCalls, sample.vertices, sample.queueDepth);
+    }
+    fclose(file);
+
+    RUBIK_LOG(EVT_PERF_DUMP) << stats.sampleCount << path;
+    return true;
+}
+
+void computeLatencyStats(LatencyStats& stats) {
+    stats.sampleCount = s_latencyCount;
+    stats.droppedCount = s_latencyDropped;
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        stats.p50Ms[stage] = 0.0f;
+        stats.p95Ms[stage] = 0.0f;
+        stats.p99Ms[stage] = 0.0f;
+        stats.maxMs[stage] = 0.0f;
+    }
+    if (s_latencyCount == 0) {
+        return;
+    }
+
+    float sorted[LATENCY_SAMPLE_COUNT];
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        for (int i = 0; i < s_latencyCount; i++) {
+            sorted[i] = s_latencySamples[i].stageMs[stage];
+        }
+        std::sort(sorted, sorted + s_latencyCount);
+        stats.p50Ms[stage] = percentile(sorted, s_latencyCount, 0.50f);
+        stats.p95Ms[stage] = percentile(sorted, s_latencyCount, 0.95f);
+        stats.p99Ms[stage] = percentile(sorted, s_latencyCount, 0.99f);
+        stats.maxMs[stage] = sorted[s_latencyCount - 1];
+    }
+}
+
+bool dumpLatencyHistogram(const char* path) {
+    static const char* const STAGE_NAMES[LATENCY_STAGE_COUNT] = {
+        "accept", "anim_start", "first_frame", "swap"
+    };
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        RUBIK_LOG(EVT_PERF_DUMP_FAILED) << path;
+        return false;
+    }
+
+    LatencyStats stats;
+    computeLatencyStats(stats);
+    fprintf(file, "# Rubik độ trễ phím -> màn hình: %d nước gần nhất, %d nước bị hủy trước khi hiện\n",
+            stats.sampleCount, stats.droppedCount);
+    fprintf(file, "# ms tính từ lúc phím tới keyboard(); swap là lúc glutSwapBuffers trả về\n");
+    fprintf(file, "stage,p50_ms,p95_ms,p99_ms,max_ms\n");
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        fprintf(file, "%s,%.3f,%.3f,%.3f,%.3f\n", STAGE_NAMES[stage],
+                stats.p50Ms[stage], stats.p95Ms[stage], stats.p99Ms[stage], stats.maxMs[stage]);
+    }
+
+    // Histogram phím -> swap, ô 1 ms; ô cuối gộp mọi mẫu chậm hơn
+    int buckets[LATENCY_HISTOGRAM_BUCKETS];
+    for (int b = 0; b < LATENCY_HISTOGRAM_BUCKETS; b++) {
+        buckets[b] = 0;
+    }
+    for (int i = 0; i < s_latencyCount; i++) {
+        int b = (int)s_latencySamples[i].stageMs[LATENCY_SWAP];
+        if (b >= LATENCY_HISTOGRAM_BUCKETS) {
+            b = LATENCY_HISTOGRAM_BUCKETS - 1;
+        }
+        if (b < 0) {
+            b = 0;
+        }
+        buckets[b]++;
+    }
+    fprintf(file, "\nswap_ms_bucket,count\n");
+    for (int b = 0; b < LATENCY_HISTOGRAM_BUCKETS; b++) {
+        if (buckets[b] != 0) {
+            fprintf(file, "%d,%d\n", b, buckets[b]);
+        }
+    }
+
+    // Mẫu thô theo thứ tự thời gian, cũ nhất trước
+    fprintf(file, "\narrival_s,accept_ms,anim_start_ms,first_frame_ms,swap_ms,queue_depth\n");
+    int start = (s_latencyHead - s_latencyCount + LATENCY_SAMPLE_COUNT) % LATENCY_SAMPLE_COUNT;
+    for (int i = 0; i < s_latencyCount; i++) {
+        const LatencySample& sample = s_latencySamples[(start + i) % LATENCY_SAMPLE_COUNT];
+        fprintf(file, "%.6f,%.3f,%.3f,%.3f,%.3f,%d\n", clockNanosToSeconds(sample.arrivalNanos),
+                sample.stageMs[LATENCY_ACCEPT], sample.stageMs[LATENCY_ANIM_START],
+                sample.stageMs[LATENCY_FIRST_FRAME], sample.stageMs[LATENCY_SWAP], sample.queueDepth);
+    }
+    fclose(file);
+
+    RUBIK_LOG(EVT_LATENCY_DUMP) << stats.sampleCount << stats.p50Ms[LATENCY_SWAP]
+                                << stats.p95Ms[LATENCY_SWAP] << stats.p99Ms[LATENCY_SWAP] << path;
+    return true;
+}
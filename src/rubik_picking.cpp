@@ -0,0 +1,211 @@
+#include "rubik_picking.h"
+#include "rubik_state.h"
+#include "rubik_render.h"
+#include "rubik_rotation.h"
+#include "rubik_constants.h"
+#include <cmath>
+
+// Mặt ngoài theo trục (0=X, 1=Y, 2=Z) và phía (0: âm, 1: dương)
+static const Face AXIS_FACES[3][2] = {
+    {LEFT, RIGHT},
+    {DOWN, UP},
+    {BACK, FRONT}
+};
+
+static int getFaceAxis(Face face) {
+    for (int axis = 0; axis < 3; axis++) {
+        if (AXIS_FACES[axis][0] == face || AXIS_FACES[axis][1] == face) {
+            return axis;
+        }
+    }
+    return 2;
+}
+
+// Ma trận camera của frame hiện tại (cùng cách tính với display())
+static void computeCameraMatrices(float view[16], float projection[16]) {
+    int width = g_windowWidth > 0 ? g_windowWidth : 1;
+    int height = g_windowHeight > 0 ? g_windowHeight : 1;
+    computeViewMatrix(view);
+    computeProjectionMatrix(projection, (float)width / (float)height);
+}
+
+void computePickRay(int x, int y, float origin[3], float direction[3]) {
+    float view[16];
+    float projection[16];
+    computeCameraMatrices(view, projection);
+    int width = g_windowWidth > 0 ? g_windowWidth : 1;
+    int height = g_windowHeight > 0 ? g_windowHeight : 1;
+
+    // Pixel -> NDC (lấy tâm pixel, trục y của chuột hướng xuống)
+    float ndcX = ((float)x + 0.5f) / (float)width * 2.0f - 1.0f;
+    float ndcY = 1.0f - ((float)y + 0.5f) / (float)height * 2.0f;
+
+    // Hướng tia trong không gian camera: nghịch đảo phần phối cảnh
+    // (projection[0] = f/aspect, projection[5] = f)
+    float eye[3] = {ndcX / projection[0], ndcY / projection[5], -1.0f};
+
+    // View là phép biến đổi cứng: nghịch đảo của R là R^T, vị trí camera là -R^T * t
+    float length = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        direction[i] = view[i * 4 + 0] * eye[0] + view[i * 4 + 1] * eye[1] + view[i * 4 + 2] * eye[2];
+        origin[i] = -(view[i * 4 + 0] * view[12] + view[i * 4 + 1] * view[13] + view[i * 4 + 2] * view[14]);
+        length += direction[i] * direction[i];
+    }
+    length = sqrtf(length);
+    for (int i = 0; i < 3; i++) {
+        direction[i] /= length;
+    }
+}
+
+// Giao tia với hộp bao của khối (phương pháp slab), rồi suy ra ô sticker trực
+// tiếp từ toạ độ điểm chạm: không phải duyệt từng mảnh
+bool pickSticker(const float origin[3], const float direction[3], StickerHit& hit) {
+    const float spacing = g_visualCube.pieceSize + g_visualCube.gapSize;
+    const float half = spacing + g_visualCube.pieceSize * 0.5f;
+
+    float tNear = -1.0e30f;
+    float tFar = 1.0e30f;
+    int nearAxis = -1;
+    for (int axis = 0; axis < 3; axis++) {
+        if (fabsf(direction[axis]) < 1.0e-8f) {
+            // Tia song song với cặp mặt này: phải nằm giữa hai mặt
+            if (origin[axis] < -half || origin[axis] > half) {
+                return false;
+            }
+            continue;
+        }
+        float t1 = (-half - origin[axis]) / direction[axis];
+        float t2 = (half - origin[axis]) / direction[axis];
+        if (t1 > t2) {
+            float temp = t1;
+            t1 = t2;
+            t2 = temp;
+        }
+        if (t1 > tNear) {
+            tNear = t1;
+            nearAxis = axis;
+        }
+        if (t2 < tFar) {
+            tFar = t2;
+        }
+        if (tNear > tFar) {
+            return false;
+        }
+    }
+    // Camera nằm trong khối hoặc khối ở sau camera
+    if (nearAxis < 0 || tNear < 0.0f) {
+        return false;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        hit.point[i] = origin[i] + direction[i] * tNear;
+    }
+    int side = hit.point[nearAxis] > 0.0f ? 1 : 0;
+    hit.face = AXIS_FACES[nearAxis][side];
+    hit.distance = tNear;
+    for (int axis = 0; axis < 3; axis++) {
+        if (axis == nearAxis) {
+            hit.grid[axis] = side ? 1 : -1;
+            continue;
+        }
+        // Ô gần nhất (điểm chạm rơi vào khe giữa hai sticker thì lấy ô gần hơn)
+        int cell = (int)floorf(hit.point[axis] / spacing + 0.5f);
+        if (cell < -1) {
+            cell = -1;
+        } else if (cell > 1) {
+            cell = 1;
+        }
+        hit.grid[axis] = cell;
+    }
+    return true;
+}
+
+bool pickStickerAt(int x, int y, StickerHit& hit) {
+    float origin[3];
+    float direction[3];
+    computePickRay(x, y, origin, direction);
+    return pickSticker(origin, direction, hit);
+}
+
+// Chiếu một điểm thế giới lên màn hình (pixel, trục y hướng xuống như toạ độ chuột)
+static bool projectToScreen(const float clip[16], const float point[3], float screen[2]) {
+    float out[4];
+    transformPoint4(clip, point, out);
+    if (out[3] <= 1.0e-6f) {
+        return false;
+    }
+    screen[0] = out[0] / out[3] * (float)g_windowWidth * 0.5f;
+    screen[1] = -out[1] / out[3] * (float)g_windowHeight * 0.5f;
+    return true;
+}
+
+bool computeDragTurn(const StickerHit& hit, int dx, int dy, Face& face, bool& clockwise) {
+    float view[16];
+    float projection[16];
+    float clip[16];
+    computeCameraMatrices(view, projection);
+    multiplyMatrix4(clip, projection, view);
+
+    float origin[2];
+    if (!projectToScreen(clip, hit.point, origin)) {
+        return false;
+    }
+
+    // Hai trục xoay có thể (vuông góc với pháp tuyến mặt được chạm): với mỗi
+    // trục, điểm chạm xoay dương một góc nhỏ sẽ đi theo vận tốc axis x p.
+    // Chọn trục mà vận tốc đó chiếu lên màn hình đi xa nhất theo hướng kéo
+    // (không chuẩn hoá, để mặt nhìn gần như song song tia nhìn không thắng chỉ
+    // nhờ hướng), dấu của tích vô hướng cho chiều xoay
+    const float step = 0.05f;
+    int normalAxis = getFaceAxis(hit.face);
+    int turnAxis = -1;
+    float turnSign = 1.0f;
+    float bestScore = 0.0f;
+    float bestAlignment = 0.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        if (axis == normalAxis) {
+            continue;
+        }
+        float moved[3] = {hit.point[0], hit.point[1], hit.point[2]};
+        int a1 = (axis + 1) % 3;
+        int a2 = (axis + 2) % 3;
+        moved[a1] -= hit.point[a2] * step;
+        moved[a2] += hit.point[a1] * step;
+        float screen[2];
+        if (!projectToScreen(clip, moved, screen)) {
+            continue;
+        }
+        float ux = screen[0] - origin[0];
+        float uy = screen[1] - origin[1];
+        float length = sqrtf(ux * ux + uy * uy);
+        if (length < 1.0e-4f) {
+            continue;
+        }
+        float score = ux * (float)dx + uy * (float)dy;
+        if (fabsf(score) > bestScore) {
+            bestScore = fabsf(score);
+            bestAlignment = bestScore / length;
+            turnAxis = axis;
+            turnSign = score > 0.0f ? 1.0f : -1.0f;
+        }
+    }
+    // Hướng kéo lệch quá xa hướng sticker di chuyển (thường là kéo theo pháp
+    // tuyến của mặt) thì không đoán
+    float dragLength = sqrtf((float)(dx * dx + dy * dy));
+    if (turnAxis < 0 || bestAlignment < PICK_DRAG_MIN_ALIGNMENT * dragLength) {
+        return false;
+    }
+
+    int layer = hit.grid[turnAxis];
+    if (layer == 0) {
+        return false;
+    }
+    face = AXIS_FACES[turnAxis][layer > 0 ? 1 : 0];
+
+    // So chiều mong muốn với chiều của nước xuôi chiều kim đồng hồ (cùng quy
+    // ước glRotatef với animation) để chọn xuôi/ngược
+    float faceAxis[3];
+    float clockwiseAngle = getFaceRotation(face, true, 90.0f, faceAxis);
+    clockwise = (clockwiseAngle * faceAxis[turnAxis] > 0.0f) == (turnSign > 0.0f);
+    return true;
+}
@@ -0,0 +1,234 @@
+#include "rubik_profiler.h"
+#include "rubik_clock.h"
+#include "rubik_log.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+volatile int g_profilerEnabled = 0;
+RUBIK_THREAD_LOCAL ProfileThreadBuffer* t_profileBuffer = 0;
+static RUBIK_THREAD_LOCAL const char* t_profileThreadName = 0;
+
+// Danh sách bộ đệm của mọi luồng đã từng ghi vùng; không bao giờ giải phóng
+// (luồng đã kết thúc vẫn còn dữ liệu cần xuất)
+static RubikMutex s_threadsMutex;
+static ProfileThreadBuffer* s_threads[PROFILE_MAX_THREADS];
+static int s_threadCount = 0;
+
+// Luồng đến sau khi đã đủ PROFILE_MAX_THREADS: t_profileBuffer trỏ vào bộ đệm rỗng
+// này (events == NULL) để ProfileZone bỏ qua mà không khoá lại, và được đếm để
+// trace báo là thiếu
+ProfileThreadBuffer g_profileNoBuffer = { NULL, 0, 0, 0, "" };
+static int s_droppedThreads = 0;
+
+// Mốc của phiên đo và cặp (tick, giây) để quy đổi tick sang micro giây
+static ProfileTicks s_captureStartTicks = 0;
+static ProfileTicks s_captureEndTicks = 0;
+static ProfileTicks s_calibrationTicks = 0;
+static ClockNanos s_calibrationNanos = 0;
+static bool s_initialized = false;
+
+static const char* s_exitTracePath = NULL;   // RUBIK_PROFILE: ghi khi thoát
+
+static void copyThreadName(ProfileThreadBuffer& buffer, const char* name) {
+    strncpy(buffer.threadName, name, sizeof(buffer.threadName) - 1);
+    buffer.threadName[sizeof(buffer.threadName) - 1] = '\0';
+}
+
+ProfileThreadBuffer* registerProfileThread() {
+    if (!s_initialized) {
+        return NULL;
+    }
+    lockMutex(s_threadsMutex);
+    ProfileThreadBuffer* buffer = NULL;
+    if (s_threadCount < PROFILE_MAX_THREADS) {
+        buffer = new ProfileThreadBuffer;
+        buffer->events = new ProfileEvent[PROFILE_EVENTS_PER_THREAD];
+        buffer->count = 0;
+        buffer->dropped = 0;
+        buffer->threadId = s_threadCount + 1;
+        if (t_profileThreadName != NULL) {
+            copyThreadName(*buffer, t_profileThreadName);
+        } else {
+            sprintf(buffer->threadName, "thread %d", buffer->threadId);
+        }
+        s_threads[s_threadCount++] = buffer;
+        t_profileBuffer = buffer;
+    } else {
+        s_droppedThreads++;
+        t_profileBuffer = &g_profileNoBuffer;
+    }
+    unlockMutex(s_threadsMutex);
+    return buffer;
+}
+
+void setProfilerThreadName(const char* name) {
+    t_profileThreadName = name;
+    if (t_profileBuffer != 0 && t_profileBuffer != &g_profileNoBuffer) {
+        lockMutex(s_threadsMutex);
+        copyThreadName(*t_profileBuffer, name);
+        unlockMutex(s_threadsMutex);
+    }
+}
+
+static void writeExitTrace() {
+    stopProfileCapture();
+    writeProfileTrace(s_exitTracePath);
+}
+
+void initProfiler() {
+    if (s_initialized) {
+        return;
+    }
+    initMutex(s_threadsMutex);
+    s_calibrationTicks = readProfileTicks();
+    s_calibrationNanos = clockRealNanos();
+    s_initialized = true;
+    setProfilerThreadName("main");
+
+    const char* path = getenv("RUBIK_PROFILE");
+    if (path != NULL && path[0] != '\0') {
+        s_exitTracePath = path;
+        startProfileCapture();
+        atexit(writeExitTrace);
+    }
+}
+
+void startProfileCapture() {
+    if (!s_initialized) {
+        return;
+    }
+    // Vùng đang dở ở luồng khác có thể ghi vào phiên mới; bộ xuất lọc theo mốc bắt đầu
+    lockMutex(s_threadsMutex);
+    for (int i = 0; i < s_threadCount; i++) {
+        s_threads[i]->count = 0;
+        s_threads[i]->dropped = 0;
+    }
+    unlockMutex(s_threadsMutex);
+    s_captureStartTicks = readProfileTicks();
+    s_captureEndTicks = 0;
+    atomicStore(&g_profilerEnabled, 1);
+}
+
+void stopProfileCapture() {
+    if (atomicLoad(&g_profilerEnabled) == 0) {
+        return;
+    }
+    atomicStore(&g_profilerEnabled, 0);
+    s_captureEndTicks = readProfileTicks();
+}
+
+bool isProfileCaptureActive() {
+    return g_profilerEnabled != 0;
+}
+
+// Số tick mỗi micro giây. Với TSC, đo lại theo clockRealNanos (khoảng đo càng
+// dài càng chính xác); nếu không, tick chính là nano giây
+static double computeTicksPerMicrosecond() {
+#if defined(_MSC_VER) || defined(__i386__) || defined(__x86_64__)
+    while (clockRealNanos() - s_calibrationNanos < PROFILE_CALIBRATION_NANOS) {
+        sleepMilliseconds(1);
+    }
+    ProfileTicks ticks = readProfileTicks();
+    ClockNanos nanos = clockRealNanos();
+    return (double)(ticks - s_calibrationTicks) * 1000.0 / (double)(nanos - s_calibrationNanos);
+#else
+    return 1000.0;
+#endif
+}
+
+// Tên vùng là chuỗi hằng trong mã nguồn, chỉ cần thoát " và '\'
+static void writeJsonString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+        }
+        fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+bool writeProfileTrace(const char* path) {
+    if (!s_initialized) {
+        return false;
+    }
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        RUBIK_LOG(EVT_PROFILE_WRITE_FAILED) << path;
+        return false;
+    }
+
+    double ticksPerMicrosecond = computeTicksPerMicrosecond();
+    ProfileTicks captureEnd = s_captureEndTicks != 0 ? s_captureEndTicks : readProfileTicks();
+    int zoneCount = 0;
+    int droppedCount = 0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"rubik\"}}");
+
+    lockMutex(s_threadsMutex);
+    int droppedThreads = s_droppedThreads;
+    if (droppedThreads > 0) {
+        // Đánh dấu ngay đầu trace để người xem biết thiếu luồng
+        fprintf(file, ",\n{\"name\":\"profiler: %d luồng không được ghi\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":0,"
+                      "\"args\":{\"droppedThreads\":%d,\"maxThreads\":%d}}",
+                droppedThreads, droppedThreads, PROFILE_MAX_THREADS);
+    }
+    for (int t = 0; t < s_threadCount; t++) {
+        const ProfileThreadBuffer& buffer = *s_threads[t];
+        int count = atomicLoad((volatile int*)&buffer.count);
+        if (count > PROFILE_EVENTS_PER_THREAD) {
+            count = PROFILE_EVENTS_PER_THREAD;
+        }
+        droppedCount += buffer.dropped;
+
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", buffer.threadId);
+        writeJsonString(file, buffer.threadName);
+        fprintf(file, "}}");
+
+        for (int i = 0; i < count; i++) {
+            const ProfileEvent& event = buffer.events[i];
+            if (event.start < s_captureStartTicks || event.end > captureEnd || event.end < event.start) {
+                continue;
+            }
+            double startUs = (double)(event.start - s_captureStartTicks) / ticksPerMicrosecond;
+            double durationUs = (double)(event.end - event.start) / ticksPerMicrosecond;
+            fprintf(file, ",\n{\"name\":");
+            writeJsonString(file, event.name);
+            fprintf(file, ",\"cat\":\"rubik\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    buffer.threadId, startUs, durationUs);
+            zoneCount++;
+        }
+    }
+    unlockMutex(s_threadsMutex);
+
+    fprintf(file, "\n]}\n");
+    bool ok = ferror(file) == 0;
+    ok = fclose(file) == 0 && ok;
+    if (droppedCount > 0) {
+        printf("PROFILE: %d vùng bị bỏ vì bộ đệm luồng đầy (%d vùng/luồng)\n",
+               droppedCount, PROFILE_EVENTS_PER_THREAD);
+    }
+    if (droppedThreads > 0) {
+        printf("PROFILE: %d luồng không được ghi vì đã đủ %d luồng, trace không đầy đủ\n",
+               droppedThreads, PROFILE_MAX_THREADS);
+    }
+    printf("PROFILE: %d vùng, %d luồng -> %s\n", zoneCount, s_threadCount, path);
+    RUBIK_LOG(EVT_PROFILE_WRITTEN) << zoneCount << s_threadCount << droppedCount << droppedThreads << path;
+    return ok;
+}
+
+void toggleProfileCapture() {
+    if (!isProfileCaptureActive()) {
+        startProfileCapture();
+        printf("PROFILE: bắt đầu ghi (F5 để dừng)\n");
+        return;
+    }
+    stopProfileCapture();
+    // Mỗi lần dừng ghi một file mới, giống F4
+    static int traceIndex = 0;
+    char path[64];
+    sprintf(path, "rubik_profile_%d.json", ++traceIndex);
+    writeProfileTrace(path);
+}
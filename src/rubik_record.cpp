@@ -0,0 +1,966 @@
+#include "rubik_record.h"
+#include "rubik_state.h"
+#include "rubik_rotation.h"
+#include "rubik_animation.h"
+#include "rubik_timer.h"
+#include "rubik_input.h"
+#include "rubik_scheduler.h"
+#include "rubik_clock.h"
+#include "rubik_constants.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
+#include "rubik_thread.h"
+#include "rubik_statecodec.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <string>
+#include <vector>
+
+static const char RECORD_MAGIC[4] = {'R', 'B', 'R', 'C'};
+static const int RECORD_MAX_EVENT_BYTES = 1 + 10 * 3;  // Tag + tối đa 3 varint
+
+// ==================== Mã hoá ====================
+
+static int writeVarint(unsigned char* out, unsigned long long value) {
+    int length = 0;
+    while (value >= 0x80) {
+        out[length++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (unsigned char)value;
+    return length;
+}
+
+static bool readVarint(const unsigned char* data, long long size, long long& offset, unsigned long long& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (offset >= size) {
+            return false;
+        }
+        unsigned char byte = data[offset++];
+        value |= (unsigned long long)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Số có dấu nhỏ (cả âm) thành varint ngắn: 0, -1, 1, -2 ... -> 0, 1, 2, 3 ...
+static unsigned long long zigzagEncode(int value) {
+    return ((unsigned int)value << 1) ^ (unsigned int)(value >> 31);
+}
+
+static int zigzagDecode(unsigned long long value) {
+    unsigned int bits = (unsigned int)value;
+    return (int)(bits >> 1) ^ -(int)(bits & 1);
+}
+
+// Đọc một sự kiện tại cursor và tiến cursor; false khi hết luồng hoặc sự kiện bị cắt dở
+static bool readRecordEvent(const unsigned char* stream, long long size, RecordCursor& cursor, RecordEvent& event) {
+    long long offset = cursor.offset;
+    if (offset >= size) {
+        return false;
+    }
+    unsigned char tag = stream[offset++];
+    unsigned long long delta;
+    if (!readVarint(stream, size, offset, delta)) {
+        return false;
+    }
+    event.type = tag >> 5;
+    event.timeNanos = cursor.timeNanos + (ClockNanos)delta * RECORD_TIME_UNIT_NANOS;
+    event.face = tag & 7;
+    event.clockwise = (tag & 8) == 0;
+    event.isScrambleMove = (tag & 16) != 0;
+    event.count = 0;
+    event.cameraX = cursor.cameraX;
+    event.cameraY = cursor.cameraY;
+    switch (event.type) {
+        case RECORD_MOVE:
+            if (event.face > DOWN) {
+                return false;
+            }
+            break;
+        case RECORD_CAMERA: {
+            unsigned long long dx, dy;
+            if (event.face > DOWN || !readVarint(stream, size, offset, dx) ||
+                !readVarint(stream, size, offset, dy)) {
+                return false;
+            }
+            event.cameraX += zigzagDecode(dx);
+            event.cameraY += zigzagDecode(dy);
+            break;
+        }
+        case RECORD_SCRAMBLE: {
+            unsigned long long count;
+            if (!readVarint(stream, size, offset, count)) {
+                return false;
+            }
+            event.count = (int)count;
+            break;
+        }
+        case RECORD_RESET:
+            break;
+        default:
+            return false;
+    }
+    cursor.offset = offset;
+    cursor.timeNanos = event.timeNanos;
+    cursor.cameraX = event.cameraX;
+    cursor.cameraY = event.cameraY;
+    cursor.eventIndex++;
+    if (event.type == RECORD_MOVE) {
+        cursor.moveIndex++;
+    }
+    return true;
+}
+
+// ==================== Checkpoint ====================
+
+// Màu đã giải của từng mặt, cùng thứ tự FRONT..DOWN với initRubikCube
+static const float* const FACE_COLORS[6] = {
+    COLOR_RED, COLOR_ORANGE, COLOR_GREEN, COLOR_BLUE, COLOR_WHITE, COLOR_YELLOW
+};
+
+static unsigned char colorToFaceIndex(const float* color) {
+    int best = 0;
+    float bestDiff = 1e9f;
+    for (int face = 0; face < 6; face++) {
+        float diff = fabs(color[0] - FACE_COLORS[face][0]) +
+                     fabs(color[1] - FACE_COLORS[face][1]) +
+                     fabs(color[2] - FACE_COLORS[face][2]);
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            best = face;
+        }
+    }
+    return (unsigned char)best;
+}
+
+static void captureFacelets(const RubikCube& cube, unsigned char facelets[54]) {
+    int indices[9];
+    for (int face = 0; face < 6; face++) {
+        getFaceIndices(face, indices);
+        for (int i = 0; i < 9; i++) {
+            facelets[face * 9 + i] = colorToFaceIndex(cube.pieces[indices[i]].colors[face]);
+        }
+    }
+}
+
+// Mặt trong của mọi mảnh luôn đen ở mọi trạng thái hợp lệ, chỉ cần ghi đè 54 sticker
+static void applyFacelets(RubikCube& cube, const unsigned char facelets[54]) {
+    int indices[9];
+    for (int face = 0; face < 6; face++) {
+        getFaceIndices(face, indices);
+        for (int i = 0; i < 9; i++) {
+            const float* color = FACE_COLORS[facelets[face * 9 + i] % 6];
+            float* sticker = cube.pieces[indices[i]].colors[face];
+            sticker[0] = color[0];
+            sticker[1] = color[1];
+            sticker[2] = color[2];
+        }
+    }
+}
+
+static int quantizeCameraAngle(float degrees) {
+    return (int)floor(degrees / RECORD_CAMERA_UNIT_DEGREES + 0.5f);
+}
+
+static void applyCamera(int cameraX, int cameraY, int frontFace) {
+    cameraAngleX = (float)cameraX * RECORD_CAMERA_UNIT_DEGREES;
+    cameraAngleY = (float)cameraY * RECORD_CAMERA_UNIT_DEGREES;
+    if (currentFrontFace != (Face)frontFace) {
+        currentFrontFace = (Face)frontFace;
+        updateRotationAxes();
+    }
+}
+
+// Nước trộn đã được chấp nhận nhưng animation chưa chạy xong
+static int countScrambleMovesInFlight() {
+    int count = (g_animation.isActive && g_animation.isScrambleMove) ? 1 : 0;
+    for (int i = 0; i < g_moveQueue.count; i++) {
+        if (g_moveQueue.scrambleFlags[(g_moveQueue.head + i) % MOVE_QUEUE_CAPACITY]) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Chụp trạng thái hiện tại (trước sự kiện tại cursor). Animation đang chạy được coi
+// như đã xong: seek luôn đưa về trạng thái đứng yên
+static void captureCheckpoint(RecordCheckpoint& checkpoint, const RecordCursor& cursor,
+                              int frontFace, ClockNanos origin) {
+    memset(&checkpoint, 0, sizeof(checkpoint));
+    checkpoint.timeNanos = cursor.timeNanos;
+    checkpoint.streamOffset = cursor.offset;
+    checkpoint.moveIndex = cursor.moveIndex;
+    checkpoint.eventIndex = cursor.eventIndex;
+    checkpoint.cameraX = cursor.cameraX;
+    checkpoint.cameraY = cursor.cameraY;
+    checkpoint.frontFace = (unsigned char)frontFace;
+    captureFacelets(g_rubikCube, checkpoint.facelets);
+
+    int pending = g_scrambleMovesPending;
+    int remaining = pending - countScrambleMovesInFlight();
+    checkpoint.scramblePending = remaining > 0 ? remaining : 0;
+    checkpoint.timerState = (unsigned char)g_timer.state;
+    if (g_timer.state == TIMER_RUNNING || g_timer.state == TIMER_STOPPED) {
+        checkpoint.timerStartNanos = g_timer.startNanos - origin;
+        checkpoint.timerEndTime = g_timer.endTime;
+        checkpoint.timerMoveCount = g_timer.moveCount;
+    }
+    if (pending > 0 && remaining <= 0) {
+        // Chỉ còn chờ animation của nước trộn cuối: timer coi như đã hẹn giờ
+        checkpoint.timerState = (unsigned char)TIMER_READY;
+    }
+}
+
+static void restoreCheckpoint(const RecordCheckpoint& checkpoint) {
+    cancelAnimationAndQueue();
+    applyFacelets(g_rubikCube, checkpoint.facelets);
+    syncVisualCube();
+    g_scrambleMovesPending = checkpoint.scramblePending;
+    resetTimerState();
+    g_timer.state = (TimerState)checkpoint.timerState;
+    if (g_timer.state == TIMER_RUNNING || g_timer.state == TIMER_STOPPED) {
+        g_timer.startNanos = checkpoint.timerStartNanos;
+        g_timer.endTime = checkpoint.timerEndTime;
+        g_timer.moveCount = checkpoint.timerMoveCount;
+    }
+    if (g_timer.state == TIMER_STOPPED && g_timer.endTime > 0.0) {
+        g_timer.currentTime = g_timer.endTime;
+        g_timer.tps = (float)((double)g_timer.moveCount / g_timer.endTime);
+    }
+    applyCamera(checkpoint.cameraX, checkpoint.cameraY, checkpoint.frontFace);
+}
+
+static void cursorFromCheckpoint(RecordCursor& cursor, const RecordCheckpoint& checkpoint) {
+    cursor.offset = checkpoint.streamOffset;
+    cursor.timeNanos = checkpoint.timeNanos;
+    cursor.cameraX = checkpoint.cameraX;
+    cursor.cameraY = checkpoint.cameraY;
+    cursor.moveIndex = checkpoint.moveIndex;
+    cursor.eventIndex = checkpoint.eventIndex;
+}
+
+// Áp dụng ngay, không animation (seek, dựng lại chỉ mục): nước trộn xong ngay lập tức
+static void applyEventInstant(const RecordEvent& event) {
+    setVirtualClock(event.timeNanos);
+    switch (event.type) {
+        case RECORD_MOVE:
+            rotateFace(event.face, event.clockwise);
+            onMoveAccepted(event.isScrambleMove);
+            handleScrambleMoveCompletion(event.isScrambleMove);
+            break;
+        case RECORD_CAMERA:
+            applyCamera(event.cameraX, event.cameraY, event.face);
+            break;
+        case RECORD_SCRAMBLE:
+            beginScramble(event.count);
+            break;
+        case RECORD_RESET:
+            resetCube();
+            break;
+    }
+}
+
+// Phát lại qua đúng đường đi của input (startRotation, hàng đợi, animation)
+static void applyEventLive(const RecordEvent& event) {
+    switch (event.type) {
+        case RECORD_MOVE:
+            // Ở tốc độ cao animation có thể tụt sau sự kiện: cho hàng đợi chạy bớt
+            // thay vì để startRotation bỏ nước đi (trạng thái sẽ lệch khỏi bản ghi)
+            while (g_animation.isActive && g_moveQueue.count >= MOVE_QUEUE_CAPACITY) {
+                stepSimulation();
+            }
+            startRotation((Face)event.face, event.clockwise, event.isScrambleMove);
+            break;
+        case RECORD_CAMERA:
+            applyCamera(event.cameraX, event.cameraY, event.face);
+            requestRedisplay();
+            break;
+        case RECORD_SCRAMBLE:
+            beginScramble(event.count);
+            break;
+        case RECORD_RESET:
+            resetCube();
+            requestRedisplay();
+            break;
+    }
+}
+
+// ==================== Ghi ====================
+
+static FILE* s_recordFile = NULL;
+static std::string s_recordPath;
+static RecordFileHeader s_recordHeader;
+static std::vector<RecordCheckpoint> s_recordCheckpoints;
+static RecordCursor s_recordCursor;        // Cùng ý nghĩa với khi đọc: vị trí và gốc delta
+static int s_recordFrontFace = FRONT;
+static ClockNanos s_recordOrigin = 0;
+static int s_movesSinceCheckpoint = 0;
+static int s_eventsSinceCheckpoint = 0;
+static bool s_recordFailed = false;
+static bool s_removeIfEmpty = false;       // Phiên tự động không có sự kiện nào thì không giữ file
+
+bool isRecording() {
+    return s_recordFile != NULL;
+}
+
+bool startRecording(const char* path) {
+    if (s_recordFile != NULL) {
+        finishRecording();
+    }
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        RUBIK_LOG(EVT_RECORD_WRITE_FAILED) << path;
+        return false;
+    }
+    s_recordPath = path;
+    memset(&s_recordHeader, 0, sizeof(s_recordHeader));
+    memcpy(s_recordHeader.magic, RECORD_MAGIC, sizeof(RECORD_MAGIC));
+    s_recordHeader.version = RECORD_FORMAT_VERSION;
+    s_recordHeader.checkpointBytes = sizeof(RecordCheckpoint);
+    s_recordHeader.checkpointMoves = RECORD_CHECKPOINT_MOVES;
+    s_recordHeader.checkpointEvents = RECORD_CHECKPOINT_EVENTS;
+    s_recordHeader.streamOffset = sizeof(RecordFileHeader) + sizeof(RecordCheckpoint);
+    s_recordHeader.startUnixTime = (long long)time(NULL);
+
+    s_recordOrigin = clockNowNanos();
+    memset(&s_recordCursor, 0, sizeof(s_recordCursor));
+    s_recordCursor.cameraX = quantizeCameraAngle(cameraAngleX);
+    s_recordCursor.cameraY = quantizeCameraAngle(cameraAngleY);
+    s_recordFrontFace = currentFrontFace;
+    s_movesSinceCheckpoint = 0;
+    s_eventsSinceCheckpoint = 0;
+    s_recordFailed = false;
+
+    // Checkpoint đầu nằm ngay sau header (file chưa đóng vẫn có trạng thái ban đầu)
+    RecordCheckpoint initial;
+    captureCheckpoint(initial, s_recordCursor, s_recordFrontFace, s_recordOrigin);
+    s_recordCheckpoints.clear();
+    s_recordCheckpoints.push_back(initial);
+    if (fwrite(&s_recordHeader, sizeof(s_recordHeader), 1, file) != 1 ||
+        fwrite(&initial, sizeof(initial), 1, file) != 1) {
+        s_recordFailed = true;
+    }
+    s_recordFile = file;
+
+    static bool exitHandlerRegistered = false;
+    if (!exitHandlerRegistered) {
+        exitHandlerRegistered = true;
+        atexit(finishRecording);
+    }
+    RUBIK_LOG(EVT_RECORD_STARTED) << path;
+    return true;
+}
+
+void finishRecording() {
+    if (s_recordFile == NULL) {
+        return;
+    }
+    FILE* file = s_recordFile;
+    s_recordFile = NULL;
+
+    s_recordHeader.eventCount = (unsigned int)s_recordCursor.eventIndex;
+    s_recordHeader.moveCount = (unsigned int)s_recordCursor.moveIndex;
+    s_recordHeader.streamBytes = s_recordCursor.offset;
+    s_recordHeader.durationNanos = s_recordCursor.timeNanos;
+    s_recordHeader.checkpointCount = (unsigned int)s_recordCheckpoints.size();
+
+    // Bảng checkpoint căn 8 byte để đọc thẳng từ vùng nhớ map
+    static const unsigned char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    long long end = s_recordHeader.streamOffset + s_recordHeader.streamBytes;
+    int padBytes = (int)((8 - end % 8) % 8);
+    s_recordHeader.indexOffset = end + padBytes;
+    bool ok = !s_recordFailed;
+    ok = fwrite(padding, 1, padBytes, file) == (size_t)padBytes && ok;
+    ok = fwrite(&s_recordCheckpoints[0], sizeof(RecordCheckpoint), s_recordCheckpoints.size(), file) ==
+         s_recordCheckpoints.size() && ok;
+    ok = fseek(file, 0, SEEK_SET) == 0 && ok;
+    ok = fwrite(&s_recordHeader, sizeof(s_recordHeader), 1, file) == 1 && ok;
+    ok = fclose(file) == 0 && ok;
+
+    if (s_removeIfEmpty && s_recordHeader.eventCount == 0) {
+        remove(s_recordPath.c_str());
+        return;
+    }
+    if (!ok) {
+        RUBIK_LOG(EVT_RECORD_WRITE_FAILED) << s_recordPath.c_str();
+        return;
+    }
+    long long fileBytes = s_recordHeader.indexOffset +
+                          (long long)s_recordCheckpoints.size() * (long long)sizeof(RecordCheckpoint);
+    RUBIK_LOG(EVT_RECORD_FINISHED) << (int)s_recordHeader.eventCount << (int)s_recordHeader.moveCount
+                                   << (int)s_recordHeader.checkpointCount << (int)fileBytes
+                                   << s_recordPath.c_str();
+}
+
+void initSessionRecording() {
+    const char* path = getenv("RUBIK_RECORD");
+    if (path != NULL && (strcmp(path, "off") == 0 || strcmp(path, "0") == 0)) {
+        return;
+    }
+    char defaultPath[64];
+    if (path == NULL || path[0] == '\0') {
+        time_t now = time(NULL);
+        strftime(defaultPath, sizeof(defaultPath), "rubik_session_%Y%m%d_%H%M%S.rrec", localtime(&now));
+        path = defaultPath;
+        s_removeIfEmpty = true;
+    }
+    startRecording(path);
+}
+
+// Ghi một sự kiện; checkpoint (nếu tới hạn) được chụp trước, khi trạng thái chưa đổi
+static void writeRecordEvent(int type, int low, const unsigned char* payload, int payloadLength) {
+    if (s_movesSinceCheckpoint >= RECORD_CHECKPOINT_MOVES || s_eventsSinceCheckpoint >= RECORD_CHECKPOINT_EVENTS) {
+        RecordCheckpoint checkpoint;
+        captureCheckpoint(checkpoint, s_recordCursor, s_recordFrontFace, s_recordOrigin);
+        s_recordCheckpoints.push_back(checkpoint);
+        s_movesSinceCheckpoint = 0;
+        s_eventsSinceCheckpoint = 0;
+    }
+
+    ClockNanos lastUnits = s_recordCursor.timeNanos / RECORD_TIME_UNIT_NANOS;
+    ClockNanos units = (clockNowNanos() - s_recordOrigin) / RECORD_TIME_UNIT_NANOS;
+    if (units < lastUnits) {
+        units = lastUnits;
+    }
+    unsigned char buffer[RECORD_MAX_EVENT_BYTES];
+    int length = 0;
+    buffer[length++] = (unsigned char)((type << 5) | low);
+    length += writeVarint(buffer + length, (unsigned long long)(units - lastUnits));
+    memcpy(buffer + length, payload, payloadLength);
+    length += payloadLength;
+    if (fwrite(buffer, 1, length, s_recordFile) != (size_t)length) {
+        s_recordFailed = true;
+    }
+
+    s_recordCursor.offset += length;
+    s_recordCursor.timeNanos = units * RECORD_TIME_UNIT_NANOS;
+    s_recordCursor.eventIndex++;
+    s_eventsSinceCheckpoint++;
+    if (type == RECORD_MOVE) {
+        s_recordCursor.moveIndex++;
+        s_movesSinceCheckpoint++;
+    }
+}
+
+void recordMoveAccepted(Face face, bool clockwise, bool isScrambleMove) {
+    if (s_recordFile == NULL) {
+        return;
+    }
+    int low = (int)face | (clockwise ? 0 : 8) | (isScrambleMove ? 16 : 0);
+    writeRecordEvent(RECORD_MOVE, low, NULL, 0);
+}
+
+void recordScrambleBegin(int numMoves) {
+    if (s_recordFile == NULL) {
+        return;
+    }
+    unsigned char payload[10];
+    int length = writeVarint(payload, (unsigned long long)(numMoves > 0 ? numMoves : 0));
+    writeRecordEvent(RECORD_SCRAMBLE, 0, payload, length);
+}
+
+void recordReset() {
+    if (s_recordFile == NULL) {
+        return;
+    }
+    writeRecordEvent(RECORD_RESET, 0, NULL, 0);
+}
+
+void recordCameraChanged() {
+    if (s_recordFile == NULL) {
+        return;
+    }
+    int x = quantizeCameraAngle(cameraAngleX);
+    int y = quantizeCameraAngle(cameraAngleY);
+    int front = (int)currentFrontFace;
+    if (x == s_recordCursor.cameraX && y == s_recordCursor.cameraY && front == s_recordFrontFace) {
+        return;
+    }
+    unsigned char payload[20];
+    int length = writeVarint(payload, zigzagEncode(x - s_recordCursor.cameraX));
+    length += writeVarint(payload + length, zigzagEncode(y - s_recordCursor.cameraY));
+    writeRecordEvent(RECORD_CAMERA, front, payload, length);
+    s_recordCursor.cameraX = x;
+    s_recordCursor.cameraY = y;
+    s_recordFrontFace = front;
+}
+
+// ==================== Đọc (file map vào bộ nhớ) ====================
+
+// Phiên đang mở để phát lại. checkpoints trỏ thẳng vào file, hoặc vào rebuilt
+// nếu phiên chưa được đóng
+struct ReplaySession {
+    MappedFile file;
+    const unsigned char* stream;
+    long long streamBytes;
+    const RecordCheckpoint* checkpoints;
+    int checkpointCount;
+    std::vector<RecordCheckpoint> rebuilt;
+    ClockNanos durationNanos;
+    int eventCount;
+    int moveCount;
+    long long startUnixTime;
+};
+
+static ReplaySession s_session;
+static bool s_sessionOpen = false;
+
+// Phiên bị ngắt (không có bảng checkpoint): giải mã tuần tự một lần, chụp checkpoint
+// theo cùng quy tắc với khi ghi. Sự kiện cuối bị cắt dở được bỏ
+static void rebuildCheckpoints(const RecordCheckpoint& initial) {
+    s_session.rebuilt.clear();
+    s_session.rebuilt.push_back(initial);
+    restoreCheckpoint(initial);
+    RecordCursor cursor;
+    cursorFromCheckpoint(cursor, initial);
+    int movesSince = 0;
+    int eventsSince = 0;
+    RecordEvent event;
+    for (;;) {
+        RecordCursor before = cursor;
+        if (!readRecordEvent(s_session.stream, s_session.streamBytes, cursor, event)) {
+            cursor = before;
+            break;
+        }
+        if (movesSince >= RECORD_CHECKPOINT_MOVES || eventsSince >= RECORD_CHECKPOINT_EVENTS) {
+            RecordCheckpoint checkpoint;
+            captureCheckpoint(checkpoint, before, currentFrontFace, 0);
+            s_session.rebuilt.push_back(checkpoint);
+            movesSince = 0;
+            eventsSince = 0;
+        }
+        applyEventInstant(event);
+        eventsSince++;
+        if (event.type == RECORD_MOVE) {
+            movesSince++;
+        }
+    }
+    s_session.streamBytes = cursor.offset;
+    s_session.durationNanos = cursor.timeNanos;
+    s_session.eventCount = cursor.eventIndex;
+    s_session.moveCount = cursor.moveIndex;
+    s_session.checkpoints = &s_session.rebuilt[0];
+    s_session.checkpointCount = (int)s_session.rebuilt.size();
+}
+
+static void closeReplaySession() {
+    if (!s_sessionOpen) {
+        return;
+    }
+    unmapFile(s_session.file);
+    s_session.rebuilt.clear();
+    s_sessionOpen = false;
+}
+
+// Header của file đã map, NULL (kèm thông báo) nếu không phải file phiên cùng phiên bản
+static const RecordFileHeader* checkRecordFile(const MappedFile& file, const char* path) {
+    const long long minimumSize = (long long)(sizeof(RecordFileHeader) + sizeof(RecordCheckpoint));
+    const RecordFileHeader* header = (const RecordFileHeader*)file.data;
+    if (file.size < minimumSize || memcmp(header->magic, RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0 ||
+        header->version != RECORD_FORMAT_VERSION || header->checkpointBytes != sizeof(RecordCheckpoint) ||
+        header->streamOffset != minimumSize) {
+        fprintf(stderr, "File phiên không hợp lệ hoặc khác phiên bản: %s\n", path);
+        RUBIK_LOG(EVT_REPLAY_OPEN_FAILED) << path;
+        return NULL;
+    }
+    return header;
+}
+
+// Phiên đã được đóng đúng cách (bảng checkpoint ở cuối file còn nguyên)
+static bool hasRecordIndex(const RecordFileHeader* header, long long fileSize) {
+    long long indexBytes = (long long)header->checkpointCount * (long long)sizeof(RecordCheckpoint);
+    return header->indexOffset != 0 && header->indexOffset % 8 == 0 && header->checkpointCount > 0 &&
+           header->streamOffset + header->streamBytes <= header->indexOffset &&
+           header->indexOffset + indexBytes <= fileSize;
+}
+
+// Mở và kiểm tra file; dùng trạng thái toàn cục (khi phải dựng lại chỉ mục)
+static bool openReplaySession(const char* path) {
+    closeReplaySession();
+    if (!mapReadOnlyFile(path, s_session.file)) {
+        RUBIK_LOG(EVT_REPLAY_OPEN_FAILED) << path;
+        return false;
+    }
+    const unsigned char* data = s_session.file.data;
+    long long size = s_session.file.size;
+    const RecordFileHeader* header = checkRecordFile(s_session.file, path);
+    if (header == NULL) {
+        unmapFile(s_session.file);
+        return false;
+    }
+    s_sessionOpen = true;
+    s_session.stream = data + header->streamOffset;
+    s_session.startUnixTime = header->startUnixTime;
+
+    if (hasRecordIndex(header, size)) {
+        s_session.streamBytes = header->streamBytes;
+        s_session.checkpoints = (const RecordCheckpoint*)(data + header->indexOffset);
+        s_session.checkpointCount = (int)header->checkpointCount;
+        s_session.durationNanos = header->durationNanos;
+        s_session.eventCount = (int)header->eventCount;
+        s_session.moveCount = (int)header->moveCount;
+    } else {
+        s_session.streamBytes = size - header->streamOffset;
+        rebuildCheckpoints(*(const RecordCheckpoint*)(data + sizeof(RecordFileHeader)));
+        printf("REPLAY: phiên chưa được đóng, đã dựng lại %d checkpoint từ %d sự kiện\n",
+               s_session.checkpointCount, s_session.eventCount);
+        RUBIK_LOG(EVT_REPLAY_INDEX_REBUILT) << s_session.checkpointCount << s_session.eventCount << path;
+    }
+    RUBIK_LOG(EVT_REPLAY_LOADED) << clockNanosToSeconds(s_session.durationNanos) << s_session.eventCount
+                                 << s_session.moveCount << s_session.checkpointCount << path;
+    return true;
+}
+
+// Checkpoint cuối cùng có mốc <= target (checkpoint đầu luôn có mốc 0)
+static int findCheckpoint(ClockNanos target) {
+    int low = 0;
+    int high = s_session.checkpointCount;   // checkpoints[high] > target
+    while (high - low > 1) {
+        int middle = low + (high - low) / 2;
+        if (s_session.checkpoints[middle].timeNanos <= target) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// Đưa trạng thái toàn cục về đúng thời điểm target; trả về cursor ngay sau sự kiện
+// cuối đã áp dụng. Số sự kiện phải giải mã bị chặn bởi khoảng checkpoint
+static RecordCursor seekSession(ClockNanos target) {
+    PROFILE_ZONE("seekReplay");
+    ClockNanos started = clockRealNanos();
+    int index = findCheckpoint(target);
+    const RecordCheckpoint& checkpoint = s_session.checkpoints[index];
+    restoreCheckpoint(checkpoint);
+    RecordCursor cursor;
+    cursorFromCheckpoint(cursor, checkpoint);
+    int applied = 0;
+    RecordEvent event;
+    for (;;) {
+        RecordCursor next = cursor;
+        if (!readRecordEvent(s_session.stream, s_session.streamBytes, next, event) || event.timeNanos > target) {
+            break;
+        }
+        applyEventInstant(event);
+        cursor = next;
+        applied++;
+    }
+    syncVisualCube();
+    setVirtualClock(target);
+    updateTimer();
+    RUBIK_LOG(EVT_REPLAY_SEEK) << clockNanosToSeconds(target) << index << applied
+                               << clockNanosToMs(clockRealNanos() - started) * 1000.0;
+    return cursor;
+}
+
+// ==================== Phát lại trong cửa sổ ====================
+
+static bool s_replayActive = false;
+static bool s_replayPaused = false;
+static float s_replaySpeed = 1.0f;
+static ClockNanos s_replayPosition = 0;     // Thời gian phiên đang phát (có thể vượt quá cuối)
+static ClockNanos s_replayLastReal = -1;    // Đồng hồ thật ở lần updateReplay trước
+static RecordCursor s_replayCursor;
+
+bool parseReplayOptions(int argc, char** argv, const char*& path, float& speed) {
+    path = NULL;
+    speed = 1.0f;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = (float)atof(argv[++i]);
+        }
+    }
+    if (speed < REPLAY_MIN_SPEED) {
+        speed = REPLAY_MIN_SPEED;
+    } else if (speed > REPLAY_MAX_SPEED) {
+        speed = REPLAY_MAX_SPEED;
+    }
+    return path != NULL;
+}
+
+bool startReplay(const char* path, float speed) {
+    setVirtualClock(0);
+    if (!openReplaySession(path)) {
+        useRealClock();
+        return false;
+    }
+    s_replayActive = true;
+    s_replayPaused = false;
+    s_replaySpeed = speed;
+    seekReplay(0.0);
+    printf("REPLAY: %s, %.1f giây, %d nước, tốc độ x%.2f\n", path,
+           clockNanosToSeconds(s_session.durationNanos), s_session.moveCount, speed);
+    printf("  Space: dừng/tiếp | , .: lùi/tới %.0f giây | [ ]: tốc độ | 0-9: nhảy tới 0%%-90%%\n",
+           REPLAY_SEEK_STEP_SECONDS);
+    return true;
+}
+
+bool isReplayActive() {
+    return s_replayActive;
+}
+
+bool isReplayPlaying() {
+    return s_replayActive && !s_replayPaused && s_replayPosition < s_session.durationNanos;
+}
+
+void updateReplay() {
+    ClockNanos realNow = clockRealNanos();
+    ClockNanos realDelta = s_replayLastReal < 0 ? 0 : realNow - s_replayLastReal;
+    s_replayLastReal = realNow;
+    if (!s_replayActive || s_replayPaused) {
+        return;
+    }
+    // Sau khoảng ngủ dài (scheduler ngừng nhịp frame) không nhảy cóc
+    const ClockNanos maxDelta = NANOS_PER_SECOND / 4;
+    if (realDelta > maxDelta) {
+        realDelta = maxDelta;
+    }
+    ClockNanos target = s_replayPosition + (ClockNanos)((double)realDelta * (double)s_replaySpeed);
+    RecordEvent event;
+    for (;;) {
+        RecordCursor next = s_replayCursor;
+        if (!readRecordEvent(s_session.stream, s_session.streamBytes, next, event) || event.timeNanos > target) {
+            break;
+        }
+        // Đồng hồ ảo đứng đúng mốc của sự kiện khi áp dụng (timer bắt đầu/dừng chính xác)
+        setVirtualClock(event.timeNanos > s_replayPosition ? event.timeNanos : s_replayPosition);
+        applyEventLive(event);
+        s_replayCursor = next;
+    }
+    s_replayPosition = target;
+    setVirtualClock(target);
+    requestRedisplay();
+}
+
+void seekReplay(double seconds) {
+    if (!s_replayActive) {
+        return;
+    }
+    ClockNanos target = clockSecondsToNanos(seconds);
+    if (target < 0) {
+        target = 0;
+    } else if (target > s_session.durationNanos) {
+        target = s_session.durationNanos;
+    }
+    s_replayCursor = seekSession(target);
+    s_replayPosition = target;
+    s_replayLastReal = -1;
+    g_lastFrameNanos = -1;
+    wakeScheduler();
+    requestRedisplay();
+}
+
+void toggleReplayPause() {
+    if (!s_replayActive) {
+        return;
+    }
+    if (!s_replayPaused && s_replayPosition >= s_session.durationNanos) {
+        // Đã phát hết: Space phát lại từ đầu
+        seekReplay(0.0);
+        return;
+    }
+    s_replayPaused = !s_replayPaused;
+    s_replayLastReal = -1;
+    wakeScheduler();
+    requestRedisplay();
+}
+
+void scaleReplaySpeed(float factor) {
+    float speed = s_replaySpeed * factor;
+    if (speed < REPLAY_MIN_SPEED) {
+        speed = REPLAY_MIN_SPEED;
+    } else if (speed > REPLAY_MAX_SPEED) {
+        speed = REPLAY_MAX_SPEED;
+    }
+    s_replaySpeed = speed;
+    requestRedisplay();
+}
+
+double getReplayPositionSeconds() {
+    ClockNanos position = s_replayPosition < s_session.durationNanos ? s_replayPosition : s_session.durationNanos;
+    return clockNanosToSeconds(position);
+}
+
+double getReplayDurationSeconds() {
+    return clockNanosToSeconds(s_session.durationNanos);
+}
+
+float getReplaySpeed() {
+    return s_replaySpeed;
+}
+
+bool isReplayPaused() {
+    return s_replayPaused;
+}
+
+// ==================== Đọc tuần tự ====================
+
+bool openRecordStream(const char* path, RecordStream& stream) {
+    if (!mapReadOnlyFile(path, stream.file)) {
+        RUBIK_LOG(EVT_REPLAY_OPEN_FAILED) << path;
+        return false;
+    }
+    const RecordFileHeader* header = checkRecordFile(stream.file, path);
+    if (header == NULL) {
+        unmapFile(stream.file);
+        return false;
+    }
+    stream.events = stream.file.data + header->streamOffset;
+    stream.eventBytes = hasRecordIndex(header, stream.file.size) ? header->streamBytes
+                                                                 : stream.file.size - header->streamOffset;
+    stream.initial = (const RecordCheckpoint*)(stream.file.data + sizeof(RecordFileHeader));
+    cursorFromCheckpoint(stream.cursor, *stream.initial);
+    return true;
+}
+
+bool readRecordStream(RecordStream& stream, RecordEvent& event) {
+    return readRecordEvent(stream.events, stream.eventBytes, stream.cursor, event);
+}
+
+void closeRecordStream(RecordStream& stream) {
+    unmapFile(stream.file);
+}
+
+void getRecordStreamInitialCube(const RecordStream& stream, RubikCube& cube) {
+    applyFacelets(cube, stream.initial->facelets);
+}
+
+// ==================== Chế độ dòng lệnh ====================
+
+bool isRecordInfoRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record-info") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printRecordInfoUsage() {
+    fprintf(stderr,
+            "Cách dùng: rubik --record-info file.rrec [--at S] [--seeks N]\n"
+            "  In thông tin phiên, đo N lần seek ngẫu nhiên (mặc định 1000) và kiểm tra\n"
+            "  seek tới cuối khớp với phát lại tuần tự. --at S: in trạng thái tại giây S.\n");
+}
+
+int runRecordInfoCommand(int argc, char** argv) {
+    const char* path = NULL;
+    double atSeconds = -1.0;
+    int seeks = 1000;
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--record-info") == 0 && hasValue) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "--at") == 0 && hasValue) {
+            atSeconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seeks") == 0 && hasValue) {
+            seeks = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Tham số không hợp lệ: %s\n", argv[i]);
+            printRecordInfoUsage();
+            return 1;
+        }
+    }
+    if (path == NULL || seeks < 0) {
+        printRecordInfoUsage();
+        return 1;
+    }
+
+    // Seek dùng đúng trạng thái toàn cục của ứng dụng, chạy theo đồng hồ ảo
+    setSchedulerHeadless(true);
+    unsigned int savedCategories = getLogCategories();
+    setLogCategories(savedCategories & ~(unsigned int)LOG_CAT_MOVE);
+    setVirtualClock(0);
+    initRubikCube();
+    if (!openReplaySession(path)) {
+        fprintf(stderr, "Không đọc được file phiên: %s\n", path);
+        useRealClock();
+        setLogCategories(savedCategories);
+        return 1;
+    }
+
+    char started[64] = "?";
+    time_t startTime = (time_t)s_session.startUnixTime;
+    const struct tm* local = localtime(&startTime);
+    if (local != NULL) {
+        strftime(started, sizeof(started), "%Y-%m-%d %H:%M:%S", local);
+    }
+    double duration = clockNanosToSeconds(s_session.durationNanos);
+    printf("RECORD: %s (ghi lúc %s)\n", path, started);
+    printf("  %.1f giây, %d sự kiện (%d nước), %d checkpoint, file %lld byte, luồng %lld byte (%.2f byte/sự kiện)\n",
+           duration, s_session.eventCount, s_session.moveCount, s_session.checkpointCount,
+           s_session.file.size, s_session.streamBytes,
+           s_session.eventCount > 0 ? (double)s_session.streamBytes / s_session.eventCount : 0.0);
+
+    int failures = 0;
+    if (seeks > 0) {
+        srand(1);
+        ClockNanos total = 0;
+        ClockNanos worst = 0;
+        for (int i = 0; i < seeks; i++) {
+            ClockNanos target = (ClockNanos)(((double)rand() / (double)RAND_MAX) * (double)s_session.durationNanos);
+            ClockNanos started = clockRealNanos();
+            seekSession(target);
+            ClockNanos elapsed = clockRealNanos() - started;
+            total += elapsed;
+            if (elapsed > worst) {
+                worst = elapsed;
+            }
+        }
+        printf("  %d lần seek ngẫu nhiên: trung bình %.1f us, chậm nhất %.1f us\n",
+               seeks, clockNanosToMs(total) * 1000.0 / seeks, clockNanosToMs(worst) * 1000.0);
+
+        // Seek tới cuối (qua chỉ mục) phải cho cùng trạng thái với giải mã tuần tự từ đầu
+        seekSession(s_session.durationNanos);
+        unsigned char indexed[54];
+        captureFacelets(g_rubikCube, indexed);
+        restoreCheckpoint(s_session.checkpoints[0]);
+        RecordCursor cursor;
+        cursorFromCheckpoint(cursor, s_session.checkpoints[0]);
+        RecordEvent event;
+        ClockNanos started = clockRealNanos();
+        while (readRecordEvent(s_session.stream, s_session.streamBytes, cursor, event)) {
+            applyEventInstant(event);
+        }
+        ClockNanos linear = clockRealNanos() - started;
+        unsigned char sequential[54];
+        captureFacelets(g_rubikCube, sequential);
+        bool match = memcmp(indexed, sequential, sizeof(indexed)) == 0;
+        printf("  Phát lại tuần tự toàn phiên: %.2f ms, trạng thái cuối %s với seek\n",
+               clockNanosToMs(linear), match ? "khớp" : "KHÔNG khớp");
+        if (!match) {
+            failures++;
+        }
+    }
+
+    if (atSeconds >= 0.0) {
+        RecordCursor cursor = seekSession(clockSecondsToNanos(atSeconds));
+        static const char* TIMER_STATES[4] = {"idle", "ready", "running", "stopped"};
+        printf("  Tại %.3fs: %d nước, camera %.2f/%.2f, timer %s", atSeconds, cursor.moveIndex,
+               cameraAngleX, cameraAngleY, TIMER_STATES[g_timer.state]);
+        if (g_timer.state == TIMER_RUNNING || g_timer.state == TIMER_STOPPED) {
+            printf(" %.3fs %d nước", g_timer.state == TIMER_RUNNING ? g_timer.currentTime : g_timer.endTime,
+                   g_timer.moveCount);
+        }
+        char facelets[55];
+        char hex[33];
+        exportCubeState(g_rubikCube, facelets, hex);
+        printf(", %s\n  %s %s\n", isCubeSolved() ? "đã giải" : "chưa giải", facelets, hex);
+    }
+
+    closeReplaySession();
+    useRealClock();
+    setLogCategories(savedCategories);
+    return failures > 0 ? 2 : 0;
+}
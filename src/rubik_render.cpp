@@ -4,12 +4,26 @@
 #include "rubik_input.h"
 #include "rubik_timer.h"
 #include "rubik_constants.h"
+#include "rubik_scheduler.h"
+#include "rubik_rotation.h"
+#include "rubik_glext.h"
+#include "rubik_instanced.h"
+#include "rubik_text.h"
+#include "rubik_perf.h"
+#include "rubik_wall.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
 #include <GL/glut.h>
 #include <cmath>
 
 int g_windowWidth = 800;
 int g_windowHeight = 600;
 
+// Phép chiếu phối cảnh hiện tại (tính lại trong reshape, nạp lại mỗi frame vì
+// overlay chữ thay phép chiếu bằng phép chiếu 2D mà không push/pop)
+static float s_projectionMatrix[16];
+static bool s_projectionValid = false;
+
 float clampAngle(float angle, float minAngle, float maxAngle) {
     if (angle < minAngle) {
         return minAngle;
@@ -59,10 +73,87 @@ void initOpenGL() {
     glDisable(GL_LIGHTING);
     glDisable(GL_LIGHT0);
     glDisable(GL_COLOR_MATERIAL);
+    
+    // Nạp hàm mở rộng và chuẩn bị renderer instancing (VBO + 1 draw call)
+    // Nếu GL không hỗ trợ, drawRubikCube() dùng immediate mode như cũ
+    loadGLExtensions();
+    initInstancedRenderer();
+}
+
+// Trục và góc xoay (quy ước glRotatef) của một lớp khi đã xoay displayAngle độ
+// Dùng chung cho cube chính và các cube của chế độ nhiều cube
+float getFaceRotation(Face face, bool clockwise, float displayAngle, float axis[3]) {
+    axis[0] = 0.0f;
+    axis[1] = 0.0f;
+    axis[2] = 0.0f;
+    int axisSign = 1;
+    
+    switch (face) {
+        case FRONT:  // Mặt trước: xoay quanh Z+
+            axis[2] = 1.0f;
+            axisSign = 1;
+            break;
+        case BACK:   // Mặt sau: xoay quanh Z-
+            axis[2] = 1.0f;
+            axisSign = -1;
+            break;
+        case LEFT:   // Mặt trái: xoay quanh X-
+            axis[0] = 1.0f;
+            axisSign = -1;
+            break;
+        case RIGHT:  // Mặt phải: xoay quanh X+
+            axis[0] = 1.0f;
+            axisSign = 1;
+            break;
+        case UP:     // Mặt trên: xoay quanh Y+
+            axis[1] = 1.0f;
+            axisSign = 1;
+            break;
+        case DOWN:   // Mặt dưới: xoay quanh Y-
+            axis[1] = 1.0f;
+            axisSign = -1;
+            break;
+    }
+    
+    // Tính góc xoay (xuôi/ngược chiều)
+    float angle = clockwise ? -displayAngle : displayAngle;
+    return angle * static_cast<float>(axisSign);
+}
+
+// Lấy trục và góc xoay hiện tại của lớp đang animation
+// Trả về góc (độ) theo quy ước của glRotatef, axis là vector đơn vị
+float getAnimationRotation(float axis[3]) {
+    return getFaceRotation(g_animation.face, g_animation.clockwise, getInterpolatedDisplayAngle(), axis);
+}
+
+// Tính ma trận affine 3x4 (theo hàng) của một mảnh: M = R(animation) * T(vị trí)
+// Tương đương với glRotatef + glTranslatef trong đường vẽ immediate mode
+void computePieceTransform(const RubikCube& cube, int pieceIndex, float transform[12]) {
+    const CubePiece& piece = cube.pieces[pieceIndex];
+    const float spacing = cube.pieceSize + cube.gapSize;
+    float world[3] = {
+        (float)piece.position[0] * spacing,
+        (float)piece.position[1] * spacing,
+        (float)piece.position[2] * spacing
+    };
+    
+    float rot[3][3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+    if (g_animation.isActive && isPieceInAnimation(pieceIndex)) {
+        float axis[3];
+        float angle = getAnimationRotation(axis);
+        axisAngleToMatrix(rot, axis, angle);
+    }
+    
+    for (int row = 0; row < 3; row++) {
+        transform[row * 4 + 0] = rot[row][0];
+        transform[row * 4 + 1] = rot[row][1];
+        transform[row * 4 + 2] = rot[row][2];
+        transform[row * 4 + 3] = rot[row][0] * world[0] + rot[row][1] * world[1] + rot[row][2] * world[2];
+    }
 }
 
 void drawCubePiece(const CubePiece& piece) {
-    const float size = g_rubikCube.pieceSize * 0.5f;
+    const float size = g_visualCube.pieceSize * 0.5f;
     
     glBegin(GL_QUADS);
     
@@ -117,103 +208,150 @@ void drawCubePiece(const CubePiece& piece) {
     glEnd();
 }
 
-// Vẽ toàn bộ Rubik's Cube (27 mảnh)
-void drawRubikCube() {
-    glPushMatrix();
+// Khóa của cache lớp tĩnh: thay đổi khi trạng thái hiển thị đổi (một nước đi vừa
+// hoàn tất) hoặc khi lớp đang xoay đổi (animation bắt đầu/kết thúc)
+int computeStaticLayerKey() {
+    int layer = g_animation.isActive ? (int)g_animation.face + 1 : 0;
+    return g_visualCubeVersion * 8 + layer;
+}
+
+// Display list chứa các mảnh không nằm trong lớp đang xoay (đường vẽ immediate mode)
+static GLuint s_staticLayerList = 0;
+static int s_staticLayerKey = -1;
+static int s_staticLayerPieces = 0;  // Số mảnh trong display list (cho HUD hiệu năng)
+
+// Vẽ một mảnh tại vị trí lưới của nó (không có xoay animation)
+static void drawPieceAtRest(const CubePiece& piece) {
+    // Tính vị trí thế giới từ toạ độ lưới
+    float worldX = (float)piece.position[0] * (g_visualCube.pieceSize + g_visualCube.gapSize);
+    float worldY = (float)piece.position[1] * (g_visualCube.pieceSize + g_visualCube.gapSize);
+    float worldZ = (float)piece.position[2] * (g_visualCube.pieceSize + g_visualCube.gapSize);
     
-    // Duyệt qua tất cả 27 mảnh
+    glPushMatrix();
+    glTranslatef(worldX, worldY, worldZ);
+    drawCubePiece(piece);
+    glPopMatrix();
+}
+
+// Dựng lại display list của lớp tĩnh (chỉ khi khóa cache thay đổi)
+static void rebuildStaticLayerList() {
+    if (s_staticLayerList == 0) {
+        s_staticLayerList = glGenLists(1);
+    }
+    glNewList(s_staticLayerList, GL_COMPILE);
+    s_staticLayerPieces = 0;
     for (int i = 0; i < 27; i++) {
-        const CubePiece& piece = g_rubikCube.pieces[i];
-        
-        // Bỏ qua mảnh ẩn (nếu có)
-        if (!piece.isVisible) {
+        const CubePiece& piece = g_visualCube.pieces[i];
+        if (!piece.isVisible || isPieceInAnimation(i)) {
             continue;
         }
-        
-        // Tính vị trí thế giới từ toạ độ lưới
-        float worldX = (float)piece.position[0] * (g_rubikCube.pieceSize + g_rubikCube.gapSize);
-        float worldY = (float)piece.position[1] * (g_rubikCube.pieceSize + g_rubikCube.gapSize);
-        float worldZ = (float)piece.position[2] * (g_rubikCube.pieceSize + g_rubikCube.gapSize);
-        
-        glPushMatrix();
-        
-        // Kiểm tra xem mảnh này có đang trong animation không
-        bool pieceAnimating = g_animation.isActive && isPieceInAnimation(i);
-        if (pieceAnimating) {
-            // Xác định trục xoay dựa trên mặt đang xoay
-            float axisX = 0.0f;
-            float axisY = 0.0f;
-            float axisZ = 0.0f;
-            int axisSign = 1;
-            
-            switch (g_animation.face) {
-                case FRONT:  // Mặt trước: xoay quanh Z+
-                    axisZ = 1.0f;
-                    axisSign = 1;
-                    break;
-                case BACK:   // Mặt sau: xoay quanh Z-
-                    axisZ = 1.0f;
-                    axisSign = -1;
-                    break;
-                case LEFT:   // Mặt trái: xoay quanh X-
-                    axisX = 1.0f;
-                    axisSign = -1;
-                    break;
-                case RIGHT:  // Mặt phải: xoay quanh X+
-                    axisX = 1.0f;
-                    axisSign = 1;
-                    break;
-                case UP:     // Mặt trên: xoay quanh Y+
-                    axisY = 1.0f;
-                    axisSign = 1;
-                    break;
-                case DOWN:   // Mặt dưới: xoay quanh Y-
-                    axisY = 1.0f;
-                    axisSign = -1;
-                    break;
-            }
-            
-            // Tính góc xoay (xuôi/ngược chiều)
-            float angle = g_animation.clockwise ? -g_animation.displayAngle : g_animation.displayAngle;
-            angle *= static_cast<float>(axisSign);
-            
-            // Áp dụng xoay trước khi dịch chuyển
-            glRotatef(angle, axisX, axisY, axisZ);
-        }
-        
-        // Dịch chuyển mảnh tới vị trí của nó
-        glTranslatef(worldX, worldY, worldZ);
-        drawCubePiece(piece);
-        glPopMatrix();
+        drawPieceAtRest(piece);
+        s_staticLayerPieces++;
+    }
+    glEndList();
+    s_staticLayerKey = computeStaticLayerKey();
+}
+
+// Vẽ toàn bộ Rubik's Cube (27 mảnh)
+void drawRubikCube() {
+    PROFILE_ZONE("drawRubikCube");
+    // Ưu tiên renderer instancing (1 draw call cho cả khối)
+    if (isInstancedRendererReady()) {
+        drawRubikCubeInstanced();
+        return;
+    }
+    
+    // Các mảnh đứng yên được vẽ từ display list, chỉ dựng lại khi nước đi hoàn tất
+    if (s_staticLayerKey != computeStaticLayerKey()) {
+        rebuildStaticLayerList();
+    }
+    glCallList(s_staticLayerList);
+    perfCountDraw(s_staticLayerPieces * 24);
+    
+    if (!g_animation.isActive) {
+        return;
     }
     
+    // Chỉ lớp đang xoay (9 mảnh) được biến đổi lại mỗi frame
+    float animAxis[3];
+    float animAngle = getAnimationRotation(animAxis);
+    
+    glPushMatrix();
+    glRotatef(animAngle, animAxis[0], animAxis[1], animAxis[2]);
+    for (int i = 0; i < 9; i++) {
+        int pieceIndex = g_animation.affectedIndices[i];
+        if (pieceIndex < 0 || !g_visualCube.pieces[pieceIndex].isVisible) {
+            continue;
+        }
+        drawPieceAtRest(g_visualCube.pieces[pieceIndex]);
+        perfCountDraw(24);
+    }
     glPopMatrix();
 }
 
+// Ma trận view của camera: lùi ra xa, xoay theo trục ngang rồi trục dọc
+// Tương đương glTranslatef + rotateAroundAxis x2
+void computeViewMatrix(float view[16]) {
+    computeViewMatrixAtDistance(view, CAMERA_DISTANCE);
+}
+
+void computeViewMatrixAtDistance(float view[16], float distance) {
+    float rotation[16];
+    makeTranslationMatrix4(view, 0.0f, 0.0f, -distance);         // Lùi camera ra xa
+    makeRotationMatrix4(rotation, horizontalAxis, cameraAngleY);   // Xoay theo trục ngang
+    multiplyMatrix4(view, view, rotation);
+    makeRotationMatrix4(rotation, verticalAxis, cameraAngleX);     // Xoay theo trục dọc
+    multiplyMatrix4(view, view, rotation);
+}
+
+// Ma trận phối cảnh (tương đương gluPerspective với các hằng số camera)
+void computeProjectionMatrix(float projection[16], float aspect) {
+    makePerspectiveMatrix4(projection, CAMERA_FOV_DEG, aspect, CAMERA_NEAR, CAMERA_FAR);
+}
+
 // Hàm callback hiển thị - vẽ tất cả mọi frame
 void display() {
+    PROFILE_ZONE("display");
+    perfBeginFrame();
+    
+    // Atlas chữ được dựng một lần ở frame đầu tiên (dùng back buffer làm nháp)
+    prepareTextAtlas();
+    
     // Xóa buffer màu và depth
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glLoadIdentity();
+    if (!s_projectionValid) {
+        computeProjectionMatrix(s_projectionMatrix, (float)g_windowWidth / (float)(g_windowHeight > 0 ? g_windowHeight : 1));
+        s_projectionValid = true;
+    }
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(s_projectionMatrix);
+    glMatrixMode(GL_MODELVIEW);
     
-    // Ghi log mỗi 30 frame (giảm spam log)
+    // Ghi log mỗi 30 frame (giảm spam log), chỉ ở mức trace
     static int frameCount = 0;
-    if (frameCount++ % 30 == 0 && g_logFile != NULL) {
-        fprintf(g_logFile, "DISPLAY: frame=%d\n", frameCount);
-        fflush(g_logFile);
+    if (frameCount++ % 30 == 0) {
+        RUBIK_LOG(EVT_DISPLAY_FRAME) << frameCount;
     }
     
-    // Thiết lập camera
-    glTranslatef(0.0f, 0.0f, -CAMERA_DISTANCE);  // Lùi camera ra xa
-    rotateAroundAxis(horizontalAxis, cameraAngleY);  // Xoay theo trục ngang
-    rotateAroundAxis(verticalAxis, cameraAngleX);    // Xoay theo trục dọc
-    
     // Vẽ cube và UI
-    drawRubikCube();
+    if (isCubeWallActive()) {
+        // Tường nhiều cube tự đặt camera (xa hơn, mặt phẳng xa lớn hơn)
+        drawCubeWall();
+    } else {
+        // Thiết lập camera (cùng ma trận với renderer phần mềm)
+        float view[16];
+        computeViewMatrix(view);
+        glLoadMatrixf(view);
+        drawRubikCube();
+    }
     displayTimerOverlay();
     
-    // Hoán đổi buffer (double buffering)
+    // Hoán đổi buffer (double buffering); thời gian chờ swap được đo riêng vì nó
+    // phản ánh GPU/driver chứ không phải CPU gửi lệnh
+    perfBeginSwap();
     glutSwapBuffers();
+    perfEndFrame();
+    onFrameRendered();
 }
 
 void reshape(int w, int h) {
@@ -225,14 +363,10 @@ void reshape(int w, int h) {
     }
     
     glViewport(0, 0, w, h);
+    computeProjectionMatrix(s_projectionMatrix, (float)w / (float)h);
+    s_projectionValid = true;
     glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
-    
-    const float fov = 45.0f;
-    const float aspect = (float)w / (float)h;
-    const float nearPlane = 0.1f;
-    const float farPlane = 100.0f;
-    
-    gluPerspective(fov, aspect, nearPlane, farPlane);
+    glLoadMatrixf(s_projectionMatrix);
     glMatrixMode(GL_MODELVIEW);
+    setTextViewport(w, h);
 }
@@ -2,9 +2,13 @@
 #include "rubik_state.h"
 #include "rubik_constants.h"
 #include "rubik_input.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
+#include "rubik_notation.h"
 #include <cmath>
 #include <cstring>
 #include <cstdio>
+#include <vector>
 
 /**
  * Trả về mặt đối diện của một mặt cho trước trên khối Rubik.
@@ -102,6 +106,142 @@ void matrixMultiply(float result[3][3], const float a[3][3], const float b[3][3]
     }
 }
 
+/**
+ * Tạo ma trận đơn vị 4x4.
+ */
+void makeIdentityMatrix4(float m[16]) {
+    for (int i = 0; i < 16; i++) {
+        m[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+}
+
+/**
+ * Tạo ma trận dịch chuyển 4x4 (tương đương glTranslatef).
+ */
+void makeTranslationMatrix4(float m[16], float x, float y, float z) {
+    makeIdentityMatrix4(m);
+    m[12] = x;
+    m[13] = y;
+    m[14] = z;
+}
+
+/**
+ * Tạo ma trận xoay 4x4 quanh một trục (tương đương glRotatef).
+ * Trục có độ dài gần 0 cho ra ma trận đơn vị (giống rotateAroundAxis).
+ * 
+ * @param m Ma trận kết quả (column-major).
+ * @param axis Trục xoay, không cần chuẩn hóa trước.
+ * @param angleDegrees Góc xoay (độ).
+ */
+void makeRotationMatrix4(float m[16], const float axis[3], float angleDegrees) {
+    makeIdentityMatrix4(m);
+    double length = sqrt((double)axis[0] * axis[0] + (double)axis[1] * axis[1] + (double)axis[2] * axis[2]);
+    if (length <= 0.0001) {
+        return;
+    }
+    double x = axis[0] / length;
+    double y = axis[1] / length;
+    double z = axis[2] / length;
+    double angleRad = (double)angleDegrees * 3.14159265358979323846 / 180.0;
+    double c = cos(angleRad);
+    double s = sin(angleRad);
+    double t = 1.0 - c;
+    
+    // Cột 0, 1, 2 (column-major)
+    m[0] = (float)(t * x * x + c);
+    m[1] = (float)(t * x * y + s * z);
+    m[2] = (float)(t * x * z - s * y);
+    m[4] = (float)(t * x * y - s * z);
+    m[5] = (float)(t * y * y + c);
+    m[6] = (float)(t * y * z + s * x);
+    m[8] = (float)(t * x * z + s * y);
+    m[9] = (float)(t * y * z - s * x);
+    m[10] = (float)(t * z * z + c);
+}
+
+/**
+ * Tạo ma trận phối cảnh 4x4 (tương đương gluPerspective).
+ */
+void makePerspectiveMatrix4(float m[16], float fovYDegrees, float aspect, float zNear, float zFar) {
+    for (int i = 0; i < 16; i++) {
+        m[i] = 0.0f;
+    }
+    double f = 1.0 / tan((double)fovYDegrees * 3.14159265358979323846 / 360.0);
+    m[0] = (float)(f / aspect);
+    m[5] = (float)f;
+    m[10] = (zFar + zNear) / (zNear - zFar);
+    m[11] = -1.0f;
+    m[14] = (2.0f * zFar * zNear) / (zNear - zFar);
+}
+
+/**
+ * Nhân hai ma trận 4x4 column-major: result = a * b.
+ * result có thể trùng với a hoặc b.
+ */
+void multiplyMatrix4(float result[16], const float a[16], const float b[16]) {
+    float temp[16];
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            temp[col * 4 + row] = a[0 * 4 + row] * b[col * 4 + 0] +
+                                  a[1 * 4 + row] * b[col * 4 + 1] +
+                                  a[2 * 4 + row] * b[col * 4 + 2] +
+                                  a[3 * 4 + row] * b[col * 4 + 3];
+        }
+    }
+    for (int i = 0; i < 16; i++) {
+        result[i] = temp[i];
+    }
+}
+
+/**
+ * Biến đổi điểm p (w = 1) bằng ma trận 4x4, kết quả là toạ độ thuần nhất.
+ */
+void transformPoint4(const float m[16], const float p[3], float out[4]) {
+    for (int row = 0; row < 4; row++) {
+        out[row] = m[row] * p[0] + m[4 + row] * p[1] + m[8 + row] * p[2] + m[12 + row];
+    }
+}
+
+/**
+ * Tách 6 mặt phẳng của frustum từ ma trận clip = projection * view (Gribb-Hartmann).
+ * Mỗi mặt phẳng (a, b, c, d) đã chuẩn hoá, điểm p nằm phía trong khi a*x + b*y + c*z + d >= 0.
+ * Thứ tự: trái, phải, dưới, trên, gần, xa.
+ */
+void extractFrustumPlanes(const float clip[16], float planes[6][4]) {
+    for (int i = 0; i < 3; i++) {
+        for (int side = 0; side < 2; side++) {
+            float sign = side == 0 ? 1.0f : -1.0f;
+            float* plane = planes[i * 2 + side];
+            for (int col = 0; col < 4; col++) {
+                plane[col] = clip[col * 4 + 3] + sign * clip[col * 4 + i];
+            }
+        }
+    }
+    for (int p = 0; p < 6; p++) {
+        float length = (float)sqrt(planes[p][0] * planes[p][0] + planes[p][1] * planes[p][1] +
+                                   planes[p][2] * planes[p][2]);
+        if (length > 0.0f) {
+            for (int c = 0; c < 4; c++) {
+                planes[p][c] /= length;
+            }
+        }
+    }
+}
+
+/**
+ * Kiểm tra hình cầu (tâm, bán kính) có giao với frustum hay không.
+ */
+bool isSphereInFrustum(const float planes[6][4], const float center[3], float radius) {
+    for (int p = 0; p < 6; p++) {
+        float distance = planes[p][0] * center[0] + planes[p][1] * center[1] +
+                         planes[p][2] * center[2] + planes[p][3];
+        if (distance < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /**
  * Xoay một vector 3D quanh một trục bất kỳ một góc nhất định.
  * Hàm này kết hợp việc tạo ma trận xoay và nhân ma trận với vector.
@@ -204,12 +344,13 @@ void rotateCoordinates(int axis, int axisSign, bool clockwise,
  * Khi một mảnh di chuyển sang vị trí mới, các mặt màu của nó cũng bị xoay theo.
  * Ví dụ: Khi xoay mặt phải, mặt trên của mảnh góc sẽ chuyển sang mặt sau.
  * 
- * @param pieceIndex Chỉ số của mảnh trong mảng g_rubikCube.pieces.
+ * @param cube Cube chứa mảnh (trạng thái logic hoặc trạng thái hiển thị).
+ * @param pieceIndex Chỉ số của mảnh trong mảng cube.pieces.
  * @param axis Trục xoay (0=X, 1=Y, 2=Z).
  * @param clockwise Hướng xoay.
  */
-void rotatePieceOrientation(int pieceIndex, int axis, bool clockwise) {
-    CubePiece* p = &g_rubikCube.pieces[pieceIndex];
+void rotatePieceOrientation(RubikCube& cube, int pieceIndex, int axis, bool clockwise) {
+    CubePiece* p = &cube.pieces[pieceIndex];
     float temp[3]; // Biến tạm để hoán đổi màu
     int i;
     
@@ -272,10 +413,11 @@ void rotatePieceOrientation(int pieceIndex, int axis, bool clockwise) {
  * Cập nhật logic vị trí và màu sắc của các mảnh sau khi xoay một mặt.
  * Đây là hàm phức tạp nhất, chịu trách nhiệm cập nhật trạng thái Rubik.
  * 
+ * @param cube Cube cần cập nhật (trạng thái logic hoặc trạng thái hiển thị).
  * @param face Mặt được xoay.
  * @param clockwise Hướng xoay.
  */
-void rotatePositions(int face, bool clockwise) {
+void rotatePositions(RubikCube& cube, int face, bool clockwise) {
     // 1. Lấy danh sách 9 mảnh thuộc mặt đang xoay
     int indices[9];
     getFaceIndices(face, indices);
@@ -287,7 +429,7 @@ void rotatePositions(int face, bool clockwise) {
     for (i = 0; i < 9; i++) {
         for (f = 0; f < 6; f++) {
             for (c = 0; c < 3; c++) {
-                backupColors[i][f][c] = g_rubikCube.pieces[indices[i]].colors[f][c];
+                backupColors[i][f][c] = cube.pieces[indices[i]].colors[f][c];
             }
         }
     }
@@ -326,14 +468,14 @@ void rotatePositions(int face, bool clockwise) {
         keyToSlot[i] = -1;
     }
     for (i = 0; i < 9; i++) {
-        const CubePiece& piece = g_rubikCube.pieces[indices[i]];
+        const CubePiece& piece = cube.pieces[indices[i]];
         int key = encodePositionKey(piece.position[0], piece.position[1], piece.position[2]);
         keyToSlot[key] = i;
     }
     
     // Tính toán vị trí đích cho từng mảnh
     for (i = 0; i < 9; i++) {
-        const CubePiece& piece = g_rubikCube.pieces[indices[i]];
+        const CubePiece& piece = cube.pieces[indices[i]];
         int rx, ry, rz;
         // Tính toạ độ mới sau khi xoay
         rotateCoordinates(rotationAxis, axisSign, clockwise,
@@ -360,14 +502,14 @@ void rotatePositions(int face, bool clockwise) {
         // Sao chép màu từ bản sao lưu
         for (f = 0; f < 6; f++) {
             for (c = 0; c < 3; c++) {
-                g_rubikCube.pieces[indices[i]].colors[f][c] = backupColors[srcIdx][f][c];
+                cube.pieces[indices[i]].colors[f][c] = backupColors[srcIdx][f][c];
             }
         }
         
         // 6. Xoay hướng màu (Orientation)
         // Mảnh trung tâm (i=4) không thay đổi hướng màu tương đối so với mặt
         if (i != 4) {
-            CubePiece* p = &g_rubikCube.pieces[indices[i]];
+            CubePiece* p = &cube.pieces[indices[i]];
             
             // Xác định chiều xoay hướng màu
             bool orientationClockwise = clockwise;
@@ -423,41 +565,53 @@ void rotatePositions(int face, bool clockwise) {
     }
     
     // Ghi log nếu cần
-    if (g_logFile != NULL) {
-        const char* faceNames[] = {"FRONT", "BACK", "LEFT", "RIGHT", "UP", "DOWN"};
-        fprintf(g_logFile, "ROTATE %s %s: colors swapped, positions preserved\n",
-                faceNames[face], clockwise ? "CW" : "CCW");
-        fflush(g_logFile);
-    }
+    RUBIK_LOG(EVT_ROTATE_COLORS) << face << clockwise;
 }
 
 /**
- * Hàm chính để xoay một mặt của Rubik's Cube.
- * Hàm này được gọi từ hệ thống xử lý input hoặc animation.
+ * Hàm chính để xoay một mặt của Rubik's Cube (trạng thái logic g_rubikCube).
+ * Được gọi ngay khi một nước đi được chấp nhận, trước khi animation chạy.
  * 
  * @param face Mặt cần xoay (FRONT, BACK, LEFT, RIGHT, UP, DOWN).
  * @param clockwise true = xuôi chiều kim đồng hồ, false = ngược chiều.
  */
 void rotateFace(int face, bool clockwise) {
+    PROFILE_ZONE("rotateFace");
     int indices[9];
     // 1. Lấy danh sách 9 mảnh thuộc mặt này
     getFaceIndices(face, indices);
     
     // 2. Thực hiện xoay logic (cập nhật màu sắc và trạng thái)
     // Hàm rotatePositions sẽ xử lý việc hoán đổi màu giữa các mảnh
-    rotatePositions(face, clockwise);
+    rotatePositions(g_rubikCube, face, clockwise);
     
     // 3. Ghi log để debug nếu cần
-    if (g_logFile != NULL) {
-        const char* faceNames[] = {"FRONT", "BACK", "LEFT", "RIGHT", "UP", "DOWN"};
-        double tsMs = getLogTimestampMs();
-        fprintf(g_logFile, "[%010.3f ms] ROTATE %s %s: pieces [%d,%d,%d,%d,%d,%d,%d,%d,%d]\n", 
-            tsMs,
-            faceNames[face], clockwise ? "CW" : "CCW",
-            indices[0], indices[1], indices[2], indices[3], indices[4],
-            indices[5], indices[6], indices[7], indices[8]);
-        fflush(g_logFile);
+    RUBIK_LOG(EVT_ROTATE_PIECES) << face << clockwise
+                                 << indices[0] << indices[1] << indices[2] << indices[3] << indices[4]
+                                 << indices[5] << indices[6] << indices[7] << indices[8];
+}
+
+/**
+ * Áp dụng một chuỗi nước đi ký hiệu WCA/SiGN ("R U R' U2", "(R U)3 M2 x") lên một cube bất kỳ.
+ * 
+ * @param cube Cube cần cập nhật (không nhất thiết là g_rubikCube).
+ * @param moves Chuỗi nước đi (xem rubik_notation.h), các nước có thể viết liền.
+ * @return Số nước mặt ngoài đã áp dụng, -1 nếu chuỗi không hợp lệ.
+ */
+int applyMoveString(RubikCube& cube, const char* moves) {
+    std::vector<MoveCode> codes;
+    NotationError error;
+    if (!parseNotation(moves, moves + strlen(moves), codes, error)) {
+        return -1;
     }
+    for (size_t i = 0; i < codes.size(); i++) {
+        int turns = moveCodeTurns(codes[i]);
+        bool clockwise = turns != 3;
+        for (int t = clockwise ? turns : 1; t > 0; t--) {
+            rotatePositions(cube, moveCodeFace(codes[i]), clockwise);
+        }
+    }
+    return (int)codes.size();
 }
 
 /**
@@ -486,21 +640,8 @@ Face getAbsoluteFace(int relativeFace) {
     }
     
     // 3. Ghi log để debug
-    if (g_logFile != NULL) {
-        const char* faceNames[] = {"FRONT", "BACK", "LEFT", "RIGHT", "UP", "DOWN"};
-        double tsMs = getLogTimestampMs();
-        extern float cameraAngleX, cameraAngleY;
-        fprintf(g_logFile,
-            "[%010.3f ms] REL FACE %d -> %s (front=%s up=%s right=%s) angles(X=%.1f,Y=%.1f)\n",
-            tsMs,
-            relativeFace,
-            faceNames[selected],
-            faceNames[mapping.front],
-            faceNames[mapping.up],
-            faceNames[mapping.right],
-            cameraAngleX,
-            cameraAngleY);
-        fflush(g_logFile);
-    }
+    extern float cameraAngleX, cameraAngleY;
+    RUBIK_LOG(EVT_REL_FACE) << relativeFace << selected << mapping.front << mapping.up << mapping.right
+                            << cameraAngleX << cameraAngleY;
     return selected;
 }
@@ -0,0 +1,110 @@
+#include "rubik_scheduler.h"
+#include "rubik_animation.h"
+#include "rubik_timer.h"
+#include "rubik_state.h"
+#include "rubik_wall.h"
+#include "rubik_log.h"
+#include "rubik_clock.h"
+#include "rubik_record.h"
+#include <GL/glut.h>
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+// Nhịp frame theo đồng hồ thật (clockRealNanos): đồng hồ ảo không dùng để chờ.
+// Không ngủ trong callback: mỗi frame đặt một glutTimerFunc tới mốc kế tiếp, vòng lặp
+// GLUT tự chờ tới mốc đó và vẫn nhận phím/chuột ngay trong lúc chờ
+static const ClockNanos NANOS_PER_MS = NANOS_PER_SECOND / 1000;
+static ClockNanos s_framePeriod = NANOS_PER_SECOND / 60;  // Chu kỳ frame mục tiêu
+static ClockNanos s_nextFrameTime = 0;                    // Mốc thời gian của frame kế tiếp
+static bool s_tickActive = false;          // Có timer frame đang chờ/đang chạy không
+static bool s_redisplayPosted = false;     // Đã gọi glutPostRedisplay cho frame tới chưa
+static bool s_headless = false;            // Chạy không cửa sổ: không gọi GLUT
+static bool s_resumedFromSleep = true;     // Frame kế tiếp là frame đầu sau khi scheduler ngủ
+
+static void onFrameTimer(int /* value */) {
+    idle();
+}
+
+void initFrameScheduler(int targetFps) {
+    if (targetFps <= 0) {
+        targetFps = 60;
+    }
+    s_framePeriod = NANOS_PER_SECOND / targetFps;
+#ifdef _WIN32
+    // Tăng độ phân giải bộ đếm giờ lên 1ms (mặc định ~15.6ms) cho glutTimerFunc
+    timeBeginPeriod(1);
+#endif
+    s_tickActive = false;
+    s_redisplayPosted = false;
+    s_resumedFromSleep = true;  // Frame đầu tiên không có frame trước để đo khoảng cách
+    RUBIK_LOG(EVT_SCHEDULER_INIT) << targetFps;
+}
+
+void setSchedulerHeadless(bool headless) {
+    s_headless = headless;
+}
+
+void requestRedisplay() {
+    if (s_headless || s_redisplayPosted) {
+        return;
+    }
+    if (!s_tickActive) {
+        s_resumedFromSleep = true;  // Vẽ lại theo sự kiện sau khi scheduler đã ngủ
+    }
+    s_redisplayPosted = true;
+    glutPostRedisplay();
+}
+
+void onFrameRendered() {
+    s_redisplayPosted = false;
+}
+
+bool hasContinuousWork() {
+    return g_animation.isActive ||
+           g_moveQueue.count > 0 ||
+           g_timer.state == TIMER_RUNNING ||
+           isCubeWallActive() ||
+           isReplayPlaying();
+}
+
+void wakeScheduler() {
+    if (s_headless || s_tickActive) {
+        return;
+    }
+    s_tickActive = true;
+    s_resumedFromSleep = true;
+    s_nextFrameTime = clockRealNanos();
+    g_lastFrameNanos = -1;  // Tránh deltaTime lớn sau khoảng thời gian ngủ
+    glutTimerFunc(0, onFrameTimer, 0);
+}
+
+bool consumeSchedulerResume() {
+    bool resumed = s_resumedFromSleep;
+    s_resumedFromSleep = false;
+    return resumed;
+}
+
+bool scheduleNextFrame() {
+    if (!hasContinuousWork()) {
+        // Không còn gì thay đổi theo thời gian: không đặt timer nữa để CPU được nghỉ
+        s_tickActive = false;
+        return false;
+    }
+    ClockNanos now = clockRealNanos();
+    if (now - s_nextFrameTime > s_framePeriod || s_nextFrameTime - now > s_framePeriod) {
+        // Bị trễ quá một frame (hoặc đồng hồ lệch): đặt lại nhịp thay vì đuổi theo
+        s_nextFrameTime = now;
+    }
+    s_nextFrameTime += s_framePeriod;
+
+    // glutTimerFunc tính bằng mili giây; mốc vẫn cộng dồn theo nano giây nên sai số
+    // làm tròn không tích lũy qua các frame
+    ClockNanos delay = s_nextFrameTime - now;
+    unsigned int delayMs = delay > 0 ? (unsigned int)((delay + NANOS_PER_MS / 2) / NANOS_PER_MS) : 0;
+    glutTimerFunc(delayMs, onFrameTimer, 0);
+    return true;
+}
@@ -0,0 +1,463 @@
+#include "rubik_simulate.h"
+#include "rubik_state.h"
+#include "rubik_rotation.h"
+#include "rubik_notation.h"
+#include "rubik_animation.h"
+#include "rubik_timer.h"
+#include "rubik_scheduler.h"
+#include "rubik_clock.h"
+#include "rubik_record.h"
+#include "rubik_solvedb.h"
+#include "rubik_constants.h"
+#include "rubik_log.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Một nước xoay 90 độ của kịch bản (R2 được tách thành hai nước)
+struct ScriptMove {
+    int face;
+    bool clockwise;
+};
+
+// Một lệnh kịch bản đã được phân tích sẵn (phân tích một lần, chạy nhiều phiên)
+enum ScriptOp {
+    SCRIPT_SCRAMBLE,
+    SCRIPT_MOVE,
+    SCRIPT_SOLVE,
+    SCRIPT_WAIT,
+    SCRIPT_SETTLE,
+    SCRIPT_RESET,
+    SCRIPT_EXPECT
+};
+
+enum ScriptExpect {
+    EXPECT_SOLVED,
+    EXPECT_UNSOLVED,
+    EXPECT_STOPPED,
+    EXPECT_READY
+};
+
+struct ScriptCommand {
+    ScriptOp op;
+    int line;
+    int count;                        // scramble: số nước; expect: ScriptExpect
+    ClockNanos duration;              // wait
+    std::vector<ScriptMove> moves;    // move
+};
+
+// Kịch bản mặc định: một phiên giải hoàn chỉnh
+static const char* DEFAULT_SCRIPT =
+    "scramble 20; settle; expect ready; wait 1.5; solve; expect solved; expect stopped; settle; wait 2";
+
+struct SimulationStats {
+    int session;
+    int failures;
+    int movesEntered;
+    int solves;
+    double solveSecondsTotal;
+    long long steps;
+};
+
+// Nước đi kể từ lần cube được giải gần nhất (solve nhập chuỗi ngược)
+static std::vector<ScriptMove> s_history;
+static ClockNanos s_pendingNanos = 0;   // Thời gian ảo chưa đủ một bước mô phỏng
+static ClockNanos s_moveInterval = 0;
+
+// Nước đôi được tách thành hai nước xuôi chiều, giống khi nhập hai lần phím
+static bool appendScriptMoves(const char* text, std::vector<ScriptMove>& moves) {
+    std::vector<MoveCode> codes;
+    NotationError error;
+    if (!parseNotation(text, text + strlen(text), codes, error)) {
+        fprintf(stderr, "Cột %d: %s\n", error.column, error.message);
+        return false;
+    }
+    for (size_t i = 0; i < codes.size(); i++) {
+        int turns = moveCodeTurns(codes[i]);
+        ScriptMove move;
+        move.face = moveCodeFace(codes[i]);
+        move.clockwise = turns != 3;
+        for (int t = move.clockwise ? turns : 1; t > 0; t--) {
+            moves.push_back(move);
+        }
+    }
+    return true;
+}
+
+static bool parseScriptLine(const std::string& text, int line, std::vector<ScriptCommand>& script) {
+    size_t start = text.find_first_not_of(" \t\r");
+    if (start == std::string::npos || text[start] == '#') {
+        return true;
+    }
+    size_t end = text.find_first_of(" \t\r", start);
+    std::string word = text.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    std::string argument;
+    if (end != std::string::npos) {
+        size_t argStart = text.find_first_not_of(" \t\r", end);
+        if (argStart != std::string::npos) {
+            argument = text.substr(argStart);
+            argument.erase(argument.find_last_not_of(" \t\r") + 1);
+        }
+    }
+
+    ScriptCommand command;
+    command.line = line;
+    command.count = 0;
+    command.duration = 0;
+    if (word == "scramble") {
+        command.op = SCRIPT_SCRAMBLE;
+        command.count = atoi(argument.c_str());
+        if (command.count <= 0 || command.count > SIMULATE_MAX_SCRAMBLE) {
+            fprintf(stderr, "Dòng %d: scramble cần 1..%d nước\n", line, SIMULATE_MAX_SCRAMBLE);
+            return false;
+        }
+    } else if (word == "move") {
+        command.op = SCRIPT_MOVE;
+        if (!appendScriptMoves(argument.c_str(), command.moves) || command.moves.empty()) {
+            fprintf(stderr, "Dòng %d: chuỗi nước đi không hợp lệ: %s\n", line, argument.c_str());
+            return false;
+        }
+    } else if (word == "solve" && argument.empty()) {
+        command.op = SCRIPT_SOLVE;
+    } else if (word == "wait") {
+        command.op = SCRIPT_WAIT;
+        double seconds = atof(argument.c_str());
+        if (seconds < 0.0 || argument.empty()) {
+            fprintf(stderr, "Dòng %d: wait cần số giây\n", line);
+            return false;
+        }
+        command.duration = clockSecondsToNanos(seconds);
+    } else if (word == "settle" && argument.empty()) {
+        command.op = SCRIPT_SETTLE;
+    } else if (word == "reset" && argument.empty()) {
+        command.op = SCRIPT_RESET;
+    } else if (word == "expect") {
+        command.op = SCRIPT_EXPECT;
+        if (argument == "solved") {
+            command.count = EXPECT_SOLVED;
+        } else if (argument == "unsolved") {
+            command.count = EXPECT_UNSOLVED;
+        } else if (argument == "stopped") {
+            command.count = EXPECT_STOPPED;
+        } else if (argument == "ready") {
+            command.count = EXPECT_READY;
+        } else {
+            fprintf(stderr, "Dòng %d: expect cần solved|unsolved|stopped|ready\n", line);
+            return false;
+        }
+    } else {
+        fprintf(stderr, "Dòng %d: lệnh không hợp lệ: %s\n", line, text.c_str() + start);
+        return false;
+    }
+    script.push_back(command);
+    return true;
+}
+
+// Dòng được tách bởi xuống dòng hoặc ';' (để viết kịch bản ngắn ngay trên dòng lệnh)
+static bool parseScript(const std::string& text, std::vector<ScriptCommand>& script) {
+    int line = 1;
+    std::string current;
+    for (size_t i = 0; i <= text.size(); i++) {
+        char c = i < text.size() ? text[i] : '\n';
+        if (c == '\n' || c == ';') {
+            if (!parseScriptLine(current, line, script)) {
+                return false;
+            }
+            current.clear();
+            if (c == '\n') {
+                line++;
+            }
+        } else {
+            current += c;
+        }
+    }
+    return true;
+}
+
+static bool readTextFile(const char* path, std::string& text) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, read);
+    }
+    fclose(file);
+    return true;
+}
+
+// ==================== Điều khiển thời gian ảo ====================
+
+// Để thời gian trôi duration nano giây, mô phỏng mọi bước trọn vẹn như idle().
+// Phần lẻ dưới một bước được giữ cho lần sau nên input rơi vào giữa hai bước như
+// khi chạy thật, còn đồng hồ (timer đo tới nano giây) vẫn tiến đủ duration
+static void advanceTime(ClockNanos duration, SimulationStats& stats) {
+    advanceVirtualClock(duration);
+    s_pendingNanos += duration;
+    while (s_pendingNanos >= SIMULATION_STEP_NANOS) {
+        s_pendingNanos -= SIMULATION_STEP_NANOS;
+        stepSimulation();
+        stats.steps++;
+    }
+}
+
+static void stepVirtualTime(SimulationStats& stats) {
+    advanceTime(SIMULATION_STEP_NANOS, stats);
+}
+
+static bool isSimulationBusy() {
+    return g_animation.isActive || g_moveQueue.count > 0;
+}
+
+static void reportFailure(SimulationStats& stats, int line, const char* message) {
+    stats.failures++;
+    fprintf(stderr, "SIMULATE: phiên %d dòng %d: %s\n", stats.session, line, message);
+    RUBIK_LOG(EVT_SIMULATE_FAILURE) << stats.session << line << message;
+}
+
+// Hiển thị phải đuổi kịp logic khi không còn animation
+static bool visualMatchesLogic() {
+    return memcmp(g_visualCube.pieces, g_rubikCube.pieces, sizeof(g_rubikCube.pieces)) == 0;
+}
+
+static void settle(SimulationStats& stats, int line) {
+    const long long limit = (long long)SIMULATE_SETTLE_LIMIT_SECONDS * SIMULATION_RATE_HZ;
+    long long steps = 0;
+    while (isSimulationBusy() && steps < limit) {
+        stepVirtualTime(stats);
+        steps++;
+    }
+    if (isSimulationBusy()) {
+        reportFailure(stats, line, "animation không dừng");
+    } else if (!visualMatchesLogic()) {
+        reportFailure(stats, line, "trạng thái hiển thị khác trạng thái logic");
+    }
+}
+
+// Nhập một nước như phím bấm: chờ hàng đợi có chỗ, rồi để 1/tps giây trôi qua
+static void enterMove(const ScriptMove& move, bool isScramble, SimulationStats& stats) {
+    while (g_animation.isActive && g_moveQueue.count >= MOVE_QUEUE_CAPACITY) {
+        stepVirtualTime(stats);
+    }
+    bool wasSolved = isCubeSolved();
+    startRotation((Face)move.face, move.clockwise, isScramble);
+    if (!isScramble) {
+        stats.movesEntered++;
+        if (g_timer.state == TIMER_STOPPED && !wasSolved && isCubeSolved()) {
+            stats.solves++;
+            stats.solveSecondsTotal += g_timer.endTime;
+        }
+    }
+    s_history.push_back(move);
+    if (isCubeSolved()) {
+        s_history.clear();
+    }
+    if (!isScramble) {
+        advanceTime(s_moveInterval, stats);
+    }
+}
+
+static void runCommand(const ScriptCommand& command, SimulationStats& stats) {
+    switch (command.op) {
+        case SCRIPT_SCRAMBLE: {
+            // Cùng cách trộn với phím S nhưng chuỗi trộn được ghi lại để solve
+            beginScramble(command.count);
+            int lastFace = -1;
+            for (int i = 0; i < command.count; i++) {
+                ScriptMove move;
+                do {
+                    move.face = rand() % 6;
+                } while (move.face == lastFace);
+                move.clockwise = (rand() % 2) == 0;
+                lastFace = move.face;
+                enterMove(move, true, stats);
+            }
+            break;
+        }
+        case SCRIPT_MOVE:
+            for (size_t i = 0; i < command.moves.size(); i++) {
+                enterMove(command.moves[i], false, stats);
+            }
+            break;
+        case SCRIPT_SOLVE: {
+            std::vector<ScriptMove> inverse(s_history.rbegin(), s_history.rend());
+            for (size_t i = 0; i < inverse.size(); i++) {
+                inverse[i].clockwise = !inverse[i].clockwise;
+                enterMove(inverse[i], false, stats);
+            }
+            break;
+        }
+        case SCRIPT_WAIT:
+            advanceTime(command.duration, stats);
+            break;
+        case SCRIPT_SETTLE:
+            settle(stats, command.line);
+            break;
+        case SCRIPT_RESET:
+            resetCube();
+            s_history.clear();
+            break;
+        case SCRIPT_EXPECT: {
+            bool ok = true;
+            const char* message = "";
+            switch (command.count) {
+                case EXPECT_SOLVED:
+                    ok = isCubeSolved();
+                    message = "cube chưa được giải";
+                    break;
+                case EXPECT_UNSOLVED:
+                    ok = !isCubeSolved();
+                    message = "cube đang ở trạng thái đã giải";
+                    break;
+                case EXPECT_STOPPED:
+                    ok = g_timer.state == TIMER_STOPPED;
+                    message = "timer chưa dừng";
+                    break;
+                case EXPECT_READY:
+                    ok = g_timer.state == TIMER_READY;
+                    message = "timer chưa sẵn sàng";
+                    break;
+            }
+            if (!ok) {
+                reportFailure(stats, command.line, message);
+            }
+            break;
+        }
+    }
+}
+
+// ==================== Chế độ dòng lệnh ====================
+
+bool isSimulationRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--simulate") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printSimulationUsage() {
+    fprintf(stderr,
+            "Cách dùng: rubik --simulate [--script \"scramble 20; settle; solve\"] [--script-file f]\n"
+            "                 [--sessions N] [--hours H] [--tps X] [--seed N] [--record out.rrec]\n"
+            "                 [--solve-db solves.db]\n"
+            "  Chạy kịch bản N phiên (hoặc tới khi đủ H giờ mô phỏng) theo đồng hồ ảo.\n"
+            "  Lệnh: scramble N, move ..., solve, wait S, settle, reset,\n"
+            "        expect solved|unsolved|stopped|ready. Mã thoát 2 nếu có lỗi kiểm tra.\n");
+}
+
+int runSimulationCommand(int argc, char** argv) {
+    std::string scriptText;
+    int sessions = 1;
+    double hours = 0.0;
+    float tps = SIMULATE_DEFAULT_TPS;
+    unsigned int seed = 1;
+    const char* recordPath = NULL;
+    const char* solveDbPath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--simulate") == 0) {
+            continue;
+        } else if (strcmp(argv[i], "--script") == 0 && hasValue) {
+            scriptText += argv[++i];
+            scriptText += '\n';
+        } else if (strcmp(argv[i], "--script-file") == 0 && hasValue) {
+            if (!readTextFile(argv[++i], scriptText)) {
+                fprintf(stderr, "Không đọc được file kịch bản: %s\n", argv[i]);
+                return 1;
+            }
+            scriptText += '\n';
+        } else if (strcmp(argv[i], "--sessions") == 0 && hasValue) {
+            sessions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--hours") == 0 && hasValue) {
+            hours = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--tps") == 0 && hasValue) {
+            tps = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--record") == 0 && hasValue) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--solve-db") == 0 && hasValue) {
+            solveDbPath = argv[++i];
+        } else {
+            fprintf(stderr, "Tham số không hợp lệ: %s\n", argv[i]);
+            printSimulationUsage();
+            return 1;
+        }
+    }
+    if (sessions <= 0 || hours < 0.0 || tps <= 0.0f) {
+        printSimulationUsage();
+        return 1;
+    }
+
+    std::vector<ScriptCommand> script;
+    if (!parseScript(scriptText.empty() ? DEFAULT_SCRIPT : scriptText, script)) {
+        return 1;
+    }
+    if (script.empty()) {
+        printSimulationUsage();
+        return 1;
+    }
+
+    // Không có cửa sổ: scheduler không gọi GLUT; mọi thời gian ứng dụng lấy từ đồng hồ ảo.
+    // Log nước đi bị tắt vì một giờ mô phỏng sinh hàng chục nghìn bản ghi
+    setSchedulerHeadless(true);
+    unsigned int savedCategories = getLogCategories();
+    setLogCategories(savedCategories & ~(unsigned int)LOG_CAT_MOVE);
+    setVirtualClock(0);
+    srand(seed);
+    initRubikCube();
+    s_history.clear();
+    s_pendingNanos = 0;
+    s_moveInterval = clockSecondsToNanos(1.0 / (double)tps);
+    if (recordPath != NULL && !startRecording(recordPath)) {
+        fprintf(stderr, "Không ghi được file phiên: %s\n", recordPath);
+        useRealClock();
+        setLogCategories(savedCategories);
+        return 1;
+    }
+    if (solveDbPath != NULL && !openSolveDatabase(solveDbPath)) {
+        fprintf(stderr, "Không mở được file lịch sử giải: %s\n", solveDbPath);
+        finishRecording();
+        useRealClock();
+        setLogCategories(savedCategories);
+        return 1;
+    }
+
+    SimulationStats stats;
+    memset(&stats, 0, sizeof(stats));
+    const ClockNanos targetNanos = clockSecondsToNanos(hours * 3600.0);
+    ClockNanos startTime = clockRealNanos();
+
+    for (stats.session = 1; hours > 0.0 ? clockNowNanos() < targetNanos : stats.session <= sessions;
+         stats.session++) {
+        for (size_t i = 0; i < script.size(); i++) {
+            runCommand(script[i], stats);
+        }
+    }
+    int sessionCount = stats.session - 1;
+
+    double realSeconds = clockNanosToSeconds(clockRealNanos() - startTime);
+    double simSeconds = clockNanosToSeconds(clockNowNanos());
+    finishRecording();
+    closeSolveDatabase();
+    useRealClock();
+    setLogCategories(savedCategories);
+
+    printf("SIMULATE: %d phiên, %.1f giây mô phỏng (%.2f giờ) trong %.3fs, nhanh gấp %.0f lần thời gian thực\n",
+           sessionCount, simSeconds, simSeconds / 3600.0, realSeconds,
+           realSeconds > 0.0 ? simSeconds / realSeconds : 0.0);
+    printf("  %lld bước mô phỏng (%.0f ns/bước), %d nước nhập, %d lần giải (trung bình %.3fs), %d lỗi\n",
+           stats.steps, stats.steps > 0 ? realSeconds * 1e9 / (double)stats.steps : 0.0,
+           stats.movesEntered, stats.solves,
+           stats.solves > 0 ? stats.solveSecondsTotal / stats.solves : 0.0, stats.failures);
+    RUBIK_LOG(EVT_SIMULATE_DONE) << sessionCount << simSeconds << realSeconds
+                                 << stats.movesEntered << stats.solves << stats.failures;
+    return stats.failures > 0 ? 2 : 0;
+}
@@ -0,0 +1,580 @@
+#include "rubik_softraster.h"
+#include "rubik_render.h"
+#include "rubik_rotation.h"
+#include "rubik_instanced.h"
+#include "rubik_state.h"
+#include "rubik_animation.h"
+#include "rubik_input.h"
+#include "rubik_scheduler.h"
+#include "rubik_clock.h"
+#include "rubik_constants.h"
+#include "rubik_thread.h"
+#include "rubik_image.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(snprintf)
+#define snprintf _snprintf
+#endif
+
+// Tam giác đã chiếu lên màn hình, dạng sẵn sàng cho raster:
+// E_i(x, y) = edgeA[i] * x + edgeB[i] * y + edgeC[i] > 0 là phía trong cạnh i
+struct SoftTriangle {
+    float edgeA[3];
+    float edgeB[3];
+    float edgeC[3];
+    bool edgeInclusive[3];     // Quy tắc top-left: pixel nằm đúng trên cạnh chỉ thuộc một tam giác
+    float depthA, depthB, depthC;  // Mặt phẳng độ sâu z(x, y)
+    unsigned char color[3];
+    int minX, minY, maxX, maxY;    // Hộp bao (pixel, đã cắt theo màn hình)
+};
+
+// Đỉnh trong không gian clip (x, y, z, w)
+struct ClipVertex {
+    float v[4];
+};
+
+// Màu nền giống glClearColor(0.2, 0.2, 0.2) trong initOpenGL()
+static const unsigned char CLEAR_COLOR[3] = {51, 51, 51};
+
+static SoftFramebuffer s_framebuffer = {0, 0, NULL, NULL};
+static std::vector<SoftTriangle> s_triangles;
+static std::vector<std::vector<int> > s_tileBins;  // Chỉ số tam giác của mỗi tile, theo thứ tự vẽ
+static int s_tilesX = 0;
+static int s_tilesY = 0;
+static int s_tileCount = 0;
+
+// Thread pool: luồng chính cũng raster cùng các worker
+static RubikThread* s_workers = NULL;
+static int s_workerCount = 0;
+static RubikMutex s_poolMutex;
+static RubikCondition s_startCondition;
+static RubikCondition s_doneCondition;
+static int s_generation = 0;        // Tăng mỗi frame để đánh thức worker
+static int s_finishedWorkers = 0;
+static bool s_quit = false;
+static volatile int s_nextTile = 0; // Tile kế tiếp chưa có luồng nhận
+
+// 4 góc của mỗi mặt, cùng thứ tự mặt và đỉnh với drawCubePiece()
+static const float PIECE_CORNERS[6][4][3] = {
+    {{-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1}},        // Trước (Z+)
+    {{1, -1, -1}, {-1, -1, -1}, {-1, 1, -1}, {1, 1, -1}},    // Sau (Z-)
+    {{-1, -1, -1}, {-1, -1, 1}, {-1, 1, 1}, {-1, 1, -1}},    // Trái (X-)
+    {{1, -1, 1}, {1, -1, -1}, {1, 1, -1}, {1, 1, 1}},        // Phải (X+)
+    {{-1, 1, 1}, {1, 1, 1}, {1, 1, -1}, {-1, 1, -1}},        // Trên (Y+)
+    {{-1, -1, -1}, {1, -1, -1}, {1, -1, 1}, {-1, -1, 1}}     // Dưới (Y-)
+};
+
+// ==================== Raster một tile ====================
+
+static void clearTile(int x0, int y0, int x1, int y1) {
+    for (int y = y0; y < y1; y++) {
+        unsigned char* color = s_framebuffer.color + ((size_t)y * s_framebuffer.width + x0) * 3;
+        float* depth = s_framebuffer.depth + (size_t)y * s_framebuffer.width + x0;
+        for (int x = x0; x < x1; x++) {
+            color[0] = CLEAR_COLOR[0];
+            color[1] = CLEAR_COLOR[1];
+            color[2] = CLEAR_COLOR[2];
+            color += 3;
+            *depth++ = 1.0f;
+        }
+    }
+}
+
+static bool insideEdge(float value, bool inclusive) {
+    return value > 0.0f || (value == 0.0f && inclusive);
+}
+
+static void rasterTriangleInTile(const SoftTriangle& tri, int x0, int y0, int x1, int y1) {
+    int minX = tri.minX > x0 ? tri.minX : x0;
+    int minY = tri.minY > y0 ? tri.minY : y0;
+    int maxX = tri.maxX < x1 - 1 ? tri.maxX : x1 - 1;
+    int maxY = tri.maxY < y1 - 1 ? tri.maxY : y1 - 1;
+    const int width = s_framebuffer.width;
+
+    for (int y = minY; y <= maxY; y++) {
+        const float py = (float)y + 0.5f;
+        // Giá trị hàm cạnh tại tâm pixel đầu hàng, sau đó cộng dồn theo x
+        float px = (float)minX + 0.5f;
+        float e0 = tri.edgeA[0] * px + tri.edgeB[0] * py + tri.edgeC[0];
+        float e1 = tri.edgeA[1] * px + tri.edgeB[1] * py + tri.edgeC[1];
+        float e2 = tri.edgeA[2] * px + tri.edgeB[2] * py + tri.edgeC[2];
+        float z = tri.depthA * px + tri.depthB * py + tri.depthC;
+
+        size_t index = (size_t)y * width + minX;
+        for (int x = minX; x <= maxX; x++, index++) {
+            if (insideEdge(e0, tri.edgeInclusive[0]) &&
+                insideEdge(e1, tri.edgeInclusive[1]) &&
+                insideEdge(e2, tri.edgeInclusive[2]) &&
+                z < s_framebuffer.depth[index]) {  // GL_LESS
+                s_framebuffer.depth[index] = z;
+                unsigned char* color = s_framebuffer.color + index * 3;
+                color[0] = tri.color[0];
+                color[1] = tri.color[1];
+                color[2] = tri.color[2];
+            }
+            e0 += tri.edgeA[0];
+            e1 += tri.edgeA[1];
+            e2 += tri.edgeA[2];
+            z += tri.depthA;
+        }
+    }
+}
+
+static void rasterTile(int tile) {
+    PROFILE_ZONE("rasterTile");
+    int x0 = (tile % s_tilesX) * SOFT_TILE_SIZE;
+    int y0 = (tile / s_tilesX) * SOFT_TILE_SIZE;
+    int x1 = x0 + SOFT_TILE_SIZE < s_framebuffer.width ? x0 + SOFT_TILE_SIZE : s_framebuffer.width;
+    int y1 = y0 + SOFT_TILE_SIZE < s_framebuffer.height ? y0 + SOFT_TILE_SIZE : s_framebuffer.height;
+
+    clearTile(x0, y0, x1, y1);
+    const std::vector<int>& bin = s_tileBins[tile];
+    for (size_t i = 0; i < bin.size(); i++) {
+        rasterTriangleInTile(s_triangles[bin[i]], x0, y0, x1, y1);
+    }
+}
+
+// Nhận tile cho tới khi hết (mỗi tile chỉ do một luồng ghi nên không cần khóa)
+static void processTiles() {
+    for (;;) {
+        int tile = atomicAdd(&s_nextTile, 1) - 1;
+        if (tile >= s_tileCount) {
+            break;
+        }
+        rasterTile(tile);
+    }
+}
+
+static void workerMain(void* arg) {
+    (void)arg;
+    setProfilerThreadName("soft raster worker");
+    int seenGeneration = 0;
+    lockMutex(s_poolMutex);
+    for (;;) {
+        while (!s_quit && s_generation == seenGeneration) {
+            waitCondition(s_startCondition, s_poolMutex);
+        }
+        if (s_quit) {
+            break;
+        }
+        seenGeneration = s_generation;
+        unlockMutex(s_poolMutex);
+
+        processTiles();
+
+        lockMutex(s_poolMutex);
+        s_finishedWorkers++;
+        signalCondition(s_doneCondition);
+    }
+    unlockMutex(s_poolMutex);
+}
+
+// Raster tất cả tile trên mọi luồng, trả về khi frame đã xong
+static void dispatchTiles() {
+    if (s_workerCount == 0) {
+        s_nextTile = 0;
+        processTiles();
+        return;
+    }
+    lockMutex(s_poolMutex);
+    s_nextTile = 0;
+    s_finishedWorkers = 0;
+    s_generation++;
+    broadcastCondition(s_startCondition);
+    unlockMutex(s_poolMutex);
+
+    processTiles();
+
+    lockMutex(s_poolMutex);
+    while (s_finishedWorkers < s_workerCount) {
+        waitCondition(s_doneCondition, s_poolMutex);
+    }
+    unlockMutex(s_poolMutex);
+}
+
+// ==================== Dựng và phân tile tam giác ====================
+
+// Cắt đa giác theo near plane (z >= -w), Sutherland-Hodgman
+static int clipPolygonNear(const ClipVertex* input, int count, ClipVertex* output) {
+    int outCount = 0;
+    for (int i = 0; i < count; i++) {
+        const ClipVertex& a = input[i];
+        const ClipVertex& b = input[(i + 1) % count];
+        float da = a.v[2] + a.v[3];
+        float db = b.v[2] + b.v[3];
+        if (da >= 0.0f) {
+            output[outCount++] = a;
+        }
+        if ((da >= 0.0f) != (db >= 0.0f)) {
+            float t = da / (da - db);
+            ClipVertex& v = output[outCount++];
+            for (int c = 0; c < 4; c++) {
+                v.v[c] = a.v[c] + (b.v[c] - a.v[c]) * t;
+            }
+        }
+    }
+    return outCount;
+}
+
+// Chiếu một tam giác lên màn hình và thêm vào danh sách (bỏ qua tam giác suy biến)
+static void setupTriangle(const ClipVertex& c0, const ClipVertex& c1, const ClipVertex& c2,
+                          const unsigned char color[4]) {
+    const ClipVertex* clip[3] = {&c0, &c1, &c2};
+    float sx[3], sy[3], sz[3];
+    for (int i = 0; i < 3; i++) {
+        float invW = 1.0f / clip[i]->v[3];
+        // Toạ độ màn hình với gốc ở góc trên trái (hàng ảnh từ trên xuống)
+        sx[i] = (clip[i]->v[0] * invW * 0.5f + 0.5f) * (float)s_framebuffer.width;
+        sy[i] = (0.5f - clip[i]->v[1] * invW * 0.5f) * (float)s_framebuffer.height;
+        sz[i] = clip[i]->v[2] * invW * 0.5f + 0.5f;
+    }
+
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sy[1] - sy[0]) * (sx[2] - sx[0]);
+    if (area == 0.0f) {
+        return;
+    }
+    if (area < 0.0f) {
+        // Không cull mặt sau (GL_CULL_FACE tắt): đảo thứ tự đỉnh để diện tích dương
+        float tmp;
+        tmp = sx[1]; sx[1] = sx[2]; sx[2] = tmp;
+        tmp = sy[1]; sy[1] = sy[2]; sy[2] = tmp;
+        tmp = sz[1]; sz[1] = sz[2]; sz[2] = tmp;
+        area = -area;
+    }
+
+    SoftTriangle tri;
+    float minXf = sx[0], maxXf = sx[0], minYf = sy[0], maxYf = sy[0];
+    for (int i = 1; i < 3; i++) {
+        if (sx[i] < minXf) minXf = sx[i];
+        if (sx[i] > maxXf) maxXf = sx[i];
+        if (sy[i] < minYf) minYf = sy[i];
+        if (sy[i] > maxYf) maxYf = sy[i];
+    }
+    // Pixel (x, y) được lấy mẫu tại tâm (x + 0.5, y + 0.5)
+    tri.minX = (int)(minXf - 0.5f);
+    tri.minY = (int)(minYf - 0.5f);
+    tri.maxX = (int)(maxXf + 0.5f);
+    tri.maxY = (int)(maxYf + 0.5f);
+    if (tri.minX < 0) tri.minX = 0;
+    if (tri.minY < 0) tri.minY = 0;
+    if (tri.maxX > s_framebuffer.width - 1) tri.maxX = s_framebuffer.width - 1;
+    if (tri.maxY > s_framebuffer.height - 1) tri.maxY = s_framebuffer.height - 1;
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY) {
+        return;
+    }
+
+    // Cạnh i đối diện đỉnh i: 1->2, 2->0, 0->1
+    float invArea = 1.0f / area;
+    tri.depthA = 0.0f;
+    tri.depthB = 0.0f;
+    tri.depthC = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        int a = (i + 1) % 3;
+        int b = (i + 2) % 3;
+        float dx = sx[b] - sx[a];
+        float dy = sy[b] - sy[a];
+        tri.edgeA[i] = -dy;
+        tri.edgeB[i] = dx;
+        tri.edgeC[i] = dy * sx[a] - dx * sy[a];
+        tri.edgeInclusive[i] = (dy < 0.0f) || (dy == 0.0f && dx > 0.0f);
+        // z = sum(E_i * z_i) / area, tuyến tính theo (x, y)
+        tri.depthA += tri.edgeA[i] * sz[i] * invArea;
+        tri.depthB += tri.edgeB[i] * sz[i] * invArea;
+        tri.depthC += tri.edgeC[i] * sz[i] * invArea;
+    }
+    tri.color[0] = color[0];
+    tri.color[1] = color[1];
+    tri.color[2] = color[2];
+
+    int index = (int)s_triangles.size();
+    s_triangles.push_back(tri);
+
+    int tileMinX = tri.minX / SOFT_TILE_SIZE;
+    int tileMaxX = tri.maxX / SOFT_TILE_SIZE;
+    int tileMinY = tri.minY / SOFT_TILE_SIZE;
+    int tileMaxY = tri.maxY / SOFT_TILE_SIZE;
+    for (int ty = tileMinY; ty <= tileMaxY; ty++) {
+        for (int tx = tileMinX; tx <= tileMaxX; tx++) {
+            s_tileBins[ty * s_tilesX + tx].push_back(index);
+        }
+    }
+}
+
+// Biến đổi 27 mảnh của g_visualCube thành tam giác màn hình và phân vào các tile
+static void buildSceneTriangles() {
+    s_triangles.clear();
+    for (int t = 0; t < s_tileCount; t++) {
+        s_tileBins[t].clear();
+    }
+
+    float view[16];
+    float projection[16];
+    float viewProjection[16];
+    computeViewMatrix(view);
+    computeProjectionMatrix(projection, (float)s_framebuffer.width / (float)s_framebuffer.height);
+    multiplyMatrix4(viewProjection, projection, view);
+
+    const float halfSize = g_visualCube.pieceSize * 0.5f;
+    for (int i = 0; i < 27; i++) {
+        const CubePiece& piece = g_visualCube.pieces[i];
+        if (!piece.isVisible) {
+            continue;
+        }
+        float transform[12];
+        computePieceTransform(g_visualCube, i, transform);
+        unsigned char colors[6][4];
+        packPieceColors(piece, colors);
+
+        for (int face = 0; face < 6; face++) {
+            ClipVertex quad[4];
+            for (int k = 0; k < 4; k++) {
+                float local[3] = {
+                    PIECE_CORNERS[face][k][0] * halfSize,
+                    PIECE_CORNERS[face][k][1] * halfSize,
+                    PIECE_CORNERS[face][k][2] * halfSize
+                };
+                float world[3];
+                for (int row = 0; row < 3; row++) {
+                    world[row] = transform[row * 4 + 0] * local[0] +
+                                 transform[row * 4 + 1] * local[1] +
+                                 transform[row * 4 + 2] * local[2] +
+                                 transform[row * 4 + 3];
+                }
+                transformPoint4(viewProjection, world, quad[k].v);
+            }
+
+            // Cắt near plane có thể sinh tối đa 5 đỉnh, sau đó chia quạt thành tam giác
+            ClipVertex clipped[8];
+            int count = clipPolygonNear(quad, 4, clipped);
+            for (int k = 1; k + 1 < count; k++) {
+                setupTriangle(clipped[0], clipped[k], clipped[k + 1], colors[face]);
+            }
+        }
+    }
+}
+
+// ==================== API ====================
+
+bool initSoftRenderer(int width, int height, int threadCount) {
+    shutdownSoftRenderer();
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    if (threadCount <= 0) {
+        threadCount = getHardwareThreadCount();
+    }
+
+    s_framebuffer.width = width;
+    s_framebuffer.height = height;
+    s_framebuffer.color = new unsigned char[(size_t)width * height * 3];
+    s_framebuffer.depth = new float[(size_t)width * height];
+
+    s_tilesX = (width + SOFT_TILE_SIZE - 1) / SOFT_TILE_SIZE;
+    s_tilesY = (height + SOFT_TILE_SIZE - 1) / SOFT_TILE_SIZE;
+    s_tileCount = s_tilesX * s_tilesY;
+    s_tileBins.assign(s_tileCount, std::vector<int>());
+    s_triangles.reserve(27 * 6 * 2);
+
+    initMutex(s_poolMutex);
+    initCondition(s_startCondition);
+    initCondition(s_doneCondition);
+    s_quit = false;
+    s_generation = 0;
+    s_workerCount = 0;
+    if (threadCount > 1) {
+        s_workers = new RubikThread[threadCount - 1];
+        for (int i = 0; i < threadCount - 1; i++) {
+            if (!startThread(s_workers[i], workerMain, NULL)) {
+                break;
+            }
+            s_workerCount++;
+        }
+    }
+
+    RUBIK_LOG(EVT_SOFT_RENDER_INIT) << width << height << s_tileCount << s_workerCount + 1;
+    return true;
+}
+
+void shutdownSoftRenderer() {
+    if (s_framebuffer.color == NULL) {
+        return;
+    }
+    lockMutex(s_poolMutex);
+    s_quit = true;
+    broadcastCondition(s_startCondition);
+    unlockMutex(s_poolMutex);
+    for (int i = 0; i < s_workerCount; i++) {
+        joinThread(s_workers[i]);
+    }
+    delete[] s_workers;
+    s_workers = NULL;
+    s_workerCount = 0;
+    destroyCondition(s_doneCondition);
+    destroyCondition(s_startCondition);
+    destroyMutex(s_poolMutex);
+
+    delete[] s_framebuffer.color;
+    delete[] s_framebuffer.depth;
+    s_framebuffer.color = NULL;
+    s_framebuffer.depth = NULL;
+    s_framebuffer.width = 0;
+    s_framebuffer.height = 0;
+    s_tileBins.clear();
+    s_triangles.clear();
+}
+
+int getSoftRendererThreadCount() {
+    return s_workerCount + 1;
+}
+
+void renderSceneSoftware() {
+    PROFILE_ZONE("renderSceneSoftware");
+    if (s_framebuffer.color == NULL) {
+        return;
+    }
+    buildSceneTriangles();
+    dispatchTiles();
+}
+
+const SoftFramebuffer& getSoftFramebuffer() {
+    return s_framebuffer;
+}
+
+// ==================== Chế độ dòng lệnh ====================
+
+bool isSoftRenderRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--soft-render") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printSoftRenderUsage() {
+    fprintf(stderr,
+            "Cách dùng: rubik --soft-render out.(ppm|png) [--frames N] [--size WxH]\n"
+            "                 [--threads N] [--angles X,Y] [--scramble N] [--seed N]\n"
+            "  Đường dẫn chứa %%d (vd. frame_%%04d.png) sẽ ghi mọi frame,\n"
+            "  nếu không chỉ frame cuối được ghi.\n");
+}
+
+int runSoftRenderCommand(int argc, char** argv) {
+    const char* outputPath = NULL;
+    int frames = 1;
+    int width = 800;
+    int height = 600;
+    int threads = 0;
+    int scrambleMoves = 0;
+    unsigned int seed = 1;
+    float angleX = SOFT_DEFAULT_ANGLE_X;
+    float angleY = SOFT_DEFAULT_ANGLE_Y;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--soft-render") == 0 && hasValue) {
+            outputPath = argv[++i];
+        } else if (strcmp(argv[i], "--frames") == 0 && hasValue) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--size") == 0 && hasValue) {
+            if (sscanf(argv[++i], "%dx%d", &width, &height) != 2) {
+                width = 0;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--angles") == 0 && hasValue) {
+            if (sscanf(argv[++i], "%f,%f", &angleX, &angleY) != 2) {
+                width = 0;
+            }
+        } else if (strcmp(argv[i], "--scramble") == 0 && hasValue) {
+            scrambleMoves = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "Tham số không hợp lệ: %s\n", argv[i]);
+            printSoftRenderUsage();
+            return 1;
+        }
+    }
+    if (outputPath == NULL || frames <= 0 || width <= 0 || height <= 0) {
+        printSoftRenderUsage();
+        return 1;
+    }
+    bool writeEveryFrame = false;
+    ImagePathPattern outputPattern;
+    if (!parseImagePathPattern(outputPath, writeEveryFrame, outputPattern)) {
+        fprintf(stderr, "Đường dẫn output chỉ được có một %%d (vd. frame_%%04d.png) và không có %% nào khác: %s\n",
+                outputPath);
+        return 1;
+    }
+
+    // Không có cửa sổ: scheduler không được gọi GLUT, mô phỏng do vòng lặp này điều khiển
+    setSchedulerHeadless(true);
+    initRubikCube();
+    updateRotationAxes();
+    cameraAngleX = angleX;
+    cameraAngleY = angleY;
+    g_renderAlpha = 1.0f;
+    srand(seed);  // Seed cố định để chuỗi trộn lặp lại được giữa các lần chạy
+
+    if (scrambleMoves > 0) {
+        shuffleCube(scrambleMoves);
+        if (frames == 1) {
+            // Ảnh tĩnh: cho hàng đợi chạy hết để chụp trạng thái đã trộn
+            for (int guard = 0; guard < 1000000 && (g_animation.isActive || g_moveQueue.count > 0); guard++) {
+                stepSimulation();
+            }
+        }
+    }
+
+    if (!initSoftRenderer(width, height, threads)) {
+        return 1;
+    }
+
+    const int stepsPerFrame = SIMULATION_RATE_HZ / TARGET_FRAME_RATE > 0 ? SIMULATION_RATE_HZ / TARGET_FRAME_RATE : 1;
+    ClockNanos renderNanos = 0;
+    ClockNanos startTime = clockRealNanos();
+    bool ok = true;
+
+    for (int frame = 0; frame < frames && ok; frame++) {
+        if (frame > 0) {
+            for (int s = 0; s < stepsPerFrame; s++) {
+                stepSimulation();
+            }
+        }
+
+        ClockNanos frameStart = clockRealNanos();
+        renderSceneSoftware();
+        renderNanos += clockRealNanos() - frameStart;
+
+        if (writeEveryFrame || frame == frames - 1) {
+            char path[1024];
+            if (writeEveryFrame) {
+                formatImagePath(outputPattern, frame, path, sizeof(path));
+            } else {
+                snprintf(path, sizeof(path), "%s", outputPath);
+            }
+            path[sizeof(path) - 1] = '\0';
+            ok = writeImageFile(path, width, height, s_framebuffer.color);
+            if (!ok) {
+                fprintf(stderr, "Không ghi được ảnh: %s\n", path);
+            }
+        }
+    }
+
+    double totalSeconds = clockNanosToSeconds(clockRealNanos() - startTime);
+    double renderSeconds = clockNanosToSeconds(renderNanos);
+    double msPerFrame = renderSeconds * 1000.0 / (double)frames;
+    double fps = renderSeconds > 0.0 ? (double)frames / renderSeconds : 0.0;
+    printf("SOFT RENDER: %dx%d, %d frame, %d luồng: %.3f ms/frame, %.1f fps (tổng %.2fs kể cả ghi file)\n",
+           width, height, frames, getSoftRendererThreadCount(), msPerFrame, fps, totalSeconds);
+    RUBIK_LOG(EVT_SOFT_RENDER_STATS) << frames << getSoftRendererThreadCount() << msPerFrame << fps << totalSeconds;
+
+    shutdownSoftRenderer();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,521 @@
+#include "rubik_solvedb.h"
+#include "rubik_constants.h"
+#include "rubik_clock.h"
+#include "rubik_log.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(snprintf)
+#define snprintf _snprintf
+#endif
+
+static const char SOLVE_DB_MAGIC[4] = {'R', 'B', 'S', 'D'};
+static const int SOLVE_READ_CHUNK = 4096;   // Số bản ghi mỗi lần fread
+
+// Cửa sổ N lần giải cuối cho trung bình cắt bỏ. Ba multiset phân hoạch cửa sổ theo
+// giá trị: low (trim lần nhanh nhất) <= middle <= high (trim lần chậm nhất), nên
+// aoN = middleSum / (N - 2 * trim) và mỗi lần thêm/bỏ chỉ di chuyển phần tử ở biên
+struct TrimmedWindow {
+    int size;
+    int trim;
+    std::vector<unsigned int> ring;   // Thứ tự thêm vào, để biết lần giải nào rời cửa sổ
+    int next;
+    int count;
+    std::multiset<unsigned int> low;
+    std::multiset<unsigned int> middle;
+    std::multiset<unsigned int> high;
+    long long middleSum;
+};
+
+static FILE* s_file = NULL;
+static std::string s_path;
+static SolveDbHeader s_header;
+static TrimmedWindow s_windows[SOLVE_AVERAGE_COUNT];
+static unsigned int s_lastMillis = 0;
+static bool s_writeFailed = false;
+
+// ==================== Cửa sổ trung bình ====================
+
+static void resetWindow(TrimmedWindow& window, int size) {
+    window.size = size;
+    window.trim = (size * SOLVE_AVERAGE_TRIM_PERCENT + 99) / 100;
+    if (window.trim < 1) {
+        window.trim = 1;
+    }
+    window.ring.assign(size, 0);
+    window.next = 0;
+    window.count = 0;
+    window.low.clear();
+    window.middle.clear();
+    window.high.clear();
+    window.middleSum = 0;
+}
+
+static void moveToMiddle(TrimmedWindow& window, unsigned int value) {
+    window.middle.insert(value);
+    window.middleSum += value;
+}
+
+static unsigned int takeFromMiddle(TrimmedWindow& window, std::multiset<unsigned int>::iterator it) {
+    unsigned int value = *it;
+    window.middle.erase(it);
+    window.middleSum -= value;
+    return value;
+}
+
+// Đưa low/high về đúng trim phần tử; chỉ lấy phần tử ở biên nên thứ tự giữa
+// các tập luôn được giữ
+static void rebalanceWindow(TrimmedWindow& window) {
+    while ((int)window.low.size() > window.trim) {
+        std::multiset<unsigned int>::iterator last = window.low.end();
+        --last;
+        moveToMiddle(window, *last);
+        window.low.erase(last);
+    }
+    while ((int)window.high.size() > window.trim) {
+        moveToMiddle(window, *window.high.begin());
+        window.high.erase(window.high.begin());
+    }
+    while ((int)window.low.size() < window.trim && !window.middle.empty()) {
+        window.low.insert(takeFromMiddle(window, window.middle.begin()));
+    }
+    while ((int)window.high.size() < window.trim && !window.middle.empty()) {
+        std::multiset<unsigned int>::iterator last = window.middle.end();
+        --last;
+        window.high.insert(takeFromMiddle(window, last));
+    }
+}
+
+static void insertIntoWindow(TrimmedWindow& window, unsigned int value) {
+    if (!window.low.empty() && value <= *window.low.rbegin()) {
+        window.low.insert(value);
+    } else if (!window.high.empty() && value >= *window.high.begin()) {
+        window.high.insert(value);
+    } else {
+        moveToMiddle(window, value);
+    }
+}
+
+// Giá trị có trong cửa sổ: nếu <= phần tử lớn nhất của low thì chắc chắn nằm trong low
+static void eraseFromWindow(TrimmedWindow& window, unsigned int value) {
+    if (!window.low.empty() && value <= *window.low.rbegin()) {
+        window.low.erase(window.low.find(value));
+    } else if (!window.high.empty() && value >= *window.high.begin()) {
+        window.high.erase(window.high.find(value));
+    } else {
+        takeFromMiddle(window, window.middle.find(value));
+    }
+}
+
+static void pushWindow(TrimmedWindow& window, unsigned int value) {
+    if (window.count == window.size) {
+        eraseFromWindow(window, window.ring[window.next]);
+    } else {
+        window.count++;
+    }
+    window.ring[window.next] = value;
+    window.next = (window.next + 1) % window.size;
+    insertIntoWindow(window, value);
+    rebalanceWindow(window);
+}
+
+// Mili giây, < 0 nếu cửa sổ chưa đầy
+static double windowAverageMillis(const TrimmedWindow& window) {
+    if (window.count < window.size) {
+        return -1.0;
+    }
+    return (double)window.middleSum / (double)(window.size - 2 * window.trim);
+}
+
+// ==================== Thống kê ====================
+
+static void resetHeaderStats(SolveDbHeader& header) {
+    header.solveCount = 0;
+    header.totalMillis = 0;
+    header.bestMillis = 0;
+    for (int i = 0; i < SOLVE_AVERAGE_COUNT; i++) {
+        header.bestAverageMillis[i] = 0.0;
+    }
+}
+
+static void initHeader(SolveDbHeader& header) {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SOLVE_DB_MAGIC, sizeof(header.magic));
+    header.version = SOLVE_DB_VERSION;
+    header.recordBytes = sizeof(SolveRecord);
+    header.averageCount = SOLVE_AVERAGE_COUNT;
+}
+
+static void resetWindows() {
+    for (int i = 0; i < SOLVE_AVERAGE_COUNT; i++) {
+        resetWindow(s_windows[i], SOLVE_AVERAGE_SIZES[i]);
+    }
+    s_lastMillis = 0;
+}
+
+// Lần giải đã có trong thống kê của header: chỉ dựng lại cửa sổ
+static void seedSolve(const SolveRecord& record) {
+    for (int i = 0; i < SOLVE_AVERAGE_COUNT; i++) {
+        pushWindow(s_windows[i], record.timeMillis);
+    }
+    s_lastMillis = record.timeMillis;
+}
+
+static void applySolve(SolveDbHeader& header, const SolveRecord& record) {
+    header.solveCount++;
+    header.totalMillis += record.timeMillis;
+    if (header.bestMillis == 0 || record.timeMillis < header.bestMillis) {
+        header.bestMillis = record.timeMillis;
+    }
+    seedSolve(record);
+    for (int i = 0; i < SOLVE_AVERAGE_COUNT; i++) {
+        double average = windowAverageMillis(s_windows[i]);
+        if (average >= 0.0 && (header.bestAverageMillis[i] == 0.0 || average < header.bestAverageMillis[i])) {
+            header.bestAverageMillis[i] = average;
+        }
+    }
+}
+
+static void fillSolveStats(const SolveDbHeader& header, SolveStats& stats) {
+    stats.solveCount = header.solveCount;
+    stats.lastSeconds = header.solveCount > 0 ? s_lastMillis / 1000.0 : -1.0;
+    stats.bestSeconds = header.solveCount > 0 ? header.bestMillis / 1000.0 : -1.0;
+    stats.meanSeconds = header.solveCount > 0 ? (double)header.totalMillis / (double)header.solveCount / 1000.0 : -1.0;
+    for (int i = 0; i < SOLVE_AVERAGE_COUNT; i++) {
+        double current = windowAverageMillis(s_windows[i]);
+        stats.currentAverage[i] = current >= 0.0 ? current / 1000.0 : -1.0;
+        stats.bestAverage[i] = header.bestAverageMillis[i] > 0.0 ? header.bestAverageMillis[i] / 1000.0 : -1.0;
+    }
+}
+
+// ==================== File ====================
+
+static long long solveRecordOffset(long long index) {
+    return (long long)sizeof(SolveDbHeader) + index * (long long)sizeof(SolveRecord);
+}
+
+static bool writeHeader(FILE* file, const SolveDbHeader& header) {
+    return fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1 && fflush(file) == 0;
+}
+
+// Đọc bản ghi [first, last): bản ghi trước gathered chỉ dựng cửa sổ, từ đó trở đi
+// được gộp vào thống kê của header
+static bool readSolveRecords(FILE* file, long long first, long long last, long long gathered, SolveDbHeader& header) {
+    if (first >= last) {
+        return true;
+    }
+    if (fseek(file, (long)solveRecordOffset(first), SEEK_SET) != 0) {
+        return false;
+    }
+    std::vector<SolveRecord> buffer(SOLVE_READ_CHUNK);
+    long long index = first;
+    while (index < last) {
+        size_t wanted = (size_t)std::min<long long>(SOLVE_READ_CHUNK, last - index);
+        if (fread(&buffer[0], sizeof(SolveRecord), wanted, file) != wanted) {
+            return false;
+        }
+        for (size_t i = 0; i < wanted; i++, index++) {
+            if (index < gathered) {
+                seedSolve(buffer[i]);
+            } else {
+                applySolve(header, buffer[i]);
+            }
+        }
+    }
+    return true;
+}
+
+static bool loadSolveDatabase(const char* path, bool writable, long long& caughtUp) {
+    caughtUp = 0;
+    FILE* file = fopen(path, writable ? "r+b" : "rb");
+    if (file == NULL && writable) {
+        file = fopen(path, "w+b");
+    }
+    if (file == NULL) {
+        return false;
+    }
+
+    SolveDbHeader header;
+    long long recordCount = 0;
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    if (fileSize <= 0 && writable) {
+        initHeader(header);
+        if (!writeHeader(file, header)) {
+            fclose(file);
+            return false;
+        }
+    } else {
+        rewind(file);
+        if (fread(&header, sizeof(header), 1, file) != 1 ||
+            memcmp(header.magic, SOLVE_DB_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != SOLVE_DB_VERSION || header.recordBytes != sizeof(SolveRecord) ||
+            header.averageCount != (unsigned int)SOLVE_AVERAGE_COUNT) {
+            fclose(file);
+            return false;
+        }
+        // Bản ghi cuối bị ghi dở (nếu có) bị bỏ qua và sẽ bị ghi đè
+        recordCount = ((long long)fileSize - (long long)sizeof(header)) / (long long)sizeof(SolveRecord);
+    }
+
+    // Header đi trước bản ghi chỉ khi file bị cắt từ bên ngoài: gộp lại từ đầu
+    if (header.solveCount < 0 || header.solveCount > recordCount) {
+        resetHeaderStats(header);
+    }
+    long long gathered = header.solveCount;
+    long long first = std::max<long long>(0, gathered - SOLVE_MAX_AVERAGE_SIZE);
+    resetWindows();
+    if (!readSolveRecords(file, first, recordCount, gathered, header)) {
+        fclose(file);
+        return false;
+    }
+    caughtUp = recordCount - gathered;
+    if (caughtUp > 0 && writable && !writeHeader(file, header)) {
+        fclose(file);
+        return false;
+    }
+
+    s_file = file;
+    s_path = path;
+    s_header = header;
+    s_writeFailed = false;
+    return true;
+}
+
+bool openSolveDatabase(const char* path) {
+    closeSolveDatabase();
+    ClockNanos started = clockRealNanos();
+    long long caughtUp = 0;
+    if (!loadSolveDatabase(path, true, caughtUp)) {
+        RUBIK_LOG(EVT_SOLVE_DB_FAILED) << path;
+        return false;
+    }
+    double elapsedMs = clockNanosToSeconds(clockRealNanos() - started) * 1000.0;
+    RUBIK_LOG(EVT_SOLVE_DB_OPENED) << (int)s_header.solveCount << (int)caughtUp << elapsedMs << path;
+    return true;
+}
+
+void closeSolveDatabase() {
+    if (s_file == NULL) {
+        return;
+    }
+    fclose(s_file);
+    s_file = NULL;
+}
+
+bool isSolveDatabaseOpen() {
+    return s_file != NULL;
+}
+
+void initSolveDatabase() {
+    const char* path = getenv("RUBIK_SOLVES");
+    if (path != NULL && (strcmp(path, "off") == 0 || strcmp(path, "0") == 0)) {
+        return;
+    }
+    if (path == NULL || path[0] == '\0') {
+        path = "rubik_solves.db";
+    }
+    if (openSolveDatabase(path)) {
+        atexit(closeSolveDatabase);
+    }
+}
+
+void addSolveRecord(double seconds, int moveCount) {
+    if (s_file == NULL) {
+        return;
+    }
+    SolveRecord record;
+    memset(&record, 0, sizeof(record));
+    record.finishedUnixTime = (long long)time(NULL);
+    record.timeMillis = (unsigned int)(seconds * 1000.0 + 0.5);
+    record.moveCount = (unsigned short)std::min(std::max(moveCount, 0), 0xFFFF);
+
+    // Bản ghi trước, header sau: bị ngắt giữa hai lần ghi thì lần mở sau gộp bù
+    bool ok = fseek(s_file, (long)solveRecordOffset(s_header.solveCount), SEEK_SET) == 0 &&
+              fwrite(&record, sizeof(record), 1, s_file) == 1;
+    applySolve(s_header, record);
+    ok = ok && writeHeader(s_file, s_header);
+    if (!ok && !s_writeFailed) {
+        s_writeFailed = true;
+        RUBIK_LOG(EVT_SOLVE_DB_FAILED) << s_path.c_str();
+    }
+
+    SolveStats stats;
+    fillSolveStats(s_header, stats);
+    RUBIK_LOG(EVT_SOLVE_STATS) << (int)stats.solveCount << stats.lastSeconds << stats.bestSeconds
+                               << stats.meanSeconds << stats.currentAverage[0]
+                               << stats.currentAverage[1] << stats.currentAverage[2];
+}
+
+void getSolveStats(SolveStats& stats) {
+    if (s_file == NULL) {
+        stats.solveCount = 0;
+        stats.lastSeconds = -1.0;
+        stats.bestSeconds = -1.0;
+        stats.meanSeconds = -1.0;
+        for (int i = 0; i < SOLVE_AVERAGE_COUNT; i++) {
+            stats.currentAverage[i] = -1.0;
+            stats.bestAverage[i] = -1.0;
+        }
+        return;
+    }
+    fillSolveStats(s_header, stats);
+}
+
+// ==================== Chế độ dòng lệnh ====================
+
+bool isSolveStatsRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--solve-stats") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printSolveStatsUsage() {
+    fprintf(stderr,
+            "Cách dùng: rubik --solve-stats rubik_solves.db [--verify]\n"
+            "  In thống kê lịch sử giải. --verify tính lại mọi trung bình từ đầu\n"
+            "  (sắp xếp từng cửa sổ) và so với thống kê cập nhật dần.\n");
+}
+
+static void formatStatSeconds(double seconds, char* buffer, size_t bufferSize) {
+    if (seconds < 0.0) {
+        snprintf(buffer, bufferSize, "-");
+    } else {
+        snprintf(buffer, bufferSize, "%.3f", seconds);
+    }
+}
+
+// Trung bình cắt bỏ của times[end - size, end) tính thẳng bằng sắp xếp, mili giây
+static double naiveAverageMillis(const std::vector<unsigned int>& times, size_t end, int size,
+                                 std::vector<unsigned int>& scratch) {
+    TrimmedWindow shape;
+    resetWindow(shape, size);
+    scratch.assign(times.begin() + (end - size), times.begin() + end);
+    std::sort(scratch.begin(), scratch.end());
+    long long sum = 0;
+    for (int i = shape.trim; i < size - shape.trim; i++) {
+        sum += scratch[i];
+    }
+    return (double)sum / (double)(size - 2 * shape.trim);
+}
+
+// So thống kê cập nhật dần với kết quả tính lại toàn bộ; trả về số chỉ số lệch
+static int verifySolveStats(const SolveStats& stats) {
+    long long recordCount = s_header.solveCount;
+    std::vector<unsigned int> times;
+    times.reserve((size_t)recordCount);
+    std::vector<SolveRecord> buffer(SOLVE_READ_CHUNK);
+    fseek(s_file, (long)solveRecordOffset(0), SEEK_SET);
+    while ((long long)times.size() < recordCount) {
+        size_t wanted = (size_t)std::min<long long>(SOLVE_READ_CHUNK, recordCount - (long long)times.size());
+        if (fread(&buffer[0], sizeof(SolveRecord), wanted, s_file) != wanted) {
+            printf("  VERIFY: đọc bản ghi thất bại\n");
+            return 1;
+        }
+        for (size_t i = 0; i < wanted; i++) {
+            times.push_back(buffer[i].timeMillis);
+        }
+    }
+
+    ClockNanos started = clockRealNanos();
+    int mismatches = 0;
+    long long total = 0;
+    unsigned int best = 0;
+    for (size_t i = 0; i < times.size(); i++) {
+        total += times[i];
+        if (best == 0 || times[i] < best) {
+            best = times[i];
+        }
+    }
+    double mean = times.empty() ? -1.0 : (double)total / (double)times.size() / 1000.0;
+    if (std::fabs(mean - stats.meanSeconds) > 1e-9 || (times.empty() ? -1.0 : best / 1000.0) != stats.bestSeconds) {
+        printf("  VERIFY: best/mean lệch\n");
+        mismatches++;
+    }
+    std::vector<unsigned int> scratch;
+    for (int a = 0; a < SOLVE_AVERAGE_COUNT; a++) {
+        int size = SOLVE_AVERAGE_SIZES[a];
+        double current = -1.0;
+        double bestAverage = -1.0;
+        for (size_t end = size; end <= times.size(); end++) {
+            double average = naiveAverageMillis(times, end, size, scratch);
+            if (bestAverage < 0.0 || average < bestAverage) {
+                bestAverage = average;
+            }
+            current = average;
+        }
+        current = current < 0.0 ? -1.0 : current / 1000.0;
+        bestAverage = bestAverage < 0.0 ? -1.0 : bestAverage / 1000.0;
+        if (std::fabs(current - stats.currentAverage[a]) > 1e-9 || std::fabs(bestAverage - stats.bestAverage[a]) > 1e-9) {
+            printf("  VERIFY: ao%d lệch: hiện tại %.6f / %.6f, tốt nhất %.6f / %.6f\n", size,
+                   stats.currentAverage[a], current, stats.bestAverage[a], bestAverage);
+            mismatches++;
+        }
+    }
+    printf("  VERIFY: tính lại từ đầu trong %.1f ms, %d chỉ số lệch\n",
+           clockNanosToSeconds(clockRealNanos() - started) * 1000.0, mismatches);
+    return mismatches;
+}
+
+int runSolveStatsCommand(int argc, char** argv) {
+    const char* path = NULL;
+    bool verify = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--solve-stats") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        } else {
+            fprintf(stderr, "Tham số không hợp lệ: %s\n", argv[i]);
+            printSolveStatsUsage();
+            return 1;
+        }
+    }
+    if (path == NULL) {
+        printSolveStatsUsage();
+        return 1;
+    }
+
+    // Chỉ đọc: các bản ghi nằm sau header được gộp trong bộ nhớ, file giữ nguyên
+    ClockNanos started = clockRealNanos();
+    long long caughtUp = 0;
+    if (!loadSolveDatabase(path, false, caughtUp)) {
+        fprintf(stderr, "Không đọc được file lịch sử giải: %s\n", path);
+        return 1;
+    }
+    double loadMs = clockNanosToSeconds(clockRealNanos() - started) * 1000.0;
+
+    SolveStats stats;
+    fillSolveStats(s_header, stats);
+    char last[32];
+    char best[32];
+    char mean[32];
+    formatStatSeconds(stats.lastSeconds, last, sizeof(last));
+    formatStatSeconds(stats.bestSeconds, best, sizeof(best));
+    formatStatSeconds(stats.meanSeconds, mean, sizeof(mean));
+    printf("SOLVES: %s\n", path);
+    printf("  %lld lần giải (%lld bản ghi gộp khi mở), nạp trong %.3f ms\n",
+           stats.solveCount, caughtUp, loadMs);
+    printf("  last %s | best %s | mean %s\n", last, best, mean);
+    for (int i = 0; i < SOLVE_AVERAGE_COUNT; i++) {
+        char current[32];
+        char bestAverage[32];
+        formatStatSeconds(stats.currentAverage[i], current, sizeof(current));
+        formatStatSeconds(stats.bestAverage[i], bestAverage, sizeof(bestAverage));
+        printf("  ao%-5d hiện tại %-10s tốt nhất %s\n", SOLVE_AVERAGE_SIZES[i], current, bestAverage);
+    }
+
+    int mismatches = verify ? verifySolveStats(stats) : 0;
+    closeSolveDatabase();
+    return mismatches > 0 ? 2 : 0;
+}
@@ -2,6 +2,9 @@
 #include "rubik_constants.h"
 #include "rubik_animation.h"
 #include "rubik_timer.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
+#include "rubik_record.h"
 #include <cstdio>
 #include <ctime>
 #include <cstring>
@@ -9,45 +12,8 @@
 #include <cstdlib>
 
 RubikCube g_rubikCube;
-FILE* g_logFile = NULL;
-clock_t g_logStartClock = 0;
-
-void initLogFile() {
-    g_logFile = fopen("rubik_debug.log", "w");
-    if (g_logFile == NULL) {
-        return;
-    }
-    g_logStartClock = clock();
-    
-    time_t rawTime;
-    struct tm* timeInfo;
-    char timeStr[80];
-    
-    time(&rawTime);
-    timeInfo = localtime(&rawTime);
-    strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", timeInfo);
-    
-    fprintf(g_logFile, "=== Nhật ký Debug Rubik's Cube ===\n");
-    fprintf(g_logFile, "Bắt đầu: %s\n", timeStr);
-    fprintf(g_logFile, "==============================\n\n");
-    fflush(g_logFile);
-}
-
-double getLogTimestampMs() {
-    if (g_logStartClock == 0) {
-        return 0.0;
-    }
-    clock_t current = clock();
-    return (double)(current - g_logStartClock) * 1000.0 / CLOCKS_PER_SEC;
-}
-
-void closeLogFile() {
-    if (g_logFile != NULL) {
-        fprintf(g_logFile, "\n=== Kết thúc nhật ký ===\n");
-        fclose(g_logFile);
-        g_logFile = NULL;
-    }
-}
+RubikCube g_visualCube;
+int g_visualCubeVersion = 0;
 
 /**
  * Chuyển đổi từ toạ độ 3D (i, j, k) sang chỉ số mảng 1D (0-26).
@@ -234,40 +200,53 @@ void initRubikCube() {
         }
     }
     
-    if (g_logFile != NULL) {
-        fprintf(g_logFile, "Giai đoạn 2: Đã khởi tạo %d mảnh Rubik\n", 27);
-        fflush(g_logFile);
-    }
+    syncVisualCube();
+    
+    RUBIK_LOG(EVT_CUBE_INIT) << 27;
+}
+
+// Đồng bộ trạng thái hiển thị với trạng thái logic
+// Chỉ dùng khi không còn animation nào đang chờ (khởi tạo, reset)
+void syncVisualCube() {
+    g_visualCube = g_rubikCube;
+    markVisualCubeChanged();
+}
+
+// Báo cho renderer biết trạng thái hiển thị đã đổi (cache hình học tĩnh cần dựng lại)
+void markVisualCubeChanged() {
+    g_visualCubeVersion++;
 }
 
 void resetCube() {
+    recordReset();
     cancelAnimationAndQueue();
     initRubikCube();
     extern int g_scrambleMovesPending;
     g_scrambleMovesPending = 0;
     resetTimerState();
-    if (g_logFile != NULL) {
-        fprintf(g_logFile, "RESET: Cube về trạng thái đã giải\n");
-        fflush(g_logFile);
-    }
+    RUBIK_LOG(EVT_CUBE_RESET);
+}
+
+// Chuẩn bị nhận numMoves nước trộn (startRotation với isScrambleMove = true);
+// timer được hẹn giờ khi nước trộn cuối cùng chạy xong animation
+void beginScramble(int numMoves) {
+    recordScrambleBegin(numMoves);
+    resetTimerState();
+    extern int g_scrambleMovesPending;
+    g_scrambleMovesPending = numMoves;
 }
 
 void shuffleCube(int numMoves) {
     if (numMoves <= 0) {
         return;
     }
-    resetTimerState();
-    extern int g_scrambleMovesPending;
-    g_scrambleMovesPending = numMoves;
+    beginScramble(numMoves);
     for (int i = 0; i < numMoves; i++) {
         Face face = static_cast<Face>(rand() % 6);
         bool clockwise = (rand() % 2) == 0;
         startRotation(face, clockwise, true);
     }
-    if (g_logFile != NULL) {
-        fprintf(g_logFile, "TRỘN: %d bước ngẫu nhiên đã xếp hàng\n", numMoves);
-        fflush(g_logFile);
-    }
+    RUBIK_LOG(EVT_SCRAMBLE_QUEUED) << numMoves;
 }
 
 /**
@@ -277,6 +256,7 @@ void shuffleCube(int numMoves) {
  * @return true nếu đã giải, false nếu chưa.
  */
 bool isCubeSolved() {
+    PROFILE_ZONE("isCubeSolved");
     const float tolerance = 0.05f;  // Dung sai so sánh màu (do sai số số thực float)
     int indices[9];
     
@@ -308,11 +288,11 @@ bool isCubeSolved() {
 }
 
 void testRotationIdentity() {
-    if (g_logFile == NULL) {
+    if (!LOG_EVENT_ENABLED(EVT_IDENTITY_TEST_BEGIN)) {
         return;
     }
     
-    fprintf(g_logFile, "\n=== KIỂM TRA TÍNH ĐỒNG NHẤT XOAỸ ===\n");
+    RUBIK_LOG(EVT_IDENTITY_TEST_BEGIN);
     
     float originalColors[27][6][3];
     for (int p = 0; p < 27; p++) {
@@ -324,7 +304,6 @@ void testRotationIdentity() {
     }
     
     const Face facesToTest[] = {FRONT, BACK, LEFT, RIGHT, UP, DOWN};
-    const char* faceNames[] = {"FRONT", "BACK", "LEFT", "RIGHT", "UP", "DOWN"};
     const int entriesPerCube = 27 * 6 * 3;
     
     for (int faceIdx = 0; faceIdx < 6; faceIdx++) {
@@ -337,7 +316,7 @@ void testRotationIdentity() {
             }
         }
         
-        fprintf(g_logFile, "Kiểm tra %s: thực hiện 4 lượt xoay CW...\n", faceNames[faceIdx]);
+        RUBIK_LOG(EVT_IDENTITY_TEST_FACE) << face;
         extern void rotateFace(int face, bool clockwise);
         for (int turn = 0; turn < 4; turn++) {
             rotateFace(face, true);
@@ -356,9 +335,9 @@ void testRotationIdentity() {
         }
         
         if (matches == entriesPerCube) {
-            fprintf(g_logFile, "  -> %s THÀNH CÔNG (%d/%d khớp)\n", faceNames[faceIdx], matches, entriesPerCube);
+            RUBIK_LOG(EVT_IDENTITY_TEST_PASS) << face << matches << entriesPerCube;
         } else {
-            fprintf(g_logFile, "  -> %s THẤT BẠI (%d/%d khớp)\n", faceNames[faceIdx], matches, entriesPerCube);
+            RUBIK_LOG(EVT_IDENTITY_TEST_FAIL) << face << matches << entriesPerCube;
         }
     }
     
@@ -370,6 +349,5 @@ void testRotationIdentity() {
         }
     }
     
-    fprintf(g_logFile, "=== KẾT THÚC KIỂM TRA TÍNH ĐỒNG NHẤT XOAỸ ===\n\n");
-    fflush(g_logFile);
+    RUBIK_LOG(EVT_IDENTITY_TEST_END);
 }
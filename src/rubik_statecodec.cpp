@@ -0,0 +1,632 @@
+#include "rubik_statecodec.h"
+#include "rubik_state.h"
+#include "rubik_animation.h"
+#include "rubik_timer.h"
+#include "rubik_constants.h"
+#include "rubik_thread.h"
+#include "rubik_clock.h"
+#include "rubik_log.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// Chữ cái facelet theo thứ tự mặt của chuỗi (chỉ số 6 = ký tự không hợp lệ)
+static const char FACELET_LETTERS[8] = "URFDLB?";
+static const int INVALID_LETTER = 6;
+static const int FACELET_FACES[6] = {UP, RIGHT, FRONT, DOWN, LEFT, BACK};
+
+// Màu chuẩn của từng chữ cái (cùng bảng màu với initRubikCube)
+static const float* const LETTER_COLORS[7] = {
+    COLOR_WHITE, COLOR_BLUE, COLOR_RED, COLOR_YELLOW, COLOR_GREEN, COLOR_ORANGE, COLOR_BLACK
+};
+
+enum FaceletLetter { LETTER_U = 0, LETTER_R, LETTER_F, LETTER_D, LETTER_L, LETTER_B };
+
+// Sticker (chỉ số facelet) của từng vị trí góc/cạnh, bắt đầu từ sticker U/D (hoặc F/B
+// với cạnh lớp giữa); hướng 0 khi sticker đầu của mảnh nằm ở sticker đầu của vị trí
+static const unsigned char CORNER_FACELETS[8][3] = {
+    {8, 9, 20}, {6, 18, 38}, {0, 36, 47}, {2, 45, 11},
+    {29, 26, 15}, {27, 44, 24}, {33, 53, 42}, {35, 17, 51}
+};
+static const unsigned char EDGE_FACELETS[12][2] = {
+    {5, 10}, {7, 19}, {3, 37}, {1, 46}, {32, 16}, {28, 25},
+    {30, 43}, {34, 52}, {23, 12}, {21, 41}, {50, 39}, {48, 14}
+};
+static const unsigned char CORNER_LETTERS[8][3] = {
+    {LETTER_U, LETTER_R, LETTER_F}, {LETTER_U, LETTER_F, LETTER_L},
+    {LETTER_U, LETTER_L, LETTER_B}, {LETTER_U, LETTER_B, LETTER_R},
+    {LETTER_D, LETTER_F, LETTER_R}, {LETTER_D, LETTER_L, LETTER_F},
+    {LETTER_D, LETTER_B, LETTER_L}, {LETTER_D, LETTER_R, LETTER_B}
+};
+static const unsigned char EDGE_LETTERS[12][2] = {
+    {LETTER_U, LETTER_R}, {LETTER_U, LETTER_F}, {LETTER_U, LETTER_L}, {LETTER_U, LETTER_B},
+    {LETTER_D, LETTER_R}, {LETTER_D, LETTER_F}, {LETTER_D, LETTER_L}, {LETTER_D, LETTER_B},
+    {LETTER_F, LETTER_R}, {LETTER_F, LETTER_L}, {LETTER_B, LETTER_L}, {LETTER_B, LETTER_R}
+};
+
+// Mục bảng tra mảnh: mảnh | hướng << 4, PIECE_INVALID nếu tổ hợp màu không tồn tại
+static const unsigned char PIECE_INVALID = 0x80;
+
+static unsigned char s_letterIndex[256];
+static unsigned char s_colorKeyLetter[16];
+static unsigned char s_cornerKey[7 * 7 * 7];   // Khóa = 3 chữ cái theo cơ số 7
+static unsigned char s_edgeKey[7 * 7];
+static unsigned char s_faceletPiece[54];
+static unsigned char s_faceletFace[54];
+
+// Vị trí mảnh (i, j, k) của ô (row, col) trên mặt thứ n, nhìn từ bên ngoài như trên net
+static void faceletCellToPosition(int n, int row, int col, int& i, int& j, int& k) {
+    switch (FACELET_FACES[n]) {
+        case UP:    i = col - 1; j = 1;       k = row - 1; break;
+        case DOWN:  i = col - 1; j = -1;      k = 1 - row; break;
+        case FRONT: i = col - 1; j = 1 - row; k = 1;       break;
+        case BACK:  i = 1 - col; j = 1 - row; k = -1;      break;
+        case LEFT:  i = -1;      j = 1 - row; k = col - 1; break;
+        default:    i = 1;       j = 1 - row; k = 1 - col; break;  // RIGHT
+    }
+}
+
+// Khóa màu không cần so khoảng cách: đỏ mạnh, xanh lá mạnh, xanh dương, xanh lá vừa (cam)
+static int colorKey(const float* color) {
+    return (int)(color[0] > 0.75f) | ((int)(color[1] > 0.75f) << 1) | ((int)(color[2] > 0.5f) << 2) |
+           ((int)(color[1] > 0.25f && color[1] <= 0.75f) << 3);
+}
+
+// Dựng bảng khi nạp chương trình (trước main), nên đọc song song từ nhiều luồng an toàn
+static bool buildStateCodecTables() {
+    memset(s_letterIndex, INVALID_LETTER, sizeof(s_letterIndex));
+    memset(s_colorKeyLetter, INVALID_LETTER, sizeof(s_colorKeyLetter));
+    for (int letter = 0; letter < 6; letter++) {
+        s_letterIndex[(unsigned char)FACELET_LETTERS[letter]] = (unsigned char)letter;
+        s_colorKeyLetter[colorKey(LETTER_COLORS[letter])] = (unsigned char)letter;
+    }
+
+    memset(s_cornerKey, PIECE_INVALID, sizeof(s_cornerKey));
+    for (int piece = 0; piece < 8; piece++) {
+        for (int twist = 0; twist < 3; twist++) {
+            const unsigned char* letters = CORNER_LETTERS[piece];
+            int key = letters[(3 - twist) % 3] * 49 + letters[(4 - twist) % 3] * 7 + letters[(5 - twist) % 3];
+            s_cornerKey[key] = (unsigned char)(piece | twist << 4);
+        }
+    }
+    memset(s_edgeKey, PIECE_INVALID, sizeof(s_edgeKey));
+    for (int piece = 0; piece < 12; piece++) {
+        for (int flip = 0; flip < 2; flip++) {
+            const unsigned char* letters = EDGE_LETTERS[piece];
+            s_edgeKey[letters[flip] * 7 + letters[flip ^ 1]] = (unsigned char)(piece | flip << 4);
+        }
+    }
+
+    for (int n = 0; n < 6; n++) {
+        for (int cell = 0; cell < 9; cell++) {
+            int i, j, k;
+            faceletCellToPosition(n, cell / 3, cell % 3, i, j, k);
+            s_faceletPiece[n * 9 + cell] = (unsigned char)positionToIndex(i, j, k);
+            s_faceletFace[n * 9 + cell] = (unsigned char)FACELET_FACES[n];
+        }
+    }
+    return true;
+}
+
+static const bool s_stateCodecTablesReady = buildStateCodecTables();
+
+void getFaceletLocation(int facelet, int& pieceIndex, int& face) {
+    pieceIndex = s_faceletPiece[facelet];
+    face = s_faceletFace[facelet];
+}
+
+int getPieceFacelets(int piece, int facelets[3]) {
+    if (piece < 8) {
+        facelets[0] = CORNER_FACELETS[piece][0];
+        facelets[1] = CORNER_FACELETS[piece][1];
+        facelets[2] = CORNER_FACELETS[piece][2];
+        return 3;
+    }
+    facelets[0] = EDGE_FACELETS[piece - 8][0];
+    facelets[1] = EDGE_FACELETS[piece - 8][1];
+    return 2;
+}
+
+void captureCubeFacelets(const RubikCube& cube, char facelets[54]) {
+    for (int s = 0; s < 54; s++) {
+        const float* color = cube.pieces[s_faceletPiece[s]].colors[s_faceletFace[s]];
+        facelets[s] = FACELET_LETTERS[s_colorKeyLetter[colorKey(color)]];
+    }
+}
+
+// Mặt trong của mọi mảnh luôn đen ở mọi trạng thái hợp lệ, chỉ cần ghi đè 54 sticker
+void applyCubeFacelets(RubikCube& cube, const char facelets[54]) {
+    for (int s = 0; s < 54; s++) {
+        const float* color = LETTER_COLORS[s_letterIndex[(unsigned char)facelets[s]]];
+        float* sticker = cube.pieces[s_faceletPiece[s]].colors[s_faceletFace[s]];
+        sticker[0] = color[0];
+        sticker[1] = color[1];
+        sticker[2] = color[2];
+    }
+}
+
+// ==================== Kiểm tra ====================
+
+// Tính chẵn lẻ của hoán vị qua số nghịch thế (không rẽ nhánh trong vòng lặp)
+static unsigned int permutationParity(const unsigned char* perm, int count) {
+    unsigned int inversions = 0;
+    for (int i = 0; i < count; i++) {
+        for (int j = i + 1; j < count; j++) {
+            inversions += (unsigned int)(perm[j] < perm[i]);
+        }
+    }
+    return inversions & 1;
+}
+
+// Các cờ lỗi được tính hết rồi mới chọn lỗi đầu tiên theo thứ tự nghiêm trọng
+static CubeStateError pickStateError(unsigned int badLetter, unsigned int badCenter, unsigned int badPiece,
+                                     unsigned int twistSum, unsigned int flipSum, unsigned int parityMismatch) {
+    if (badLetter) {
+        return CUBE_STATE_BAD_LETTER;
+    }
+    if (badCenter) {
+        return CUBE_STATE_BAD_CENTER;
+    }
+    if (badPiece) {
+        return CUBE_STATE_BAD_PIECE;
+    }
+    if (twistSum % 3 != 0) {
+        return CUBE_STATE_TWIST;
+    }
+    if (flipSum & 1) {
+        return CUBE_STATE_FLIP;
+    }
+    return parityMismatch ? CUBE_STATE_PARITY : CUBE_STATE_OK;
+}
+
+CubeStateError faceletsToCubies(const char* facelets, CubieState& state) {
+    unsigned char letters[54];
+    unsigned int badLetter = 0;
+    for (int s = 0; s < 54; s++) {
+        letters[s] = s_letterIndex[(unsigned char)facelets[s]];
+        badLetter |= (unsigned int)(letters[s] == INVALID_LETTER);
+    }
+    unsigned int badCenter = 0;
+    for (int n = 0; n < 6; n++) {
+        badCenter |= (unsigned int)(letters[n * 9 + 4] != n);
+    }
+
+    // Chữ cái không hợp lệ (6) vẫn nằm trong bảng khóa cơ số 7 và tra ra PIECE_INVALID
+    unsigned int badPiece = 0;
+    unsigned int seen = 0;
+    unsigned int twistSum = 0;
+    for (int i = 0; i < 8; i++) {
+        const unsigned char* at = CORNER_FACELETS[i];
+        unsigned char entry = s_cornerKey[letters[at[0]] * 49 + letters[at[1]] * 7 + letters[at[2]]];
+        badPiece |= entry >> 7;
+        state.cornerPerm[i] = (unsigned char)(entry & 7);
+        state.cornerTwist[i] = (unsigned char)((entry >> 4) & 3);
+        seen |= 1u << (entry & 7);
+        twistSum += state.cornerTwist[i];
+    }
+    badPiece |= (unsigned int)(seen != 0xFFu);
+
+    seen = 0;
+    unsigned int flipSum = 0;
+    for (int i = 0; i < 12; i++) {
+        const unsigned char* at = EDGE_FACELETS[i];
+        unsigned char entry = s_edgeKey[letters[at[0]] * 7 + letters[at[1]]];
+        badPiece |= entry >> 7;
+        state.edgePerm[i] = (unsigned char)(entry & 15);
+        state.edgeFlip[i] = (unsigned char)((entry >> 4) & 1);
+        seen |= 1u << (entry & 15);
+        flipSum += state.edgeFlip[i];
+    }
+    badPiece |= (unsigned int)(seen != 0xFFFu);
+
+    unsigned int parityMismatch = permutationParity(state.cornerPerm, 8) ^ permutationParity(state.edgePerm, 12);
+    return pickStateError(badLetter, badCenter, badPiece, twistSum, flipSum, parityMismatch);
+}
+
+CubeStateError validateCubieState(const CubieState& state) {
+    unsigned int badPiece = 0;
+    unsigned int seen = 0;
+    unsigned int twistSum = 0;
+    for (int i = 0; i < 8; i++) {
+        badPiece |= (unsigned int)(state.cornerPerm[i] >= 8) | (unsigned int)(state.cornerTwist[i] >= 3);
+        seen |= 1u << (state.cornerPerm[i] & 7);
+        twistSum += state.cornerTwist[i];
+    }
+    badPiece |= (unsigned int)(seen != 0xFFu);
+    seen = 0;
+    unsigned int flipSum = 0;
+    for (int i = 0; i < 12; i++) {
+        badPiece |= (unsigned int)(state.edgePerm[i] >= 12) | (unsigned int)(state.edgeFlip[i] >= 2);
+        seen |= 1u << (state.edgePerm[i] & 15);
+        flipSum += state.edgeFlip[i];
+    }
+    badPiece |= (unsigned int)(seen != 0xFFFu);
+    unsigned int parityMismatch = permutationParity(state.cornerPerm, 8) ^ permutationParity(state.edgePerm, 12);
+    return pickStateError(0, 0, badPiece, twistSum, flipSum, parityMismatch);
+}
+
+void cubiesToFacelets(const CubieState& state, char facelets[54]) {
+    for (int n = 0; n < 6; n++) {
+        facelets[n * 9 + 4] = FACELET_LETTERS[n];
+    }
+    for (int i = 0; i < 8; i++) {
+        const unsigned char* letters = CORNER_LETTERS[state.cornerPerm[i]];
+        int twist = state.cornerTwist[i];
+        for (int m = 0; m < 3; m++) {
+            facelets[CORNER_FACELETS[i][(m + twist) % 3]] = FACELET_LETTERS[letters[m]];
+        }
+    }
+    for (int i = 0; i < 12; i++) {
+        const unsigned char* letters = EDGE_LETTERS[state.edgePerm[i]];
+        int flip = state.edgeFlip[i];
+        facelets[EDGE_FACELETS[i][flip]] = FACELET_LETTERS[letters[0]];
+        facelets[EDGE_FACELETS[i][flip ^ 1]] = FACELET_LETTERS[letters[1]];
+    }
+}
+
+// ==================== Nhị phân 16 byte ====================
+
+// Hạng Lehmer: chữ số thứ i (cơ số count - i) là số phần tử phía sau nhỏ hơn perm[i]
+static unsigned int rankPermutation(const unsigned char* perm, int count) {
+    unsigned int rank = 0;
+    for (int i = 0; i < count; i++) {
+        unsigned int smaller = 0;
+        for (int j = i + 1; j < count; j++) {
+            smaller += (unsigned int)(perm[j] < perm[i]);
+        }
+        rank = rank * (unsigned int)(count - i) + smaller;
+    }
+    return rank;
+}
+
+// Ngược lại của rankPermutation, false nếu rank >= count!
+// Dựng từ cuối lên: phần đuôi đã dựng là hoán vị tương đối, chèn phần tử mới có hạng
+// digit thì mọi phần tử >= digit tăng 1 (cộng so sánh thay vì dò tìm có rẽ nhánh)
+static bool unrankPermutation(unsigned int rank, int count, unsigned char* perm) {
+    for (int i = count - 1; i >= 0; i--) {
+        unsigned int radix = (unsigned int)(count - i);
+        unsigned char digit = (unsigned char)(rank % radix);
+        rank /= radix;
+        perm[i] = digit;
+        for (int j = i + 1; j < count; j++) {
+            perm[j] = (unsigned char)(perm[j] + (perm[j] >= digit));
+        }
+    }
+    return rank == 0;
+}
+
+void packCubieState(const CubieState& state, PackedCubeState& packed) {
+    unsigned int cornerRank = rankPermutation(state.cornerPerm, 8);
+    unsigned int edgeRank = rankPermutation(state.edgePerm, 12);
+    unsigned int twist = 0;
+    for (int i = 0; i < 7; i++) {
+        twist = twist * 3 + state.cornerTwist[i];
+    }
+    unsigned int flip = 0;
+    for (int i = 0; i < 11; i++) {
+        flip |= (unsigned int)state.edgeFlip[i] << i;
+    }
+    unsigned char* out = packed.bytes;
+    memset(out, 0, sizeof(packed.bytes));
+    out[0] = (unsigned char)cornerRank;
+    out[1] = (unsigned char)(cornerRank >> 8);
+    out[2] = (unsigned char)twist;
+    out[3] = (unsigned char)(twist >> 8);
+    out[4] = (unsigned char)edgeRank;
+    out[5] = (unsigned char)(edgeRank >> 8);
+    out[6] = (unsigned char)(edgeRank >> 16);
+    out[7] = (unsigned char)(edgeRank >> 24);
+    out[8] = (unsigned char)flip;
+    out[9] = (unsigned char)(flip >> 8);
+    out[10] = CUBE_STATE_PACKED_VERSION;
+}
+
+CubeStateError unpackCubieState(const PackedCubeState& packed, CubieState& state) {
+    const unsigned char* in = packed.bytes;
+    unsigned int cornerRank = in[0] | (unsigned int)in[1] << 8;
+    unsigned int twist = in[2] | (unsigned int)in[3] << 8;
+    unsigned int edgeRank = in[4] | (unsigned int)in[5] << 8 | (unsigned int)in[6] << 16 | (unsigned int)in[7] << 24;
+    unsigned int flip = in[8] | (unsigned int)in[9] << 8;
+    unsigned int reserved = in[11] | in[12] | in[13] | in[14] | in[15];
+    bool inRange = unrankPermutation(cornerRank, 8, state.cornerPerm) &
+                   unrankPermutation(edgeRank, 12, state.edgePerm);
+    if (!inRange || twist >= 2187 || flip >= 2048 || in[10] != CUBE_STATE_PACKED_VERSION || reserved != 0) {
+        return CUBE_STATE_BAD_PACKED;
+    }
+
+    unsigned int twistSum = 0;
+    for (int i = 6; i >= 0; i--) {
+        state.cornerTwist[i] = (unsigned char)(twist % 3);
+        twistSum += twist % 3;
+        twist /= 3;
+    }
+    state.cornerTwist[7] = (unsigned char)((3 - twistSum % 3) % 3);
+    unsigned int flipSum = 0;
+    for (int i = 0; i < 11; i++) {
+        state.edgeFlip[i] = (unsigned char)((flip >> i) & 1);
+        flipSum += state.edgeFlip[i];
+    }
+    state.edgeFlip[11] = (unsigned char)(flipSum & 1);
+
+    // Twist/flip đúng theo cách mã hóa, chỉ còn tính chẵn lẻ cần kiểm tra
+    if (permutationParity(state.cornerPerm, 8) != permutationParity(state.edgePerm, 12)) {
+        return CUBE_STATE_PARITY;
+    }
+    return CUBE_STATE_OK;
+}
+
+void packedStateToHex(const PackedCubeState& packed, char hex[32]) {
+    static const char DIGITS[] = "0123456789abcdef";
+    for (int i = 0; i < 16; i++) {
+        hex[i * 2] = DIGITS[packed.bytes[i] >> 4];
+        hex[i * 2 + 1] = DIGITS[packed.bytes[i] & 15];
+    }
+}
+
+static int hexDigitValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool hexToPackedState(const char* hex, PackedCubeState& packed) {
+    for (int i = 0; i < 16; i++) {
+        int high = hexDigitValue(hex[i * 2]);
+        int low = hexDigitValue(hex[i * 2 + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        packed.bytes[i] = (unsigned char)(high << 4 | low);
+    }
+    return true;
+}
+
+const char* getCubeStateErrorMessage(CubeStateError error) {
+    switch (error) {
+        case CUBE_STATE_OK:         return "hợp lệ";
+        case CUBE_STATE_BAD_LENGTH: return "cần 54 ký tự facelet hoặc 32 chữ số hex";
+        case CUBE_STATE_BAD_LETTER: return "ký tự facelet ngoài URFDLB";
+        case CUBE_STATE_BAD_CENTER: return "tâm các mặt phải theo thứ tự URFDLB";
+        case CUBE_STATE_BAD_PIECE:  return "mảnh không tồn tại hoặc bị lặp";
+        case CUBE_STATE_TWIST:      return "tổng hướng góc không chia hết cho 3";
+        case CUBE_STATE_FLIP:       return "tổng hướng cạnh lẻ";
+        case CUBE_STATE_PARITY:     return "hoán vị góc và cạnh khác tính chẵn lẻ";
+        case CUBE_STATE_BAD_PACKED: return "mã nhị phân không hợp lệ";
+    }
+    return "lỗi không xác định";
+}
+
+// Một dòng văn bản (facelet hoặc hex) sang cubie, đã kiểm tra
+static CubeStateError textToCubies(const char* text, int length, CubieState& state) {
+    if (length == 54) {
+        return faceletsToCubies(text, state);
+    }
+    PackedCubeState packed;
+    if (length != 32) {
+        return CUBE_STATE_BAD_LENGTH;
+    }
+    if (!hexToPackedState(text, packed)) {
+        return CUBE_STATE_BAD_PACKED;
+    }
+    return unpackCubieState(packed, state);
+}
+
+// ==================== Nhập/xuất trạng thái của engine ====================
+
+CubeStateError exportCubeState(const RubikCube& cube, char facelets[55], char hex[33]) {
+    CubieState state;
+    captureCubeFacelets(cube, facelets);
+    facelets[54] = '\0';
+    CubeStateError error = faceletsToCubies(facelets, state);
+    if (error != CUBE_STATE_OK) {
+        memset(hex, '-', 32);
+    } else {
+        PackedCubeState packed;
+        packCubieState(state, packed);
+        packedStateToHex(packed, hex);
+    }
+    hex[32] = '\0';
+    return error;
+}
+
+CubeStateError importCubeState(const char* text, int length) {
+    CubieState state;
+    CubeStateError error = textToCubies(text, length, state);
+    if (error != CUBE_STATE_OK) {
+        RUBIK_LOG(EVT_STATE_IMPORT_FAILED) << getCubeStateErrorMessage(error);
+        return error;
+    }
+    char facelets[55];
+    cubiesToFacelets(state, facelets);
+    facelets[54] = '\0';
+
+    cancelAnimationAndQueue();
+    applyCubeFacelets(g_rubikCube, facelets);
+    syncVisualCube();
+    g_scrambleMovesPending = 0;
+    resetTimerState();
+    RUBIK_LOG(EVT_STATE_IMPORTED) << facelets;
+    return CUBE_STATE_OK;
+}
+
+void printCurrentCubeState() {
+    char facelets[55];
+    char hex[33];
+    CubeStateError error = exportCubeState(g_rubikCube, facelets, hex);
+    char line[128];
+    snprintf(line, sizeof(line), "%s %s", facelets, hex);
+    printf("Trạng thái: %s\n", line);
+    if (error != CUBE_STATE_OK) {
+        printf("  (%s)\n", getCubeStateErrorMessage(error));
+    }
+    fflush(stdout);
+    RUBIK_LOG(EVT_STATE_EXPORTED) << line;
+}
+
+const char* parseStateOption(int argc, char** argv) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--state") == 0) {
+            return argv[i + 1];
+        }
+    }
+    return NULL;
+}
+
+// ==================== Chế độ dòng lệnh ====================
+
+bool isStateConvertRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--state-convert") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printStateConvertUsage() {
+    fprintf(stderr,
+            "Cách dùng: rubik --state-convert input [output] [--to bin|text]\n"
+            "  --to bin (mặc định): mỗi dòng input là 54 ký tự facelet URFDLB hoặc 32 chữ số hex,\n"
+            "  output là các bản ghi 16 byte. --to text: input là bản ghi 16 byte, output là dòng\n"
+            "  facelet. Trạng thái không giải được bị báo lỗi và bỏ qua; thiếu output thì chỉ kiểm tra.\n");
+}
+
+int runStateConvertCommand(int argc, char** argv) {
+    const char* path = NULL;
+    const char* outPath = NULL;
+    bool toText = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--state-convert") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            ++i;
+            if (strcmp(argv[i], "text") == 0) {
+                toText = true;
+            } else if (strcmp(argv[i], "bin") != 0) {
+                fprintf(stderr, "Định dạng không hợp lệ: %s\n", argv[i]);
+                printStateConvertUsage();
+                return 1;
+            }
+        } else if (path != NULL && outPath == NULL && argv[i][0] != '-') {
+            outPath = argv[i];
+        } else {
+            fprintf(stderr, "Tham số không hợp lệ: %s\n", argv[i]);
+            printStateConvertUsage();
+            return 1;
+        }
+    }
+    if (path == NULL) {
+        printStateConvertUsage();
+        return 1;
+    }
+
+    MappedFile file;
+    if (!mapReadOnlyFile(path, file)) {
+        fprintf(stderr, "Không đọc được file: %s\n", path);
+        return 1;
+    }
+    if (toText && file.size % 16 != 0) {
+        fprintf(stderr, "%s: kích thước %lld byte không phải bội của 16\n", path, file.size);
+        unmapFile(file);
+        return 1;
+    }
+    FILE* out = NULL;
+    if (outPath != NULL && (out = fopen(outPath, "wb")) == NULL) {
+        fprintf(stderr, "Không ghi được file: %s\n", outPath);
+        unmapFile(file);
+        return 1;
+    }
+
+    std::string outBuffer;
+    long long states = 0;
+    long long invalid = 0;
+    ClockNanos started = clockRealNanos();
+    const char* data = (const char*)file.data;
+    const char* fileEnd = data + file.size;
+    if (toText) {
+        char line[55];
+        line[54] = '\n';
+        for (const char* record = data; record < fileEnd; record += 16) {
+            PackedCubeState packed;
+            CubieState state;
+            memcpy(packed.bytes, record, 16);
+            CubeStateError error = unpackCubieState(packed, state);
+            if (error != CUBE_STATE_OK) {
+                if (invalid < CUBE_STATE_MAX_REPORTED_ERRORS) {
+                    fprintf(stderr, "%s: bản ghi %lld: %s\n", path, states + invalid, getCubeStateErrorMessage(error));
+                }
+                invalid++;
+                continue;
+            }
+            states++;
+            if (out != NULL) {
+                cubiesToFacelets(state, line);
+                outBuffer.append(line, 55);
+            }
+            if (outBuffer.size() >= (1 << 20)) {
+                fwrite(outBuffer.data(), 1, outBuffer.size(), out);
+                outBuffer.clear();
+            }
+        }
+    } else {
+        long long lineNumber = 0;
+        for (const char* lineStart = data; lineStart < fileEnd; ) {
+            const char* newline = (const char*)memchr(lineStart, '\n', fileEnd - lineStart);
+            const char* lineEnd = newline != NULL ? newline : fileEnd;
+            lineNumber++;
+            const char* textEnd = lineEnd;
+            while (textEnd > lineStart && (textEnd[-1] == '\r' || textEnd[-1] == ' ' || textEnd[-1] == '\t')) {
+                textEnd--;
+            }
+            if (textEnd > lineStart) {
+                CubieState state;
+                CubeStateError error = textToCubies(lineStart, (int)(textEnd - lineStart), state);
+                if (error != CUBE_STATE_OK) {
+                    if (invalid < CUBE_STATE_MAX_REPORTED_ERRORS) {
+                        fprintf(stderr, "%s:%lld: %s\n", path, lineNumber, getCubeStateErrorMessage(error));
+                    }
+                    invalid++;
+                } else {
+                    states++;
+                    if (out != NULL) {
+                        PackedCubeState packed;
+                        packCubieState(state, packed);
+                        outBuffer.append((const char*)packed.bytes, 16);
+                    }
+                    if (outBuffer.size() >= (1 << 20)) {
+                        fwrite(outBuffer.data(), 1, outBuffer.size(), out);
+                        outBuffer.clear();
+                    }
+                }
+            }
+            lineStart = lineEnd + 1;
+        }
+    }
+    double seconds = clockNanosToSeconds(clockRealNanos() - started);
+
+    bool writeFailed = false;
+    if (out != NULL) {
+        fwrite(outBuffer.data(), 1, outBuffer.size(), out);
+        writeFailed = ferror(out) != 0;
+        writeFailed = fclose(out) != 0 || writeFailed;
+    }
+    double millionsPerSecond = seconds > 0.0 ? (double)(states + invalid) / seconds / 1e6 : 0.0;
+    if (invalid > CUBE_STATE_MAX_REPORTED_ERRORS) {
+        fprintf(stderr, "... và %lld trạng thái lỗi khác\n", invalid - CUBE_STATE_MAX_REPORTED_ERRORS);
+    }
+    printf("STATE: %s, %lld trạng thái hợp lệ, %lld lỗi\n", path, states, invalid);
+    printf("  %.3fs, %.1f triệu trạng thái/giây\n", seconds, millionsPerSecond);
+    if (writeFailed) {
+        fprintf(stderr, "Lỗi khi ghi file: %s\n", outPath);
+    }
+    RUBIK_LOG(EVT_STATE_CONVERT) << (int)states << (int)invalid << millionsPerSecond << path;
+    unmapFile(file);
+    return writeFailed ? 1 : (invalid > 0 ? 2 : 0);
+}
@@ -0,0 +1,273 @@
+#include "rubik_text.h"
+#include "rubik_glext.h"
+#include "rubik_state.h"
+#include "rubik_constants.h"
+#include "rubik_perf.h"
+#include "rubik_log.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Kích thước texture atlas (lũy thừa của 2 để chạy được trên OpenGL 1.1)
+static const int ATLAS_TEXTURE_WIDTH = 512;
+static const int ATLAS_TEXTURE_HEIGHT = 256;
+
+enum AtlasState {
+    ATLAS_PENDING = 0,   // Chưa dựng (cửa sổ chưa đủ lớn hoặc chưa có frame nào)
+    ATLAS_READY,
+    ATLAS_FAILED         // Không dựng được: luôn dùng glutBitmapCharacter
+};
+
+static AtlasState s_atlasState = ATLAS_PENDING;
+static GLuint s_atlasTexture = 0;
+static int s_advance[128];              // Độ rộng bước tiến của từng ký tự (pixel)
+static float s_ortho[16];               // Phép chiếu 2D theo pixel cửa sổ
+static bool s_orthoValid = false;
+static TextLabel s_labels[TEXT_MAX_LABELS];
+
+static void* const TEXT_FONT = GLUT_BITMAP_HELVETICA_18;
+
+bool isTextAtlasReady() {
+    return s_atlasState == ATLAS_READY;
+}
+
+void setTextViewport(int width, int height) {
+    if (width <= 0) {
+        width = 1;
+    }
+    if (height <= 0) {
+        height = 1;
+    }
+    // Tương đương gluOrtho2D(0, width, 0, height)
+    for (int i = 0; i < 16; i++) {
+        s_ortho[i] = 0.0f;
+    }
+    s_ortho[0] = 2.0f / (float)width;
+    s_ortho[5] = 2.0f / (float)height;
+    s_ortho[10] = -1.0f;
+    s_ortho[12] = -1.0f;
+    s_ortho[13] = -1.0f;
+    s_ortho[15] = 1.0f;
+    s_orthoValid = true;
+}
+
+// Bố cục lại các quad của một dòng chữ theo bảng advance của atlas
+static void layoutTextLabel(TextLabel& label) {
+    const float cellU = (float)TEXT_ATLAS_CELL / (float)ATLAS_TEXTURE_WIDTH;
+    const float cellV = (float)TEXT_ATLAS_CELL / (float)ATLAS_TEXTURE_HEIGHT;
+    // Căn về pixel nguyên để texel khớp 1:1 với pixel màn hình
+    float penX = floorf(label.x + 0.5f);
+    const float y0 = floorf(label.y + 0.5f) - (float)TEXT_ATLAS_BASELINE;
+    const float y1 = y0 + (float)TEXT_ATLAS_CELL;
+
+    label.glyphCount = 0;
+    for (const char* p = label.text; *p != '\0'; p++) {
+        int c = (unsigned char)*p;
+        if (c < 32 || c > 127) {
+            c = '?';
+        }
+        int cell = c - 32;
+        float u0 = (float)(cell % TEXT_ATLAS_COLUMNS) * cellU;
+        float v0 = (float)(cell / TEXT_ATLAS_COLUMNS) * cellV;
+        float x1 = penX + (float)TEXT_ATLAS_CELL;
+
+        float* v = &label.vertices[label.glyphCount * 16];
+        v[0] = penX; v[1] = y0; v[2] = u0;         v[3] = v0;
+        v[4] = x1;   v[5] = y0; v[6] = u0 + cellU; v[7] = v0;
+        v[8] = x1;   v[9] = y1; v[10] = u0 + cellU; v[11] = v0 + cellV;
+        v[12] = penX; v[13] = y1; v[14] = u0;       v[15] = v0 + cellV;
+
+        label.glyphCount++;
+        penX += (float)s_advance[c];
+    }
+    label.dirty = true;
+}
+
+void prepareTextAtlas() {
+    if (s_atlasState != ATLAS_PENDING) {
+        return;
+    }
+    const int atlasWidth = TEXT_ATLAS_COLUMNS * TEXT_ATLAS_CELL;
+    const int atlasHeight = TEXT_ATLAS_ROWS * TEXT_ATLAS_CELL;
+    if (g_windowWidth < atlasWidth || g_windowHeight < atlasHeight) {
+        return;  // Back buffer chưa đủ chỗ làm nháp, thử lại ở frame sau
+    }
+    if (!s_orthoValid) {
+        setTextViewport(g_windowWidth, g_windowHeight);
+    }
+
+    // Vẽ 96 glyph màu trắng trên nền đen vào góc dưới trái của back buffer.
+    // display() sẽ xóa buffer ngay sau đó nên frame hiện tại không bị ảnh hưởng.
+    GLfloat clearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(s_ortho);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glDisable(GL_DEPTH_TEST);
+    glColor3f(1.0f, 1.0f, 1.0f);
+    for (int c = 0; c < 128; c++) {
+        s_advance[c] = 0;
+    }
+    for (int c = 32; c < 128; c++) {
+        int cell = c - 32;
+        glRasterPos2i((cell % TEXT_ATLAS_COLUMNS) * TEXT_ATLAS_CELL,
+                      (cell / TEXT_ATLAS_COLUMNS) * TEXT_ATLAS_CELL + TEXT_ATLAS_BASELINE);
+        glutBitmapCharacter(TEXT_FONT, c);
+        s_advance[c] = glutBitmapWidth(TEXT_FONT, c);
+    }
+
+    // Đọc lại kênh đỏ làm alpha của atlas
+    std::vector<unsigned char> pixels((size_t)atlasWidth * atlasHeight);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, atlasWidth, atlasHeight, GL_RED, GL_UNSIGNED_BYTE, &pixels[0]);
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    glEnable(GL_DEPTH_TEST);
+
+    std::vector<unsigned char> empty((size_t)ATLAS_TEXTURE_WIDTH * ATLAS_TEXTURE_HEIGHT, 0);
+    glGenTextures(1, &s_atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, s_atlasTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, ATLAS_TEXTURE_WIDTH, ATLAS_TEXTURE_HEIGHT, 0,
+                 GL_ALPHA, GL_UNSIGNED_BYTE, &empty[0]);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, atlasWidth, atlasHeight,
+                    GL_ALPHA, GL_UNSIGNED_BYTE, &pixels[0]);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    s_atlasState = (glGetError() == GL_NO_ERROR) ? ATLAS_READY : ATLAS_FAILED;
+    if (s_atlasState == ATLAS_READY) {
+        for (int i = 0; i < TEXT_MAX_LABELS; i++) {
+            if (s_labels[i].visible) {
+                layoutTextLabel(s_labels[i]);
+            }
+        }
+    }
+    RUBIK_LOG(EVT_TEXT_ATLAS) << atlasWidth << atlasHeight
+                              << (s_atlasState == ATLAS_READY ? "ready" : "failed, using glutBitmapCharacter");
+}
+
+void setTextLabel(int slot, float x, float y, const float color[3], const char* text) {
+    if (slot < 0 || slot >= TEXT_MAX_LABELS) {
+        return;
+    }
+    TextLabel& label = s_labels[slot];
+    bool sameText = strncmp(label.text, text, TEXT_LABEL_MAX_CHARS) == 0;
+    if (label.visible && sameText && label.x == x && label.y == y) {
+        label.color[0] = color[0];
+        label.color[1] = color[1];
+        label.color[2] = color[2];
+        return;
+    }
+    label.visible = true;
+    if (!sameText) {
+        strncpy(label.text, text, TEXT_LABEL_MAX_CHARS);
+        label.text[TEXT_LABEL_MAX_CHARS] = '\0';
+    }
+    label.x = x;
+    label.y = y;
+    label.color[0] = color[0];
+    label.color[1] = color[1];
+    label.color[2] = color[2];
+    if (isTextAtlasReady()) {
+        layoutTextLabel(label);
+    }
+}
+
+void hideTextLabel(int slot) {
+    if (slot >= 0 && slot < TEXT_MAX_LABELS) {
+        s_labels[slot].visible = false;
+    }
+}
+
+// Đường dự phòng khi chưa có atlas: vẽ từng ký tự bằng glBitmap của GLUT
+static void drawLabelWithGlut(const TextLabel& label) {
+    glRasterPos2f(label.x, label.y);
+    for (const char* p = label.text; *p != '\0'; p++) {
+        glutBitmapCharacter(TEXT_FONT, *p);
+        perfCountDraw(0);  // Mỗi ký tự là một lệnh glBitmap riêng
+    }
+}
+
+static void drawLabelWithAtlas(TextLabel& label) {
+    if (label.glyphCount == 0) {
+        return;
+    }
+    const GLsizei stride = 4 * sizeof(float);
+    if (g_glBuffersSupported) {
+        if (label.buffer == 0) {
+            pglGenBuffers(1, &label.buffer);
+            label.dirty = true;
+        }
+        pglBindBuffer(GL_ARRAY_BUFFER, label.buffer);
+        if (label.dirty) {
+            pglBufferData(GL_ARRAY_BUFFER, sizeof(float) * 16 * label.glyphCount,
+                          label.vertices, GL_DYNAMIC_DRAW);
+        }
+        glVertexPointer(2, GL_FLOAT, stride, (const void*)0);
+        glTexCoordPointer(2, GL_FLOAT, stride, (const void*)(2 * sizeof(float)));
+    } else {
+        glVertexPointer(2, GL_FLOAT, stride, &label.vertices[0]);
+        glTexCoordPointer(2, GL_FLOAT, stride, &label.vertices[2]);
+    }
+    label.dirty = false;
+    glDrawArrays(GL_QUADS, 0, label.glyphCount * 4);
+    perfCountDraw(label.glyphCount * 4);
+}
+
+void drawTextLabels() {
+    bool anyVisible = false;
+    for (int i = 0; i < TEXT_MAX_LABELS; i++) {
+        anyVisible = anyVisible || s_labels[i].visible;
+    }
+    if (!anyVisible) {
+        return;
+    }
+    if (!s_orthoValid) {
+        setTextViewport(g_windowWidth, g_windowHeight);
+    }
+
+    // Không push/pop ma trận: display() nạp lại phép chiếu phối cảnh ở đầu mỗi frame
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(s_ortho);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glDisable(GL_DEPTH_TEST);
+
+    if (!isTextAtlasReady()) {
+        for (int i = 0; i < TEXT_MAX_LABELS; i++) {
+            if (s_labels[i].visible) {
+                glColor3fv(s_labels[i].color);
+                drawLabelWithGlut(s_labels[i]);
+            }
+        }
+    } else {
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, s_atlasTexture);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        for (int i = 0; i < TEXT_MAX_LABELS; i++) {
+            if (s_labels[i].visible) {
+                glColor3fv(s_labels[i].color);
+                drawLabelWithAtlas(s_labels[i]);
+            }
+        }
+        if (g_glBuffersSupported) {
+            pglBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDisable(GL_TEXTURE_2D);
+    }
+
+    // Trạng thái mặc định của renderer: depth test bật, ánh sáng tắt (initOpenGL)
+    glEnable(GL_DEPTH_TEST);
+}
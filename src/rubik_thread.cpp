@@ -0,0 +1,248 @@
+#include "rubik_thread.h"
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#endif
+
+#ifdef _WIN32
+static unsigned __stdcall threadEntry(void* param) {
+    RubikThread* thread = (RubikThread*)param;
+    thread->function(thread->arg);
+    return 0;
+}
+#else
+static void* threadEntry(void* param) {
+    RubikThread* thread = (RubikThread*)param;
+    thread->function(thread->arg);
+    return NULL;
+}
+#endif
+
+// Lưu ý: đối tượng thread phải còn sống cho tới khi joinThread
+bool startThread(RubikThread& thread, ThreadFunction function, void* arg) {
+    thread.function = function;
+    thread.arg = arg;
+#ifdef _WIN32
+    thread.handle = (HANDLE)_beginthreadex(NULL, 0, threadEntry, &thread, 0, NULL);
+    return thread.handle != NULL;
+#else
+    return pthread_create(&thread.handle, NULL, threadEntry, &thread) == 0;
+#endif
+}
+
+void joinThread(RubikThread& thread) {
+#ifdef _WIN32
+    WaitForSingleObject(thread.handle, INFINITE);
+    CloseHandle(thread.handle);
+    thread.handle = NULL;
+#else
+    pthread_join(thread.handle, NULL);
+#endif
+}
+
+int getHardwareThreadCount() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+void initMutex(RubikMutex& mutex) {
+#ifdef _WIN32
+    InitializeCriticalSection(&mutex.section);
+#else
+    pthread_mutex_init(&mutex.mutex, NULL);
+#endif
+}
+
+void destroyMutex(RubikMutex& mutex) {
+#ifdef _WIN32
+    DeleteCriticalSection(&mutex.section);
+#else
+    pthread_mutex_destroy(&mutex.mutex);
+#endif
+}
+
+void lockMutex(RubikMutex& mutex) {
+#ifdef _WIN32
+    EnterCriticalSection(&mutex.section);
+#else
+    pthread_mutex_lock(&mutex.mutex);
+#endif
+}
+
+void unlockMutex(RubikMutex& mutex) {
+#ifdef _WIN32
+    LeaveCriticalSection(&mutex.section);
+#else
+    pthread_mutex_unlock(&mutex.mutex);
+#endif
+}
+
+void initCondition(RubikCondition& condition) {
+#ifdef _WIN32
+    InitializeConditionVariable(&condition.condition);
+#else
+    pthread_cond_init(&condition.condition, NULL);
+#endif
+}
+
+void destroyCondition(RubikCondition& condition) {
+#ifdef _WIN32
+    (void)condition;  // CONDITION_VARIABLE không cần giải phóng
+#else
+    pthread_cond_destroy(&condition.condition);
+#endif
+}
+
+void waitCondition(RubikCondition& condition, RubikMutex& mutex) {
+#ifdef _WIN32
+    SleepConditionVariableCS(&condition.condition, &mutex.section, INFINITE);
+#else
+    pthread_cond_wait(&condition.condition, &mutex.mutex);
+#endif
+}
+
+void signalCondition(RubikCondition& condition) {
+#ifdef _WIN32
+    WakeConditionVariable(&condition.condition);
+#else
+    pthread_cond_signal(&condition.condition);
+#endif
+}
+
+void broadcastCondition(RubikCondition& condition) {
+#ifdef _WIN32
+    WakeAllConditionVariable(&condition.condition);
+#else
+    pthread_cond_broadcast(&condition.condition);
+#endif
+}
+
+void sleepMilliseconds(int milliseconds) {
+    if (milliseconds <= 0) {
+        return;
+    }
+#ifdef _WIN32
+    Sleep((DWORD)milliseconds);
+#else
+    struct timespec ts;
+    ts.tv_sec = milliseconds / 1000;
+    ts.tv_nsec = (long)(milliseconds % 1000) * 1000000L;
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {
+    }
+#endif
+}
+
+int atomicAdd(volatile int* value, int delta) {
+#ifdef _WIN32
+    return (int)InterlockedExchangeAdd((volatile LONG*)value, (LONG)delta) + delta;
+#else
+    return __sync_add_and_fetch(value, delta);
+#endif
+}
+
+bool atomicCompareExchange(volatile int* value, int expected, int desired) {
+#ifdef _WIN32
+    return InterlockedCompareExchange((volatile LONG*)value, (LONG)desired, (LONG)expected) == (LONG)expected;
+#else
+    return __sync_bool_compare_and_swap(value, expected, desired);
+#endif
+}
+
+int atomicLoad(volatile int* value) {
+#ifdef _WIN32
+    return (int)InterlockedCompareExchange((volatile LONG*)value, 0, 0);
+#else
+    int result = *value;
+    __sync_synchronize();
+    return result;
+#endif
+}
+
+void atomicStore(volatile int* value, int newValue) {
+#ifdef _WIN32
+    InterlockedExchange((volatile LONG*)value, (LONG)newValue);
+#else
+    __sync_synchronize();
+    *value = newValue;
+    __sync_synchronize();
+#endif
+}
+
+// Map cả file vào bộ nhớ chỉ để đọc; file rỗng coi như lỗi
+bool mapReadOnlyFile(const char* path, MappedFile& file) {
+    file.data = NULL;
+    file.size = 0;
+    file.fileHandle = NULL;
+    file.mappingHandle = NULL;
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* view = mapping != NULL ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (view == NULL) {
+        if (mapping != NULL) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(handle);
+        return false;
+    }
+    file.data = (const unsigned char*)view;
+    file.size = size.QuadPart;
+    file.fileHandle = handle;
+    file.mappingHandle = mapping;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    file.data = (const unsigned char*)view;
+    file.size = (long long)info.st_size;
+#endif
+    return true;
+}
+
+void unmapFile(MappedFile& file) {
+    if (file.data == NULL) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(file.data);
+    CloseHandle((HANDLE)file.mappingHandle);
+    CloseHandle((HANDLE)file.fileHandle);
+#else
+    munmap((void*)file.data, (size_t)file.size);
+#endif
+    file.data = NULL;
+    file.size = 0;
+}
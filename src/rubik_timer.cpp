@@ -2,33 +2,51 @@
 #include "rubik_state.h"
 #include "rubik_animation.h"
 #include "rubik_constants.h"
-#include <GL/glut.h>
+#include "rubik_scheduler.h"
+#include "rubik_text.h"
+#include "rubik_perf.h"
+#include "rubik_wall.h"
+#include "rubik_log.h"
+#include "rubik_clock.h"
+#include "rubik_record.h"
+#include "rubik_solvedb.h"
 #include <cstdio>
 
 #if defined(_MSC_VER) && !defined(snprintf)
 #define snprintf _snprintf
 #endif
 
-SpeedTimer g_timer = {TIMER_IDLE, 0.0f, 0.0f, 0, 0.0f, 0.0f, 0.0f};
+SpeedTimer g_timer = {TIMER_IDLE, 0, 0.0, 0, 0.0, 0.0f};
 
 void resetTimerState() {
     g_timer.state = TIMER_IDLE;
-    g_timer.startTime = 0.0f;
-    g_timer.endTime = 0.0f;
+    g_timer.startNanos = 0;
+    g_timer.endTime = 0.0;
     g_timer.moveCount = 0;
-    g_timer.currentTime = 0.0f;
+    g_timer.currentTime = 0.0;
     g_timer.tps = 0.0f;
-    g_timer.lastSampleTime = 0.0f;
 }
 
 void armTimerForSolve() {
     g_timer.state = TIMER_READY;
-    g_timer.startTime = 0.0f;
-    g_timer.endTime = 0.0f;
+    g_timer.startNanos = 0;
+    g_timer.endTime = 0.0;
     g_timer.moveCount = 0;
-    g_timer.currentTime = 0.0f;
+    g_timer.currentTime = 0.0;
     g_timer.tps = 0.0f;
-    g_timer.lastSampleTime = 0.0f;
+}
+
+// Cập nhật thời gian đã trôi và TPS theo đồng hồ chung (độ phân giải nano giây,
+// không phụ thuộc bước mô phỏng)
+static void sampleTimer() {
+    ClockNanos elapsed = clockNowNanos() - g_timer.startNanos;
+    if (elapsed < 0) {
+        elapsed = 0;
+    }
+    g_timer.currentTime = clockNanosToSeconds(elapsed);
+    if (g_timer.currentTime > 0.0) {
+        g_timer.tps = (float)((double)g_timer.moveCount / g_timer.currentTime);
+    }
 }
 
 void handleScrambleMoveCompletion(bool wasScrambleMove) {
@@ -41,21 +59,32 @@ void handleScrambleMoveCompletion(bool wasScrambleMove) {
     }
 }
 
-void onMoveStarted() {
+void onMoveAccepted(bool isScrambleMove) {
+    if (isScrambleMove) {
+        return;
+    }
     if (g_timer.state == TIMER_READY) {
         g_timer.state = TIMER_RUNNING;
-        g_timer.startTime = (float)glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
-        g_timer.lastSampleTime = g_timer.startTime;
+        g_timer.startNanos = clockNowNanos();
         g_timer.moveCount = 0;
-        g_timer.currentTime = 0.0f;
+        g_timer.currentTime = 0.0;
         g_timer.tps = 0.0f;
-        if (g_logFile != NULL) {
-            fprintf(g_logFile, "TIMER ĐÃ BẮT ĐẦU\n");
-            fflush(g_logFile);
-        }
+        RUBIK_LOG(EVT_TIMER_START);
+    }
+    if (g_timer.state != TIMER_RUNNING) {
+        return;
     }
-    if (g_timer.state == TIMER_RUNNING) {
-        g_timer.moveCount++;
+    g_timer.moveCount++;
+    
+    // Trạng thái logic đã được cập nhật nên có thể dừng timer ngay tại nước đi cuối,
+    // không phải chờ animation trong hàng đợi chạy xong
+    if (isCubeSolved()) {
+        sampleTimer();
+        g_timer.state = TIMER_STOPPED;
+        g_timer.endTime = g_timer.currentTime;
+        RUBIK_LOG(EVT_TIMER_SOLVED) << g_timer.endTime << g_timer.moveCount << g_timer.tps;
+        addSolveRecord(g_timer.endTime, g_timer.moveCount);
+        requestRedisplay();
     }
 }
 
@@ -63,110 +92,225 @@ void updateTimer() {
     if (g_timer.state != TIMER_RUNNING) {
         return;
     }
-    float now = (float)glutGet(GLUT_ELAPSED_TIME) / 1000.0f;
-    g_timer.currentTime = now - g_timer.startTime;
-    g_timer.lastSampleTime = now;
-    if (g_timer.currentTime < 0.0f) {
-        g_timer.currentTime = 0.0f;
-    }
-    if (g_timer.currentTime > 0.0f) {
-        g_timer.tps = (float)g_timer.moveCount / g_timer.currentTime;
+    sampleTimer();
+    requestRedisplay();
+}
+
+// Định dạng thời gian mm:ss.cc (centisecond, giống đồng hồ thi đấu WCA)
+void formatTimerText(double seconds, char* buffer, int bufferSize) {
+    if (seconds < 0.0) {
+        seconds = 0.0;
     }
-    if (!g_animation.isActive && isCubeSolved()) {
-        g_timer.state = TIMER_STOPPED;
-        g_timer.endTime = g_timer.currentTime;
-        if (g_logFile != NULL) {
-            fprintf(g_logFile, "========================================\n");
-            fprintf(g_logFile, "ĐÃ GIẢI XONG CUBE!\n");
-            fprintf(g_logFile, "Thời gian: %.2f giây\n", g_timer.endTime);
-            fprintf(g_logFile, "Số nước: %d\n", g_timer.moveCount);
-            fprintf(g_logFile, "TPS: %.2f\n", g_timer.tps);
-            fprintf(g_logFile, "========================================\n");
-            fflush(g_logFile);
-        }
+    int centiseconds = (int)(seconds * 100.0);
+    int minutes = centiseconds / 6000;
+    int sec = (centiseconds / 100) % 60;
+    if (bufferSize > 0) {
+        snprintf(buffer, bufferSize, "%02d:%02d.%02d", minutes, sec, centiseconds % 100);
     }
-    glutPostRedisplay();
 }
 
-void renderBitmapString(float x, float y, void* font, const char* string) {
-    glRasterPos2f(x, y);
-    while (*string != '\0') {
-        glutBitmapCharacter(font, *string);
-        ++string;
+// Trung bình chưa đủ lần giải hiển thị là "-"
+static void formatAverageText(double seconds, char* buffer, int bufferSize) {
+    if (seconds < 0.0) {
+        snprintf(buffer, bufferSize, "-");
+    } else {
+        snprintf(buffer, bufferSize, "%.2f", seconds);
     }
 }
 
-void formatTimerText(float seconds, char* buffer, int bufferSize) {
-    if (seconds < 0.0f) {
-        seconds = 0.0f;
+// Các giá trị nguyên quyết định nội dung overlay
+// Chuỗi chỉ được định dạng lại khi một trong các giá trị này đổi
+// (với timer đang chạy: tối đa một lần mỗi centisecond hiển thị)
+struct OverlayKey {
+    int scramblePending;
+    int state;
+    int centiseconds;
+    int moveCount;
+    int tpsHundredths;
+    int windowWidth;
+    int windowHeight;
+    int wallVisible;
+    int wallFull;
+    int wallTextured;
+    int replayCentiseconds;   // -1 khi không phát lại
+    int replaySpeedHundredths;
+    int replayPaused;
+    int solveCount;           // Thống kê lịch sử đổi sau mỗi lần giải
+};
+
+static OverlayKey s_overlayKey = {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -2, -1, -1, -1};
+
+static bool sameOverlayKey(const OverlayKey& a, const OverlayKey& b) {
+    return a.scramblePending == b.scramblePending && a.state == b.state &&
+           a.centiseconds == b.centiseconds && a.moveCount == b.moveCount &&
+           a.tpsHundredths == b.tpsHundredths &&
+           a.windowWidth == b.windowWidth && a.windowHeight == b.windowHeight &&
+           a.wallVisible == b.wallVisible && a.wallFull == b.wallFull &&
+           a.wallTextured == b.wallTextured &&
+           a.replayCentiseconds == b.replayCentiseconds &&
+           a.replaySpeedHundredths == b.replaySpeedHundredths && a.replayPaused == b.replayPaused &&
+           a.solveCount == b.solveCount;
+}
+
+static void updateOverlayLabels() {
+    OverlayKey key;
+    key.scramblePending = g_scrambleMovesPending;
+    key.state = (int)g_timer.state;
+    key.centiseconds = 0;
+    key.moveCount = 0;
+    key.tpsHundredths = 0;
+    if (g_timer.state == TIMER_RUNNING || g_timer.state == TIMER_STOPPED) {
+        double seconds = g_timer.state == TIMER_RUNNING ? g_timer.currentTime : g_timer.endTime;
+        key.centiseconds = (int)(seconds * 100.0);
+        key.moveCount = g_timer.moveCount;
+        key.tpsHundredths = (int)(g_timer.tps * 100.0f + 0.5f);
     }
-    int minutes = (int)(seconds / 60.0f);
-    float sec = seconds - minutes * 60.0f;
-    if (bufferSize > 0) {
-        snprintf(buffer, bufferSize, "%02d:%06.3f", minutes, sec);
+    key.windowWidth = g_windowWidth;
+    key.windowHeight = g_windowHeight;
+    int wallLod[3] = {0, 0, 0};
+    key.wallVisible = -1;
+    if (isCubeWallActive()) {
+        key.wallVisible = getCubeWallVisibleCount();
+        getCubeWallLodCounts(wallLod);
     }
-}
+    key.wallFull = wallLod[0];
+    key.wallTextured = wallLod[1];
+    key.replayCentiseconds = -1;
+    key.replaySpeedHundredths = 0;
+    key.replayPaused = 0;
+    if (isReplayActive()) {
+        key.replayCentiseconds = (int)(getReplayPositionSeconds() * 100.0);
+        key.replaySpeedHundredths = (int)(getReplaySpeed() * 100.0f + 0.5f);
+        key.replayPaused = isReplayPaused() ? 1 : 0;
+    }
+    SolveStats solveStats;
+    getSolveStats(solveStats);
+    key.solveCount = (int)solveStats.solveCount;
+    if (sameOverlayKey(key, s_overlayKey)) {
+        return;
+    }
+    s_overlayKey = key;
 
-void displayTimerOverlay() {
-    glMatrixMode(GL_PROJECTION);
-    glPushMatrix();
-    glLoadIdentity();
-    gluOrtho2D(0.0f, (float)g_windowWidth, 0.0f, (float)g_windowHeight);
-    glMatrixMode(GL_MODELVIEW);
-    glPushMatrix();
-    glLoadIdentity();
-    GLboolean depthEnabled = glIsEnabled(GL_DEPTH_TEST);
-    GLboolean lightingEnabled = glIsEnabled(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
+    static const float ORANGE[3] = {1.0f, 0.6f, 0.0f};
+    static const float WHITE[3] = {1.0f, 1.0f, 1.0f};
+    static const float YELLOW[3] = {1.0f, 1.0f, 0.2f};
+    static const float GREEN[3] = {0.0f, 1.0f, 0.0f};
+    static const float LIGHT_GREEN[3] = {0.2f, 1.0f, 0.2f};
+    const float top = (float)g_windowHeight;
     char buffer[128];
-    if (g_scrambleMovesPending > 0) {
-        glColor3f(1.0f, 0.6f, 0.0f);
+    int used = 0;
+
+    if (isCubeWallActive()) {
+        snprintf(buffer, sizeof(buffer), "Cube wall: %d cubes | %d in view",
+                 getCubeWallCount(), getCubeWallVisibleCount());
+        setTextLabel(used++, 10.0f, top - 20.0f, WHITE, buffer);
+        snprintf(buffer, sizeof(buffer), "LOD full %d | textured %d | box %d",
+                 wallLod[0], wallLod[1], wallLod[2]);
+        setTextLabel(used++, 10.0f, top - 40.0f, WHITE, buffer);
+        setTextLabel(used++, 10.0f, top - 60.0f, WHITE, "+/- to zoom, drag or arrows to rotate");
+    } else if (g_scrambleMovesPending > 0) {
         snprintf(buffer, sizeof(buffer), "Scrambling... (%d moves left)", g_scrambleMovesPending);
-        renderBitmapString(10.0f, g_windowHeight - 20.0f, GLUT_BITMAP_HELVETICA_18, buffer);
-        renderBitmapString(10.0f, g_windowHeight - 40.0f, GLUT_BITMAP_HELVETICA_18,
-                           "Please wait for scramble to finish");
+        setTextLabel(used++, 10.0f, top - 20.0f, ORANGE, buffer);
+        setTextLabel(used++, 10.0f, top - 40.0f, ORANGE, "Please wait for scramble to finish");
     } else {
         switch (g_timer.state) {
             case TIMER_IDLE:
-                glColor3f(1.0f, 1.0f, 1.0f);
-                renderBitmapString(10.0f, g_windowHeight - 20.0f, GLUT_BITMAP_HELVETICA_18,
-                                   "Press 'S' to scramble");
+                setTextLabel(used++, 10.0f, top - 20.0f, WHITE, "Press 'S' to scramble");
                 break;
             case TIMER_READY:
-                glColor3f(1.0f, 1.0f, 0.2f);
-                renderBitmapString(10.0f, g_windowHeight - 20.0f, GLUT_BITMAP_HELVETICA_18,
-                                   "READY - Make a move to start");
+                setTextLabel(used++, 10.0f, top - 20.0f, YELLOW, "READY - Make a move to start");
                 break;
             case TIMER_RUNNING:
-                glColor3f(0.0f, 1.0f, 0.0f);
                 formatTimerText(g_timer.currentTime, buffer, sizeof(buffer));
-                renderBitmapString(10.0f, g_windowHeight - 20.0f, GLUT_BITMAP_HELVETICA_18,
-                                   buffer);
+                setTextLabel(used++, 10.0f, top - 20.0f, GREEN, buffer);
                 snprintf(buffer, sizeof(buffer), "Moves: %d", g_timer.moveCount);
-                renderBitmapString(10.0f, g_windowHeight - 40.0f, GLUT_BITMAP_HELVETICA_18,
-                                   buffer);
+                setTextLabel(used++, 10.0f, top - 40.0f, GREEN, buffer);
                 snprintf(buffer, sizeof(buffer), "TPS: %.2f", g_timer.tps);
-                renderBitmapString(10.0f, g_windowHeight - 60.0f, GLUT_BITMAP_HELVETICA_18,
-                                   buffer);
+                setTextLabel(used++, 10.0f, top - 60.0f, GREEN, buffer);
                 break;
             case TIMER_STOPPED:
-                glColor3f(0.2f, 1.0f, 0.2f);
                 snprintf(buffer, sizeof(buffer), "Solved! Time %.2fs | Moves %d | TPS %.2f",
                          g_timer.endTime, g_timer.moveCount, g_timer.tps);
-                renderBitmapString(g_windowWidth * 0.2f, g_windowHeight * 0.5f,
-                                   GLUT_BITMAP_HELVETICA_18, buffer);
+                setTextLabel(used++, g_windowWidth * 0.2f, g_windowHeight * 0.5f, LIGHT_GREEN, buffer);
+                if (isSolveDatabaseOpen()) {
+                    char best[16];
+                    char ao5[16];
+                    char ao12[16];
+                    formatAverageText(solveStats.bestSeconds, best, sizeof(best));
+                    formatAverageText(solveStats.currentAverage[0], ao5, sizeof(ao5));
+                    formatAverageText(solveStats.currentAverage[1], ao12, sizeof(ao12));
+                    snprintf(buffer, sizeof(buffer), "Solve #%lld | Best %s | ao5 %s | ao12 %s",
+                             solveStats.solveCount, best, ao5, ao12);
+                    setTextLabel(used++, g_windowWidth * 0.2f, g_windowHeight * 0.5f - 20.0f, LIGHT_GREEN, buffer);
+                }
                 break;
         }
     }
-    if (depthEnabled) {
-        glEnable(GL_DEPTH_TEST);
+    if (isReplayActive()) {
+        static const float CYAN[3] = {0.6f, 0.9f, 1.0f};
+        char position[16];
+        char duration[16];
+        formatTimerText(getReplayPositionSeconds(), position, sizeof(position));
+        formatTimerText(getReplayDurationSeconds(), duration, sizeof(duration));
+        snprintf(buffer, sizeof(buffer), "REPLAY %s / %s  x%.2f%s", position, duration,
+                 getReplaySpeed(), isReplayPaused() ? "  PAUSED" : "");
+        setTextLabel(used++, 10.0f, top - 80.0f, CYAN, buffer);
     }
-    if (lightingEnabled) {
-        glEnable(GL_LIGHTING);
+    while (used < TIMER_OVERLAY_LABELS) {
+        hideTextLabel(used++);
     }
-    glPopMatrix();
-    glMatrixMode(GL_PROJECTION);
-    glPopMatrix();
-    glMatrixMode(GL_MODELVIEW);
+}
+
+// HUD hiệu năng ở góc dưới trái: thống kê tính lại mỗi PERF_HUD_REFRESH_FRAMES frame
+// (sắp xếp vòng mẫu để lấy percentile) nên chữ không nhảy liên tục
+static void updatePerfLabels() {
+    static int framesUntilRefresh = 0;
+    static bool wasVisible = false;
+    if (!g_perfHudVisible) {
+        if (wasVisible) {
+            for (int slot = TIMER_OVERLAY_LABELS; slot < TEXT_MAX_LABELS; slot++) {
+                hideTextLabel(slot);
+            }
+            wasVisible = false;
+        }
+        return;
+    }
+    if (wasVisible && --framesUntilRefresh > 0) {
+        return;
+    }
+    wasVisible = true;
+    framesUntilRefresh = PERF_HUD_REFRESH_FRAMES;
+
+    static const float CYAN[3] = {0.6f, 0.9f, 1.0f};
+    PerfStats stats;
+    computePerfStats(stats);
+    char buffer[128];
+    int slot = TIMER_OVERLAY_LABELS;
+
+    LatencyStats latency;
+    computeLatencyStats(latency);
+    if (latency.sampleCount > 0) {
+        snprintf(buffer, sizeof(buffer), "Key->swap p50 %.1f p95 %.1f p99 %.1f ms (%d)",
+                 latency.p50Ms[LATENCY_SWAP], latency.p95Ms[LATENCY_SWAP],
+                 latency.p99Ms[LATENCY_SWAP], latency.sampleCount);
+        setTextLabel(slot++, 10.0f, 70.0f, CYAN, buffer);
+    }
+    snprintf(buffer, sizeof(buffer), "Frame %.2f ms | p50 %.2f p95 %.2f p99 %.2f",
+             stats.lastFrameMs, stats.p50FrameMs, stats.p95FrameMs, stats.p99FrameMs);
+    setTextLabel(slot++, 10.0f, 50.0f, CYAN, buffer);
+    snprintf(buffer, sizeof(buffer), "Update %.2f | Render %.2f | Swap %.2f ms",
+             stats.avgUpdateMs, stats.avgRenderMs, stats.avgSwapMs);
+    setTextLabel(slot++, 10.0f, 30.0f, CYAN, buffer);
+    snprintf(buffer, sizeof(buffer), "Draw calls %d | Vertices %d | Queue %d",
+             stats.drawCalls, stats.vertices, stats.queueDepth);
+    setTextLabel(slot++, 10.0f, 10.0f, CYAN, buffer);
+    while (slot < TEXT_MAX_LABELS) {
+        hideTextLabel(slot++);
+    }
+}
+
+void displayTimerOverlay() {
+    updateOverlayLabels();
+    updatePerfLabels();
+    drawTextLabels();
 }
@@ -0,0 +1,477 @@
+#include "rubik_video.h"
+#include "rubik_softraster.h"
+#include "rubik_thread.h"
+#include "rubik_state.h"
+#include "rubik_rotation.h"
+#include "rubik_notation.h"
+#include "rubik_animation.h"
+#include "rubik_input.h"
+#include "rubik_scheduler.h"
+#include "rubik_clock.h"
+#include "rubik_constants.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Một nước xoay 90 độ của video (F2 được tách thành hai nước)
+struct VideoMove {
+    int face;
+    bool clockwise;
+};
+
+// Frame đi qua các giai đoạn; bộ đệm được cấp một lần và quay vòng
+struct VideoFrame {
+    unsigned char* rgb;   // Kết quả giai đoạn vẽ
+    unsigned char* yuv;   // Kết quả giai đoạn đổi màu (Y, rồi U, rồi V)
+};
+
+// Hàng đợi có giới hạn giữa hai giai đoạn: push chặn khi đầy, pop chặn khi rỗng.
+// pop trả về NULL khi hàng đợi đã đóng và không còn frame
+struct FrameQueue {
+    VideoFrame* items[VIDEO_FRAME_POOL];
+    int capacity;
+    int head;
+    int count;
+    bool closed;
+    RubikMutex mutex;
+    RubikCondition notEmpty;
+    RubikCondition notFull;
+};
+
+static void initFrameQueue(FrameQueue& queue, int capacity) {
+    queue.capacity = capacity;
+    queue.head = 0;
+    queue.count = 0;
+    queue.closed = false;
+    initMutex(queue.mutex);
+    initCondition(queue.notEmpty);
+    initCondition(queue.notFull);
+}
+
+static void destroyFrameQueue(FrameQueue& queue) {
+    destroyCondition(queue.notFull);
+    destroyCondition(queue.notEmpty);
+    destroyMutex(queue.mutex);
+}
+
+static void pushFrame(FrameQueue& queue, VideoFrame* frame) {
+    lockMutex(queue.mutex);
+    while (queue.count >= queue.capacity) {
+        waitCondition(queue.notFull, queue.mutex);
+    }
+    queue.items[(queue.head + queue.count) % queue.capacity] = frame;
+    queue.count++;
+    signalCondition(queue.notEmpty);
+    unlockMutex(queue.mutex);
+}
+
+static VideoFrame* popFrame(FrameQueue& queue) {
+    lockMutex(queue.mutex);
+    while (queue.count == 0 && !queue.closed) {
+        waitCondition(queue.notEmpty, queue.mutex);
+    }
+    VideoFrame* frame = NULL;
+    if (queue.count > 0) {
+        frame = queue.items[queue.head];
+        queue.head = (queue.head + 1) % queue.capacity;
+        queue.count--;
+        signalCondition(queue.notFull);
+    }
+    unlockMutex(queue.mutex);
+    return frame;
+}
+
+// Không còn frame nào được đẩy vào: đánh thức giai đoạn sau để nó kết thúc
+static void closeFrameQueue(FrameQueue& queue) {
+    lockMutex(queue.mutex);
+    queue.closed = true;
+    broadcastCondition(queue.notEmpty);
+    unlockMutex(queue.mutex);
+}
+
+// Trạng thái dùng chung của pipeline
+struct VideoPipeline {
+    int width;
+    int height;
+    bool y4m;
+    FILE* file;
+    FrameQueue freeFrames;     // Frame rảnh, chờ giai đoạn vẽ
+    FrameQueue convertFrames;  // Đã vẽ, chờ đổi màu
+    FrameQueue writeFrames;    // Đã đổi màu, chờ ghi
+    volatile int writeFailed;  // Khác 0 khi ghi file lỗi (giai đoạn vẽ dừng sớm)
+    ClockNanos convertNanos;   // Thời gian làm việc của từng luồng (không tính lúc chờ)
+    ClockNanos writeNanos;
+};
+
+// RGB -> YCbCr BT.601 dải giới hạn (16-235), chroma lấy trung bình khối 2x2
+static void convertFrameToYUV420(const unsigned char* rgb, unsigned char* yuv, int width, int height) {
+    unsigned char* planeY = yuv;
+    unsigned char* planeU = yuv + width * height;
+    unsigned char* planeV = planeU + (width / 2) * (height / 2);
+    for (int y = 0; y < height; y += 2) {
+        const unsigned char* row0 = rgb + (size_t)y * width * 3;
+        const unsigned char* row1 = row0 + width * 3;
+        unsigned char* outY0 = planeY + (size_t)y * width;
+        unsigned char* outY1 = outY0 + width;
+        for (int x = 0; x < width; x += 2) {
+            int sumR = 0;
+            int sumG = 0;
+            int sumB = 0;
+            const unsigned char* pixels[4] = {row0 + x * 3, row0 + x * 3 + 3, row1 + x * 3, row1 + x * 3 + 3};
+            unsigned char* outputs[4] = {outY0 + x, outY0 + x + 1, outY1 + x, outY1 + x + 1};
+            for (int k = 0; k < 4; k++) {
+                int r = pixels[k][0];
+                int g = pixels[k][1];
+                int b = pixels[k][2];
+                *outputs[k] = (unsigned char)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+                sumR += r;
+                sumG += g;
+                sumB += b;
+            }
+            int r = (sumR + 2) >> 2;
+            int g = (sumG + 2) >> 2;
+            int b = (sumB + 2) >> 2;
+            size_t c = (size_t)(y / 2) * (width / 2) + x / 2;
+            planeU[c] = (unsigned char)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            planeV[c] = (unsigned char)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+static void convertStageMain(void* arg) {
+    VideoPipeline& pipeline = *(VideoPipeline*)arg;
+    VideoFrame* frame;
+    setProfilerThreadName("video convert");
+    while ((frame = popFrame(pipeline.convertFrames)) != NULL) {
+        PROFILE_ZONE("convertFrameToYUV420");
+        ClockNanos start = clockRealNanos();
+        convertFrameToYUV420(frame->rgb, frame->yuv, pipeline.width, pipeline.height);
+        pipeline.convertNanos += clockRealNanos() - start;
+        pushFrame(pipeline.writeFrames, frame);
+    }
+    closeFrameQueue(pipeline.writeFrames);
+}
+
+static void writeStageMain(void* arg) {
+    VideoPipeline& pipeline = *(VideoPipeline*)arg;
+    const size_t frameBytes = (size_t)pipeline.width * pipeline.height * 3 / 2;
+    VideoFrame* frame;
+    setProfilerThreadName("video write");
+    while ((frame = popFrame(pipeline.writeFrames)) != NULL) {
+        // Sau khi lỗi vẫn tiếp tục nhận frame để trả về hàng rảnh, tránh treo pipeline
+        if (pipeline.writeFailed == 0) {
+            PROFILE_ZONE("writeVideoFrame");
+            ClockNanos start = clockRealNanos();
+            bool ok = true;
+            if (pipeline.y4m) {
+                ok = fputs("FRAME\n", pipeline.file) >= 0;
+            }
+            ok = ok && fwrite(frame->yuv, 1, frameBytes, pipeline.file) == frameBytes;
+            if (!ok) {
+                atomicAdd(&pipeline.writeFailed, 1);
+            }
+            pipeline.writeNanos += clockRealNanos() - start;
+        }
+        pushFrame(pipeline.freeFrames, frame);
+    }
+}
+
+// ==================== Chuẩn bị chuỗi nước đi ====================
+
+// Nước đôi được tách thành hai nước xuôi chiều, giống khi nhập hai lần phím
+static bool appendMoves(const char* text, std::vector<VideoMove>& moves) {
+    std::vector<MoveCode> codes;
+    NotationError error;
+    if (!parseNotation(text, text + strlen(text), codes, error)) {
+        fprintf(stderr, "Cột %d: %s\n", error.column, error.message);
+        return false;
+    }
+    for (size_t i = 0; i < codes.size(); i++) {
+        int turns = moveCodeTurns(codes[i]);
+        VideoMove move;
+        move.face = moveCodeFace(codes[i]);
+        move.clockwise = turns != 3;
+        for (int t = move.clockwise ? turns : 1; t > 0; t--) {
+            moves.push_back(move);
+        }
+    }
+    return true;
+}
+
+static bool readTextFile(const char* path, std::string& text) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    char buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, read);
+    }
+    fclose(file);
+    return true;
+}
+
+// Trộn ngẫu nhiên (không xoay cùng một mặt hai lần liền)
+static void appendRandomMoves(int count, std::vector<VideoMove>& moves) {
+    int lastFace = -1;
+    for (int i = 0; i < count; i++) {
+        VideoMove move;
+        do {
+            move.face = rand() % 6;
+        } while (move.face == lastFace);
+        move.clockwise = (rand() % 2) == 0;
+        lastFace = move.face;
+        moves.push_back(move);
+    }
+}
+
+// ==================== Chế độ dòng lệnh ====================
+
+bool isVideoExportRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--export-video") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printVideoExportUsage() {
+    fprintf(stderr,
+            "Cách dùng: rubik --export-video out.(y4m|yuv) [--moves \"R U R'\"] [--moves-file f]\n"
+            "                 [--setup \"...\"] [--scramble N] [--seed N] [--size WxH] [--fps N]\n"
+            "                 [--threads N] [--angles X,Y] [--hold S]\n"
+            "  .y4m ghi YUV4MPEG2, đuôi khác ghi YUV 4:2:0 thô (ffmpeg -f rawvideo -pix_fmt yuv420p).\n"
+            "  --setup/--scramble đặt trạng thái đầu (không quay), --moves/--moves-file là phần được quay;\n"
+            "  chỉ có --scramble thì video phát lời giải ngược của chuỗi trộn.\n"
+            "  Kích thước phải chẵn.\n");
+}
+
+int runVideoExportCommand(int argc, char** argv) {
+    const char* outputPath = NULL;
+    std::string moveText;
+    std::string setupText;
+    int width = 800;
+    int height = 600;
+    int fps = TARGET_FRAME_RATE;
+    int threads = 0;
+    int scrambleMoves = 0;
+    unsigned int seed = 1;
+    float angleX = SOFT_DEFAULT_ANGLE_X;
+    float angleY = SOFT_DEFAULT_ANGLE_Y;
+    float holdSeconds = VIDEO_DEFAULT_HOLD_SECONDS;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--export-video") == 0 && hasValue) {
+            outputPath = argv[++i];
+        } else if (strcmp(argv[i], "--moves") == 0 && hasValue) {
+            moveText += argv[++i];
+            moveText += ' ';
+        } else if (strcmp(argv[i], "--moves-file") == 0 && hasValue) {
+            if (!readTextFile(argv[++i], moveText)) {
+                fprintf(stderr, "Không đọc được file nước đi: %s\n", argv[i]);
+                return 1;
+            }
+            moveText += ' ';
+        } else if (strcmp(argv[i], "--setup") == 0 && hasValue) {
+            setupText += argv[++i];
+            setupText += ' ';
+        } else if (strcmp(argv[i], "--scramble") == 0 && hasValue) {
+            scrambleMoves = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--size") == 0 && hasValue) {
+            if (sscanf(argv[++i], "%dx%d", &width, &height) != 2) {
+                width = 0;
+            }
+        } else if (strcmp(argv[i], "--fps") == 0 && hasValue) {
+            fps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--angles") == 0 && hasValue) {
+            if (sscanf(argv[++i], "%f,%f", &angleX, &angleY) != 2) {
+                width = 0;
+            }
+        } else if (strcmp(argv[i], "--hold") == 0 && hasValue) {
+            holdSeconds = (float)atof(argv[++i]);
+        } else {
+            fprintf(stderr, "Tham số không hợp lệ: %s\n", argv[i]);
+            printVideoExportUsage();
+            return 1;
+        }
+    }
+    if (outputPath == NULL || width <= 0 || height <= 0 || (width % 2) != 0 || (height % 2) != 0 ||
+        fps <= 0 || holdSeconds < 0.0f) {
+        printVideoExportUsage();
+        return 1;
+    }
+
+    std::vector<VideoMove> setupMoves;
+    std::vector<VideoMove> playMoves;
+    srand(seed);  // Seed cố định để chuỗi trộn lặp lại được giữa các lần chạy
+    if (!appendMoves(setupText.c_str(), setupMoves) || !appendMoves(moveText.c_str(), playMoves)) {
+        fprintf(stderr, "Chuỗi nước đi không hợp lệ\n");
+        return 1;
+    }
+    size_t scrambleStart = setupMoves.size();
+    appendRandomMoves(scrambleMoves, setupMoves);
+    if (playMoves.empty()) {
+        // Chỉ có chuỗi trộn: phát lời giải là chuỗi trộn đảo ngược
+        for (size_t i = setupMoves.size(); i > scrambleStart; i--) {
+            VideoMove move = setupMoves[i - 1];
+            move.clockwise = !move.clockwise;
+            playMoves.push_back(move);
+        }
+    }
+    if (playMoves.empty()) {
+        printVideoExportUsage();
+        return 1;
+    }
+
+    // Không có cửa sổ: scheduler không được gọi GLUT, mô phỏng do vòng lặp này điều khiển
+    setSchedulerHeadless(true);
+    initRubikCube();
+    updateRotationAxes();
+    cameraAngleX = angleX;
+    cameraAngleY = angleY;
+    for (size_t i = 0; i < setupMoves.size(); i++) {
+        rotatePositions(g_rubikCube, setupMoves[i].face, setupMoves[i].clockwise);
+    }
+    syncVisualCube();
+
+    if (!initSoftRenderer(width, height, threads)) {
+        return 1;
+    }
+
+    VideoPipeline pipeline;
+    pipeline.width = width;
+    pipeline.height = height;
+    pipeline.y4m = strlen(outputPath) >= 4 && strcmp(outputPath + strlen(outputPath) - 4, ".y4m") == 0;
+    pipeline.file = fopen(outputPath, "wb");
+    pipeline.writeFailed = 0;
+    pipeline.convertNanos = 0;
+    pipeline.writeNanos = 0;
+    if (pipeline.file == NULL) {
+        fprintf(stderr, "Không mở được file video: %s\n", outputPath);
+        shutdownSoftRenderer();
+        return 1;
+    }
+    if (pipeline.y4m) {
+        // C420jpeg: chroma đặt ở tâm khối 2x2, đúng với cách lấy trung bình ở trên
+        fprintf(pipeline.file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+    }
+
+    initFrameQueue(pipeline.freeFrames, VIDEO_FRAME_POOL);
+    initFrameQueue(pipeline.convertFrames, VIDEO_QUEUE_DEPTH);
+    initFrameQueue(pipeline.writeFrames, VIDEO_QUEUE_DEPTH);
+    const size_t rgbBytes = (size_t)width * height * 3;
+    VideoFrame frames[VIDEO_FRAME_POOL];
+    for (int i = 0; i < VIDEO_FRAME_POOL; i++) {
+        frames[i].rgb = new unsigned char[rgbBytes];
+        frames[i].yuv = new unsigned char[(size_t)width * height * 3 / 2];
+        pushFrame(pipeline.freeFrames, &frames[i]);
+    }
+
+    RubikThread convertThread;
+    RubikThread writeThread;
+    bool convertStarted = startThread(convertThread, convertStageMain, &pipeline);
+    bool writeStarted = convertStarted && startThread(writeThread, writeStageMain, &pipeline);
+    if (!writeStarted) {
+        fprintf(stderr, "Không tạo được luồng cho pipeline video\n");
+        closeFrameQueue(pipeline.convertFrames);
+        if (convertStarted) {
+            joinThread(convertThread);
+        }
+        atomicAdd(&pipeline.writeFailed, 1);
+    }
+
+    // Giai đoạn vẽ (luồng chính): tiến mô phỏng tới thời điểm của từng frame
+    // rồi vẽ, nội suy góc animation giữa hai bước mô phỏng
+    const int holdFrames = (int)(holdSeconds * (float)fps + 0.5f);
+    size_t nextMove = 0;
+    int frameCount = 0;
+    int endHold = -1;
+    ClockNanos renderNanos = 0;
+    ClockNanos startTime = clockRealNanos();
+    ClockNanos simStart = g_simTimeNanos;
+
+    while (writeStarted && pipeline.writeFailed == 0) {
+        ClockNanos target = simStart + (ClockNanos)frameCount * NANOS_PER_SECOND / fps;
+        // Nước đầu tiên bắt đầu sau đoạn giữ hình; các nước sau được đưa vào
+        // hàng đợi animation khi còn chỗ nên nối tiếp nhau không ngắt quãng
+        if (frameCount >= holdFrames) {
+            while (nextMove < playMoves.size() &&
+                   (!g_animation.isActive || g_moveQueue.count < MOVE_QUEUE_CAPACITY)) {
+                startRotation((Face)playMoves[nextMove].face, playMoves[nextMove].clockwise);
+                nextMove++;
+            }
+        }
+        int guard = 0;
+        while (g_simTimeNanos < target && guard++ < MAX_SIMULATION_STEPS_PER_FRAME * 100) {
+            stepSimulation();
+        }
+        g_renderAlpha = 1.0f - (float)(g_simTimeNanos - target) / (float)SIMULATION_STEP_NANOS;
+        if (g_renderAlpha < 0.0f) {
+            g_renderAlpha = 0.0f;
+        }
+
+        if (endHold < 0 && nextMove == playMoves.size() && !g_animation.isActive && g_moveQueue.count == 0) {
+            endHold = frameCount + holdFrames;
+        }
+        if (endHold >= 0 && frameCount > endHold) {
+            break;
+        }
+
+        VideoFrame* frame = popFrame(pipeline.freeFrames);
+        ClockNanos renderStart = clockRealNanos();
+        renderSceneSoftware();
+        memcpy(frame->rgb, getSoftFramebuffer().color, rgbBytes);
+        renderNanos += clockRealNanos() - renderStart;
+        pushFrame(pipeline.convertFrames, frame);
+        frameCount++;
+    }
+
+    if (writeStarted) {
+        closeFrameQueue(pipeline.convertFrames);
+        joinThread(convertThread);
+        joinThread(writeThread);
+    }
+    bool ok = pipeline.writeFailed == 0;
+    if (fclose(pipeline.file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "Không ghi được file video: %s\n", outputPath);
+    }
+
+    for (int i = 0; i < VIDEO_FRAME_POOL; i++) {
+        delete[] frames[i].rgb;
+        delete[] frames[i].yuv;
+    }
+    destroyFrameQueue(pipeline.writeFrames);
+    destroyFrameQueue(pipeline.convertFrames);
+    destroyFrameQueue(pipeline.freeFrames);
+
+    double totalSeconds = clockNanosToSeconds(clockRealNanos() - startTime);
+    double videoSeconds = (double)frameCount / (double)fps;
+    double speedup = totalSeconds > 0.0 ? videoSeconds / totalSeconds : 0.0;
+    int frameDivisor = frameCount > 0 ? frameCount : 1;
+    printf("VIDEO: %dx%d @%d fps, %d nước, %d frame (%.2fs video) trong %.2fs, nhanh gấp %.1f lần thời gian thực\n",
+           width, height, fps, (int)playMoves.size(), frameCount, videoSeconds, totalSeconds, speedup);
+    printf("  ms/frame: vẽ %.3f (%d luồng), đổi màu %.3f, ghi %.3f\n",
+           clockNanosToMs(renderNanos) / frameDivisor, getSoftRendererThreadCount(),
+           clockNanosToMs(pipeline.convertNanos) / frameDivisor, clockNanosToMs(pipeline.writeNanos) / frameDivisor);
+    RUBIK_LOG(EVT_VIDEO_EXPORT) << outputPath << frameCount << totalSeconds << speedup;
+    RUBIK_LOG(EVT_VIDEO_STAGES) << clockNanosToMs(renderNanos) / frameDivisor
+                                << clockNanosToMs(pipeline.convertNanos) / frameDivisor
+                                << clockNanosToMs(pipeline.writeNanos) / frameDivisor;
+
+    shutdownSoftRenderer();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,574 @@
+#include "rubik_wall.h"
+#include "rubik_state.h"
+#include "rubik_rotation.h"
+#include "rubik_render.h"
+#include "rubik_animation.h"
+#include "rubik_instanced.h"
+#include "rubik_constants.h"
+#include "rubik_scheduler.h"
+#include "rubik_perf.h"
+#include "rubik_log.h"
+#include "rubik_profiler.h"
+#include <GL/glut.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Một nước đi được mã hoá trong 1 byte: face * 2 + (xuôi chiều ? 1 : 0)
+// Nước ngược của nó chỉ khác bit thấp nhất
+static inline int encodeWallMove(int face, bool clockwise) {
+    return face * 2 + (clockwise ? 1 : 0);
+}
+
+// Bảng hoán vị sticker của 12 nước đi: sau nước đi, sticker (mảnh affected[a], mặt f)
+// nhận màu của sticker nguồn source[a][f] = slot * 6 + mặt (slot trong khối 26 instance)
+struct WallMoveTable {
+    int affectedSlots[9];
+    unsigned short source[9][6];
+};
+
+static WallMoveTable s_moveTables[12];
+static int s_slotOfPiece[27];              // Chỉ số mảnh (0..26) -> slot instance, -1 cho lõi
+static float s_restOffsets[WALL_PIECES_PER_CUBE][3];  // Tâm mảnh so với tâm cube (đã nghiêng)
+static int s_slotGrid[WALL_PIECES_PER_CUBE][3];        // Toạ độ lưới của từng slot
+static float s_tilt[3][3];                 // Xoay nghiêng chung của mọi cube
+
+// Trạng thái các cube (mảng song song, chỉ số là số thứ tự cube)
+static int s_cubeCount = 0;
+static int s_columns = 0;
+static int s_rows = 0;
+static std::vector<PieceInstance> s_instances;    // 26 instance liền nhau mỗi cube
+static std::vector<float> s_centers;              // 3 float mỗi cube
+static std::vector<unsigned char> s_scripts;      // WALL_SCRIPT_MOVES nước trộn mỗi cube
+static std::vector<int> s_scriptPos;              // 0 .. 2 * WALL_SCRIPT_MOVES - 1
+static std::vector<float> s_progress;             // Tiến độ nước hiện tại (< 0: đang nghỉ)
+static std::vector<float> s_prevProgress;         // Ở bước mô phỏng trước (để nội suy)
+static std::vector<float> s_rate;                 // Nước mỗi giây
+
+// Bộ đệm gom các cube nhìn thấy thành một dãy instance liền nhau
+// (mảnh của cube vẽ đầy đủ và hộp của cube nhỏ nhất chung một draw call)
+static std::vector<PieceInstance> s_visibleInstances;
+static std::vector<CubeLodInstance> s_visibleLodInstances;
+static int s_visibleCubes = 0;
+static int s_lodCounts[3] = {0, 0, 0};
+static float s_zoom = 1.0f;
+
+// LOD: hộp một màu mỗi mặt (màu mảnh tâm, không đổi khi xoay mặt) và atlas sticker
+static unsigned char s_boxColors[6][4];
+static int s_stickerSlot[6][9];           // Slot mảnh chứa sticker thứ k của mặt
+static int s_stickerTexel[6][9];          // Vị trí texel (x + y * LOD_ATLAS_WIDTH) trong ô của cube
+static std::vector<unsigned char> s_atlasPixels;
+static int s_atlasHeight = 0;
+static unsigned int s_atlasTexture = 0;
+static int s_atlasDirtyFirstRow = 0;
+static int s_atlasDirtyLastRow = -1;
+
+// Sinh số ngẫu nhiên riêng để kịch bản chỉ phụ thuộc seed
+static unsigned int s_randomState = 1;
+
+static unsigned int nextWallRandom() {
+    s_randomState = s_randomState * 1103515245u + 12345u;
+    return (s_randomState >> 16) & 0x7FFF;
+}
+
+int parseCubeWallCount(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--wall") != 0) {
+            continue;
+        }
+        int count = WALL_DEFAULT_CUBES;
+        if (i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') {
+            count = atoi(argv[i + 1]);
+        }
+        if (count < 1) {
+            count = 1;
+        } else if (count > WALL_MAX_CUBES) {
+            count = WALL_MAX_CUBES;
+        }
+        return count;
+    }
+    return 0;
+}
+
+// Dựng bảng hoán vị bằng chính rotatePositions: mỗi sticker được đánh số bằng
+// giá trị màu, sau nước đi đọc lại số để biết sticker đến từ đâu
+static void buildMoveTables() {
+    unsigned int savedCategories = getLogCategories();  // rotatePositions ghi log mỗi lần gọi
+    setLogCategories(savedCategories & ~(unsigned int)LOG_CAT_MOVE);
+    for (int move = 0; move < 12; move++) {
+        int face = move / 2;
+        bool clockwise = (move % 2) != 0;
+        RubikCube cube = g_rubikCube;
+        for (int p = 0; p < 27; p++) {
+            for (int f = 0; f < 6; f++) {
+                cube.pieces[p].colors[f][0] = (float)(p * 6 + f);
+            }
+        }
+        rotatePositions(cube, face, clockwise);
+
+        int indices[9];
+        getFaceIndices(face, indices);
+        WallMoveTable& table = s_moveTables[move];
+        for (int a = 0; a < 9; a++) {
+            table.affectedSlots[a] = s_slotOfPiece[indices[a]];
+            for (int f = 0; f < 6; f++) {
+                int source = (int)cube.pieces[indices[a]].colors[f][0];
+                table.source[a][f] = (unsigned short)(s_slotOfPiece[source / 6] * 6 + source % 6);
+            }
+        }
+    }
+    setLogCategories(savedCategories);
+}
+
+static const float ZERO_OFFSET[3] = {0.0f, 0.0f, 0.0f};
+
+// Transform 3x4 của một mảnh: M = T(tâm cube) * Tilt * R * T(lưới)
+static void writeWallTransform(float transform[12], const float center[3],
+                               const float rot[3][3], const float offset[3]) {
+    for (int row = 0; row < 3; row++) {
+        transform[row * 4 + 0] = rot[row][0];
+        transform[row * 4 + 1] = rot[row][1];
+        transform[row * 4 + 2] = rot[row][2];
+        transform[row * 4 + 3] = center[row] + offset[row];
+    }
+}
+
+static void resetWallTransforms(int cube, const int* slots, int slotCount) {
+    PieceInstance* block = &s_instances[(size_t)cube * WALL_PIECES_PER_CUBE];
+    const float* center = &s_centers[(size_t)cube * 3];
+    for (int k = 0; k < slotCount; k++) {
+        int slot = slots[k];
+        writeWallTransform(block[slot].transform, center, s_tilt, s_restOffsets[slot]);
+    }
+}
+
+// Hoán vị màu sticker của một cube theo bảng (9 mảnh của lớp)
+static void applyWallMove(int cube, int move) {
+    PieceInstance* block = &s_instances[(size_t)cube * WALL_PIECES_PER_CUBE];
+    const WallMoveTable& table = s_moveTables[move];
+    unsigned char backup[WALL_PIECES_PER_CUBE][6][4];
+    for (int a = 0; a < 9; a++) {
+        int slot = table.affectedSlots[a];
+        memcpy(backup[slot], block[slot].colors, sizeof(backup[slot]));
+    }
+    for (int a = 0; a < 9; a++) {
+        unsigned char (*colors)[4] = block[table.affectedSlots[a]].colors;
+        for (int f = 0; f < 6; f++) {
+            int source = table.source[a][f];
+            memcpy(colors[f], backup[source / 6][source % 6], 4);
+        }
+    }
+}
+
+// Góc ô 18x3 texel của cube trong atlas sticker
+static void getAtlasOrigin(int cube, int& x, int& y) {
+    const int blocksPerRow = LOD_ATLAS_WIDTH / LOD_ATLAS_BLOCK_WIDTH;
+    x = (cube % blocksPerRow) * LOD_ATLAS_BLOCK_WIDTH;
+    y = (cube / blocksPerRow) * LOD_ATLAS_BLOCK_HEIGHT;
+}
+
+// Chép 54 màu sticker của cube vào atlas (phía CPU) và đánh dấu các hàng cần upload
+static void writeCubeAtlas(int cube) {
+    const PieceInstance* block = &s_instances[(size_t)cube * WALL_PIECES_PER_CUBE];
+    int originX;
+    int originY;
+    getAtlasOrigin(cube, originX, originY);
+    unsigned char* base = &s_atlasPixels[((size_t)originY * LOD_ATLAS_WIDTH + originX) * 4];
+    for (int face = 0; face < 6; face++) {
+        for (int k = 0; k < 9; k++) {
+            memcpy(base + (size_t)s_stickerTexel[face][k] * 4, block[s_stickerSlot[face][k]].colors[face], 4);
+        }
+    }
+    if (s_atlasDirtyLastRow < s_atlasDirtyFirstRow) {
+        s_atlasDirtyFirstRow = originY;
+        s_atlasDirtyLastRow = originY + LOD_ATLAS_BLOCK_HEIGHT - 1;
+    } else {
+        if (originY < s_atlasDirtyFirstRow) {
+            s_atlasDirtyFirstRow = originY;
+        }
+        if (originY + LOD_ATLAS_BLOCK_HEIGHT - 1 > s_atlasDirtyLastRow) {
+            s_atlasDirtyLastRow = originY + LOD_ATLAS_BLOCK_HEIGHT - 1;
+        }
+    }
+}
+
+// Upload phần atlas đã đổi từ frame trước (tạo texture ở lần đầu)
+static void uploadAtlas() {
+    if (s_atlasTexture == 0) {
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        s_atlasTexture = texture;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, LOD_ATLAS_WIDTH, s_atlasHeight, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, &s_atlasPixels[0]);
+    } else if (s_atlasDirtyLastRow >= s_atlasDirtyFirstRow) {
+        glBindTexture(GL_TEXTURE_2D, s_atlasTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, s_atlasDirtyFirstRow, LOD_ATLAS_WIDTH,
+                        s_atlasDirtyLastRow - s_atlasDirtyFirstRow + 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                        &s_atlasPixels[(size_t)s_atlasDirtyFirstRow * LOD_ATLAS_WIDTH * 4]);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    s_atlasDirtyFirstRow = 0;
+    s_atlasDirtyLastRow = -1;
+}
+
+// Nước đi hiện tại của cube: nửa đầu kịch bản là trộn, nửa sau là giải ngược lại
+static int getCurrentWallMove(int cube) {
+    int pos = s_scriptPos[cube];
+    const unsigned char* script = &s_scripts[(size_t)cube * WALL_SCRIPT_MOVES];
+    if (pos < WALL_SCRIPT_MOVES) {
+        return script[pos];
+    }
+    return script[2 * WALL_SCRIPT_MOVES - 1 - pos] ^ 1;
+}
+
+void initCubeWall(int cubeCount, unsigned int seed) {
+    s_randomState = seed;
+    s_cubeCount = cubeCount;
+    s_columns = (int)ceil(sqrt((double)cubeCount * 4.0 / 3.0));
+    s_rows = (cubeCount + s_columns - 1) / s_columns;
+
+    // Slot instance của 26 mảnh nhìn thấy
+    const int core = positionToIndex(0, 0, 0);
+    const float spacing = PIECE_SIZE + GAP_SIZE;
+    float tiltX[3][3];
+    float tiltY[3][3];
+    const float axisX[3] = {1.0f, 0.0f, 0.0f};
+    const float axisY[3] = {0.0f, 1.0f, 0.0f};
+    axisAngleToMatrix(tiltX, axisX, WALL_TILT_X_DEG);
+    axisAngleToMatrix(tiltY, axisY, WALL_TILT_Y_DEG);
+    matrixMultiply(s_tilt, tiltX, tiltY);
+
+    int slot = 0;
+    for (int p = 0; p < 27; p++) {
+        if (p == core) {
+            s_slotOfPiece[p] = -1;
+            continue;
+        }
+        const CubePiece& piece = g_rubikCube.pieces[p];
+        float grid[3];
+        for (int c = 0; c < 3; c++) {
+            s_slotGrid[slot][c] = piece.position[c];
+            grid[c] = (float)piece.position[c] * spacing;
+        }
+        for (int row = 0; row < 3; row++) {
+            s_restOffsets[slot][row] = s_tilt[row][0] * grid[0] + s_tilt[row][1] * grid[1] +
+                                       s_tilt[row][2] * grid[2];
+        }
+        s_slotOfPiece[p] = slot++;
+    }
+    buildMoveTables();
+
+    // Cube đã giải làm mẫu (initCubeWall được gọi ngay sau initRubikCube)
+    PieceInstance solvedBlock[WALL_PIECES_PER_CUBE];
+    for (int p = 0; p < 27; p++) {
+        if (s_slotOfPiece[p] >= 0) {
+            packPieceColors(g_rubikCube.pieces[p], solvedBlock[s_slotOfPiece[p]].colors);
+        }
+    }
+
+    // Sticker của từng mặt: mảnh nằm trên lớp ngoài của mặt đó, vị trí texel theo (u, v)
+    static const int faceNormals[6][3] = {
+        {0, 0, 1}, {0, 0, -1}, {-1, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, -1, 0}
+    };
+    for (int face = 0; face < 6; face++) {
+        int k = 0;
+        for (int s = 0; s < WALL_PIECES_PER_CUBE; s++) {
+            const int* grid = s_slotGrid[s];
+            if (grid[0] * faceNormals[face][0] + grid[1] * faceNormals[face][1] +
+                grid[2] * faceNormals[face][2] != 1) {
+                continue;
+            }
+            int u;
+            int v;
+            getStickerCell(face, grid, u, v);
+            s_stickerSlot[face][k] = s;
+            s_stickerTexel[face][k] = face * 3 + u + v * LOD_ATLAS_WIDTH;
+            if (grid[0] * grid[0] + grid[1] * grid[1] + grid[2] * grid[2] == 1) {
+                memcpy(s_boxColors[face], solvedBlock[s].colors[face], 4);
+            }
+            k++;
+        }
+    }
+    const int blocksPerRow = LOD_ATLAS_WIDTH / LOD_ATLAS_BLOCK_WIDTH;
+    int atlasRows = (cubeCount + blocksPerRow - 1) / blocksPerRow * LOD_ATLAS_BLOCK_HEIGHT;
+    s_atlasHeight = 1;
+    while (s_atlasHeight < atlasRows) {
+        s_atlasHeight *= 2;
+    }
+    s_atlasPixels.assign((size_t)LOD_ATLAS_WIDTH * s_atlasHeight * 4, 0);
+
+    s_instances.resize((size_t)cubeCount * WALL_PIECES_PER_CUBE);
+    s_visibleInstances.resize((size_t)cubeCount * WALL_PIECES_PER_CUBE);
+    s_visibleLodInstances.resize(cubeCount);
+    s_centers.resize((size_t)cubeCount * 3);
+    s_scripts.resize((size_t)cubeCount * WALL_SCRIPT_MOVES);
+    s_scriptPos.resize(cubeCount);
+    s_progress.resize(cubeCount);
+    s_prevProgress.resize(cubeCount);
+    s_rate.resize(cubeCount);
+
+    int allSlots[WALL_PIECES_PER_CUBE];
+    for (int k = 0; k < WALL_PIECES_PER_CUBE; k++) {
+        allSlots[k] = k;
+    }
+    for (int cube = 0; cube < cubeCount; cube++) {
+        int column = cube % s_columns;
+        int row = cube / s_columns;
+        float* center = &s_centers[(size_t)cube * 3];
+        center[0] = ((float)column - (float)(s_columns - 1) * 0.5f) * WALL_CUBE_SPACING;
+        center[1] = ((float)(s_rows - 1) * 0.5f - (float)row) * WALL_CUBE_SPACING;
+        center[2] = 0.0f;
+
+        memcpy(&s_instances[(size_t)cube * WALL_PIECES_PER_CUBE], solvedBlock, sizeof(solvedBlock));
+        resetWallTransforms(cube, allSlots, WALL_PIECES_PER_CUBE);
+
+        // Kịch bản trộn: không xoay cùng một mặt hai lần liên tiếp
+        unsigned char* script = &s_scripts[(size_t)cube * WALL_SCRIPT_MOVES];
+        int lastFace = -1;
+        for (int m = 0; m < WALL_SCRIPT_MOVES; m++) {
+            int face;
+            do {
+                face = (int)(nextWallRandom() % 6);
+            } while (face == lastFace);
+            lastFace = face;
+            script[m] = (unsigned char)encodeWallMove(face, (nextWallRandom() & 1) != 0);
+        }
+
+        // Mỗi cube bắt đầu ở một chỗ khác nhau trong kịch bản để tường không chạy đồng bộ
+        s_scriptPos[cube] = (int)(nextWallRandom() % (2 * WALL_SCRIPT_MOVES));
+        int target = s_scriptPos[cube];
+        for (s_scriptPos[cube] = 0; s_scriptPos[cube] < target; s_scriptPos[cube]++) {
+            applyWallMove(cube, getCurrentWallMove(cube));
+        }
+        float seconds = WALL_MOVE_SECONDS_MIN +
+                        (WALL_MOVE_SECONDS_MAX - WALL_MOVE_SECONDS_MIN) * (float)nextWallRandom() / 32767.0f;
+        s_rate[cube] = 1.0f / seconds;
+        s_progress[cube] = -WALL_MOVE_PAUSE + (1.0f + WALL_MOVE_PAUSE) * (float)nextWallRandom() / 32768.0f;
+        s_prevProgress[cube] = s_progress[cube];
+        writeCubeAtlas(cube);
+    }
+
+    RUBIK_LOG(EVT_WALL_INIT) << cubeCount << s_columns << s_rows << cubeCount * WALL_PIECES_PER_CUBE;
+}
+
+bool isCubeWallActive() {
+    return s_cubeCount > 0;
+}
+
+void updateCubeWall(float stepSeconds) {
+    PROFILE_ZONE("updateCubeWall");
+    float* progress = &s_progress[0];
+    float* prevProgress = &s_prevProgress[0];
+    const float* rate = &s_rate[0];
+    for (int cube = 0; cube < s_cubeCount; cube++) {
+        prevProgress[cube] = progress[cube];
+        progress[cube] += stepSeconds * rate[cube];
+        if (progress[cube] < 1.0f) {
+            continue;
+        }
+
+        // Nước đi xong: hoán vị màu, đưa lớp về vị trí nghỉ, chuyển sang nước kế tiếp
+        int move = getCurrentWallMove(cube);
+        applyWallMove(cube, move);
+        resetWallTransforms(cube, s_moveTables[move].affectedSlots, 9);
+        writeCubeAtlas(cube);
+        s_scriptPos[cube] = (s_scriptPos[cube] + 1) % (2 * WALL_SCRIPT_MOVES);
+        progress[cube] = -WALL_MOVE_PAUSE;
+        prevProgress[cube] = progress[cube];
+    }
+    requestRedisplay();
+}
+
+// Tính lại transform 9 mảnh của lớp đang xoay (chỉ cho cube nhìn thấy)
+static void updateTurningLayer(int cube, float progress) {
+    int move = getCurrentWallMove(cube);
+    float axis[3];
+    float angle = getFaceRotation((Face)(move / 2), (move & 1) != 0,
+                                  easeInOutCubic(progress) * 90.0f, axis);
+    float turn[3][3];
+    float rot[3][3];
+    axisAngleToMatrix(turn, axis, angle);
+    matrixMultiply(rot, s_tilt, turn);
+
+    const float spacing = PIECE_SIZE + GAP_SIZE;
+    PieceInstance* block = &s_instances[(size_t)cube * WALL_PIECES_PER_CUBE];
+    const float* center = &s_centers[(size_t)cube * 3];
+    const int* slots = s_moveTables[move].affectedSlots;
+    for (int k = 0; k < 9; k++) {
+        int slot = slots[k];
+        float grid[3] = {
+            (float)s_slotGrid[slot][0] * spacing,
+            (float)s_slotGrid[slot][1] * spacing,
+            (float)s_slotGrid[slot][2] * spacing
+        };
+        float offset[3];
+        for (int row = 0; row < 3; row++) {
+            offset[row] = rot[row][0] * grid[0] + rot[row][1] * grid[1] + rot[row][2] * grid[2];
+        }
+        writeWallTransform(block[slot].transform, center, rot, offset);
+    }
+}
+
+// Đường dự phòng khi GL không hỗ trợ instancing: vẽ từng mảnh bằng immediate mode
+static void drawWallInstancesImmediate(const PieceInstance* instances, int count) {
+    static const float corners[6][4][3] = {
+        {{-1, -1, 1}, {1, -1, 1}, {1, 1, 1}, {-1, 1, 1}},
+        {{1, -1, -1}, {-1, -1, -1}, {-1, 1, -1}, {1, 1, -1}},
+        {{-1, -1, -1}, {-1, -1, 1}, {-1, 1, 1}, {-1, 1, -1}},
+        {{1, -1, 1}, {1, -1, -1}, {1, 1, -1}, {1, 1, 1}},
+        {{-1, 1, 1}, {1, 1, 1}, {1, 1, -1}, {-1, 1, -1}},
+        {{-1, -1, -1}, {1, -1, -1}, {1, -1, 1}, {-1, -1, 1}}
+    };
+    const float size = PIECE_SIZE * 0.5f;
+    for (int n = 0; n < count; n++) {
+        const PieceInstance& instance = instances[n];
+        const float* t = instance.transform;
+        float matrix[16] = {
+            t[0], t[4], t[8], 0.0f,
+            t[1], t[5], t[9], 0.0f,
+            t[2], t[6], t[10], 0.0f,
+            t[3], t[7], t[11], 1.0f
+        };
+        glPushMatrix();
+        glMultMatrixf(matrix);
+        glBegin(GL_QUADS);
+        for (int face = 0; face < 6; face++) {
+            glColor3ubv(instance.colors[face]);
+            for (int v = 0; v < 4; v++) {
+                glVertex3f(corners[face][v][0] * size, corners[face][v][1] * size, corners[face][v][2] * size);
+            }
+        }
+        glEnd();
+        glPopMatrix();
+        perfCountDraw(24);
+    }
+}
+
+void drawCubeWall() {
+    PROFILE_ZONE("drawCubeWall");
+    if (s_cubeCount == 0) {
+        return;
+    }
+
+    // Camera lùi đủ xa để thấy cả tường, phím +/- thay đổi hệ số s_zoom
+    float aspect = (float)g_windowWidth / (float)(g_windowHeight > 0 ? g_windowHeight : 1);
+    float tanHalf = (float)tan((double)CAMERA_FOV_DEG * 3.14159265358979323846 / 360.0);
+    float fitHeight = (float)s_rows * WALL_CUBE_SPACING * 0.5f / tanHalf;
+    float fitWidth = (float)s_columns * WALL_CUBE_SPACING * 0.5f / (tanHalf * aspect);
+    float distance = ((fitHeight > fitWidth ? fitHeight : fitWidth) + WALL_CUBE_SPACING) * s_zoom;
+    float extent = (float)(s_columns > s_rows ? s_columns : s_rows) * WALL_CUBE_SPACING;
+
+    float projection[16];
+    float view[16];
+    float clip[16];
+    makePerspectiveMatrix4(projection, CAMERA_FOV_DEG, aspect, WALL_CAMERA_NEAR, distance + extent);
+    computeViewMatrixAtDistance(view, distance);
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(projection);
+    glMatrixMode(GL_MODELVIEW);
+    glLoadMatrixf(view);
+
+    // Loại cube ngoài frustum, chọn mức chi tiết theo kích thước trên màn hình,
+    // gom các cube còn lại thành các dãy instance liền nhau
+    float planes[6][4];
+    multiplyMatrix4(clip, projection, view);
+    extractFrustumPlanes(clip, planes);
+    const bool lodTextured = isCubeLodRendererReady();
+    const float cubeExtent = 3.0f * (PIECE_SIZE + GAP_SIZE) - GAP_SIZE;
+    const float pixelsPerUnit = (float)g_windowHeight * 0.5f / tanHalf;  // Ở độ sâu 1
+    const float boxScale = cubeExtent / PIECE_SIZE;
+    PieceInstance* out = &s_visibleInstances[0];
+    CubeLodInstance* lodOut = &s_visibleLodInstances[0];
+    int instanceCount = 0;
+    int lodCount = 0;
+    s_visibleCubes = 0;
+    s_lodCounts[0] = 0;
+    s_lodCounts[1] = 0;
+    s_lodCounts[2] = 0;
+    for (int cube = 0; cube < s_cubeCount; cube++) {
+        const float* center = &s_centers[(size_t)cube * 3];
+        if (!isSphereInFrustum(planes, center, WALL_CUBE_RADIUS)) {
+            continue;
+        }
+        s_visibleCubes++;
+
+        // Độ sâu trong không gian camera -> kích thước cube trên màn hình
+        float depth = -(view[2] * center[0] + view[6] * center[1] + view[10] * center[2] + view[14]);
+        float pixels = depth > WALL_CAMERA_NEAR ? cubeExtent * pixelsPerUnit / depth : LOD_FULL_MIN_PIXELS;
+
+        if (pixels < LOD_BOX_MAX_PIXELS) {
+            // Một hộp 6 màu: dùng lại hình học của mảnh, phóng to bằng ma trận
+            PieceInstance& box = out[instanceCount++];
+            for (int row = 0; row < 3; row++) {
+                box.transform[row * 4 + 0] = s_tilt[row][0] * boxScale;
+                box.transform[row * 4 + 1] = s_tilt[row][1] * boxScale;
+                box.transform[row * 4 + 2] = s_tilt[row][2] * boxScale;
+                box.transform[row * 4 + 3] = center[row];
+            }
+            memcpy(box.colors, s_boxColors, sizeof(s_boxColors));
+            s_lodCounts[2]++;
+        } else if (pixels < LOD_FULL_MIN_PIXELS && lodTextured) {
+            // Hộp dán atlas sticker; lớp đang xoay không được vẽ animation ở mức này
+            CubeLodInstance& lod = lodOut[lodCount++];
+            writeWallTransform(lod.transform, center, s_tilt, ZERO_OFFSET);
+            int originX;
+            int originY;
+            getAtlasOrigin(cube, originX, originY);
+            lod.atlasOrigin[0] = (float)originX;
+            lod.atlasOrigin[1] = (float)originY;
+            s_lodCounts[1]++;
+        } else {
+            float progress = s_prevProgress[cube] + (s_progress[cube] - s_prevProgress[cube]) * g_renderAlpha;
+            if (progress > 0.0f) {
+                updateTurningLayer(cube, progress);
+            }
+            memcpy(out + instanceCount, &s_instances[(size_t)cube * WALL_PIECES_PER_CUBE],
+                   sizeof(PieceInstance) * WALL_PIECES_PER_CUBE);
+            instanceCount += WALL_PIECES_PER_CUBE;
+            s_lodCounts[0]++;
+        }
+    }
+
+    if (isInstancedRendererReady()) {
+        drawPieceInstances(out, instanceCount);
+    } else {
+        drawWallInstancesImmediate(out, instanceCount);
+    }
+    if (lodCount > 0) {
+        uploadAtlas();
+        drawCubeLodInstances(lodOut, lodCount, s_atlasTexture, LOD_ATLAS_WIDTH, s_atlasHeight);
+    }
+}
+
+void zoomCubeWall(float factor) {
+    s_zoom *= factor;
+    if (s_zoom < 0.02f) {
+        s_zoom = 0.02f;
+    } else if (s_zoom > 4.0f) {
+        s_zoom = 4.0f;
+    }
+    requestRedisplay();
+}
+
+int getCubeWallCount() {
+    return s_cubeCount;
+}
+
+int getCubeWallVisibleCount() {
+    return s_visibleCubes;
+}
+
+void getCubeWallLodCounts(int counts[3]) {
+    counts[0] = s_lodCounts[0];
+    counts[1] = s_lodCounts[1];
+    counts[2] = s_lodCounts[2];
+}